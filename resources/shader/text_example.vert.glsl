@@ -9,7 +9,7 @@ void main(void) {
     // Enlarge the quad to make some room for effects.
     float scale = 2;
     vec2 pos = vertPos * scale;
-    gl_Position = r_projectionMatrix * spriteVMTransform * vec4(pos, 0.0, 1.0);
+    gl_Position = r_projectionMatrix * sprite_transform_vertex(pos);
 
     // Adjust texture coordinates so that the glyph remains in the center, unaffected by the scaling factor.
     // Some extra code is required in the fragment shader to chop off the unwanted bits of the texture.
@@ -22,7 +22,7 @@ void main(void) {
     texRegion = spriteTexRegion;
 
     // Global overlay coordinates for this primitive.
-    texCoordOverlay = (spriteTexTransform * vec4(tc, 0.0, 1.0)).xy;
+    texCoordOverlay = sprite_transform_texcoord(tc);
 
     // Fragment shader needs to know the sprite dimensions so that it can denormalize texCoord for processing.
     dimensions = spriteDimensions;
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+
+'''
+Packs the key-value resource definitions (sprites, textures, animations, music) into a single
+binary manifest, so that the game doesn't have to open and parse hundreds of tiny files.
+See src/resource/manifest.h for the format.
+'''
+
+import os
+import struct
+import sys
+
+from taiseilib.common import write_depfile
+
+MAGIC = b'TAIKVM\0\0'
+VERSION = 1
+EXTENSIONS = ('.spr', '.tex', '.ani', '.bgm')
+
+
+def parse_keyvalue(path):
+    # mirrors parse_keyvalue_stream_cb() in src/util/kvparser.c
+    pairs = []
+
+    with open(path, 'r', encoding='utf-8') as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.lstrip()
+
+            if not line or line.startswith('#'):
+                continue
+
+            key, sep, val = line.partition('= ')
+
+            if not sep:
+                raise ValueError('{}:{}: missing separator'.format(path, lineno))
+
+            pairs.append((key.rstrip(), val.rstrip('\r\n')))
+
+    return pairs
+
+
+class StringTable:
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, s):
+        if s not in self.offsets:
+            self.offsets[s] = len(self.data)
+            self.data += s.encode('utf-8') + b'\0'
+
+        return self.offsets[s]
+
+
+def main(args):
+    assert(len(args) > 4)
+    manifest = args[1]
+    sourcedir = args[2]
+    depfile = args[3]
+    directories = args[4:]
+
+    files = {}
+
+    for directory in directories:
+        for root, dirs, filenames in os.walk(directory):
+            for fn in filenames:
+                if not fn.endswith(EXTENSIONS):
+                    continue
+
+                abspath = os.path.join(root, fn)
+                rel = os.path.join(os.path.basename(directory), os.path.relpath(abspath, directory))
+                files['res/' + rel.replace(os.sep, '/')] = abspath
+
+    strings = StringTable()
+    entries = bytearray()
+    pairs = bytearray()
+    num_pairs = 0
+
+    # sorted by byte value, for binary search with strcmp()
+    for vfspath in sorted(files, key=lambda p: p.encode('utf-8')):
+        kv = parse_keyvalue(files[vfspath])
+        entries += struct.pack('<III', strings.add(vfspath), num_pairs, len(kv))
+
+        for key, val in kv:
+            pairs += struct.pack('<II', strings.add(key), strings.add(val))
+
+        num_pairs += len(kv)
+
+    with open(manifest, 'wb') as f:
+        f.write(MAGIC)
+        f.write(struct.pack('<IIII', VERSION, len(files), num_pairs, len(strings.data)))
+        f.write(entries)
+        f.write(pairs)
+        f.write(strings.data)
+
+    write_depfile(depfile, manifest, list(files.values()) + [__file__])
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -15,8 +15,15 @@ directories = sys.argv[4:]
 
 with ZipFile(archive, "w", ZIP_DEFLATED) as zf:
     handled_subdirs = set()
+    dependencies = []
 
     for directory in directories:
+        if os.path.isfile(directory):
+            # generated files, e.g. the resource manifest, go into the root of the archive
+            zf.write(directory, os.path.basename(directory))
+            dependencies.append(directory)
+            continue
+
         for root, dirs, files in os.walk(directory):
             for fn in files:
                 if fn == 'meson.build':
@@ -35,7 +42,6 @@ with ZipFile(archive, "w", ZIP_DEFLATED) as zf:
                     zf.writestr(zi, "")
 
                 zf.write(abspath, rel)
+                dependencies.append(os.path.join(sourcedir, rel))
 
-    write_depfile(depfile, archive,
-        [os.path.join(sourcedir, x) for x in zf.namelist()] + [__file__]
-    )
+    write_depfile(depfile, archive, dependencies + [__file__])
@@ -62,6 +62,33 @@ void play_sound_ex(const char *name, int cooldown, bool replace) attr_nonnull(1)
 void play_sound_delayed(const char *name, int cooldown, bool replace, int delay) attr_nonnull(1);
 void play_loop(const char *name) attr_nonnull(1);
 void play_ui_sound(const char *name) attr_nonnull(1);
+
+// Variants taking a pre-resolved sound; NULL is silently ignored.
+void play_sound_p(Sound *snd);
+void play_sound_ex_p(Sound *snd, int cooldown, bool replace);
+void play_sound_delayed_p(Sound *snd, int cooldown, bool replace, int delay);
+void play_loop_p(Sound *snd);
+void play_ui_sound_p(Sound *snd);
+
+// A cached name lookup that stays valid across sound unloads.
+typedef struct SoundRef {
+	Sound *snd;
+	uint epoch;
+} SoundRef;
+
+Sound* sound_ref_resolve(SoundRef *ref, const char *name) attr_nonnull(1, 2);
+
+// Resolves a sound name once per call site, e.g. play_sound_p(SFX("shot1")).
+#ifdef USE_GNU_EXTENSIONS
+	#define SFX(name) (__extension__({ \
+		static SoundRef _sfx_ref; \
+		sound_ref_resolve(&_sfx_ref, (name)); \
+	}))
+#else
+	#define SFX(name) get_sound(name)
+#endif
+
+void audio_sound_unloaded(Sound *snd) attr_nonnull(1);
 void reset_sounds(void);
 void pause_sounds(void);
 void resume_sounds(void);
@@ -20,32 +20,72 @@ CurrentBGM current_bgm = { .name = NULL };
 static char *saved_bgm;
 static ht_str2int_t sfx_volumes;
 
-static struct enqueued_sound {
-	LIST_INTERFACE(struct enqueued_sound);
-	char *name;
+#define SOUND_QUEUE_SIZE 256
+
+typedef struct EnqueuedSound {
+	Sound *snd;
 	int time;
 	int cooldown;
 	bool replace;
-} *sound_queue;
+} EnqueuedSound;
+
+static struct {
+	// fixed-capacity ring of delayed plays, kept in the order they were enqueued
+	EnqueuedSound queue[SOUND_QUEUE_SIZE];
+	uint queue_head;
+	uint queue_count;
+
+	// sounds with a loop state to update, so that update_sounds() doesn't have to visit every sound
+	Sound **loops;
+	uint num_loops;
+	uint loops_capacity;
+
+	// bumped whenever a sound is unloaded, invalidating all SoundRefs
+	uint epoch;
+} sounds;
+
+static void enqueue_sound(Sound *snd, int cooldown, bool replace, int delay) {
+	if(sounds.queue_count == SOUND_QUEUE_SIZE) {
+		log_warn("Delayed sound queue is full, sound dropped");
+		return;
+	}
 
-static void play_sound_internal(const char *name, bool is_ui, int cooldown, bool replace, int delay) {
-	if(delay > 0) {
-		struct enqueued_sound *s = malloc(sizeof(struct enqueued_sound));
-		s->time = global.frames + delay;
-		s->name = strdup(name);
-		s->cooldown = cooldown;
-		s->replace = replace;
-		list_push(&sound_queue, s);
+	EnqueuedSound *s = sounds.queue + (sounds.queue_head + sounds.queue_count++) % SOUND_QUEUE_SIZE;
+	s->snd = snd;
+	s->time = global.frames + delay;
+	s->cooldown = cooldown;
+	s->replace = replace;
+}
+
+static void track_loop(Sound *snd) {
+	if(snd->tracked) {
 		return;
 	}
 
-	if(!audio_backend_initialized() || global.frameskip) {
+	if(sounds.num_loops == sounds.loops_capacity) {
+		sounds.loops_capacity = sounds.loops_capacity ? sounds.loops_capacity * 2 : 16;
+		sounds.loops = realloc(sounds.loops, sizeof(*sounds.loops) * sounds.loops_capacity);
+	}
+
+	sounds.loops[sounds.num_loops++] = snd;
+	snd->tracked = true;
+}
+
+static void play_sound_internal(Sound *snd, bool is_ui, int cooldown, bool replace, int delay) {
+	if(!snd) {
 		return;
 	}
 
-	Sound *snd = get_sound(name);
+	if(delay > 0) {
+		enqueue_sound(snd, cooldown, replace, delay);
+		return;
+	}
 
-	if(!snd || (!is_ui && snd->lastplayframe + 3 + cooldown >= global.frames)) {
+	if(!audio_backend_initialized() || global.frameskip || replay_is_seeking()) {
+		return;
+	}
+
+	if(!is_ui && snd->lastplayframe + 3 + cooldown >= global.frames) {
 		return;
 	}
 
@@ -55,91 +95,156 @@ static void play_sound_internal(const char *name, bool is_ui, int cooldown, bool
 		(snd->impl, is_ui ? SNDGROUP_UI : SNDGROUP_MAIN);
 }
 
-static void* discard_enqueued_sound(List **queue, List *vsnd, void *arg) {
-	struct enqueued_sound *snd = (struct enqueued_sound*)vsnd;
-	free(snd->name);
-	free(list_unlink(queue, vsnd));
-	return NULL;
+static Sound* get_sound_if_enabled(const char *name) {
+	if(!audio_backend_initialized()) {
+		return NULL;
+	}
+
+	return get_sound(name);
 }
 
-static void* play_enqueued_sound(struct enqueued_sound **queue, struct enqueued_sound *snd, void *arg) {
-	play_sound_internal(snd->name, false, snd->cooldown, snd->replace, 0);
-	free(snd->name);
-	free(list_unlink(queue, snd));
-	return NULL;
+Sound* sound_ref_resolve(SoundRef *ref, const char *name) {
+	if(ref->snd && ref->epoch == sounds.epoch) {
+		return ref->snd;
+	}
+
+	// missing sounds aren't cached, in case they get loaded later
+	ref->snd = get_sound_if_enabled(name);
+	ref->epoch = sounds.epoch;
+	return ref->snd;
 }
 
 void play_sound(const char *name) {
-	play_sound_internal(name, false, 0, false, 0);
+	play_sound_p(get_sound_if_enabled(name));
 }
 
 void play_sound_ex(const char *name, int cooldown, bool replace) {
-	play_sound_internal(name, false, cooldown, replace, 0);
+	play_sound_ex_p(get_sound_if_enabled(name), cooldown, replace);
 }
 
 void play_sound_delayed(const char *name, int cooldown, bool replace, int delay) {
-	play_sound_internal(name, false, cooldown, replace, delay);
+	play_sound_delayed_p(get_sound_if_enabled(name), cooldown, replace, delay);
 }
 
 void play_ui_sound(const char *name) {
-	play_sound_internal(name, true, 0, true, 0);
+	play_ui_sound_p(get_sound_if_enabled(name));
 }
 
 void play_loop(const char *name) {
-	if(!audio_backend_initialized() || global.frameskip) {
-		return;
-	}
+	play_loop_p(get_sound_if_enabled(name));
+}
 
-	Sound *snd = get_sound(name);
+void play_sound_p(Sound *snd) {
+	play_sound_internal(snd, false, 0, false, 0);
+}
 
-	if(!snd) {
+void play_sound_ex_p(Sound *snd, int cooldown, bool replace) {
+	play_sound_internal(snd, false, cooldown, replace, 0);
+}
+
+void play_sound_delayed_p(Sound *snd, int cooldown, bool replace, int delay) {
+	play_sound_internal(snd, false, cooldown, replace, delay);
+}
+
+void play_ui_sound_p(Sound *snd) {
+	play_sound_internal(snd, true, 0, true, 0);
+}
+
+void play_loop_p(Sound *snd) {
+	if(!snd || !audio_backend_initialized() || global.frameskip || replay_is_seeking()) {
 		return;
 	}
 
 	if(!snd->islooping) {
 		audio_backend_sound_loop(snd->impl, SNDGROUP_MAIN);
 		snd->islooping = true;
+		track_loop(snd);
 	}
 	if(snd->islooping == LS_LOOPING) {
 		snd->lastplayframe = global.frames;
 	}
 }
 
-static void* reset_sounds_callback(const char *name, Resource *res, void *arg) {
-	bool reset = (intptr_t)arg;
-	Sound *snd = res->data;
+static void update_loop(Sound *snd, bool reset) {
+	if(snd->islooping && (global.frames > snd->lastplayframe + LOOPTIMEOUTFRAMES || reset)) {
+		audio_backend_sound_stop_loop(snd->impl);
+		snd->islooping = LS_FADEOUT;
+	}
 
-	if(snd) {
-		if(reset) {
-			snd->lastplayframe = 0;
-		}
+	if(snd->islooping && (global.frames > snd->lastplayframe + LOOPTIMEOUTFRAMES + LOOPFADEOUT*60/1000. || reset)) {
+		snd->islooping = LS_OFF;
+	}
+}
 
-		if(snd->islooping && (global.frames > snd->lastplayframe + LOOPTIMEOUTFRAMES || reset)) {
-			audio_backend_sound_stop_loop(snd->impl);
-			snd->islooping = LS_FADEOUT;
-		}
+static void update_loops(bool reset) {
+	for(uint i = 0; i < sounds.num_loops;) {
+		Sound *snd = sounds.loops[i];
+		update_loop(snd, reset);
 
-		if(snd->islooping && (global.frames > snd->lastplayframe + LOOPTIMEOUTFRAMES + LOOPFADEOUT*60/1000. || reset)) {
-			snd->islooping = LS_OFF;
+		if(snd->islooping == LS_OFF) {
+			snd->tracked = false;
+			sounds.loops[i] = sounds.loops[--sounds.num_loops];
+		} else {
+			++i;
 		}
 	}
+}
+
+static void* reset_sound_callback(const char *name, Resource *res, void *arg) {
+	Sound *snd = res->data;
+
+	if(snd) {
+		snd->lastplayframe = 0;
+	}
 
 	return NULL;
 }
 
 void reset_sounds(void) {
-	resource_for_each(RES_SFX, reset_sounds_callback, (void*)true);
-	list_foreach(&sound_queue, discard_enqueued_sound, NULL);
+	resource_for_each(RES_SFX, reset_sound_callback, NULL);
+	update_loops(true);
+	sounds.queue_head = sounds.queue_count = 0;
 }
 
 void update_sounds(void) {
-	resource_for_each(RES_SFX, reset_sounds_callback, (void*)false);
+	update_loops(false);
+
+	uint count = sounds.queue_count;
+	sounds.queue_count = 0;
+
+	for(uint i = 0; i < count; ++i) {
+		EnqueuedSound s = sounds.queue[(sounds.queue_head + i) % SOUND_QUEUE_SIZE];
 
-	for(struct enqueued_sound *s = sound_queue, *next; s; s = next) {
-		next = (struct enqueued_sound*)s->next;
+		if(!s.snd) {
+			continue;
+		}
+
+		if(s.time <= global.frames) {
+			play_sound_internal(s.snd, false, s.cooldown, s.replace, 0);
+		} else {
+			// compact the pending sounds towards the head, preserving their order
+			sounds.queue[(sounds.queue_head + sounds.queue_count++) % SOUND_QUEUE_SIZE] = s;
+		}
+	}
+}
+
+void audio_sound_unloaded(Sound *snd) {
+	sounds.epoch++;
+
+	for(uint i = 0; i < sounds.queue_count; ++i) {
+		EnqueuedSound *s = sounds.queue + (sounds.queue_head + i) % SOUND_QUEUE_SIZE;
+
+		if(s->snd == snd) {
+			s->snd = NULL;
+		}
+	}
 
-		if(s->time <= global.frames) {
-			play_enqueued_sound(&sound_queue, s, NULL);
+	if(snd->tracked) {
+		for(uint i = 0; i < sounds.num_loops; ++i) {
+			if(sounds.loops[i] == snd) {
+				sounds.loops[i] = sounds.loops[--sounds.num_loops];
+				break;
+			}
 		}
 	}
 }
@@ -317,4 +422,6 @@ void audio_shutdown(void) {
 	events_unregister_handler(audio_config_updated);
 	audio_backend_shutdown();
 	ht_destroy(&sfx_volumes);
+	free(sounds.loops);
+	memset(&sounds, 0, sizeof(sounds));
 }
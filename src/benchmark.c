@@ -0,0 +1,210 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include "benchmark.h"
+#include "util.h"
+
+typedef struct BenchFrame {
+	uint16_t stage_id;
+	int frame;
+	double total;
+	double sections[BENCH_NUM_SECTIONS];
+} BenchFrame;
+
+BenchState _bench;
+
+static struct {
+	BenchFrame *frames;
+	size_t num_frames;
+	size_t capacity;
+	char *trace_path;
+} bench;
+
+static const char *const section_names[] = {
+	#define BENCH_SECTION(id, name) name,
+	BENCH_SECTIONS
+	#undef BENCH_SECTION
+};
+
+void bench_init(const char *trace_path) {
+	memset(&_bench, 0, sizeof(_bench));
+	memset(&bench, 0, sizeof(bench));
+	_bench.enabled = true;
+
+	if(trace_path) {
+		bench.trace_path = strdup(trace_path);
+	}
+}
+
+void bench_shutdown(void) {
+	free(bench.frames);
+	free(bench.trace_path);
+	memset(&bench, 0, sizeof(bench));
+	_bench.enabled = false;
+}
+
+void bench_frame_end(uint16_t stage_id, int frame) {
+	if(!_bench.enabled) {
+		return;
+	}
+
+	hrtime_t now = time_get();
+
+	if(bench.num_frames == bench.capacity) {
+		bench.capacity = bench.capacity ? bench.capacity * 2 : 4096;
+		bench.frames = realloc(bench.frames, bench.capacity * sizeof(*bench.frames));
+	}
+
+	BenchFrame *f = bench.frames + bench.num_frames++;
+	f->stage_id = stage_id;
+	f->frame = frame;
+	f->total = now - _bench.frame_start;
+	memcpy(f->sections, _bench.section_time, sizeof(f->sections));
+	memset(_bench.section_time, 0, sizeof(_bench.section_time));
+}
+
+static int double_cmp(const void *p1, const void *p2) {
+	double a = *(const double*)p1;
+	double b = *(const double*)p2;
+	return (a > b) - (a < b);
+}
+
+static double percentile(const double *sorted, size_t num, double p) {
+	// nearest-rank method
+	size_t rank = ceil(p * num);
+	return sorted[rank ? rank - 1 : 0];
+}
+
+static void report_row(const char *name, double *times, size_t num, double frame_total) {
+	double total = 0;
+
+	for(size_t i = 0; i < num; ++i) {
+		total += times[i];
+	}
+
+	qsort(times, num, sizeof(*times), double_cmp);
+
+	tsfprintf(stdout, "%-20s %10.2f %6.1f%% %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+		name,
+		total * 1e3,
+		100 * total / frame_total,
+		total / num * 1e6,
+		percentile(times, num, 0.50) * 1e6,
+		percentile(times, num, 0.90) * 1e6,
+		percentile(times, num, 0.99) * 1e6,
+		times[num - 1] * 1e6
+	);
+}
+
+static void write_trace_csv(SDL_RWops *out) {
+	SDL_RWprintf(out, "stage,frame,total_us");
+
+	for(int s = 0; s < BENCH_NUM_SECTIONS; ++s) {
+		SDL_RWprintf(out, ",%s_us", section_names[s]);
+	}
+
+	SDL_RWprintf(out, "\n");
+
+	for(size_t i = 0; i < bench.num_frames; ++i) {
+		BenchFrame *f = bench.frames + i;
+		SDL_RWprintf(out, "%X,%i,%.3f", f->stage_id, f->frame, f->total * 1e6);
+
+		for(int s = 0; s < BENCH_NUM_SECTIONS; ++s) {
+			SDL_RWprintf(out, ",%.3f", f->sections[s] * 1e6);
+		}
+
+		SDL_RWprintf(out, "\n");
+	}
+}
+
+static void write_trace_json(SDL_RWops *out) {
+	SDL_RWprintf(out, "{\n\t\"unit\": \"us\",\n\t\"sections\": [");
+
+	for(int s = 0; s < BENCH_NUM_SECTIONS; ++s) {
+		SDL_RWprintf(out, "%s\"%s\"", s ? ", " : "", section_names[s]);
+	}
+
+	SDL_RWprintf(out, "],\n\t\"frames\": [\n");
+
+	for(size_t i = 0; i < bench.num_frames; ++i) {
+		BenchFrame *f = bench.frames + i;
+		SDL_RWprintf(out, "\t\t{ \"stage\": \"%X\", \"frame\": %i, \"total\": %.3f, \"sections\": [", f->stage_id, f->frame, f->total * 1e6);
+
+		for(int s = 0; s < BENCH_NUM_SECTIONS; ++s) {
+			SDL_RWprintf(out, "%s%.3f", s ? ", " : "", f->sections[s] * 1e6);
+		}
+
+		SDL_RWprintf(out, "] }%s\n", i + 1 < bench.num_frames ? "," : "");
+	}
+
+	SDL_RWprintf(out, "\t]\n}\n");
+}
+
+static void write_trace(const char *path) {
+	SDL_RWops *out = SDL_RWFromFile(path, "w");
+
+	if(!out) {
+		log_warn("Couldn't open %s for writing: %s", path, SDL_GetError());
+		return;
+	}
+
+	if(strendswith(path, ".json")) {
+		write_trace_json(out);
+	} else {
+		write_trace_csv(out);
+	}
+
+	SDL_RWclose(out);
+	log_info("Benchmark trace written to %s", path);
+}
+
+void bench_report(void) {
+	if(!bench.num_frames) {
+		log_warn("No frames were recorded");
+		return;
+	}
+
+	size_t num = bench.num_frames;
+	double *times = calloc(num, sizeof(*times));
+	double frame_total = 0;
+
+	for(size_t i = 0; i < num; ++i) {
+		frame_total += bench.frames[i].total;
+	}
+
+	tsfprintf(stdout, "\nReplay benchmark: %zu frames in %.3f s (%.1f frames/s)\n\n",
+		num, frame_total, num / frame_total
+	);
+
+	tsfprintf(stdout, "%-20s %10s %7s %9s %9s %9s %9s %9s\n",
+		"section", "total ms", "share", "mean us", "p50 us", "p90 us", "p99 us", "max us"
+	);
+
+	for(size_t i = 0; i < num; ++i) {
+		times[i] = bench.frames[i].total;
+	}
+
+	report_row("frame", times, num, frame_total);
+
+	for(int s = 0; s < BENCH_NUM_SECTIONS; ++s) {
+		for(size_t i = 0; i < num; ++i) {
+			times[i] = bench.frames[i].sections[s];
+		}
+
+		report_row(section_names[s], times, num, frame_total);
+	}
+
+	tsfprintf(stdout, "\n");
+	free(times);
+
+	if(bench.trace_path) {
+		write_trace(bench.trace_path);
+	}
+}
@@ -0,0 +1,63 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include "hirestime.h"
+
+// Per-frame timings of the stage logic, collected in --bench-replay mode.
+
+#define BENCH_SECTIONS \
+	BENCH_SECTION(STAGE_EVENTS, "stage_events") \
+	BENCH_SECTION(PLAYER_LOGIC, "player_logic") \
+	BENCH_SECTION(PROCESS_BOSS, "process_boss") \
+	BENCH_SECTION(PROCESS_ENEMIES, "process_enemies") \
+	BENCH_SECTION(PROCESS_PROJECTILES, "process_projectiles") \
+	BENCH_SECTION(PROCESS_ITEMS, "process_items") \
+	BENCH_SECTION(PROCESS_LASERS, "process_lasers") \
+	BENCH_SECTION(PROCESS_PARTICLES, "process_particles") \
+
+typedef enum BenchSection {
+	#define BENCH_SECTION(id, name) BENCH_##id,
+	BENCH_SECTIONS
+	#undef BENCH_SECTION
+	BENCH_NUM_SECTIONS,
+} BenchSection;
+
+typedef struct BenchState {
+	bool enabled;
+	hrtime_t frame_start;
+	hrtime_t section_start[BENCH_NUM_SECTIONS];
+	double section_time[BENCH_NUM_SECTIONS];
+} BenchState;
+
+extern BenchState _bench;
+
+void bench_init(const char *trace_path);
+void bench_shutdown(void);
+void bench_frame_end(uint16_t stage_id, int frame);
+void bench_report(void);
+
+static inline attr_must_inline void bench_frame_begin(void) {
+	if(_bench.enabled) {
+		_bench.frame_start = time_get();
+	}
+}
+
+static inline attr_must_inline void bench_section_begin(BenchSection s) {
+	if(_bench.enabled) {
+		_bench.section_start[s] = time_get();
+	}
+}
+
+static inline attr_must_inline void bench_section_end(BenchSection s) {
+	if(_bench.enabled) {
+		_bench.section_time[s] += time_get() - _bench.section_start[s];
+	}
+}
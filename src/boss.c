@@ -219,7 +219,7 @@ static Projectile* spawn_boss_glow(Boss *boss, const Color *clr, int timeout) {
 	return PARTICLE(
 		.sprite_ptr = memdup(aniplayer_get_frame(&boss->ani), sizeof(Sprite)),
 		// this is in sync with the boss position oscillation
-		.pos = boss->pos + 6 * sin(global.frames/25.0) * I,
+		.pos = boss->pos + 6 * sim_sin(global.frames/25.0) * I,
 		.color = clr,
 		.rule = boss_glow,
 		.draw_rule = BossGlow,
@@ -240,7 +240,7 @@ static void spawn_particle_effects(Boss *boss) {
 	if(!(global.frames % 13) && !is_extra) {
 		PARTICLE(
 			.sprite = "smoke",
-			.pos = cexp(I*global.frames),
+			.pos = sim_cexp(I*global.frames),
 			.color = RGBA(shadowcolor->r, shadowcolor->g, shadowcolor->b, 0.0),
 			.rule = enemy_flare,
 			.timeout = 180,
@@ -434,7 +434,7 @@ void boss_rule_extra(Boss *boss, float alpha) {
 
 	for(int i = 0; i < cnt; ++i) {
 		float a = i*2*M_PI/cnt + global.frames / 100.0;
-		complex dir = cexp(I*(a+global.frames/50.0));
+		complex dir = sim_cexp(I*(a+global.frames/50.0));
 		complex vel = dir * 3;
 		float v = max(0, alpha - 1);
 		float psina = psin(a);
@@ -488,9 +488,9 @@ static DamageResult ent_damage_boss(EntityInterface *ent, const DamageInfo *dmg)
 	boss->current->hp -= dmg->amount*factor;
 
 	if(boss->current->hp < boss->current->maxhp * 0.1) {
-		play_loop("hit1");
+		play_loop_p(SFX("hit1"));
 	} else {
-		play_loop("hit0");
+		play_loop_p(SFX("hit0"));
 	}
 
 	return DMG_RESULT_OK;
@@ -662,11 +662,11 @@ void process_boss(Boss **pboss) {
 	if(extra) {
 		float base = 0.2;
 		float ampl = 0.2;
-		float s = sin(time / 90.0 + M_PI*1.2);
+		float s = sim_sin(time / 90.0 + M_PI*1.2);
 
 		if(boss->current->endtime) {
 			float p = (boss->current->endtime - global.frames)/(float)ATTACK_END_DELAY_EXTRA;
-			float a = max((base + ampl * s) * p * 0.5, 5 * pow(1 - p, 3));
+			float a = max((base + ampl * s) * p * 0.5, 5 * sim_pow(1 - p, 3));
 			if(a < 2) {
 				global.shake_view = 3 * a;
 				boss_rule_extra(boss, a);
@@ -687,7 +687,7 @@ void process_boss(Boss **pboss) {
 			boss_rule_extra(boss, 1+time/(float)ATTACK_START_DELAY_EXTRA);
 		} else {
 			float o = min(0, -5 + time/30.0);
-			float q = (time <= 150? 1 - pow(time/250.0, 2) : min(1, time/60.0));
+			float q = (time <= 150? 1 - sim_pow(time/250.0, 2) : min(1, time/60.0));
 
 			boss_rule_extra(boss, max(1-time/300.0, base + ampl * s) * q);
 			if(o) {
@@ -724,7 +724,7 @@ void process_boss(Boss **pboss) {
 		float t = (global.frames - boss->current->endtime)/(float)BOSS_DEATH_DELAY + 1;
 		tsrand_fill(6);
 
-		Color *clr = RGBA_MUL_ALPHA(0.1 + sin(10*t), 0.1 + cos(10*t), 0.5, t);
+		Color *clr = RGBA_MUL_ALPHA(0.1 + sim_sin(10*t), 0.1 + sim_cos(10*t), 0.5, t);
 		clr->a = 0;
 
 		PARTICLE(
@@ -734,7 +734,7 @@ void process_boss(Boss **pboss) {
 			.draw_rule = Petal,
 			.color = clr,
 			.args = {
-				sign(anfrand(5))*(3+t*5*afrand(0))*cexp(I*M_PI*8*t),
+				sign(anfrand(5))*(3+t*5*afrand(0))*sim_cexp(I*M_PI*8*t),
 				5+I,
 				afrand(2) + afrand(3)*I,
 				afrand(4) + 360.0*I*afrand(1)
@@ -762,7 +762,7 @@ void process_boss(Boss **pboss) {
 					.timeout = 60 + 10 * afrand(2),
 					.rule = linear,
 					.draw_rule = Fade,
-					.args = { (3+afrand(0)*10)*cexp(I*tsrand_a(1)) },
+					.args = { (3+afrand(0)*10)*sim_cexp(I*tsrand_a(1)) },
 				);
 			}
 
@@ -772,7 +772,7 @@ void process_boss(Boss **pboss) {
 
 		play_sound_ex("bossdeath", BOSS_DEATH_DELAY * 2, false);
 	} else {
-		if(cabs(boss->pos - global.plr.pos) < 16) {
+		if(sim_cabs(boss->pos - global.plr.pos) < 16) {
 			ent_damage(&global.plr.ent, &(DamageInfo) { .type = DMG_ENEMY_COLLISION });
 		}
 	}
@@ -948,8 +948,8 @@ void boss_generic_move(Boss *b, int time) {
 	float f = (time + ATTACK_START_DELAY) / ((float)atck->timeout + ATTACK_START_DELAY);
 	float x = f;
 	float a = 0.3;
-	f = 1 - pow(f - 1, 4);
-	f = f * (1 + a * pow(1 - x, 2));
+	f = 1 - sim_pow(f - 1, 4);
+	f = f * (1 + a * sim_pow(1 - x, 2));
 	b->pos = atck->info->pos_dest * f + BOSS_DEFAULT_SPAWN_POS * (1 - f);
 }
 
@@ -44,6 +44,10 @@ int cli_args(int argc, char **argv, CLIAction *a) {
 	struct TsOption taisei_opts[] = {
 		{{"replay", required_argument, 0, 'r'}, "Play a replay from %s", "FILE"},
 		{{"verify-replay", required_argument, 0, 'R'}, "Play a replay from %s in headless mode, crash as soon as it desyncs", "FILE"},
+		{{"bench-replay", required_argument, 0, 'b'}, "Play a replay from %s in headless mode as fast as possible and print timing statistics", "FILE"},
+		{{"seek", required_argument, 0, 'F'}, "Start --replay at frame %s of the selected stage", "FRAME"},
+		{{"bench-trace", required_argument, 0, 'B'}, "Write per-frame --bench-replay timings to %s (CSV, or JSON if the name ends with .json)", "FILE"},
+		{{"render-stats", required_argument, 0, 'S'}, "Render every --bench-replay frame with the null renderer and write per-frame render statistics to %s", "FILE"},
 #ifdef DEBUG
 		{{"play", no_argument, 0, 'p'}, "Play a specific stage", 0},
 		{{"sid", required_argument, 0, 'i'}, "Select stage by %s", "ID"},
@@ -110,6 +114,18 @@ int cli_args(int argc, char **argv, CLIAction *a) {
 			a->type = CLI_VerifyReplay;
 			a->filename = strdup(optarg);
 			break;
+		case 'b':
+			a->type = CLI_BenchReplay;
+			a->filename = strdup(optarg);
+			break;
+		case 'B':
+			free(a->trace_filename);
+			a->trace_filename = strdup(optarg);
+			break;
+		case 'S':
+			free(a->render_stats_filename);
+			a->render_stats_filename = strdup(optarg);
+			break;
 		case 'p':
 			a->type = CLI_SelectStage;
 			break;
@@ -154,6 +170,11 @@ int cli_args(int argc, char **argv, CLIAction *a) {
 				}
 			}
 			break;
+		case 'F':
+			a->seek_frame = strtol(optarg, &endptr, 10);
+			if(!*optarg || endptr == optarg || a->seek_frame < 0)
+				log_fatal("Frame '%s' is not a valid frame number", optarg);
+			break;
 		case 't':
 			a->type = CLI_DumpVFSTree,
 			a->filename = strdup(optarg ? optarg : "");
@@ -170,6 +191,7 @@ int cli_args(int argc, char **argv, CLIAction *a) {
 		switch(a->type) {
 			case CLI_PlayReplay:
 			case CLI_VerifyReplay:
+			case CLI_BenchReplay:
 			case CLI_SelectStage:
 				if(stage_get(stageid) == NULL) {
 					log_fatal("Invalid stage id: %X", stageid);
@@ -182,6 +204,11 @@ int cli_args(int argc, char **argv, CLIAction *a) {
 		}
 	}
 
+	if(a->seek_frame && a->type != CLI_PlayReplay) {
+		log_warn("--seek was ignored");
+		a->seek_frame = 0;
+	}
+
 	if(plrmode) {
 		if(a->type == CLI_SelectStage) {
 			a->plrmode = plrmode;
@@ -190,6 +217,14 @@ int cli_args(int argc, char **argv, CLIAction *a) {
 		}
 	}
 
+	if(a->trace_filename && a->type != CLI_BenchReplay) {
+		log_warn("--bench-trace was ignored");
+	}
+
+	if(a->render_stats_filename && a->type != CLI_BenchReplay) {
+		log_warn("--render-stats was ignored");
+	}
+
 	a->stageid = stageid;
 
 	if(a->type == CLI_SelectStage && !stageid)
@@ -200,4 +235,6 @@ int cli_args(int argc, char **argv, CLIAction *a) {
 
 void free_cli_action(CLIAction *a) {
 	free(a->filename);
+	free(a->trace_filename);
+	free(a->render_stats_filename);
 }
@@ -15,6 +15,7 @@ typedef enum {
 	CLI_RunNormally = 0,
 	CLI_PlayReplay,
 	CLI_VerifyReplay,
+	CLI_BenchReplay,
 	CLI_SelectStage,
 	CLI_DumpStages,
 	CLI_DumpVFSTree,
@@ -26,9 +27,12 @@ typedef struct CLIAction CLIAction;
 struct CLIAction {
 	CLIActionType type;
 	char *filename;
+	char *trace_filename;
+	char *render_stats_filename;
 	int stageid;
 	int diff;
 	int frameskip;
+	int seek_frame;
 	PlayerMode *plrmode;
 };
 
@@ -18,6 +18,7 @@
 #include "stageobjects.h"
 #include "util/glm.h"
 #include "entity.h"
+#include "enemygrid.h"
 
 #ifdef create_enemy_p
 #undef create_enemy_p
@@ -93,6 +94,7 @@ Enemy *create_enemy_p(EnemyList *enemies, complex pos, float hp, EnemyVisualRule
 
 	fix_pos0_visual(e);
 	ent_register(&e->ent, ENT_ENEMY);
+	enemygrid_invalidate();
 
 	e->logic_rule(e, EVENT_BIRTH);
 	return e;
@@ -113,7 +115,7 @@ void* _delete_enemy(ListAnchor *enemies, List* enemy, void *arg) {
 				.timeout = 10,
 				.rule = linear,
 				.draw_rule = Fade,
-				.args = { (3+afrand(0)*10)*cexp(I*afrand(1)*2*M_PI) },
+				.args = { (3+afrand(0)*10)*sim_cexp(I*afrand(1)*2*M_PI) },
 			);
 		}
 
@@ -123,9 +125,10 @@ void* _delete_enemy(ListAnchor *enemies, List* enemy, void *arg) {
 	}
 
 	e->logic_rule(e, EVENT_DEATH);
-	del_ref(enemy);
+	del_ref(e);
 	ent_unregister(&e->ent);
 	objpool_release(stage_object_pools.enemies, (ObjectInterface*)alist_unlink(enemies, enemy));
+	enemygrid_invalidate();
 
 	return NULL;
 }
@@ -228,7 +231,7 @@ void BigFairy(Enemy *e, int t, bool render) {
 		return;
 	}
 
-	float s = sin((float)(global.frames-e->birthtime)/10.f)/6 + 0.8;
+	float s = sim_sin((float)(global.frames-e->birthtime)/10.f)/6 + 0.8;
 	Color *clr = RGBA_MUL_ALPHA(1, 1, 1, e->alpha);
 
 	r_draw_sprite(&(SpriteParams) {
@@ -255,7 +258,7 @@ void Fairy(Enemy *e, int t, bool render) {
 		return;
 	}
 
-	float s = sin((float)(global.frames-e->birthtime)/10.f)/6 + 0.8;
+	float s = sim_sin((float)(global.frames-e->birthtime)/10.f)/6 + 0.8;
 	Color *clr = RGBA_MUL_ALPHA(1, 1, 1, e->alpha);
 
 	r_draw_sprite(&(SpriteParams) {
@@ -328,9 +331,9 @@ static DamageResult ent_damage_enemy(EntityInterface *ienemy, const DamageInfo *
 	}
 
 	if(enemy->hp < enemy->spawn_hp * 0.1) {
-		play_loop("hit1");
+		play_loop_p(SFX("hit1"));
 	} else {
-		play_loop("hit0");
+		play_loop_p(SFX("hit0"));
 	}
 
 	return DMG_RESULT_OK;
@@ -348,7 +351,7 @@ void process_enemies(EnemyList *enemies) {
 
 		int action = enemy->logic_rule(enemy, global.frames - enemy->birthtime);
 
-		if(enemy->hp > ENEMY_IMMUNE && enemy->alpha >= 1.0 && cabs(enemy->pos - global.plr.pos) < 7) {
+		if(enemy->hp > ENEMY_IMMUNE && enemy->alpha >= 1.0 && sim_cabs(enemy->pos - global.plr.pos) < 7) {
 			ent_damage(&global.plr.ent, &(DamageInfo) { .type = DMG_ENEMY_COLLISION });
 		}
 
@@ -0,0 +1,250 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include "enemygrid.h"
+#include "global.h"
+
+enum {
+	GRID_CELL_SIZE = 32,
+	GRID_COLS = (VIEWPORT_W + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE,
+	GRID_ROWS = (VIEWPORT_H + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE,
+	GRID_CELLS = GRID_COLS * GRID_ROWS,
+	GRID_NO_CELL = UINT16_MAX,
+
+	// Extra margin for query ranges, so that rounding errors near cell boundaries can't hide anything.
+	GRID_QUERY_SLACK = 1,
+};
+
+typedef struct GridEntry {
+	Enemy *enemy;
+	uint order; // position in global.enemies
+} GridEntry;
+
+typedef struct GridRange {
+	int x0, y0;
+	int x1, y1;
+} GridRange;
+
+static struct {
+	GridEntry *entries; // grouped by cell, in list order within each cell
+	uint16_t *entry_cells;
+	uint cell_start[GRID_CELLS + 1];
+	uint num_entries;
+	uint capacity;
+	bool valid;
+
+	// reused by enemygrid_foreach_in_radius, unless a callback starts a nested query
+	GridEntry *scratch;
+	uint scratch_capacity;
+	bool scratch_busy;
+} grid;
+
+void enemygrid_init(void) {
+	memset(&grid, 0, sizeof(grid));
+}
+
+void enemygrid_shutdown(void) {
+	free(grid.entries);
+	free(grid.entry_cells);
+	free(grid.scratch);
+	memset(&grid, 0, sizeof(grid));
+}
+
+void enemygrid_invalidate(void) {
+	grid.valid = false;
+}
+
+static inline int grid_coord(double v, int num_cells) {
+	// Everything outside of the viewport is clamped into the border cells.
+	// The query ranges are clamped the same way, so those enemies are still found.
+
+	if(v < 0) {
+		return 0;
+	}
+
+	if(v >= num_cells * GRID_CELL_SIZE) {
+		return num_cells - 1;
+	}
+
+	return (int)(v / GRID_CELL_SIZE);
+}
+
+static inline uint16_t grid_cell(complex pos) {
+	double x = creal(pos);
+	double y = cimag(pos);
+
+	if(!isfinite(x) || !isfinite(y)) {
+		// Can never be within a finite distance of anything, so don't bother.
+		return GRID_NO_CELL;
+	}
+
+	return grid_coord(y, GRID_ROWS) * GRID_COLS + grid_coord(x, GRID_COLS);
+}
+
+static void enemygrid_build(void) {
+	uint num = 0;
+
+	for(Enemy *e = global.enemies.first; e; e = e->next) {
+		++num;
+	}
+
+	if(num > grid.capacity) {
+		grid.capacity = topow2(num);
+		grid.entries = realloc(grid.entries, grid.capacity * sizeof(*grid.entries));
+		grid.entry_cells = realloc(grid.entry_cells, grid.capacity * sizeof(*grid.entry_cells));
+	}
+
+	memset(grid.cell_start, 0, sizeof(grid.cell_start));
+
+	uint i = 0;
+
+	for(Enemy *e = global.enemies.first; e; e = e->next, ++i) {
+		uint16_t cell = grid.entry_cells[i] = grid_cell(e->pos);
+
+		if(cell != GRID_NO_CELL) {
+			++grid.cell_start[cell + 1];
+		}
+	}
+
+	for(uint c = 0; c < GRID_CELLS; ++c) {
+		grid.cell_start[c + 1] += grid.cell_start[c];
+	}
+
+	uint cursor[GRID_CELLS];
+	memcpy(cursor, grid.cell_start, sizeof(cursor));
+	i = 0;
+
+	for(Enemy *e = global.enemies.first; e; e = e->next, ++i) {
+		uint16_t cell = grid.entry_cells[i];
+
+		if(cell != GRID_NO_CELL) {
+			grid.entries[cursor[cell]++] = (GridEntry) { .enemy = e, .order = i };
+		}
+	}
+
+	grid.num_entries = grid.cell_start[GRID_CELLS];
+	grid.valid = true;
+}
+
+static bool enemygrid_query_range(complex origin, double radius, GridRange *range) {
+	double x = creal(origin);
+	double y = cimag(origin);
+
+	if(!(radius > 0) || !isfinite(x) || !isfinite(y)) {
+		// Nothing can possibly be closer than that.
+		return false;
+	}
+
+	if(!grid.valid) {
+		enemygrid_build();
+	}
+
+	if(!grid.num_entries) {
+		return false;
+	}
+
+	double r = radius + GRID_QUERY_SLACK;
+
+	range->x0 = grid_coord(x - r, GRID_COLS);
+	range->x1 = grid_coord(x + r, GRID_COLS);
+	range->y0 = grid_coord(y - r, GRID_ROWS);
+	range->y1 = grid_coord(y + r, GRID_ROWS);
+
+	return true;
+}
+
+Enemy* enemygrid_find_first(complex origin, double radius, EnemyGridFilter filter, void *arg) {
+	GridRange range;
+
+	if(!enemygrid_query_range(origin, radius, &range)) {
+		return NULL;
+	}
+
+	GridEntry *best = NULL;
+
+	for(int y = range.y0; y <= range.y1; ++y) {
+		for(int x = range.x0; x <= range.x1; ++x) {
+			uint cell = y * GRID_COLS + x;
+			GridEntry *end = grid.entries + grid.cell_start[cell + 1];
+
+			for(GridEntry *ent = grid.entries + grid.cell_start[cell]; ent < end; ++ent) {
+				if(best && ent->order > best->order) {
+					// Entries within a cell are in list order, so nothing here can beat what we already have.
+					break;
+				}
+
+				if(sim_cabs(ent->enemy->pos - origin) < radius && (!filter || filter(ent->enemy, arg))) {
+					best = ent;
+					break;
+				}
+			}
+		}
+	}
+
+	return best ? best->enemy : NULL;
+}
+
+static int grid_entry_order_cmp(const void *p1, const void *p2) {
+	const GridEntry *e1 = p1;
+	const GridEntry *e2 = p2;
+	return (e1->order > e2->order) - (e1->order < e2->order);
+}
+
+void enemygrid_foreach_in_radius(complex origin, double radius, EnemyGridCallback callback, void *arg) {
+	GridRange range;
+
+	if(!enemygrid_query_range(origin, radius, &range)) {
+		return;
+	}
+
+	// The callback may invalidate the grid (or even start another query), so collect everything first.
+	GridEntry *matches;
+	bool nested = grid.scratch_busy;
+	uint num_matches = 0;
+
+	if(nested) {
+		matches = calloc(grid.num_entries, sizeof(*matches));
+	} else {
+		if(grid.num_entries > grid.scratch_capacity) {
+			grid.scratch_capacity = topow2(grid.num_entries);
+			grid.scratch = realloc(grid.scratch, grid.scratch_capacity * sizeof(*grid.scratch));
+		}
+
+		matches = grid.scratch;
+		grid.scratch_busy = true;
+	}
+
+	for(int y = range.y0; y <= range.y1; ++y) {
+		for(int x = range.x0; x <= range.x1; ++x) {
+			uint cell = y * GRID_COLS + x;
+			GridEntry *end = grid.entries + grid.cell_start[cell + 1];
+
+			for(GridEntry *ent = grid.entries + grid.cell_start[cell]; ent < end; ++ent) {
+				if(sim_cabs(ent->enemy->pos - origin) < radius) {
+					matches[num_matches++] = *ent;
+				}
+			}
+		}
+	}
+
+	if(num_matches > 1) {
+		qsort(matches, num_matches, sizeof(*matches), grid_entry_order_cmp);
+	}
+
+	for(uint i = 0; i < num_matches; ++i) {
+		callback(matches[i].enemy, arg);
+	}
+
+	if(nested) {
+		free(matches);
+	} else {
+		grid.scratch_busy = false;
+	}
+}
@@ -0,0 +1,35 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include "enemy.h"
+
+// A uniform grid over the viewport that speeds up "which enemies are near this point" queries.
+//
+// The grid is rebuilt lazily from global.enemies on the first query after it has been invalidated.
+// Enemy creation and deletion invalidate it automatically; code that moves enemies around in bulk
+// (i.e. the stage logic) must call enemygrid_invalidate() afterwards.
+//
+// Queries are only a broad phase: every candidate is still tested against its current position
+// and hp, and results are reported in global.enemies order, so they are exactly equivalent to
+// a linear scan of the list.
+
+typedef bool (*EnemyGridFilter)(Enemy *e, void *arg);
+typedef void (*EnemyGridCallback)(Enemy *e, void *arg);
+
+void enemygrid_init(void);
+void enemygrid_shutdown(void);
+void enemygrid_invalidate(void);
+
+// Returns the first enemy in global.enemies with cabs(e->pos - origin) < radius that passes the filter (if any).
+Enemy* enemygrid_find_first(complex origin, double radius, EnemyGridFilter filter, void *arg);
+
+// Calls the callback for every enemy with cabs(e->pos - origin) < radius, in global.enemies order.
+void enemygrid_foreach_in_radius(complex origin, double radius, EnemyGridCallback callback, void *arg) attr_nonnull(3);
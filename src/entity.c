@@ -12,38 +12,77 @@
 #include "util.h"
 #include "renderer/api.h"
 #include "global.h"
+#include "enemygrid.h"
 
 static struct {
 	EntityInterface **array;
+	EntityInterface **scratch;
 	uint num;
+	uint num_sorted;
+	uint num_holes;
 	uint capacity;
 	uint32_t total_spawns;
 } entities;
 
+// NOTE: entities.array may contain NULL holes left by ent_unregister(); they are squeezed out lazily.
+// Everything in array[0 .. num_sorted) was in draw order as of the last ent_draw() (minus the holes),
+// unless somebody has changed its draw_layer since then. Everything after that has been registered
+// since, in spawn order.
+
 #define FOR_EACH_ENT(ent) for(EntityInterface **_ent = entities.array, *ent = *entities.array; _ent < entities.array + entities.num; ent = *(++_ent))
 
+static void ent_alloc_arrays(void) {
+	entities.array = realloc(entities.array, entities.capacity * sizeof(EntityInterface*));
+	entities.scratch = realloc(entities.scratch, entities.capacity * sizeof(EntityInterface*));
+}
+
 void ent_init(void) {
 	memset(&entities, 0, sizeof(entities));
 	entities.capacity = 4096;
 	entities.array = calloc(entities.capacity, sizeof(EntityInterface*));
+	entities.scratch = calloc(entities.capacity, sizeof(EntityInterface*));
 }
 
 void ent_shutdown(void) {
-	if(entities.num) {
-		log_warn("%u entities were not properly unregistered", entities.num);
+	if(entities.num - entities.num_holes) {
+		log_warn("%u entities were not properly unregistered", entities.num - entities.num_holes);
 	}
 
 	FOR_EACH_ENT(ent) {
-		ent_unregister(ent);
+		if(ent) {
+			ent_unregister(ent);
+		}
 	}
 
 	free(entities.array);
+	free(entities.scratch);
+}
+
+static void ent_compact(void) {
+	uint num = 0;
+	uint num_sorted = 0;
+
+	for(uint i = 0; i < entities.num; ++i) {
+		EntityInterface *ent = entities.array[i];
+
+		if(ent) {
+			ent->index = num;
+			entities.array[num++] = ent;
+
+			if(i < entities.num_sorted) {
+				++num_sorted;
+			}
+		}
+	}
+
+	entities.num = num;
+	entities.num_sorted = num_sorted;
+	entities.num_holes = 0;
 }
 
 void ent_register(EntityInterface *ent, EntityType type) {
 	assert(type > _ENT_TYPE_ENUM_BEGIN && type < _ENT_TYPE_ENUM_END);
 	ent->type = type;
-	ent->index = entities.num++;
 	ent->spawn_id = ++entities.total_spawns;
 
 	if(ent->spawn_id == 0) {
@@ -53,11 +92,16 @@ void ent_register(EntityInterface *ent, EntityType type) {
 		log_debug("spawn_id just overflowed. You might be spawning stuff waaaay too often");
 	}
 
-	if(entities.capacity < entities.num) {
-		entities.capacity *= 2;
-		entities.array = realloc(entities.array, entities.capacity * sizeof(EntityInterface*));
+	if(entities.num == entities.capacity) {
+		if(entities.num_holes) {
+			ent_compact();
+		} else {
+			entities.capacity *= 2;
+			ent_alloc_arrays();
+		}
 	}
 
+	ent->index = entities.num++;
 	entities.array[ent->index] = ent;
 
 	assert(ent->index < entities.num);
@@ -65,10 +109,15 @@ void ent_register(EntityInterface *ent, EntityType type) {
 }
 
 void ent_unregister(EntityInterface *ent) {
-	EntityInterface *sub = entities.array[--entities.num];
-	assert(ent->index <= entities.num);
+	assert(ent->index < entities.num);
 	assert(entities.array[ent->index] == ent);
-	entities.array[sub->index = ent->index] = sub;
+	entities.array[ent->index] = NULL;
+	++entities.num_holes;
+}
+
+static inline uint64_t ent_sort_key(const EntityInterface *ent) {
+	// Same order as ent_cmp()
+	return ((uint64_t)ent->draw_layer << 32) | ent->spawn_id;
 }
 
 static int ent_cmp(const void *ptr1, const void *ptr2) {
@@ -85,32 +134,91 @@ static int ent_cmp(const void *ptr1, const void *ptr2) {
 	return r;
 }
 
-void ent_draw(EntityPredicate predicate) {
-	qsort(entities.array, entities.num, sizeof(EntityInterface*), ent_cmp);
+static void ent_sort(void) {
+	// Most entities keep their place in the draw order from frame to frame, so instead of sorting
+	// everything again, pick out the ones that aren't in order anymore (new spawns and the rare ones
+	// that changed their draw_layer), sort just those, and merge them back in.
+
+	EntityInterface **sorted = entities.array;
+	EntityInterface **unsorted = entities.scratch;
+	uint num_sorted = 0;
+	uint num_unsorted = 0;
+	uint64_t last_key = 0;
+
+	for(uint i = 0; i < entities.num_sorted; ++i) {
+		EntityInterface *ent = entities.array[i];
+
+		if(!ent) {
+			continue;
+		}
+
+		uint64_t key = ent_sort_key(ent);
 
-	if(predicate) {
-		FOR_EACH_ENT(ent) {
-			ent->index = _ent - entities.array;
-			assert(entities.array[ent->index] == ent);
+		if(num_sorted && key < last_key) {
+			unsorted[num_unsorted++] = ent;
+		} else {
+			sorted[num_sorted++] = ent;
+			last_key = key;
+		}
+	}
+
+	for(uint i = entities.num_sorted; i < entities.num; ++i) {
+		EntityInterface *ent = entities.array[i];
+
+		if(ent) {
+			unsorted[num_unsorted++] = ent;
+		}
+	}
+
+	uint num = num_sorted + num_unsorted;
 
-			if(ent->draw_func && predicate(ent)) {
-				r_state_push();
-				ent->draw_func(ent);
-				r_state_pop();
+	if(num_unsorted) {
+		qsort(unsorted, num_unsorted, sizeof(EntityInterface*), ent_cmp);
+
+		// Merge from the back, so that it can be done in place.
+		int i = num_sorted - 1;
+		int j = num_unsorted - 1;
+
+		for(int k = num - 1; j >= 0; --k) {
+			if(i >= 0 && ent_sort_key(sorted[i]) > ent_sort_key(unsorted[j])) {
+				sorted[k] = sorted[i--];
+			} else {
+				sorted[k] = unsorted[j--];
 			}
 		}
-	} else {
-		FOR_EACH_ENT(ent) {
-			ent->index = _ent - entities.array;
-			assert(entities.array[ent->index] == ent);
-
-			if(ent->draw_func) {
-				r_state_push();
-				ent->draw_func(ent);
-				r_state_pop();
+	}
+
+	entities.num = entities.num_sorted = num;
+	entities.num_holes = 0;
+}
+
+void ent_draw(EntityPredicate predicate) {
+	ent_sort();
+
+	// Sprites are only reordered within a layer; see r_sprites_defer_begin.
+	uint layer = LAYER_ID_NONE;
+	r_sprites_defer_begin();
+
+	FOR_EACH_ENT(ent) {
+		ent->index = _ent - entities.array;
+		assert(entities.array[ent->index] == ent);
+
+		if(ent->draw_func && (!predicate || predicate(ent))) {
+			uint ent_layer = ent->draw_layer >> LAYER_LOW_BITS;
+
+			if(ent_layer != layer) {
+				r_sprites_defer_end();
+				r_sprites_defer_begin();
+				layer = ent_layer;
 			}
+
+			r_state_push();
+			ent->draw_func(ent);
+			r_state_pop();
 		}
 	}
+
+	r_sprites_defer_end();
 }
 
 DamageResult ent_damage(EntityInterface *ent, const DamageInfo *damage) {
@@ -127,14 +235,14 @@ DamageResult ent_damage(EntityInterface *ent, const DamageInfo *damage) {
 	return res;
 }
 
+static void ent_area_damage_enemy(Enemy *e, void *damage) {
+	ent_damage(&e->ent, damage);
+}
+
 void ent_area_damage(complex origin, float radius, const DamageInfo *damage) {
-	for(Enemy *e = global.enemies.first; e; e = e->next) {
-		if(cabs(origin - e->pos) < radius) {
-			ent_damage(&e->ent, damage);
-		}
-	}
+	enemygrid_foreach_in_radius(origin, radius, ent_area_damage_enemy, (void*)damage);
 
-	if(global.boss && cabs(origin - global.boss->pos) < radius) {
+	if(global.boss && sim_cabs(origin - global.boss->pos) < radius) {
 		ent_damage(&global.boss->ent, damage);
 	}
 }
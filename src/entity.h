@@ -80,6 +80,7 @@ typedef DamageResult (*EntityDamageFunc)(EntityInterface *target, const DamageIn
 	drawlayer_t draw_layer; \
 	uint32_t spawn_id; \
 	uint index; \
+	uint32_t ref_slot; \
 }
 
 #define ENTITY_INTERFACE(typename) union { \
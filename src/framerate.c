@@ -70,10 +70,14 @@ void loop_at_fps(LogicFrameFunc logic_frame, RenderFrameFunc render_frame, void
 	bool compensate = env_get("TAISEI_FRAMELIMITER_COMPENSATE", 1);
 	bool uncapped_rendering_env = env_get("TAISEI_FRAMELIMITER_LOGIC_ONLY", 0);
 	bool late_swap = config_get_int(CONFIG_VID_LATE_SWAP);
+	bool skip_rendering = false;
 
 	if(global.is_replay_verification) {
 		uncapped_rendering_env = false;
 		delay = 0;
+
+		// unless the rendering is what's being measured
+		skip_rendering = !*env_get("TAISEI_RENDER_STATS", "");
 	}
 
 	uint32_t frame_num = 0;
@@ -162,7 +166,7 @@ begin_frame:
 			break;
 		}
 
-		if((!uncapped_rendering && frame_num % get_effective_frameskip()) || global.is_replay_verification) {
+		if((!uncapped_rendering && frame_num % get_effective_frameskip()) || skip_rendering) {
 			rframe_action = RFRAME_DROP;
 		} else {
 			r_framebuffer_clear(NULL, CLEAR_ALL, RGBA(0, 0, 0, 1), 1);
@@ -99,8 +99,6 @@ typedef struct {
 	Boss *boss;
 	Dialog *dialog;
 
-	RefArray refs;
-
 	int game_over;
 
 	struct {
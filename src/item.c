@@ -25,9 +25,16 @@ static Sprite* item_sprite(ItemType type) {
 		[BPoint]    = "item/bullet_point",
 	};
 
+	static ResourceID ids[sizeof(map)/sizeof(char*)];
+
 	// int cast to silence a WTF warning
 	assert((int)type < sizeof(map)/sizeof(char*));
-	return get_sprite(map[type]);
+
+	if(!ids[type]) {
+		ids[type] = res_id(RES_SPRITE, map[type]);
+	}
+
+	return get_resource_data_by_id(ids[type], RESF_DEFAULT | RESF_UNSAFE);
 }
 
 static void ent_draw_item(EntityInterface *ent) {
@@ -107,10 +114,10 @@ complex move_item(Item *i) {
 	complex oldpos = i->pos;
 
 	if(i->auto_collect) {
-		i->pos -= (7+i->auto_collect)*cexp(I*carg(i->pos - global.plr.pos));
+		i->pos -= (7+i->auto_collect)*sim_cexp(I*sim_carg(i->pos - global.plr.pos));
 	} else {
 		complex oldpos = i->pos;
-		i->pos = i->pos0 + log(t/5.0 + 1)*5*(i->v + lim) + lim*t;
+		i->pos = i->pos0 + sim_log(t/5.0 + 1)*5*(i->v + lim) + lim*t;
 
 		complex v = i->pos - oldpos;
 		double half = item_sprite(i->type)->w/2.0;
@@ -157,7 +164,7 @@ void process_items(void) {
 
 		if(plr_alive) {
 			if(
-				(cabs(global.plr.pos - item->pos) < r) ||
+				(sim_cabs(global.plr.pos - item->pos) < r) ||
 				(cimag(global.plr.pos) < player_property(&global.plr, PLR_PROP_POC)) ||
 				plr_bombing
 			) {
@@ -177,15 +184,15 @@ void process_items(void) {
 			switch(item->type) {
 			case Power:
 				player_set_power(&global.plr, global.plr.power + POWER_VALUE);
-				play_sound("item_generic");
+				play_sound_p(SFX("item_generic"));
 				break;
 			case Point:
 				player_add_points(&global.plr, 100);
-				play_sound("item_generic");
+				play_sound_p(SFX("item_generic"));
 				break;
 			case BPoint:
 				player_add_points(&global.plr, 1);
-				play_sound("item_generic");
+				play_sound_p(SFX("item_generic"));
 				break;
 			case Life:
 				player_add_lives(&global.plr, 1);
@@ -213,7 +220,7 @@ void process_items(void) {
 }
 
 int collision_item(Item *i) {
-	if(cabs(global.plr.pos - i->pos) < 10)
+	if(sim_cabs(global.plr.pos - i->pos) < 10)
 		return 1;
 
 	return 0;
@@ -221,7 +228,7 @@ int collision_item(Item *i) {
 
 void spawn_item(complex pos, ItemType type) {
 	tsrand_fill(2);
-	create_item(pos, (12 + 6 * afrand(0)) * (cexp(I*(3*M_PI/2 + anfrand(1)*M_PI/11))) - 3*I, type);
+	create_item(pos, (12 + 6 * afrand(0)) * (sim_cexp(I*(3*M_PI/2 + anfrand(1)*M_PI/11))) - 3*I, type);
 }
 
 void spawn_items(complex pos, ...) {
@@ -14,11 +14,32 @@
 #include "stageobjects.h"
 #include "renderer/api.h"
 
+enum {
+	LASER_U_TEX,
+	LASER_U_ORIGIN,
+	LASER_U_ARGS,
+	LASER_U_TIMESHIFT,
+	LASER_U_WIDTH,
+	LASER_U_WIDTH_EXPONENT,
+	LASER_U_SPAN,
+};
+
 static struct {
 	VertexArray *varr;
 	VertexBuffer *vbuf;
 	ShaderProgram *shader_generic;
-} lasers;
+	UniformLayout uniforms;
+} lasers = {
+	.uniforms.names = {
+		[LASER_U_TEX]            = "tex",
+		[LASER_U_ORIGIN]         = "origin",
+		[LASER_U_ARGS]           = "args[0]",
+		[LASER_U_TIMESHIFT]      = "timeshift",
+		[LASER_U_WIDTH]          = "width",
+		[LASER_U_WIDTH_EXPONENT] = "width_exponent",
+		[LASER_U_SPAN]           = "span",
+	},
+};
 
 typedef struct LaserInstancedAttribs {
 	float pos[2];
@@ -107,7 +128,7 @@ Laser *create_laser(complex pos, float time, float deathtime, const Color *color
 }
 
 Laser *create_laserline(complex pos, complex dir, float charge, float dur, const Color *clr) {
-	return create_laserline_ab(pos, (pos)+(dir)*VIEWPORT_H*1.4/cabs(dir), cabs(dir), charge, dur, clr);
+	return create_laserline_ab(pos, (pos)+(dir)*VIEWPORT_H*1.4/sim_cabs(dir), sim_cabs(dir), charge, dur, clr);
 }
 
 Laser *create_laserline_ab(complex a, complex b, float width, float charge, float dur, const Color *clr) {
@@ -142,6 +163,221 @@ static bool draw_laser_instanced_prepare(Laser *l, uint *out_instances, float *o
 	return true;
 }
 
+/*
+ * Sampling the LaserPosRule is the expensive part of colliding, clearing and drawing curved
+ * lasers. The samples are cached per laser, and stay valid for as long as the frame and all
+ * the laser fields a position rule may depend on stay the same, so reusing them gives
+ * exactly the same results as sampling anew.
+ */
+
+typedef struct LaserSampleKey {
+	complex pos;
+	complex args[4];
+	int frame;
+	float timespan;
+	float deathtime;
+	float timeshift;
+	float speed;
+	float collision_step;
+	float width_exponent;
+} LaserSampleKey;
+
+typedef struct LaserPolyline {
+	LaserSampleKey key;
+	complex *points;
+	float *widthfacs; // widthfacs[i] is for the segment ending at points[i]
+	uint num_points;
+	uint capacity;
+	complex tail;
+	Rect bbox;
+	float max_widthfac;
+	bool valid;
+} LaserPolyline;
+
+typedef struct LaserInstances {
+	LaserSampleKey key;
+	LaserInstancedAttribs *attrs;
+	uint num_instances;
+	uint capacity;
+	float timeshift;
+	bool valid;
+} LaserInstances;
+
+struct LaserCache {
+	LaserPolyline polyline;
+	LaserInstances instances;
+};
+
+static void laser_sample_key(Laser *l, LaserSampleKey *key) {
+	// zero the padding too, so that keys can be compared with memcmp
+	memset(key, 0, sizeof(*key));
+	key->pos = l->pos;
+	memcpy(key->args, l->args, sizeof(key->args));
+	key->frame = global.frames;
+	key->timespan = l->timespan;
+	key->deathtime = l->deathtime;
+	key->timeshift = l->timeshift;
+	key->speed = l->speed;
+	key->collision_step = l->collision_step;
+	key->width_exponent = l->width_exponent;
+}
+
+static bool laser_sample_key_matches(Laser *l, const LaserSampleKey *cached) {
+	LaserSampleKey key;
+	laser_sample_key(l, &key);
+	return !memcmp(&key, cached, sizeof(key));
+}
+
+static struct LaserCache *laser_cache(Laser *l) {
+	if(!l->cache) {
+		l->cache = calloc(1, sizeof(*l->cache));
+	}
+
+	return l->cache;
+}
+
+static void laser_cache_free(Laser *l) {
+	if(l->cache) {
+		free(l->cache->polyline.points);
+		free(l->cache->polyline.widthfacs);
+		free(l->cache->instances.attrs);
+		free(l->cache);
+		l->cache = NULL;
+	}
+}
+
+static void polyline_add_point(LaserPolyline *pl, complex p, float widthfac) {
+	if(pl->num_points == pl->capacity) {
+		pl->capacity = pl->capacity ? pl->capacity * 2 : 32;
+		pl->points = realloc(pl->points, sizeof(*pl->points) * pl->capacity);
+		pl->widthfacs = realloc(pl->widthfacs, sizeof(*pl->widthfacs) * pl->capacity);
+	}
+
+	pl->points[pl->num_points] = p;
+	pl->widthfacs[pl->num_points] = widthfac;
+	pl->num_points++;
+
+	if(widthfac > pl->max_widthfac) {
+		pl->max_widthfac = widthfac;
+	}
+}
+
+static void polyline_expand_bbox(LaserPolyline *pl, complex p) {
+	double x = creal(p), y = cimag(p);
+
+	// NaN points never intersect anything, so it's fine that they are left out
+	if(x < rect_left(pl->bbox)) {
+		pl->bbox.top_left = CMPLX(x, cimag(pl->bbox.top_left));
+	}
+
+	if(x > rect_right(pl->bbox)) {
+		pl->bbox.bottom_right = CMPLX(x, cimag(pl->bbox.bottom_right));
+	}
+
+	if(y < rect_top(pl->bbox)) {
+		pl->bbox.top_left = CMPLX(creal(pl->bbox.top_left), y);
+	}
+
+	if(y > rect_bottom(pl->bbox)) {
+		pl->bbox.bottom_right = CMPLX(creal(pl->bbox.bottom_right), y);
+	}
+}
+
+static LaserPolyline *laser_get_polyline(Laser *l) {
+	LaserPolyline *pl = &laser_cache(l)->polyline;
+
+	if(pl->valid && laser_sample_key_matches(l, &pl->key)) {
+		return pl;
+	}
+
+	// This must sample exactly like the collision code always did, or replays will desync.
+	float t_end = (global.frames - l->birthtime) * l->speed + l->timeshift; // end of the laser based on length
+	float t_death = l->deathtime * l->speed + l->timeshift; // end of the laser based on lifetime
+	float t = t_end - l->timespan;
+
+	if(t < 0) {
+		t = 0;
+	}
+
+	pl->num_points = 0;
+	pl->max_widthfac = 0;
+	polyline_add_point(pl, l->prule(l, t), 0);
+
+	for(t += l->collision_step; t <= min(t_end, t_death); t += l->collision_step) {
+		float t1 = t - l->timespan / 2; // i have no idea
+		float tail = l->timespan / 1.9;
+		float widthfac = -0.75 / sim_pow(tail, 2) * (t1 - tail) * (t1 + tail);
+		widthfac = max(0.25, sim_pow(widthfac, l->width_exponent));
+
+		polyline_add_point(pl, l->prule(l, t), widthfac);
+	}
+
+	pl->tail = l->prule(l, min(t_end, t_death));
+	pl->bbox.top_left = CMPLX(INFINITY, INFINITY);
+	pl->bbox.bottom_right = CMPLX(-INFINITY, -INFINITY);
+
+	for(uint i = 0; i < pl->num_points; ++i) {
+		polyline_expand_bbox(pl, pl->points[i]);
+	}
+
+	polyline_expand_bbox(pl, pl->tail);
+
+	// some position rules normalize the laser's args, so take the key after sampling
+	laser_sample_key(l, &pl->key);
+	pl->valid = true;
+
+	return pl;
+}
+
+// Conservative test: false only if no part of the polyline can be within radius of p.
+static bool polyline_near_point(LaserPolyline *pl, complex p, double radius) {
+	double x = creal(p), y = cimag(p);
+	double dx = max(0, max(rect_left(pl->bbox) - x, x - rect_right(pl->bbox)));
+	double dy = max(0, max(rect_top(pl->bbox) - y, y - rect_bottom(pl->bbox)));
+
+	// slack for rounding errors in lineseg_circle_intersect
+	radius += 1;
+
+	return dx * dx + dy * dy <= radius * radius;
+}
+
+static LaserInstancedAttribs *laser_get_instances(Laser *l, uint *out_instances, float *out_timeshift) {
+	float timeshift;
+	uint instances;
+
+	if(!draw_laser_instanced_prepare(l, &instances, &timeshift)) {
+		return NULL;
+	}
+
+	LaserInstances *li = &laser_cache(l)->instances;
+
+	if(!li->valid || !laser_sample_key_matches(l, &li->key)) {
+		if(instances > li->capacity) {
+			li->capacity = topow2_u32(instances);
+			li->attrs = realloc(li->attrs, sizeof(*li->attrs) * li->capacity);
+		}
+
+		for(uint i = 0; i < instances; ++i) {
+			complex pos = l->prule(l, i * 0.5 + timeshift);
+			complex delta = pos - l->prule(l, i * 0.5 + timeshift - 0.1);
+
+			li->attrs[i].pos[0] = creal(pos);
+			li->attrs[i].pos[1] = cimag(pos);
+			li->attrs[i].delta[0] = creal(delta);
+			li->attrs[i].delta[1] = cimag(delta);
+		}
+
+		li->num_instances = instances;
+		li->timeshift = timeshift;
+		laser_sample_key(l, &li->key);
+		li->valid = true;
+	}
+
+	*out_instances = li->num_instances;
+	*out_timeshift = li->timeshift;
+	return li->attrs;
+}
+
 static void draw_laser_curve_specialized(Laser *l) {
 	float timeshift;
 	uint instances;
@@ -150,46 +386,37 @@ static void draw_laser_curve_specialized(Laser *l) {
 		return;
 	}
 
+	Uniform **u = r_uniform_layout(&lasers.uniforms, l->shader);
 	r_color(&l->color);
-	r_uniform_sampler("tex", "part/lasercurve");
-	r_uniform_vec2_complex("origin", l->pos);
-	r_uniform_vec2_array_complex("args[0]", 0, 4, l->args);
-	r_uniform_float("timeshift", timeshift);
-	r_uniform_float("width", l->width);
-	r_uniform_float("width_exponent", l->width_exponent);
-	r_uniform_int("span", instances);
+	r_uniform_sampler(u[LASER_U_TEX], "part/lasercurve");
+	r_uniform_vec2_complex(u[LASER_U_ORIGIN], l->pos);
+	r_uniform_vec2_array_complex(u[LASER_U_ARGS], 0, 4, l->args);
+	r_uniform_float(u[LASER_U_TIMESHIFT], timeshift);
+	r_uniform_float(u[LASER_U_WIDTH], l->width);
+	r_uniform_float(u[LASER_U_WIDTH_EXPONENT], l->width_exponent);
+	r_uniform_int(u[LASER_U_SPAN], instances);
 	r_draw(PRIM_TRIANGLE_FAN, 0, 4, NULL, instances, 0);
 }
 
 static void draw_laser_curve_generic(Laser *l) {
 	float timeshift;
 	uint instances;
+	LaserInstancedAttribs *attrs = laser_get_instances(l, &instances, &timeshift);
 
-	if(!draw_laser_instanced_prepare(l, &instances, &timeshift)) {
+	if(!attrs) {
 		return;
 	}
 
+	Uniform **u = r_uniform_layout(&lasers.uniforms, lasers.shader_generic);
 	r_color(&l->color);
-	r_uniform_sampler("tex", "part/lasercurve");
-	r_uniform_float("timeshift", timeshift);
-	r_uniform_float("width", l->width);
-	r_uniform_float("width_exponent", l->width_exponent);
-	r_uniform_int("span", instances);
+	r_uniform_sampler(u[LASER_U_TEX], "part/lasercurve");
+	r_uniform_float(u[LASER_U_TIMESHIFT], timeshift);
+	r_uniform_float(u[LASER_U_WIDTH], l->width);
+	r_uniform_float(u[LASER_U_WIDTH_EXPONENT], l->width_exponent);
+	r_uniform_int(u[LASER_U_SPAN], instances);
 
-	LaserInstancedAttribs attrs[instances], *aptr = attrs;
 	r_vertex_buffer_invalidate(lasers.vbuf);
-
-	for(uint i = 0; i < instances; ++i, ++aptr) {
-		complex pos = l->prule(l, i * 0.5 + timeshift);
-		complex delta = pos - l->prule(l, i * 0.5 + timeshift - 0.1);
-
-		aptr->pos[0] = creal(pos);
-		aptr->pos[1] = cimag(pos);
-		aptr->delta[0] = creal(delta);
-		aptr->delta[1] = cimag(delta);
-	}
-
-	r_vertex_buffer_append(lasers.vbuf, sizeof(attrs), &attrs);
+	r_vertex_buffer_append(lasers.vbuf, sizeof(*attrs) * instances, attrs);
 	r_draw(PRIM_TRIANGLE_FAN, 0, 4, NULL, instances, 0);
 }
 
@@ -223,8 +450,9 @@ void* _delete_laser(ListAnchor *lasers, List *laser, void *arg) {
 	if(l->lrule)
 		l->lrule(l, EVENT_DEATH);
 
-	del_ref(laser);
+	del_ref(l);
 	ent_unregister(&l->ent);
+	laser_cache_free(l);
 	objpool_release(stage_object_pools.lasers, (ObjectInterface*)alist_unlink(lasers, laser));
 	return NULL;
 }
@@ -302,32 +530,31 @@ static bool collision_laser_curve(Laser *l) {
 		return false;
 	}
 
-	float t_end = (global.frames - l->birthtime) * l->speed + l->timeshift; // end of the laser based on length
-	float t_death = l->deathtime * l->speed + l->timeshift; // end of the laser based on lifetime
-	float t = t_end - l->timespan;
-	bool grazed = false;
+	LaserPolyline *pl = laser_get_polyline(l);
+	bool check_graze = !(global.frames % 7) && global.frames - abs(global.plr.recovery) > 0;
+	double max_radius = max(pl->max_widthfac * l->width * 0.5 + 1, l->width * 0.5);
 
-	if(t < 0) {
-		t = 0;
+	if(check_graze) {
+		max_radius = max(max_radius, l->width * 2 + 8);
 	}
 
-	LineSegment segment = { .a = l->prule(l,t) };
-	Circle collision_area = { .origin = global.plr.pos };
+	if(!polyline_near_point(pl, global.plr.pos, max_radius)) {
+		return false;
+	}
 
-	for(t += l->collision_step; t <= min(t_end,t_death); t += l->collision_step) {
-		float t1 = t - l->timespan / 2; // i have no idea
-		float tail = l->timespan / 1.9;
-		float widthfac = -0.75 / pow(tail, 2) * (t1 - tail) * (t1 + tail);
-		widthfac = max(0.25, pow(widthfac, l->width_exponent));
+	LineSegment segment = { .a = pl->points[0] };
+	Circle collision_area = { .origin = global.plr.pos };
+	bool grazed = false;
 
-		segment.b = l->prule(l, t);
-		collision_area.radius = widthfac * l->width * 0.5 + 1;
+	for(uint i = 1; i < pl->num_points; ++i) {
+		segment.b = pl->points[i];
+		collision_area.radius = pl->widthfacs[i] * l->width * 0.5 + 1;
 
 		if(lineseg_circle_intersect(segment, collision_area) >= 0) {
 			return true;
 		}
 
-		if(!grazed && !(global.frames % 7) && global.frames - abs(global.plr.recovery) > 0) {
+		if(!grazed && check_graze) {
 			collision_area.radius = l->width * 2+8;
 			float f = lineseg_circle_intersect(segment, collision_area);
 
@@ -340,34 +567,26 @@ static bool collision_laser_curve(Laser *l) {
 		segment.a = segment.b;
 	}
 
-	segment.b = l->prule(l, min(t_end, t_death));
+	segment.b = pl->tail;
 	collision_area.radius = l->width * 0.5; // WTF: what is this sorcery?
 
 	return lineseg_circle_intersect(segment, collision_area) >= 0;
 }
 
 bool laser_intersects_circle(Laser *l, Circle circle) {
-	// TODO: lots of copypasta from the function above here, maybe refactor both somehow.
-
-	float t_end = (global.frames - l->birthtime) * l->speed + l->timeshift; // end of the laser based on length
-	float t_death = l->deathtime * l->speed + l->timeshift; // end of the laser based on lifetime
-	float t = t_end - l->timespan;
+	LaserPolyline *pl = laser_get_polyline(l);
+	double orig_radius = circle.radius;
+	double max_radius = orig_radius + max(pl->max_widthfac * l->width * 0.5 + 1, l->width * 0.5);
 
-	if(t < 0) {
-		t = 0;
+	if(!polyline_near_point(pl, circle.origin, max_radius)) {
+		return false;
 	}
 
-	LineSegment segment = { .a = l->prule(l, t) };
-	double orig_radius = circle.radius;
-
-	for(t += l->collision_step; t <= min(t_end, t_death); t += l->collision_step) {
-		float t1 = t - l->timespan / 2; // i have no idea
-		float tail = l->timespan / 1.9;
-		float widthfac = -0.75 / pow(tail, 2) * (t1 - tail) * (t1 + tail);
-		widthfac = max(0.25, pow(widthfac, l->width_exponent));
+	LineSegment segment = { .a = pl->points[0] };
 
-		segment.b = l->prule(l, t);
-		circle.radius = orig_radius + widthfac * l->width * 0.5 + 1;
+	for(uint i = 1; i < pl->num_points; ++i) {
+		segment.b = pl->points[i];
+		circle.radius = orig_radius + pl->widthfacs[i] * l->width * 0.5 + 1;
 
 		if(lineseg_circle_intersect(segment, circle) >= 0) {
 			return true;
@@ -376,7 +595,7 @@ bool laser_intersects_circle(Laser *l, Circle circle) {
 		segment.a = segment.b;
 	}
 
-	segment.b = l->prule(l, min(t_end, t_death));
+	segment.b = pl->tail;
 	circle.radius = orig_radius + l->width * 0.5; // WTF: what is this sorcery?
 
 	return lineseg_circle_intersect(segment, circle) >= 0;
@@ -411,7 +630,7 @@ complex las_weird_sine(Laser *l, float t) {             // [0] = velocity; [1] =
 	}
 
 	double s = (l->args[2] * t + l->args[3]);
-	return l->pos + cexp(I * (carg(l->args[0]) + l->args[1] * sin(s) / s)) * t * cabs(l->args[0]);
+	return l->pos + sim_cexp(I * (sim_carg(l->args[0]) + l->args[1] * sim_sin(s) / s)) * t * sim_cabs(l->args[0]);
 }
 
 complex las_sine(Laser *l, float t) {               // [0] = velocity; [1] = sine amplitude; [2] = sine frequency; [3] = sine phase
@@ -423,13 +642,13 @@ complex las_sine(Laser *l, float t) {               // [0] = velocity; [1] = sin
 	}
 
 	complex line_vel = l->args[0];
-	complex line_dir = line_vel / cabs(line_vel);
+	complex line_dir = line_vel / sim_cabs(line_vel);
 	complex line_normal = cimag(line_dir) - I*creal(line_dir);
 	complex sine_amp = l->args[1];
 	complex sine_freq = l->args[2];
 	complex sine_phase = l->args[3];
 
-	complex sine_ofs = line_normal * sine_amp * sin(sine_freq * t + sine_phase);
+	complex sine_ofs = line_normal * sine_amp * sim_sin(sine_freq * t + sine_phase);
 	return l->pos + t * line_vel + sine_ofs;
 }
 
@@ -446,11 +665,11 @@ complex las_sine_expanding(Laser *l, float t) { // [0] = velocity; [1] = sine am
 	double frequency = creal(l->args[2]);
 	double phase = creal(l->args[3]);
 
-	double angle = carg(velocity);
-	double speed = cabs(velocity);
+	double angle = sim_carg(velocity);
+	double speed = sim_cabs(velocity);
 
 	double s = (frequency * t + phase);
-	return l->pos + cexp(I * (angle + amplitude * sin(s))) * t * speed;
+	return l->pos + sim_cexp(I * (angle + amplitude * sim_sin(s))) * t * speed;
 }
 
 complex las_turning(Laser *l, float t) { // [0] = vel0; [1] = vel1; [2] r: turn begin time, i: turn end time
@@ -465,8 +684,8 @@ complex las_turning(Laser *l, float t) { // [0] = vel0; [1] = vel1; [2] r: turn
 	float end = cimag(l->args[2]);
 
 	float a = clamp((t - begin) / (end - begin), 0, 1);
-	a = 1.0 - (0.5 + 0.5 * cos(a * M_PI));
-	a = 1.0 - pow(1.0 - a, 2);
+	a = 1.0 - (0.5 + 0.5 * sim_cos(a * M_PI));
+	a = 1.0 - sim_sqr(1.0 - a);
 
 	complex v = v1 * a + v0 * (1 - a);
 
@@ -484,7 +703,7 @@ complex las_circle(Laser *l, float t) {
 	double time_ofs = cimag(l->args[0]);
 	double radius = creal(l->args[1]);
 
-	return l->pos + radius * cexp(I * (t + time_ofs) * turn_speed);
+	return l->pos + radius * sim_cexp(I * (t + time_ofs) * turn_speed);
 }
 
 float laser_charge(Laser *l, int t, float charge, float width) {
@@ -46,6 +46,8 @@ struct Laser {
 
 	complex args[4];
 
+	struct LaserCache *cache;
+
 	bool unclearable;
 	bool dead;
 };
@@ -27,6 +27,7 @@
 #include "credits.h"
 #include "renderer/api.h"
 #include "taskmanager.h"
+#include "benchmark.h"
 
 static void taisei_shutdown(void) {
 	log_info("Shutting down");
@@ -174,7 +175,7 @@ int main(int argc, char **argv) {
 
 		free_cli_action(&a);
 		return 0;
-	} else if(a.type == CLI_PlayReplay || a.type == CLI_VerifyReplay) {
+	} else if(a.type == CLI_PlayReplay || a.type == CLI_VerifyReplay || a.type == CLI_BenchReplay) {
 		if(!replay_load_syspath(&replay, a.filename, REPLAY_READ_ALL)) {
 			free_cli_action(&a);
 			return 1;
@@ -187,9 +188,19 @@ int main(int argc, char **argv) {
 			return 1;
 		}
 
-		if(a.type == CLI_VerifyReplay) {
+		replay_stage_seek_on_start(replay.stages + replay_idx, a.seek_frame);
+
+		if(a.type == CLI_VerifyReplay || a.type == CLI_BenchReplay) {
 			headless = true;
 		}
+
+		if(a.type == CLI_BenchReplay) {
+			bench_init(a.trace_filename);
+
+			if(a.render_stats_filename) {
+				env_set("TAISEI_RENDER_STATS", a.render_stats_filename, true);
+			}
+		}
 	} else if(a.type == CLI_DumpVFSTree) {
 		vfs_setup(true);
 
@@ -256,9 +267,15 @@ int main(int argc, char **argv) {
 
 	atexit(taisei_shutdown);
 
-	if(a.type == CLI_PlayReplay || a.type == CLI_VerifyReplay) {
+	if(a.type == CLI_PlayReplay || a.type == CLI_VerifyReplay || a.type == CLI_BenchReplay) {
 		replay_play(&replay, replay_idx);
 		replay_destroy(&replay);
+
+		if(a.type == CLI_BenchReplay) {
+			bench_report();
+			bench_shutdown();
+		}
+
 		return 0;
 	}
 
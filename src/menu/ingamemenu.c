@@ -129,6 +129,11 @@ void create_ingame_menu(MenuData *m) {
 	set_transition(TransEmpty, 0, m->transition_out_time);
 }
 
+static void rewind_replay(MenuData *m, void *arg) {
+	replay_seek_playback(imax(0, global.frames - 10 * FPS));
+	menu_commonaction_close(m, arg);
+}
+
 static void skip_stage(MenuData *m, void *arg) {
 	global.game_over = GAMEOVER_WIN;
 	menu_commonaction_close(m, arg);
@@ -144,6 +149,7 @@ void create_ingame_menu_replay(MenuData *m) {
 	m->context = "Replay Paused";
 	add_menu_entry(m, "Options", enter_options, NULL)->transition = TransMenuDark;
 	add_menu_entry(m, "Continue Watching", menu_commonaction_close, NULL);
+	add_menu_entry(m, "Rewind 10 Seconds", rewind_replay, NULL)->transition = TransFadeBlack;
 	add_menu_entry(m, "Restart the Stage", restart_game, NULL)->transition = TransFadeBlack;
 	add_menu_entry(m, "Skip the Stage", skip_stage, NULL)->transition = TransFadeBlack;
 	add_menu_entry(m, "Stop Watching", return_to_title, NULL)->transition = TransFadeBlack;
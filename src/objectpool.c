@@ -12,43 +12,124 @@
 #include "util.h"
 #include "list.h"
 
+// Objects are addressed by slot index: the first max_objects slots live in the pool itself,
+// and every extent adds another max_objects. A bitmap tracks which slots are in use; new
+// objects always take the lowest free slot, which keeps the live set packed at the front.
+//
+// Every slot starts with a header holding its own index, followed by the object. The header
+// is written once when the slots are allocated and never touched by users of the pool, so
+// going from an object back to its slot doesn't need to search the extents.
+
+typedef uint64_t ObjectPoolBits;
+#define OBJPOOL_BITS_PER_WORD (sizeof(ObjectPoolBits) * CHAR_BIT)
+
+typedef union ObjectPoolSlotHeader {
+	size_t index;
+	max_align_t align;
+} ObjectPoolSlotHeader;
+
 struct ObjectPool {
 	char *tag;
 	size_t size_of_object;
+	size_t size_of_slot;
 	size_t max_objects;
 	size_t usage;
 	size_t peak_usage;
 	size_t num_extents;
 	char **extents;
-	ObjectInterface *free_objects;
+	ObjectPoolBits *used_slots;
+	uint32_t *generations;
+	size_t first_free_word;
 	char objects[];
 };
 
-static inline ObjectInterface* obj_ptr(ObjectPool *pool, char *objects, size_t idx) {
-	return (ObjectInterface*)(void*)(objects + idx * pool->size_of_object);
+static inline size_t objpool_capacity(ObjectPool *pool) {
+	return pool->max_objects * (1 + pool->num_extents);
+}
+
+static inline size_t objpool_num_words(ObjectPool *pool) {
+	return (objpool_capacity(pool) + OBJPOOL_BITS_PER_WORD - 1) / OBJPOOL_BITS_PER_WORD;
+}
+
+static inline uint objpool_lowest_bit(ObjectPoolBits word) {
+	assert(word != 0);
+
+#ifdef USE_GNU_EXTENSIONS
+	return __builtin_ctzll(word);
+#else
+	uint bit = 0;
+
+	while(!(word & 1)) {
+		word >>= 1;
+		++bit;
+	}
+
+	return bit;
+#endif
+}
+
+static inline char* objpool_chunk(ObjectPool *pool, size_t chunk) {
+	return chunk ? pool->extents[chunk - 1] : pool->objects;
+}
+
+static inline ObjectPoolSlotHeader* slot_ptr(ObjectPool *pool, size_t idx) {
+	char *chunk = objpool_chunk(pool, idx / pool->max_objects);
+	return (ObjectPoolSlotHeader*)(void*)(chunk + (idx % pool->max_objects) * pool->size_of_slot);
+}
+
+static inline ObjectInterface* obj_ptr(ObjectPool *pool, size_t idx) {
+	return (ObjectInterface*)(void*)(slot_ptr(pool, idx) + 1);
 }
 
-static void objpool_register_objects(ObjectPool *pool, char *objects) {
+static void objpool_init_chunk(ObjectPool *pool, size_t chunk) {
+	size_t first = chunk * pool->max_objects;
+
 	for(size_t i = 0; i < pool->max_objects; ++i) {
-		list_push(&pool->free_objects, obj_ptr(pool, objects, i));
+		slot_ptr(pool, first + i)->index = first + i;
+	}
+}
+
+static void objpool_resize_slots(ObjectPool *pool, size_t old_capacity) {
+	size_t old_words = (old_capacity + OBJPOOL_BITS_PER_WORD - 1) / OBJPOOL_BITS_PER_WORD;
+	size_t capacity = objpool_capacity(pool);
+	size_t num_words = objpool_num_words(pool);
+
+	pool->used_slots = realloc(pool->used_slots, num_words * sizeof(*pool->used_slots));
+	memset(pool->used_slots + old_words, 0, (num_words - old_words) * sizeof(*pool->used_slots));
+
+	pool->generations = realloc(pool->generations, capacity * sizeof(*pool->generations));
+	memset(pool->generations + old_capacity, 0, (capacity - old_capacity) * sizeof(*pool->generations));
+
+	// Mark the padding bits past the end as used, so that they are never handed out.
+	size_t tail = capacity % OBJPOOL_BITS_PER_WORD;
+
+	if(tail) {
+		pool->used_slots[num_words - 1] |= ~(ObjectPoolBits)0 << tail;
 	}
 }
 
 ObjectPool *objpool_alloc(size_t obj_size, size_t max_objects, const char *tag) {
 	// TODO: overflow handling
 
-	ObjectPool *pool = malloc(sizeof(ObjectPool) + (obj_size * max_objects));
+	size_t align = alignof(ObjectPoolSlotHeader);
+	size_t slot_size = (sizeof(ObjectPoolSlotHeader) + obj_size + align - 1) / align * align;
+
+	ObjectPool *pool = malloc(sizeof(ObjectPool) + (slot_size * max_objects));
 	pool->size_of_object = obj_size;
+	pool->size_of_slot = slot_size;
 	pool->max_objects = max_objects;
-	pool->free_objects = NULL;
 	pool->usage = 0;
 	pool->peak_usage = 0;
 	pool->num_extents = 0;
 	pool->extents = NULL;
+	pool->used_slots = NULL;
+	pool->generations = NULL;
+	pool->first_free_word = 0;
 	pool->tag = strdup(tag);
 
-	memset(pool->objects, 0, obj_size * max_objects);
-	objpool_register_objects(pool, pool->objects);
+	memset(pool->objects, 0, slot_size * max_objects);
+	objpool_init_chunk(pool, 0);
+	objpool_resize_slots(pool, 0);
 
 	log_debug("[%s] Allocated pool for %zu objects, %zu bytes each",
 		pool->tag,
@@ -59,11 +140,21 @@ ObjectPool *objpool_alloc(size_t obj_size, size_t max_objects, const char *tag)
 	return pool;
 }
 
-static char *objpool_add_extent(ObjectPool *pool) {
+static void objpool_add_extent(ObjectPool *pool) {
+	// The padding bits of the old last word are about to become real slots.
+	size_t old_capacity = objpool_capacity(pool);
+	size_t tail = old_capacity % OBJPOOL_BITS_PER_WORD;
+
+	if(tail) {
+		pool->used_slots[old_capacity / OBJPOOL_BITS_PER_WORD] &= ~(~(ObjectPoolBits)0 << tail);
+	}
+
+	pool->first_free_word = old_capacity / OBJPOOL_BITS_PER_WORD;
+
 	pool->extents = realloc(pool->extents, (++pool->num_extents) * sizeof(*pool->extents));
-	char *extent = pool->extents[pool->num_extents - 1] = calloc(pool->max_objects, pool->size_of_object);
-	objpool_register_objects(pool, extent);
-	return extent;
+	pool->extents[pool->num_extents - 1] = calloc(pool->max_objects, pool->size_of_slot);
+	objpool_init_chunk(pool, pool->num_extents);
+	objpool_resize_slots(pool, old_capacity);
 }
 
 static char* objpool_fmt_size(ObjectPool *pool) {
@@ -89,17 +180,31 @@ static char* objpool_fmt_size(ObjectPool *pool) {
 	}
 }
 
+static ObjectInterface* objpool_take_free_slot(ObjectPool *pool) {
+	size_t num_words = objpool_num_words(pool);
+
+	for(size_t w = pool->first_free_word; w < num_words; ++w) {
+		ObjectPoolBits free_bits = ~pool->used_slots[w];
+
+		if(free_bits) {
+			uint bit = objpool_lowest_bit(free_bits);
+			pool->used_slots[w] |= (ObjectPoolBits)1 << bit;
+			pool->first_free_word = w;
+			return obj_ptr(pool, w * OBJPOOL_BITS_PER_WORD + bit);
+		}
+	}
+
+	pool->first_free_word = num_words;
+	return NULL;
+}
+
 ObjectInterface *objpool_acquire(ObjectPool *pool) {
-	ObjectInterface *obj = list_pop(&pool->free_objects);
+	ObjectInterface *obj = objpool_take_free_slot(pool);
 
 	if(obj) {
 acquired:
 		memset(obj, 0, pool->size_of_object);
 
-		IF_OBJPOOL_DEBUG({
-			obj->_object_private.used = true;
-		})
-
 		if(++pool->usage > pool->peak_usage) {
 			pool->peak_usage = pool->usage;
 		}
@@ -116,31 +221,45 @@ acquired:
 	free(tmp);
 
 	objpool_add_extent(pool);
-	obj = list_pop(&pool->free_objects);
+	obj = objpool_take_free_slot(pool);
 	assert(obj != NULL);
 	goto acquired;
 }
 
-void objpool_release(ObjectPool *pool, ObjectInterface *object) {
-	objpool_memtest(pool, object);
+static void objpool_release_slot(ObjectPool *pool, size_t idx) {
+	size_t w = idx / OBJPOOL_BITS_PER_WORD;
+	ObjectPoolBits bit = (ObjectPoolBits)1 << (idx % OBJPOOL_BITS_PER_WORD);
 
-	IF_OBJPOOL_DEBUG({
-		if(!object->_object_private.used) {
-			log_fatal("[%s] Attempted to release an unused object %p",
-				pool->tag,
-				(void*)object
-			);
-		}
+	if(!(pool->used_slots[w] & bit)) {
+		log_fatal("[%s] Attempted to release an unused object %p",
+			pool->tag,
+			(void*)obj_ptr(pool, idx)
+		);
+	}
 
-		object->_object_private.used = false;
-	})
+	pool->used_slots[w] &= ~bit;
+	pool->generations[idx]++;
 
-	list_push(&pool->free_objects, object);
+	if(w < pool->first_free_word) {
+		pool->first_free_word = w;
+	}
 
 	pool->usage--;
+}
+
+void objpool_release(ObjectPool *pool, ObjectInterface *object) {
+	objpool_release_slot(pool, objpool_object_index(pool, object));
 	// log_debug("[%s] Usage: %zu", pool->tag, pool->usage);
 }
 
+void objpool_release_list(ObjectPool *pool, ListAnchor *list) {
+	for(List *e = list->first; e; e = e->next) {
+		objpool_release_slot(pool, objpool_object_index(pool, (ObjectInterface*)e));
+	}
+
+	list->first = list->last = NULL;
+}
+
 void objpool_free(ObjectPool *pool) {
 	if(!pool) {
 		return;
@@ -155,6 +274,8 @@ void objpool_free(ObjectPool *pool) {
 	}
 
 	free(pool->extents);
+	free(pool->used_slots);
+	free(pool->generations);
 	free(pool->tag);
 	free(pool);
 }
@@ -165,47 +286,31 @@ size_t objpool_object_size(ObjectPool *pool) {
 
 void objpool_get_stats(ObjectPool *pool, ObjectPoolStats *stats) {
 	stats->tag = pool->tag;
-	stats->capacity = pool->max_objects * (1 + pool->num_extents);
+	stats->capacity = objpool_capacity(pool);
 	stats->usage = pool->usage;
 	stats->peak_usage = pool->peak_usage;
 }
 
-attr_unused
-static bool objpool_object_in_subpool(ObjectPool *pool, ObjectInterface *object, char *objects) {
-	char *objofs = (char*)object;
-	char *minofs = objects;
-	char *maxofs = objects + (pool->max_objects - 1) * pool->size_of_object;
-
-	if(objofs < minofs || objofs > maxofs) {
-		return false;
-	}
+size_t objpool_object_index(ObjectPool *pool, ObjectInterface *object) {
+	assert(pool != NULL);
+	assert(object != NULL);
 
-	ptrdiff_t misalign = (ptrdiff_t)(objofs - objects) % pool->size_of_object;
+	size_t idx = ((ObjectPoolSlotHeader*)(void*)object - 1)->index;
 
-	if(misalign) {
-		log_fatal("[%s] Object pointer %p is misaligned by %zi",
-			pool->tag,
-			(void*)objofs,
-			(ssize_t)misalign
-		);
-	}
+	IF_OBJPOOL_DEBUG({
+		if(idx >= objpool_capacity(pool) || obj_ptr(pool, idx) != object) {
+			log_fatal("[%s] Object pointer %p does not belong to this pool",
+				pool->tag,
+				(void*)object
+			);
+		}
+	})
 
-	return true;
+	return idx;
 }
 
-attr_unused
-static bool objpool_object_in_pool(ObjectPool *pool, ObjectInterface *object) {
-	if(objpool_object_in_subpool(pool, object, pool->objects)) {
-		return true;
-	}
-
-	for(size_t i = 0; i < pool->num_extents; ++i) {
-		if(objpool_object_in_subpool(pool, object, pool->extents[i])) {
-			return true;
-		}
-	}
-
-	return false;
+uint32_t objpool_object_generation(ObjectPool *pool, ObjectInterface *object) {
+	return pool->generations[objpool_object_index(pool, object)];
 }
 
 void objpool_memtest(ObjectPool *pool, ObjectInterface *object) {
@@ -213,11 +318,6 @@ void objpool_memtest(ObjectPool *pool, ObjectInterface *object) {
 	assert(object != NULL);
 
 	IF_OBJPOOL_DEBUG({
-		if(!objpool_object_in_pool(pool, object)) {
-			log_fatal("[%s] Object pointer %p does not belong to this pool",
-				pool->tag,
-				(void*)object
-			);
-		}
+		objpool_object_index(pool, object);
 	})
 }
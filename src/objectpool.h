@@ -36,11 +36,6 @@ struct ObjectPoolStats {
 
 #define OBJECT_INTERFACE_BASE(typename) struct { \
 	LIST_INTERFACE(typename); \
-	IF_OBJPOOL_DEBUG( \
-		struct { \
-			bool used; \
-		} _object_private; \
-	) \
 }
 
 #define OBJECT_INTERFACE(typename) union { \
@@ -70,6 +65,21 @@ ObjectPool *objpool_alloc(size_t obj_size, size_t max_objects, const char *tag);
 void objpool_free(ObjectPool *pool);
 ObjectInterface *objpool_acquire(ObjectPool *pool);
 void objpool_release(ObjectPool *pool, ObjectInterface *object);
+
+// Releases every object in the list at once and empties it. The objects are not unlinked
+// one by one, so the caller must have finished tearing them down already.
+// This is still linear in the length of the list: live objects are scattered over the pool,
+// so each one's bit in the slot bitmap and its generation have to be updated individually.
+// What it saves over objpool_release() is the unlinking, at O(1) per object.
+void objpool_release_list(ObjectPool *pool, ListAnchor *list);
+
+// Every object has a stable slot index within its pool. The generation of a slot is bumped
+// whenever its object is released, so (index, generation) pairs identify an object uniquely.
+// Pools built with objectpool_fake.c have no slots; every object there has index 0 and
+// generation 0.
+size_t objpool_object_index(ObjectPool *pool, ObjectInterface *object);
+uint32_t objpool_object_generation(ObjectPool *pool, ObjectInterface *object);
+
 void objpool_get_stats(ObjectPool *pool, ObjectPoolStats *stats);
 void objpool_memtest(ObjectPool *pool, ObjectInterface *object);
 size_t objpool_object_size(ObjectPool *pool);
@@ -29,6 +29,23 @@ void objpool_release(ObjectPool *pool, ObjectInterface *object) {
 	free(object);
 }
 
+void objpool_release_list(ObjectPool *pool, ListAnchor *list) {
+	for(List *e = list->first, *next; e; e = next) {
+		next = e->next;
+		free(e);
+	}
+
+	list->first = list->last = NULL;
+}
+
+size_t objpool_object_index(ObjectPool *pool, ObjectInterface *object) {
+	return 0;
+}
+
+uint32_t objpool_object_generation(ObjectPool *pool, ObjectInterface *object) {
+	return 0;
+}
+
 void objpool_free(ObjectPool *pool) {
 	free(pool);
 }
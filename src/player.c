@@ -117,8 +117,8 @@ void player_move(Player *plr, complex delta) {
 	plr->pos = x + y*I;
 	complex realdir = plr->pos - lastpos;
 
-	if(cabs(realdir)) {
-		plr->lastmovedir = realdir / cabs(realdir);
+	if(sim_cabs(realdir)) {
+		plr->lastmovedir = realdir / sim_cabs(realdir);
 	}
 
 	plr->velocity = realdir;
@@ -485,7 +485,7 @@ static int player_death_effect(Projectile *p, int t) {
 			for(int i = 0; i < 12; ++i) {
 				PARTICLE(
 					.sprite = "blast",
-					.pos = p->pos + 2 * frand() * cexp(I*M_PI*2*frand()),
+					.pos = p->pos + 2 * frand() * sim_cexp(I*M_PI*2*frand()),
 					.color = RGBA(0.15, 0.2, 0.5, 0),
 					.timeout = 12 + i + 2 * nfrand(),
 					.draw_rule = GrowFade,
@@ -518,7 +518,7 @@ void player_death(Player *plr) {
 			.rule = linear,
 			.timeout = 40,
 			.draw_rule = Shrink,
-			.args = { (3+afrand(0)*7)*cexp(I*tsrand_a(1)) },
+			.args = { (3+afrand(0)*7)*sim_cexp(I*tsrand_a(1)) },
 			.flags = PFLAG_NOREFLECT,
 		);
 	}
@@ -781,8 +781,8 @@ bool player_applymovement_gamepad(Player *plr) {
 		gamepad_normalize_axis_value(plr->axis_ud) * I
 	);
 
-	if(cabs(direction) > 1) {
-		direction /= cabs(direction);
+	if(sim_cabs(direction) > 1) {
+		direction /= sim_cabs(direction);
 	}
 
 	int sr = sign(creal(direction));
@@ -858,8 +858,8 @@ void player_applymovement(Player *plr) {
 	if(left)    direction -= 1.0;
 	if(right)   direction += 1.0;
 
-	if(cabs(direction))
-		direction /= cabs(direction);
+	if(sim_cabs(direction))
+		direction /= sim_cabs(direction);
 
 	if(direction)
 		player_move(&global.plr, direction);
@@ -914,7 +914,7 @@ void player_graze(Player *plr, complex pos, int pts, int effect_intensity) {
 	}
 
 	player_add_points(plr, pts);
-	play_sound("graze");
+	play_sound_p(SFX("graze"));
 
 	for(int i = 0; i < effect_intensity; ++i) {
 		tsrand_fill(3);
@@ -925,7 +925,7 @@ void player_graze(Player *plr, complex pos, int pts, int effect_intensity) {
 			.rule = linear,
 			.timeout = 5 + 5 * afrand(2),
 			.draw_rule = Shrink,
-			.args = { (1+afrand(0)*5)*cexp(I*M_PI*2*afrand(1)) },
+			.args = { (1+afrand(0)*5)*sim_cexp(I*M_PI*2*afrand(1)) },
 			.flags = PFLAG_NOREFLECT,
 			.layer = LAYER_PARTICLE_LOW,
 		);
@@ -1072,7 +1072,7 @@ complex plrutil_homing_target(complex org, complex fallback) {
 
 	if(global.boss && boss_is_vulnerable(global.boss)) {
 		target = global.boss->pos;
-		mindst = cabs(target - org);
+		mindst = sim_cabs(target - org);
 	}
 
 	for(Enemy *e = global.enemies.first; e; e = e->next) {
@@ -1080,7 +1080,7 @@ complex plrutil_homing_target(complex org, complex fallback) {
 			continue;
 		}
 
-		double dst = cabs(e->pos - org);
+		double dst = sim_cabs(e->pos - org);
 
 		if(dst < mindst) {
 			mindst = dst;
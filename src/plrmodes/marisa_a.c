@@ -96,7 +96,7 @@ static void trace_laser(Enemy *e, complex vel, float damage) {
 				.rule = linear,
 				.timeout = 3 + 5 * afrand(2),
 				.draw_rule = Shrink,
-				.args = { (2+afrand(0)*6)*cexp(I*M_PI*2*afrand(1)) },
+				.args = { (2+afrand(0)*6)*sim_cexp(I*M_PI*2*afrand(1)) },
 				.flags = PFLAG_NOREFLECT,
 			);
 
@@ -371,7 +371,7 @@ static int marisa_laser_slave(Enemy *e, int t) {
 		f = smoothreclamp(f, 0, 1, 0, 1);
 		float factor = (1.0 + 0.7 * psin(t/15.0)) * -(1-f) * !!angle;
 
-		complex dir = -cexp(I*(angle*factor + ld->lean + M_PI/2));
+		complex dir = -sim_cexp(I*(angle*factor + ld->lean + M_PI/2));
 		trace_laser(e, 5 * dir, creal(e->args[1]));
 
 		PARTICLE(
@@ -413,7 +413,7 @@ static void masterspark_visual(Enemy *e, int t2, bool render) {
 
 static int masterspark_star(Projectile *p, int t) {
 	if(t >= 0) {
-		p->args[0] += 0.1*p->args[0]/cabs(p->args[0]);
+		p->args[0] += 0.1*p->args[0]/sim_cabs(p->args[0]);
 		p->angle += 0.1;
 	}
 
@@ -435,7 +435,7 @@ static int masterspark(Enemy *e, int t2) {
 	if(t2 < 0)
 		return 1;
 
-	e->args[0] *= cexp(I*(0.005*creal(global.plr.velocity) + nfrand() * 0.005));
+	e->args[0] *= sim_cexp(I*(0.005*creal(global.plr.velocity) + nfrand() * 0.005));
 	complex diroffset = e->args[0];
 
 	float t = player_get_bomb_progress(&global.plr, NULL);
@@ -443,7 +443,7 @@ static int masterspark(Enemy *e, int t2) {
 	if(t >= 3.0/4.0) {
 		global.shake_view = 8 * (1 - t * 4 + 3);
 	} else if(t2 % 2 == 0) {
-		complex dir = -cexp(1.5*I*sin(t2*M_PI*1.12))*I;
+		complex dir = -sim_cexp(1.5*I*sim_sin(t2*M_PI*1.12))*I;
 		Color *c = HSLA(-t*5.321,1,0.5,0.5*frand());
 		PARTICLE(
 			.sprite = "maristar_orbit",
@@ -77,8 +77,8 @@ static int marisa_star_slave(Enemy *e, int t) {
 			v = creal(v) * (1 - 5 * focus) + I * cimag(v) * (1 - 2.5 * focus);
 			a = creal(a) * focus * -0.0525 + I * cimag(a) * 2;
 
-			v *= cexp(I*i*M_PI/20*sign(v));
-			a *= cexp(I*i*M_PI/20*sign(v)*focus);
+			v *= sim_cexp(I*i*M_PI/20*sign(v));
+			a *= sim_cexp(I*i*M_PI/20*sign(v)*focus);
 
 			PROJECTILE(
 				.proto = pp_maristar,
@@ -102,7 +102,7 @@ static int marisa_star_slave(Enemy *e, int t) {
 
 static int marisa_star_orbit_star(Projectile *p, int t) { // XXX: because growfade is the worst
 	if(t >= 0) {
-		p->args[0] += p->args[0]/cabs(p->args[0])*0.15;
+		p->args[0] += p->args[0]/sim_cabs(p->args[0])*0.15;
 		p->angle += 0.1;
 	}
 
@@ -134,8 +134,8 @@ static int marisa_star_orbit(Enemy *e, int t) {
 		return ACTION_DESTROY;
 	}
 
-	double r = 100*pow(tanh(t/20.),2);
-	complex dir = e->args[1]*r*cexp(I*(sqrt(1000+t*t+0.03*t*t*t))*0.04);
+	double r = 100*sim_pow(sim_tanh(t/20.),2);
+	complex dir = e->args[1]*r*sim_cexp(I*(sqrt(1000+t*t+0.03*t*t*t))*0.04);
 	e->pos = global.plr.pos+dir;
 
 	float fadetime = 3./4;
@@ -172,7 +172,7 @@ static int marisa_star_orbit(Enemy *e, int t) {
 			.draw_rule = GrowFade,
 			.timeout = 150,
 			.flags = PFLAG_NOREFLECT,
-			.args = { -5*dir/cabs(dir), 5 },
+			.args = { -5*dir/sim_cabs(dir), 5 },
 		);
 	}
 
@@ -219,7 +219,7 @@ static void marisa_star_bomb(Player *plr) {
 
 	int count = 5; // might as well be hard coded. We are talking marisa here.
 	for(int i = 0; i < 5; i++) {
-		complex dir = cexp(2*I*M_PI/count*i);
+		complex dir = sim_cexp(2*I*M_PI/count*i);
 		Enemy *e = create_enemy2c(plr->pos, ENEMY_BOMB, marisa_star_orbit_visual, marisa_star_orbit, i ,dir);
 		e->ent.draw_layer = LAYER_PLAYER_FOCUS - 1;
 	}
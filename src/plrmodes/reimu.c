@@ -68,7 +68,7 @@ int reimu_common_ofuda(Projectile *p, int t) {
 		return ACTION_ACK;
 	}
 
-	p->angle = carg(p->args[0]);
+	p->angle = sim_carg(p->args[0]);
 
 	if(t == EVENT_BIRTH) {
 		return ACTION_ACK;
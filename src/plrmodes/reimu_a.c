@@ -137,7 +137,7 @@ static Projectile* reimu_spirit_spawn_homing_impact(Projectile *p, int t) {
 
 static inline double reimu_spirit_homing_aimfactor(double t, double maxt) {
 	t = clamp(t, 0, maxt);
-	double q = pow(1 - t / maxt, 3);
+	double q = sim_pow(1 - t / maxt, 3);
 	return 4 * q * (1 - q);
 }
 
@@ -151,16 +151,16 @@ static int reimu_spirit_homing(Projectile *p, int t) {
 	}
 
 	p->args[3] = plrutil_homing_target(p->pos, p->args[3]);
-	double v = cabs(p->args[0]);
+	double v = sim_cabs(p->args[0]);
 
-	complex aimdir = cexp(I*carg(p->args[3] - p->pos));
+	complex aimdir = sim_cexp(I*sim_carg(p->args[3] - p->pos));
 	double aim = reimu_spirit_homing_aimfactor(t, p->args[1]);
 
 	p->args[0] += v * 0.25 * aim * aimdir;
-	p->args[0] = v * cexp(I*carg(p->args[0]));
-	p->angle = carg(p->args[0]);
+	p->args[0] = v * sim_cexp(I*sim_carg(p->args[0]));
+	p->angle = sim_carg(p->args[0]);
 
-	double s = 1;// max(pow(2*t/creal(p->args[1]), 2), 0.1); //(0.25 + 0.75 * (1 - aim));
+	double s = 1;// max(sim_pow(2*t/creal(p->args[1]), 2), 0.1); //(0.25 + 0.75 * (1 - aim));
 	p->pos += p->args[0] * s;
 	reimu_spirit_spawn_ofuda_particle(p, t, 0.5);
 
@@ -255,7 +255,7 @@ static int reimu_spirit_bomb_orb(Projectile *p, int t) {
 				.color = HSLA(3 * (float)i / count + offset, 1, 0.5, 0), // reimu_spirit_orb_color(&(Color){0}, i%3),w
 				.timeout = 60,
 				.pos = p->pos,
-				.args = { cexp(I * 2 * M_PI / count * (i + offset)) * 15 },
+				.args = { sim_cexp(I * 2 * M_PI / count * (i + offset)) * 15 },
 				.angle = 2*M_PI*frand(),
 				.rule = linear,
 				.draw_rule = Fade,
@@ -269,7 +269,7 @@ static int reimu_spirit_bomb_orb(Projectile *p, int t) {
 				.sprite = "blast",
 				.size = 64 * (I+1),
 				.color = color_mul_scalar(reimu_spirit_orb_color(&(Color){0}, i), 2),
-				.pos = p->pos + 30 * cexp(I*2*M_PI/3*(i+t*0.1)),
+				.pos = p->pos + 30 * sim_cexp(I*2*M_PI/3*(i+t*0.1)),
 				.timeout = 40,
 				.draw_rule = ScaleFade,
 				.layer = LAYER_BOSS + 2,
@@ -279,7 +279,7 @@ static int reimu_spirit_bomb_orb(Projectile *p, int t) {
 			PARTICLE(
 				.sprite = "fantasyseal_impact",
 				.color = reimu_spirit_orb_color(&(Color){0}, i),
-				.pos = p->pos + 2 * cexp(I*2*M_PI/3*(i+t*0.1)),
+				.pos = p->pos + 2 * sim_cexp(I*2*M_PI/3*(i+t*0.1)),
 				.timeout = 120,
 				.draw_rule = reimu_spirit_bomb_orb_draw_impact,
 				.layer = LAYER_BOSS + 1,
@@ -304,22 +304,22 @@ static int reimu_spirit_bomb_orb(Projectile *p, int t) {
 		play_sound("redirect");
 	}
 
-	complex target_circle = global.plr.pos + 10 * sqrt(t) * p->args[0]*(1 + 0.1 * sin(0.2*t));
-	p->args[0] *= cexp(I*0.12);
+	complex target_circle = global.plr.pos + 10 * sqrt(t) * p->args[0]*(1 + 0.1 * sim_sin(0.2*t));
+	p->args[0] *= sim_cexp(I*0.12);
 
-	double circlestrength = 1.0 / (1 + exp(t-circletime));
+	double circlestrength = 1.0 / (1 + sim_exp(t-circletime));
 
 	p->args[3] = plrutil_homing_target(p->pos, p->args[3]);
 	complex target_homing = p->args[3];
 	complex homing = target_homing - p->pos;
-	complex v = 0.3 * (circlestrength * (target_circle - p->pos) + 0.2 * (1-circlestrength) * (homing + 2*homing/(cabs(homing)+0.01)));
+	complex v = 0.3 * (circlestrength * (target_circle - p->pos) + 0.2 * (1-circlestrength) * (homing + 2*homing/(sim_cabs(homing)+0.01)));
 	p->args[2] += (v - p->args[2]) * 0.2;
 	p->pos += p->args[2];
 
 	for(int i = 0; i < 3 /*&& circlestrength < 1*/; i++) {
-		complex pos = p->pos + 10 * cexp(I*2*M_PI/3*(i+t*0.1));
+		complex pos = p->pos + 10 * sim_cexp(I*2*M_PI/3*(i+t*0.1));
 		complex v = global.plr.pos - pos;
-		v *= 3 * circlestrength / cabs(v);
+		v *= 3 * circlestrength / sim_cabs(v);
 
 		PARTICLE(
 			.sprite_ptr = get_sprite("part/stain"),
@@ -345,7 +345,7 @@ static void reimu_spirit_bomb(Player *p) {
 			.pos = p->pos,
 			.draw_rule = reimu_spirit_bomb_orb_visual,
 			.rule = reimu_spirit_bomb_orb,
-			.args = { cexp(I*2*M_PI/count*i), i, 0, 0},
+			.args = { sim_cexp(I*2*M_PI/count*i), i, 0, 0},
 			.timeout = 160 + 20 * i,
 			.type = PlrProj,
 			.damage = 0,
@@ -404,7 +404,7 @@ static void reimu_spirit_shot(Player *p) {
 					.pos = p->pos - I + 5 * i,
 					.color = color_mul_scalar(RGBA(1, 1, 1, 0.5), 0.7),
 					.rule = linear,
-					.args = { -18.0*I*cexp(I*spread) },
+					.args = { -18.0*I*sim_cexp(I*spread) },
 					.type = PlrProj,
 					.damage = 60 - 5 * (p->power / 100),
 					.shader = "sprite_default",
@@ -434,7 +434,7 @@ static void reimu_spirit_slave_shot(Enemy *e, int t) {
 			.shader = "sprite_default",
 		);
 	} else if(!(st % 12)) {
-		complex v = -10 * I * cexp(I*cimag(e->args[0]));
+		complex v = -10 * I * sim_cexp(I*cimag(e->args[0]));
 
 		PROJECTILE(
 			.proto = pp_ofuda,
@@ -486,9 +486,9 @@ static int reimu_spirit_slave(Enemy *e, int t) {
 	double speed = 0.005 * min(1, t / 12.0);
 
 	if(global.plr.inputflags & INFLAG_FOCUS) {
-		GO_TO(e, global.plr.pos + cimag(e->args[1]) * cexp(I*(creal(e->args[0]) + t * creal(e->args[1]))), speed * cabs(e->args[1]));
+		GO_TO(e, global.plr.pos + cimag(e->args[1]) * sim_cexp(I*(creal(e->args[0]) + t * creal(e->args[1]))), speed * sim_cabs(e->args[1]));
 	} else {
-		GO_TO(e, global.plr.pos + e->pos0, speed * cabs(e->pos0));
+		GO_TO(e, global.plr.pos + e->pos0, speed * sim_cabs(e->pos0));
 	}
 
 	return ACTION_NONE;
@@ -637,7 +637,7 @@ double reimu_spirit_property(Player *plr, PlrProperty prop) {
 
 	switch(prop) {
 		case PLR_PROP_SPEED: {
-			return base_value * (pow(player_get_bomb_progress(plr, NULL), 0.5));
+			return base_value * (sim_pow(player_get_bomb_progress(plr, NULL), 0.5));
 		}
 
 		default: {
@@ -149,8 +149,8 @@ static int reimu_dream_gap(Enemy *e, int t) {
 }
 
 static void reimu_dream_gap_link(Enemy *g0, Enemy *g1) {
-	int ref0 = add_ref(g0);
-	int ref1 = add_ref(g1);
+	RefHandle ref0 = add_ref(g0);
+	RefHandle ref1 = add_ref(g1);
 	g0->args[3] = ref1;
 	g1->args[3] = ref0;
 }
@@ -332,14 +332,14 @@ static void reimu_dream_bullet_warp(Projectile *p, int t) {
 	Rect p_bbox = { p->pos - p_long_side * half, p->pos + p_long_side * half };
 
 	FOR_EACH_GAP(gap) {
-		double a = (carg(-gap->pos0) - carg(p->args[0]));
+		double a = (sim_carg(-gap->pos0) - sim_carg(p->args[0]));
 
 		if(fabs(a) < 2*M_PI/3) {
 			continue;
 		}
 
 		Rect gap_bbox, overlap;
-		complex gap_size = (GAP_LENGTH + I * GAP_WIDTH) * cexp(I*carg(gap->args[0]));
+		complex gap_size = (GAP_LENGTH + I * GAP_WIDTH) * sim_cexp(I*sim_carg(gap->args[0]));
 		complex p0 = gap->pos - gap_size * 0.5;
 		complex p1 = gap->pos + gap_size * 0.5;
 		gap_bbox.top_left = min(creal(p0), creal(p1)) + I * min(cimag(p0), cimag(p1));
@@ -361,7 +361,7 @@ static void reimu_dream_bullet_warp(Projectile *p, int t) {
 			reimu_dream_spawn_warp_effect(gap->pos + gap->args[0] * GAP_LENGTH * (fract - 0.5), false);
 			reimu_dream_spawn_warp_effect(o, true);
 
-			p->args[0] = -cabs(p->args[0]) * ngap->pos0;
+			p->args[0] = -sim_cabs(p->args[0]) * ngap->pos0;
 			p->pos = o + p->args[0];
 			p->args[3] += 1;
 		}
@@ -374,7 +374,7 @@ static int reimu_dream_ofuda(Projectile *p, int t) {
 	}
 
 	complex ov = p->args[0];
-	double s = cabs(ov);
+	double s = sim_cabs(ov);
 	p->args[0] *= clamp(s * (1.5 - t / 10.0), s*1.0, 1.5*s) / s;
 	int r = reimu_common_ofuda(p, t);
 	p->args[0] = ov;
@@ -387,7 +387,7 @@ static int reimu_dream_needle(Projectile *p, int t) {
 		reimu_dream_bullet_warp(p, t);
 	}
 
-	p->angle = carg(p->args[0]);
+	p->angle = sim_carg(p->args[0]);
 
 	if(t < 0) {
 		return ACTION_ACK;
@@ -420,7 +420,7 @@ static void reimu_dream_shot(Player *p) {
 	if(!(global.frames % 6)) {
 		for(int i = -1; i < 2; i += 2) {
 			complex shot_dir = i * ((p->inputflags & INFLAG_FOCUS) ? 1 : I);
-			complex spread_dir = shot_dir * cexp(I*M_PI*0.5);
+			complex spread_dir = shot_dir * sim_cexp(I*M_PI*0.5);
 
 			for(int j = -1; j < 2; j += 2) {
 				PROJECTILE(
@@ -474,7 +474,7 @@ static int reimu_dream_slave(Enemy *e, int t) {
 	} else {
 		double x = creal(ofs);
 		double y = cimag(ofs);
-		complex tpos = global.plr.pos + x * sin(a) + y * I * cos(a);
+		complex tpos = global.plr.pos + x * sim_sin(a) + y * I * sim_cos(a);
 		e->pos += (tpos - e->pos) * 0.5;
 	}
 
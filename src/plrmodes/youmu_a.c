@@ -36,8 +36,8 @@ static int myon_particle_rule(Projectile *p, int t) {
 }
 
 static complex myon_tail_dir(void) {
-	double angle = carg(MYON->args[0]);
-	complex dir = cexp(I*(0.1 * sin(global.frames * 0.05) + angle));
+	double angle = sim_carg(MYON->args[0]);
+	complex dir = sim_cexp(I*(0.1 * sim_sin(global.frames * 0.05) + angle));
 	float f = abs(global.plr.focus) / 30.0;
 	return f * f * dir;
 }
@@ -48,11 +48,11 @@ static int myon_flare_particle_rule(Projectile *p, int t) {
 	}
 
 	// wiggle wiggle
-	p->pos += 0.05 * (MYON->pos - p->pos) * cexp(I * sin((t - global.frames * 2) * 0.1) * M_PI/8);
+	p->pos += 0.05 * (MYON->pos - p->pos) * sim_cexp(I * sim_sin((t - global.frames * 2) * 0.1) * M_PI/8);
 	p->args[0] = 3 * myon_tail_dir();
 
 	int r = myon_particle_rule(p, t);
-	myon_color(&p->color, creal(p->args[3]), pow(1 - min(1, t / (double)p->timeout), 2), 0.95);
+	myon_color(&p->color, creal(p->args[3]), sim_pow(1 - min(1, t / (double)p->timeout), 2), 0.95);
 	return r;
 }
 
@@ -68,7 +68,7 @@ static void myon_draw_trail(Projectile *p, int t) {
 static void spawn_stardust(complex pos, float myon_color_f, int timeout, complex v) {
 	PARTICLE(
 		.sprite = "stardust",
-		.pos = pos+5*frand()*cexp(2.0*I*M_PI*frand()),
+		.pos = pos+5*frand()*sim_cexp(2.0*I*M_PI*frand()),
 		.draw_rule = myon_draw_trail,
 		.rule = myon_particle_rule,
 		.timeout = timeout,
@@ -81,31 +81,31 @@ static void spawn_stardust(complex pos, float myon_color_f, int timeout, complex
 
 static void myon_spawn_trail(Enemy *e, int t) {
 	float a = global.frames * 0.07;
-	complex pos = e->pos + 3 * (cos(a) + I * sin(a));
+	complex pos = e->pos + 3 * (sim_cos(a) + I * sim_sin(a));
 
-	complex stardust_v = 3 * myon_tail_dir() * cexp(I*M_PI/16*sin(1.33*t));
+	complex stardust_v = 3 * myon_tail_dir() * sim_cexp(I*M_PI/16*sim_sin(1.33*t));
 	float f = abs(global.plr.focus) / 30.0;
 	stardust_v = f * stardust_v + (1 - f) * -I;
 
 	if(player_should_shoot(&global.plr, true)) {
 		PARTICLE(
 			.sprite = "smoke",
-			.pos = pos+10*frand()*cexp(2.0*I*M_PI*frand()),
+			.pos = pos+10*frand()*sim_cexp(2.0*I*M_PI*frand()),
 			.draw_rule = myon_draw_trail,
 			.rule = myon_particle_rule,
 			.timeout = 60,
-			.args = { -I*0.0*cexp(I*M_PI/16*sin(t)), -0.2, 0, f },
+			.args = { -I*0.0*sim_cexp(I*M_PI/16*sim_sin(t)), -0.2, 0, f },
 			.flags = PFLAG_NOREFLECT,
 			.angle = M_PI*2*frand(),
 		);
 
 		PARTICLE(
 			.sprite = "flare",
-			.pos = pos+5*frand()*cexp(2.0*I*M_PI*frand()),
+			.pos = pos+5*frand()*sim_cexp(2.0*I*M_PI*frand()),
 			.draw_rule = Shrink,
 			.rule = myon_particle_rule,
 			.timeout = 10,
-			.args = { cexp(I*M_PI*2*frand())*0.5, 0.2, 0, f },
+			.args = { sim_cexp(I*M_PI*2*frand())*0.5, 0.2, 0, f },
 			.flags = PFLAG_NOREFLECT,
 			.angle = M_PI*2*frand(),
 		);
@@ -142,8 +142,8 @@ static int myon_proj(Projectile *p, int t) {
 
 	linear(p, t);
 
-	//p->pos = global.plr.slaves->pos - global.plr.slaves->args[0] / cabs(global.plr.slaves->args[0]) * t * cabs(p->args[0]);
-	//p->angle = carg(-global.plr.slaves->args[0]);
+	//p->pos = global.plr.slaves->pos - global.plr.slaves->args[0] / sim_cabs(global.plr.slaves->args[0]) * t * sim_cabs(p->args[0]);
+	//p->angle = sim_carg(-global.plr.slaves->args[0]);
 
 	// spawn_stardust(p->pos, multiply_colors(p->color, myon_color(abs(global.plr.focus) / 30.0, 0.1)), 20, p->args[0]*0.1);
 
@@ -164,7 +164,7 @@ static int myon_proj(Projectile *p, int t) {
 		.angle = p->angle,
 	);
 
-	p->shader_params.vector[0] = pow(1 - min(1, t / 10.0), 2);
+	p->shader_params.vector[0] = sim_pow(1 - min(1, t / 10.0), 2);
 
 	return ACTION_NONE;
 }
@@ -174,8 +174,8 @@ static void myon_proj_draw(Projectile *p, int t) {
 }
 
 static Projectile* youmu_mirror_myon_proj(char *tex, complex pos, double speed, double angle, double aoffs, double upfactor, float dmg) {
-	complex dir = cexp(I*(M_PI/2 + aoffs)) * upfactor + cexp(I * (angle + aoffs)) * (1 - upfactor);
-	dir = dir / cabs(dir);
+	complex dir = sim_cexp(I*(M_PI/2 + aoffs)) * upfactor + sim_cexp(I * (angle + aoffs)) * (1 - upfactor);
+	dir = dir / sim_cabs(dir);
 
 	// float f = ((global.plr.inputflags & INFLAG_FOCUS) == INFLAG_FOCUS);
 	float f = smoothreclamp(abs(global.plr.focus) / 30.0, 0, 1, 0, 1);
@@ -220,7 +220,7 @@ static int youmu_mirror_myon(Enemy *e, int t) {
 	myon_spawn_trail(e, t);
 
 	Player *plr = &global.plr;
-	float rad = cabs(e->pos0);
+	float rad = sim_cabs(e->pos0);
 
 	double nfocus = plr->focus / 30.0;
 
@@ -232,20 +232,20 @@ static int youmu_mirror_myon(Enemy *e, int t) {
 			e->pos0 = rad * -plr->lastmovedir;
 		} else {
 			e->pos0 = e->pos - plr->pos;
-			e->pos0 *= rad / cabs(e->pos0);
+			e->pos0 *= rad / sim_cabs(e->pos0);
 		}
 	}
 
 	complex target = plr->pos + e->pos0;
-	complex v = cexp(I*carg(target - e->pos)) * min(10, 0.07 * max(0, cabs(target - e->pos) - VIEWPORT_W * 0.5 * nfocus));
+	complex v = sim_cexp(I*sim_carg(target - e->pos)) * min(10, 0.07 * max(0, sim_cabs(target - e->pos) - VIEWPORT_W * 0.5 * nfocus));
 	float s = sign(creal(e->pos) - creal(global.plr.pos));
 
 	if(!s) {
-		s = sign(sin(t/10.0));
+		s = sign(sim_sin(t/10.0));
 	}
 
-	float rot = clamp(0.005 * cabs(global.plr.pos - e->pos) - M_PI/6, 0, M_PI/8);
-	v *= cexp(I*rot*s);
+	float rot = clamp(0.005 * sim_cabs(global.plr.pos - e->pos) - M_PI/6, 0, M_PI/8);
+	v *= sim_cexp(I*rot*s);
 	e->pos += v;
 
 	if(!(plr->inputflags & INFLAG_SHOT) || !(plr->inputflags & INFLAG_FOCUS)) {
@@ -261,7 +261,7 @@ static int youmu_mirror_myon(Enemy *e, int t) {
 		double r1 = (psin(global.frames * 2.0) * 0.5 + 0.5) * 0.1;
 		double r2 = (psin(global.frames * 1.2) * 0.5 + 0.5) * 0.1;
 
-		double a = carg(e->args[0]);
+		double a = sim_carg(e->args[0]);
 		double f = smoothreclamp(0.5 + 0.5 * (1.0 - nfocus), 0, 1, 0, 1);
 		double u = 0; // smoothreclamp(1 - nfocus, 0, 1, 0, 1);
 
@@ -269,7 +269,7 @@ static int youmu_mirror_myon(Enemy *e, int t) {
 		r2 *= f;
 
 		int p = plr->power / 100;
-		int dmg_center = 180 - rint(160 * (1 - pow(1 - 0.25 * p, 2)));
+		int dmg_center = 180 - rint(160 * (1 - sim_pow(1 - 0.25 * p, 2)));
 		int dmg_side = 41 - 3 * p;
 
 		if(plr->power >= 100 && !((global.frames+0) % 6)) {
@@ -312,7 +312,7 @@ static int youmu_mirror_self_proj(Projectile *p, int t) {
 
 	complex diff = p->pos0 + v * t - p->pos;
 	p->pos += diff;
-	p->angle = carg(diff ? diff : v);
+	p->angle = sim_carg(diff ? diff : v);
 
 	return 1;
 }
@@ -325,7 +325,7 @@ static Projectile* youmu_mirror_self_shot(Player *plr, complex ofs, complex vel,
 		.draw_rule = myon_proj_draw,
 		.rule = youmu_mirror_self_proj,
 		.args = {
-			vel*0.2*cexp(I*M_PI*0.5*sign(creal(ofs))), vel, turntime,
+			vel*0.2*sim_cexp(I*M_PI*0.5*sign(creal(ofs))), vel, turntime,
 		},
 	);
 }
@@ -346,8 +346,8 @@ static void youmu_mirror_shot(Player *plr) {
 			int dmg = 21;
 			double spread = M_PI/64 * (1 + 0.5 * smoothreclamp(psin(global.frames/10.0), 0, 1, 0, 1));
 
-			youmu_mirror_self_shot(plr, (+10 + I*10), -(20.0-i)*I*cexp(-I*(1+i)*spread), dmg, 20);
-			youmu_mirror_self_shot(plr, (-10 + I*10), -(20.0-i)*I*cexp(+I*(1+i)*spread), dmg, 20);
+			youmu_mirror_self_shot(plr, (+10 + I*10), -(20.0-i)*I*sim_cexp(-I*(1+i)*spread), dmg, 20);
+			youmu_mirror_self_shot(plr, (-10 + I*10), -(20.0-i)*I*sim_cexp(+I*(1+i)*spread), dmg, 20);
 		}
 	}
 }
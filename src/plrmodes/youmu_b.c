@@ -63,7 +63,7 @@ static void youmu_trap_draw_child_proj(Projectile *p, int t) {
 }
 
 static float youmu_trap_charge(int t) {
-	return pow(clamp(t / 60.0, 0, 1), 1.5);
+	return sim_pow(clamp(t / 60.0, 0, 1), 1.5);
 }
 
 static Projectile* youmu_homing_trail(Projectile *p, complex v, int to) {
@@ -94,16 +94,16 @@ static int youmu_homing(Projectile *p, int t) { // a[0]: velocity, a[1]: aim (r:
 
 	p->args[3] = youmu_homing_target(p->pos, p->args[3]);
 
-	double v = cabs(p->args[0]);
-	complex aimdir = cexp(I*carg(p->args[3] - p->pos));
+	double v = sim_cabs(p->args[0]);
+	complex aimdir = sim_cexp(I*sim_carg(p->args[3] - p->pos));
 
 	p->args[0] += creal(p->args[1]) * aimdir;
-	// p->args[0] = v * cexp(I*carg(p->args[0])) + cimag(p->args[1]) * aimdir;
-	p->args[0] *= v / cabs(p->args[0]);
+	// p->args[0] = v * sim_cexp(I*sim_carg(p->args[0])) + cimag(p->args[1]) * aimdir;
+	p->args[0] *= v / sim_cabs(p->args[0]);
 
 	p->args[1] = creal(p->args[1]) + cimag(p->args[1]) * (1 + I);
 
-	p->angle = carg(p->args[0]);
+	p->angle = sim_carg(p->args[0]);
 	p->pos += p->args[0];
 
 	Projectile *trail = youmu_homing_trail(p, 0.5 * p->args[0], 12);
@@ -181,7 +181,7 @@ static int youmu_trap(Projectile *p, int t) {
 		for(int i = 0; i < cnt; ++i) {
 			int dur = 55 + 20 * nfrand();
 			float a = (i / (float)cnt) * M_PI * 2;
-			complex dir = cexp(I*(a));
+			complex dir = sim_cexp(I*(a));
 
 			PROJECTILE("youmu", p->pos, RGBA(1, 1, 1, 0.85), youmu_homing,
 				.args = { 5 * (1 + charge) * dir, aim, dur + charge*I, creal(p->pos) - VIEWPORT_H*I },
@@ -203,8 +203,8 @@ static int youmu_trap(Projectile *p, int t) {
 	p->angle = global.frames + t;
 	p->pos += p->args[0] * (0.01 + 0.99 * max(0, (10 - t) / 10.0));
 
-	youmu_trap_trail(p, cexp(I*p->angle), 30 * (1 + charge), true);
-	youmu_trap_trail(p, cexp(I*-p->angle), 30, false);
+	youmu_trap_trail(p, sim_cexp(I*p->angle), 30 * (1 + charge), true);
+	youmu_trap_trail(p, sim_cexp(I*-p->angle), 30, false);
 	return 1;
 }
 
@@ -250,7 +250,7 @@ static int youmu_particle_slice_logic(Projectile *p, int t) {
 
 	p->color = *RGBA(a, a, a, 0);
 
-	complex phase = cexp(p->angle*I);
+	complex phase = sim_cexp(p->angle*I);
 	if(t%5 == 0) {
 		tsrand_fill(4);
 		PARTICLE(
@@ -261,7 +261,7 @@ static int youmu_particle_slice_logic(Projectile *p, int t) {
 			.color = RGBA(0.1, 0.1, 0.5, 0),
 			.args = {
 				phase,
-				phase*cexp(0.1*I),
+				phase*sim_cexp(0.1*I),
 				afrand(1) + afrand(2)*I,
 				afrand(3) + 360.0*I*afrand(0)
 			},
@@ -288,7 +288,7 @@ static int youmu_slash(Enemy *e, int t) {
 
 	TIMER(&t);
 	FROM_TO(0,10000,3) {
-	complex pos = cexp(I*_i)*(100+10*_i*_i*0.01);
+	complex pos = sim_cexp(I*_i)*(100+10*_i*_i*0.01);
 		PARTICLE(
 			.sprite = "youmu_slice",
 			.color = RGBA(1, 1, 1, 0),
@@ -297,7 +297,7 @@ static int youmu_slash(Enemy *e, int t) {
 			.rule = youmu_particle_slice_logic,
 			.flags = PFLAG_NOREFLECT,
 			.timeout = 100,
-			.angle = carg(pos),
+			.angle = sim_carg(pos),
 			.layer = LAYER_PARTICLE_HIGH | 0x1,
 		);
 	}
@@ -310,17 +310,17 @@ static int youmu_asymptotic(Projectile *p, int t) {
 		return ACTION_ACK;
 	}
 
-	p->angle = carg(p->args[0]);
+	p->angle = sim_carg(p->args[0]);
 	p->args[1] *= 0.8;
 	p->pos += p->args[0] * (p->args[1] + 1);
 
-	youmu_homing_trail(p, cexp(I*p->angle), 5);
+	youmu_homing_trail(p, sim_cexp(I*p->angle), 5);
 	return 1;
 }
 
 static void youmu_haunting_power_shot(Player *plr, int p) {
 	int d = -2;
-	double spread = 0.5 * (1 + 0.25 * sin(global.frames/10.0));
+	double spread = 0.5 * (1 + 0.25 * sim_sin(global.frames/10.0));
 	double speed = 8;
 
 	if(2 * plr->power / 100 < p || (global.frames + d * p) % 12) {
@@ -330,7 +330,7 @@ static void youmu_haunting_power_shot(Player *plr, int p) {
 	float np = (float)p / (2 * plr->power / 100);
 
 	for(int sign = -1; sign < 2; sign += 2) {
-		complex dir = cexp(I*carg(sign*p*spread-speed*I));
+		complex dir = sim_cexp(I*sim_carg(sign*p*spread-speed*I));
 
 		PROJECTILE(
 			.sprite = "hghost",
@@ -338,7 +338,7 @@ static void youmu_haunting_power_shot(Player *plr, int p) {
 			.rule = youmu_asymptotic,
 			.color = RGB(0.7 + 0.3 * (1-np), 0.8 + 0.2 * sqrt(1-np), 1.0),
 			.draw_rule = youmu_homing_draw_proj,
-			.args = { speed * dir * (1 - 0.25 * (1 - np)), 3 * (1 - pow(1 - np, 2)), 60, },
+			.args = { speed * dir * (1 - 0.25 * (1 - np)), 3 * (1 - sim_pow(1 - np, 2)), 60, },
 			.type = PlrProj,
 			.damage = 30,
 			.shader = "sprite_default",
@@ -355,7 +355,7 @@ static void youmu_haunting_shot(Player *plr) {
 
 			if(!(global.frames % (45 - 4 * pwr))) {
 				int pcnt = 11 + pwr * 4;
-				int pdmg = 120 - 18 * 4 * (1 - pow(1 - pwr / 4.0, 1.5));
+				int pdmg = 120 - 18 * 4 * (1 - sim_pow(1 - pwr / 4.0, 1.5));
 				complex aim = 0.15*I;
 
 				PROJECTILE("youhoming", plr->pos, RGB(1, 1, 1), youmu_trap,
@@ -14,6 +14,7 @@
 #include "global.h"
 #include "list.h"
 #include "stageobjects.h"
+#include "enemygrid.h"
 
 static ProjArgs defaults_proj = {
 	.sprite = "proj/",
@@ -150,13 +151,82 @@ static inline char* event_name(int ev) {
 	log_fatal("Bad event %i", ev);
 }
 
+static inline int proj_rule_linear(Projectile *p, int t) { // sure is physics in here; a[0]: velocity
+	if(t == EVENT_DEATH) {
+		return ACTION_ACK;
+	}
+
+	p->angle = sim_carg(p->args[0]);
+
+	if(t == EVENT_BIRTH) {
+		return ACTION_ACK;
+	}
+
+	p->pos = p->pos0 + p->args[0]*t;
+
+	return ACTION_NONE;
+}
+
+static inline int proj_rule_accelerated(Projectile *p, int t) {
+	if(t == EVENT_DEATH) {
+		return ACTION_ACK;
+	}
+
+	p->angle = sim_carg(p->args[0]);
+
+	if(t == EVENT_BIRTH) {
+		return ACTION_ACK;
+	}
+
+	p->pos += p->args[0];
+	p->args[0] += p->args[1];
+
+	return 1;
+}
+
+static inline int proj_rule_asymptotic(Projectile *p, int t) { // v = a[0]*(a[1] + 1); a[1] -> 0
+	if(t == EVENT_DEATH) {
+		return ACTION_ACK;
+	}
+
+	p->angle = sim_carg(p->args[0]);
+
+	if(t == EVENT_BIRTH) {
+		return ACTION_ACK;
+	}
+
+	p->args[1] *= 0.8;
+	p->pos += p->args[0]*(p->args[1] + 1);
+
+	return 1;
+}
+
+static inline int proj_dispatch_rule(Projectile *p, int t) {
+	// The vast majority of projectiles use one of the built-in rules.
+	// Calling those directly lets them get inlined into the update loop.
+
+	if(p->rule == linear) {
+		return proj_rule_linear(p, t);
+	}
+
+	if(p->rule == accelerated) {
+		return proj_rule_accelerated(p, t);
+	}
+
+	if(p->rule == asymptotic) {
+		return proj_rule_asymptotic(p, t);
+	}
+
+	return p->rule(p, t);
+}
+
 static inline int proj_call_rule(Projectile *p, int t) {
 	int result = ACTION_NONE;
 
 	if(p->timeout > 0 && t >= p->timeout) {
 		result = ACTION_DESTROY;
 	} else if(p->rule != NULL) {
-		result = p->rule(p, t);
+		result = proj_dispatch_rule(p, t);
 
 		if(t < 0 && result != ACTION_ACK) {
 			set_debug_info(&p->debug);
@@ -203,12 +273,18 @@ static double projectile_rect_area(Projectile *p) {
 	return w * h;
 }
 
+static inline ObjectPool* projectile_pool(ProjectileList *projlist) {
+	// Particles come and go much faster than anything else, so they get a pool of their own
+	// to keep them from fragmenting the one used by actual projectiles.
+	return projlist == &global.particles ? stage_object_pools.particles : stage_object_pools.projectiles;
+}
+
 static Projectile* _create_projectile(ProjArgs *args) {
 	if(IN_DRAW_CODE) {
 		log_fatal("Tried to spawn a projectile while in drawing code");
 	}
 
-	Projectile *p = (Projectile*)objpool_acquire(stage_object_pools.projectiles);
+	Projectile *p = (Projectile*)objpool_acquire(projectile_pool(args->dest));
 
 	p->birthtime = global.frames;
 	p->pos = p->pos0 = p->prevpos = args->pos;
@@ -292,28 +368,43 @@ Projectile* _proj_attach_dbginfo(Projectile *p, DebugInfo *dbg, const char *call
 }
 #endif
 
-static void* _delete_projectile(ListAnchor *projlist, List *proj, void *arg) {
-	Projectile *p = (Projectile*)proj;
-	ProjectileListInterface *out_list_pointers = arg;
+static void teardown_projectile(Projectile *p) {
 	proj_call_rule(p, EVENT_DEATH);
+	del_ref(p);
+	ent_unregister(&p->ent);
+}
+
+void delete_projectile(ProjectileList *projlist, Projectile *proj, ProjectileListInterface *out_list_pointers) {
+	teardown_projectile(proj);
 
 	if(out_list_pointers) {
-		*&out_list_pointers->list_interface = p->list_interface;
+		*&out_list_pointers->list_interface = proj->list_interface;
 	}
 
-	del_ref(proj);
-	ent_unregister(&p->ent);
-	objpool_release(stage_object_pools.projectiles, (ObjectInterface*)alist_unlink(projlist, proj));
-
-	return NULL;
+	objpool_release(projectile_pool(projlist), (ObjectInterface*)alist_unlink(projlist, proj));
 }
 
-void delete_projectile(ProjectileList *projlist, Projectile *proj, ProjectileListInterface *out_list_pointers) {
-	_delete_projectile((ListAnchor*)projlist, (List*)proj, out_list_pointers);
+void delete_projectiles(ProjectileList *projlist) {
+	// Death rules may still spawn more objects into this list; those are torn down as well.
+	// They must not delete anything from it, though, or the walk below would follow freed links.
+	IF_OBJPOOL_DEBUG(ObjectPool *pool = projectile_pool(projlist);)
+
+	for(Projectile *p = projlist->first; p; p = p->next) {
+		IF_OBJPOOL_DEBUG(uint32_t gen = objpool_object_generation(pool, &p->object_interface);)
+		teardown_projectile(p);
+
+		IF_OBJPOOL_DEBUG({
+			if(objpool_object_generation(pool, &p->object_interface) != gen) {
+				log_fatal("Projectile %p was deleted by a death rule while its list was being deleted", (void*)p);
+			}
+		})
+	}
+
+	objpool_release_list(projectile_pool(projlist), (ListAnchor*)projlist);
 }
 
-void delete_projectiles(ProjectileList *projlist) {
-	alist_foreach(projlist, _delete_projectile, NULL);
+static bool projectile_collision_filter(Enemy *e, void *arg) {
+	return e->hp != ENEMY_IMMUNE;
 }
 
 void calc_projectile_collision(Projectile *p, ProjCollisionResult *out_col) {
@@ -337,7 +428,7 @@ void calc_projectile_collision(Projectile *p, ProjCollisionResult *out_col) {
 			.b = global.plr.pos - p->pos
 		};
 
-		attr_unused double seglen = cabs(seg.a - seg.b);
+		attr_unused double seglen = sim_cabs(seg.a - seg.b);
 
 		if(seglen > 30) {
 			log_debug(
@@ -345,7 +436,7 @@ void calc_projectile_collision(Projectile *p, ProjCollisionResult *out_col) {
 					? "Lerp over HUGE distance %f; this is ABSOLUTELY a bug! Player speed was %f. Spawned at %s:%d (%s)"
 					: "Lerp over large distance %f; this is either a bug or a very fast projectile, investigate. Player speed was %f. Spawned at %s:%d (%s)",
 				seglen,
-				cabs(global.plr.velocity),
+				sim_cabs(global.plr.velocity),
 				p->debug.file,
 				p->debug.line,
 				p->debug.func
@@ -366,17 +457,17 @@ void calc_projectile_collision(Projectile *p, ProjCollisionResult *out_col) {
 			}
 		}
 	} else if(p->type == PlrProj) {
-		for(Enemy *e = global.enemies.first; e; e = e->next) {
-			if(e->hp != ENEMY_IMMUNE && cabs(e->pos - p->pos) < 30) {
-				out_col->type = PCOL_ENTITY;
-				out_col->entity = &e->ent;
-				out_col->fatal = true;
+		Enemy *e = enemygrid_find_first(p->pos, 30, projectile_collision_filter, NULL);
 
-				return;
-			}
+		if(e) {
+			out_col->type = PCOL_ENTITY;
+			out_col->entity = &e->ent;
+			out_col->fatal = true;
+
+			return;
 		}
 
-		if(global.boss && cabs(global.boss->pos - p->pos) < 42) {
+		if(global.boss && sim_cabs(global.boss->pos - p->pos) < 42) {
 			if(boss_is_vulnerable(global.boss)) {
 				out_col->type = PCOL_ENTITY;
 				out_col->entity = &global.boss->ent;
@@ -474,7 +565,7 @@ Projectile* spawn_projectile_collision_effect(Projectile *proj) {
 		.rule = linear,
 		.draw_rule = DeathShrink,
 		.angle = proj->angle,
-		.args = { 5*cexp(I*proj->angle) },
+		.args = { 5*sim_cexp(I*proj->angle) },
 		.timeout = 10,
 	);
 }
@@ -534,6 +625,9 @@ void process_projectiles(ProjectileList *projlist, bool collision) {
 	int action;
 
 	for(Projectile *proj = projlist->first; proj; proj = list_ptrs.next) {
+		// Projectiles are scattered all over the pool; get the next one on its way while we're busy with this one.
+		PREFETCH(proj->next);
+
 		proj->prevpos = proj->pos;
 		action = proj_call_rule(proj, global.frames - proj->birthtime);
 		*&list_ptrs.list_interface = proj->list_interface;
@@ -578,7 +672,7 @@ int trace_projectile(Projectile *p, ProjCollisionResult *out_col, ProjCollisionT
 	int t;
 
 	for(t = timeofs; p; ++t) {
-		int action = p->rule(p, t);
+		int action = proj_dispatch_rule(p, t);
 		calc_projectile_collision(p, out_col);
 
 		if(out_col->type & stopflags || action == ACTION_DESTROY) {
@@ -601,54 +695,16 @@ bool projectile_is_clearable(Projectile *p) {
 	return false;
 }
 
-int linear(Projectile *p, int t) { // sure is physics in here; a[0]: velocity
-	if(t == EVENT_DEATH) {
-		return ACTION_ACK;
-	}
-
-	p->angle = carg(p->args[0]);
-
-	if(t == EVENT_BIRTH) {
-		return ACTION_ACK;
-	}
-
-	p->pos = p->pos0 + p->args[0]*t;
-
-	return ACTION_NONE;
+int linear(Projectile *p, int t) {
+	return proj_rule_linear(p, t);
 }
 
 int accelerated(Projectile *p, int t) {
-	if(t == EVENT_DEATH) {
-		return ACTION_ACK;
-	}
-
-	p->angle = carg(p->args[0]);
-
-	if(t == EVENT_BIRTH) {
-		return ACTION_ACK;
-	}
-
-	p->pos += p->args[0];
-	p->args[0] += p->args[1];
-
-	return 1;
+	return proj_rule_accelerated(p, t);
 }
 
-int asymptotic(Projectile *p, int t) { // v = a[0]*(a[1] + 1); a[1] -> 0
-	if(t == EVENT_DEATH) {
-		return ACTION_ACK;
-	}
-
-	p->angle = carg(p->args[0]);
-
-	if(t == EVENT_BIRTH) {
-		return ACTION_ACK;
-	}
-
-	p->args[1] *= 0.8;
-	p->pos += p->args[0]*(p->args[1] + 1);
-
-	return 1;
+int asymptotic(Projectile *p, int t) {
+	return proj_rule_asymptotic(p, t);
 }
 
 static inline void apply_common_transforms(Projectile *proj, int t) {
@@ -767,7 +823,7 @@ void ScaleFade(Projectile *p, int t) {
 	double scale_max = cimag(p->args[2]);
 	double timefactor = t / (double)p->timeout;
 	double scale = scale_min * (1 - timefactor) + scale_max * timefactor;
-	double alpha = pow(1 - timefactor, 2);
+	double alpha = sim_pow(1 - timefactor, 2);
 
 	r_mat_scale(scale, scale, 1);
 	ProjDrawCore(p, color_mul_scalar(COLOR_COPY(&p->color), alpha));
@@ -798,11 +854,11 @@ void petal_explosion(int n, complex pos) {
 		PARTICLE(
 			.sprite = "petal",
 			.pos = pos,
-			.color = RGBA_MUL_ALPHA(sin(5*t) * t, cos(5*t) * t, 0.5 * t, 0),
+			.color = RGBA_MUL_ALPHA(sim_sin(5*t) * t, sim_cos(5*t) * t, 0.5 * t, 0),
 			.rule = asymptotic,
 			.draw_rule = Petal,
 			.args = {
-				(3+5*afrand(2))*cexp(I*M_PI*2*afrand(3)),
+				(3+5*afrand(2))*sim_cexp(I*M_PI*2*afrand(3)),
 				5,
 				afrand(4) + afrand(5)*I,
 				afrand(1) + 360.0*I*afrand(0),
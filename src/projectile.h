@@ -61,34 +61,38 @@ typedef struct ProjPrototype ProjPrototype;
 struct Projectile {
 	ENTITY_INTERFACE_NAMED(Projectile, ent);
 
+	// NOTE: the fields process_projectiles() touches on every frame go first, so that updating
+	// a projectile pulls in as few cache lines as possible. Keep the drawing-only stuff at the end.
+
 	complex pos;
 	complex pos0;
 	complex prevpos; // used to lerp trajectory for collision detection; set this to pos if you intend to "teleport" the projectile in the rule!
-	complex size; // affects out-of-viewport culling and grazing
-	complex collision_size; // affects collision with player (TODO: make this work for player projectiles too?)
 	complex args[RULE_ARGC];
 	ProjRule rule;
-	ProjDrawRule draw_rule;
-	ShaderProgram *shader;
-	Sprite *sprite;
-	ProjPrototype *proto;
-	Color color;
-	ShaderCustomParams shader_params;
-	BlendMode blend;
 	int birthtime;
-	float damage;
-	float angle;
-	ProjType type;
-	DamageType damage_type;
-	int max_viewport_dist;
-	ProjFlags flags;
 
 	// XXX: this is in frames of course, but needs to be float
 	// to avoid subtle truncation and integer division gotchas.
 	float timeout;
 
+	ProjType type;
+	ProjFlags flags;
 	int graze_counter_reset_timer;
 	short graze_counter;
+	float angle;
+	complex size; // affects out-of-viewport culling and grazing
+	complex collision_size; // affects collision with player (TODO: make this work for player projectiles too?)
+	int max_viewport_dist;
+	float damage;
+	DamageType damage_type;
+	Sprite *sprite;
+
+	ProjDrawRule draw_rule;
+	ShaderProgram *shader;
+	ProjPrototype *proto;
+	Color color;
+	ShaderCustomParams shader_params;
+	BlendMode blend;
 
 #ifdef PROJ_DEBUG
 	DebugInfo debug;
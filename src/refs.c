@@ -10,8 +10,18 @@
 
 #include "global.h"
 #include "refs.h"
+#include "hashtable.h"
 
-void *_FREEREF;
+RefTable _refs;
+
+// Slots of referenced pointers that aren't entities, keyed by address.
+static ht_int2int_t ptr_slots;
+static bool ptr_slots_created;
+
+#define ENT_TYPE(typename, id) \
+	static_assert(_REF_ENTITY_DISPATCH((typename*)NULL, 1, 0), "_REF_ENTITY_DISPATCH doesn't handle " #typename);
+ENT_TYPES
+#undef ENT_TYPE
 
 #ifdef DEBUG
 	// #define DEBUG_REFS
@@ -23,71 +33,173 @@ void *_FREEREF;
 	#define REFLOG(...)
 #endif
 
-int add_ref(void *ptr) {
-	int i, firstfree = -1;
+static inline RefHandle make_handle(uint32_t slot) {
+	return (RefHandle)(slot | ((uint64_t)_refs.slots[slot].generation << REF_SLOT_BITS));
+}
+
+static RefSlot *resolve_handle(RefHandle handle) {
+	uint32_t slot = (uint64_t)handle & REF_SLOT_MASK;
+
+	if(handle <= 0 || slot >= _refs.num_slots) {
+		return NULL;
+	}
+
+	RefSlot *s = _refs.slots + slot;
+
+	if(s->refs <= 0 || s->generation != ((uint64_t)handle >> REF_SLOT_BITS)) {
+		return NULL;
+	}
+
+	return s;
+}
+
+static uint32_t alloc_slot(void *ptr, bool is_entity) {
+	uint32_t slot = _refs.free_list;
+
+	if(slot) {
+		_refs.free_list = _refs.slots[slot].next_free;
+	} else {
+		if(_refs.num_slots == 0) {
+			// slot 0 is reserved, so that 0 is never a valid handle
+			_refs.num_slots = 1;
+		}
+
+		if(_refs.num_slots == _refs.capacity) {
+			if(_refs.capacity > REF_SLOT_MASK) {
+				log_fatal("Too many references");
+			}
 
-	for(i = 0; i < global.refs.count; i++) {
-		if(global.refs.ptrs[i].ptr == ptr) {
-			global.refs.ptrs[i].refs++;
-			REFLOG("increased refcount for %p (ref %i): %i", ptr, i, global.refs.ptrs[i].refs);
-			return i;
-		} else if(firstfree < 0 && global.refs.ptrs[i].ptr == FREEREF) {
-			firstfree = i;
+			_refs.capacity = _refs.capacity ? _refs.capacity * 2 : 64;
+			_refs.slots = realloc(_refs.slots, _refs.capacity * sizeof(*_refs.slots));
+			memset(_refs.slots + _refs.num_slots, 0, (_refs.capacity - _refs.num_slots) * sizeof(*_refs.slots));
 		}
+
+		slot = _refs.num_slots++;
 	}
 
-	if(firstfree >= 0) {
-		global.refs.ptrs[firstfree].ptr = ptr;
-		global.refs.ptrs[firstfree].refs = 1;
-		REFLOG("found free ref for %p: %i", ptr, firstfree);
-		return firstfree;
+	RefSlot *s = _refs.slots + slot;
+	s->ptr = ptr;
+	s->refs = 1;
+	s->is_entity = is_entity;
+	s->next_free = 0;
+
+	return slot;
+}
+
+static bool entity_owns_slot(EntityInterface *ent) {
+	uint32_t slot = ent->ref_slot;
+	return slot && slot < _refs.num_slots && _refs.slots[slot].ptr == ent && _refs.slots[slot].refs > 0;
+}
+
+RefHandle _add_ref_ptr(void *ptr) {
+	if(!ptr_slots_created) {
+		ht_create(&ptr_slots);
+		ptr_slots_created = true;
 	}
 
-	global.refs.ptrs = realloc(global.refs.ptrs, (++global.refs.count)*sizeof(Reference));
-	global.refs.ptrs[global.refs.count - 1].ptr = ptr;
-	global.refs.ptrs[global.refs.count - 1].refs = 1;
-	REFLOG("new ref for %p: %i", ptr, global.refs.count - 1);
+	int64_t key = (int64_t)(uintptr_t)ptr;
+	uint32_t slot = ht_get(&ptr_slots, key, 0);
 
-	return global.refs.count - 1;
+	if(slot) {
+		RefSlot *s = _refs.slots + slot;
+		assert(s->ptr == ptr && s->refs > 0);
+		s->refs++;
+		REFLOG("increased refcount for %p (ref %u): %i", ptr, slot, s->refs);
+		return make_handle(slot);
+	}
+
+	slot = alloc_slot(ptr, false);
+	ht_set(&ptr_slots, key, slot);
+	REFLOG("new ref for %p: %u", ptr, slot);
+	return make_handle(slot);
 }
 
-void del_ref(void *ptr) {
-	int i;
+RefHandle _add_ref_entity(void *ptr) {
+	EntityInterface *ent = ptr;
+
+	if(entity_owns_slot(ent)) {
+		RefSlot *s = _refs.slots + ent->ref_slot;
+		s->refs++;
+		REFLOG("increased refcount for %p (ref %u): %i", ptr, ent->ref_slot, s->refs);
+		return make_handle(ent->ref_slot);
+	}
 
-	for(i = 0; i < global.refs.count; i++)
-		if(global.refs.ptrs[i].ptr == ptr)
-			global.refs.ptrs[i].ptr = NULL;
+	ent->ref_slot = alloc_slot(ent, true);
+	REFLOG("new ref for entity %p: %u", ptr, ent->ref_slot);
+	return make_handle(ent->ref_slot);
 }
 
-void free_ref(int i) {
-	if(i < 0)
+void _del_ref_entity(EntityInterface *ent) {
+	if(entity_owns_slot(ent)) {
+		_refs.slots[ent->ref_slot].ptr = NULL;
+		REFLOG("invalidated ref %u", ent->ref_slot);
+	}
+
+	ent->ref_slot = 0;
+}
+
+void *_ref_get_entity(RefHandle handle, uint type) {
+	RefSlot *s = resolve_handle(handle);
+
+	if(!s || !s->ptr || !s->is_entity) {
+		return NULL;
+	}
+
+	EntityInterface *ent = s->ptr;
+	return ent->type == type ? ent : NULL;
+}
+
+void free_ref(RefHandle handle) {
+	RefSlot *s = resolve_handle(handle);
+
+	if(!s) {
 		return;
+	}
 
-	global.refs.ptrs[i].refs--;
-	REFLOG("decreased refcount for %p (ref %i): %i", global.refs.ptrs[i].ptr, i, global.refs.ptrs[i].refs);
+	uint32_t slot = s - _refs.slots;
+	s->refs--;
+	REFLOG("decreased refcount for %p (ref %u): %i", s->ptr, slot, s->refs);
+
+	if(s->refs > 0) {
+		return;
+	}
 
-	if(global.refs.ptrs[i].refs <= 0) {
-		global.refs.ptrs[i].ptr = FREEREF;
-		global.refs.ptrs[i].refs = 0;
-		REFLOG("ref %i is now free", i);
+	if(s->is_entity) {
+		if(s->ptr) {
+			((EntityInterface*)s->ptr)->ref_slot = 0;
+		}
+	} else {
+		ht_unset(&ptr_slots, (int64_t)(uintptr_t)s->ptr);
 	}
+
+	s->ptr = NULL;
+	s->refs = 0;
+	s->generation++;
+	s->next_free = _refs.free_list;
+	_refs.free_list = slot;
+	REFLOG("ref %u is now free", slot);
 }
 
 void free_all_refs(void) {
 	int inuse = 0;
 	int inuse_unique = 0;
 
-	for(int i = 0; i < global.refs.count; i++) {
-		if(global.refs.ptrs[i].refs) {
-			inuse += global.refs.ptrs[i].refs;
+	for(uint32_t i = 1; i < _refs.num_slots; i++) {
+		if(_refs.slots[i].refs > 0) {
+			inuse += _refs.slots[i].refs;
 			inuse_unique += 1;
 		}
 	}
 
 	if(inuse) {
-		log_warn("%i refs were still in use (%i unique, %i total allocated)", inuse, inuse_unique, global.refs.count);
+		log_warn("%i refs were still in use (%i unique, %u total allocated)", inuse, inuse_unique, _refs.num_slots - 1);
 	}
 
-	free(global.refs.ptrs);
-	memset(&global.refs, 0, sizeof(RefArray));
+	free(_refs.slots);
+	memset(&_refs, 0, sizeof(_refs));
+
+	if(ptr_slots_created) {
+		ht_destroy(&ptr_slots);
+		ptr_slots_created = false;
+	}
 }
@@ -9,20 +9,93 @@
 #pragma once
 #include "taisei.h"
 
-typedef struct {
+/*
+ * Handles are slot indices tagged with the generation of the slot at the time the
+ * reference was taken. Freeing a slot bumps its generation, so stale handles resolve
+ * to NULL instead of aliasing whatever reuses the slot. Generations are 32 bits wide,
+ * so a handle only comes back after a slot has been reused 2^32 times. Handles are
+ * positive integers below 2^52, so they survive being stored in the complex args of
+ * entities exactly. Slot 0 is never used, which makes 0 a valid "no reference" value.
+ *
+ * Every referenced object has a single refcounted slot. Entities remember theirs, so
+ * referencing an already referenced entity and invalidating references on death are
+ * O(1), without any scans; other pointers are looked up in a hashtable.
+ */
+
+typedef int64_t RefHandle;
+
+#define REF_SLOT_BITS 20
+#define REF_SLOT_MASK ((1u << REF_SLOT_BITS) - 1)
+
+typedef struct RefSlot {
 	void *ptr;
 	int refs;
-} Reference;
-
-typedef struct {
-	Reference *ptrs;
-	int count;
-} RefArray;
-
-extern void *_FREEREF;
-#define FREEREF &_FREEREF
-#define REF(p) (global.refs.ptrs[(int)(p)].ptr)
-int add_ref(void *ptr);
-void del_ref(void *ptr);
-void free_ref(int i);
+	uint32_t generation;
+	bool is_entity;
+	uint32_t next_free;
+} RefSlot;
+
+typedef struct RefTable {
+	RefSlot *slots;
+	uint32_t num_slots;
+	uint32_t capacity;
+	uint32_t free_list;
+} RefTable;
+
+extern RefTable _refs;
+
+typedef struct EntityInterface EntityInterface;
+typedef struct Projectile Projectile;
+typedef struct Laser Laser;
+typedef struct Enemy Enemy;
+typedef struct Boss Boss;
+typedef struct Player Player;
+typedef struct Item Item;
+
+RefHandle _add_ref_ptr(void *ptr);
+RefHandle _add_ref_entity(void *ent) attr_nonnull(1);
+void _del_ref_entity(EntityInterface *ent) attr_nonnull(1);
+void *_ref_get_entity(RefHandle handle, uint type);
+
+static inline attr_must_inline void *ref_get(RefHandle handle) {
+	uint32_t slot = (uint64_t)handle & REF_SLOT_MASK;
+
+	if(handle <= 0 || slot >= _refs.num_slots) {
+		return NULL;
+	}
+
+	RefSlot *s = _refs.slots + slot;
+
+	if(s->generation != ((uint64_t)handle >> REF_SLOT_BITS)) {
+		return NULL;
+	}
+
+	return s->ptr;
+}
+
+// Must cover every type in ENT_TYPES; refs.c checks this at compile time.
+#define _REF_ENTITY_DISPATCH(p, ent_func, ptr_func) _Generic((p), \
+	EntityInterface*: ent_func, \
+	Projectile*: ent_func, \
+	Laser*: ent_func, \
+	Enemy*: ent_func, \
+	Boss*: ent_func, \
+	Player*: ent_func, \
+	Item*: ent_func, \
+	default: ptr_func \
+)
+
+// Returns the referenced pointer, or NULL if it was freed or deleted.
+#define REF(h) ref_get((RefHandle)(h))
+
+// Like REF, but also NULL if the handle doesn't refer to an entity of the given type.
+#define REF_ENT(h, typename) ((typename*)_ref_get_entity((RefHandle)(h), ENT_TYPE_ID(typename)))
+
+// Every referenced object has one refcounted slot; referencing it again returns the same handle.
+#define add_ref(p) _REF_ENTITY_DISPATCH(p, _add_ref_entity, _add_ref_ptr)(p)
+
+// Invalidates all references to an entity that is about to be deleted.
+#define del_ref(ent) _del_ref_entity(&(ent)->entity_interface)
+
+void free_ref(RefHandle handle);
 void free_all_refs(void);
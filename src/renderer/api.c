@@ -24,6 +24,9 @@ static struct {
 		ShaderProgram *standard;
 		ShaderProgram *standardnotex;
 	} progs;
+
+	// bumped whenever a program is destroyed; see r_uniform_layout
+	uint prog_generation;
 } R;
 
 void r_init(void) {
@@ -45,7 +48,6 @@ void r_post_init(void) {
 
 	preload_resources(RES_SHADER_PROGRAM, RESF_PERMANENT,
 		"sprite_default",
-		"texture_post_load",
 		"standard",
 		"standardnotex",
 	NULL);
@@ -213,6 +215,7 @@ static VertexAttribTypeInfo va_type_info[] = {
 	[VA_USHORT] = VATYPE(uint16_t),
 	[VA_INT]    = VATYPE(int32_t),
 	[VA_UINT]   = VATYPE(uint32_t),
+	[VA_HALF_FLOAT] = VATYPE(uint16_t),
 };
 
 const VertexAttribTypeInfo* r_vertex_attrib_type_info(VertexAttribType type) {
@@ -265,6 +268,10 @@ SDL_Window* r_create_window(const char *title, int x, int y, int w, int h, uint3
 	return B.create_window(title, x, y, w, h, flags);
 }
 
+void r_destroy_window(SDL_Window *window) {
+	B.destroy_window(window);
+}
+
 bool r_supports(RendererFeature feature) {
 	return B.supports(feature);
 }
@@ -349,7 +356,12 @@ ShaderProgram* r_shader_program_link(uint num_objects, ShaderObject *shobjs[num_
 }
 
 void r_shader_program_destroy(ShaderProgram *prog) {
+	if(r_shader_current() == prog && prog != R.progs.standard) {
+		r_shader_standard();
+	}
+
 	B.shader_program_destroy(prog);
+	++R.prog_generation;
 }
 
 void r_shader_program_set_debug_label(ShaderProgram *prog, const char *label) {
@@ -373,11 +385,46 @@ Uniform* r_shader_uniform(ShaderProgram *prog, const char *uniform_name) {
 	return B.shader_uniform(prog, uniform_name);
 }
 
+Uniform** r_uniform_layout(UniformLayout *layout, ShaderProgram *prog) {
+	// a destroyed program's address may be reused, so the pointers alone can't be trusted
+	if(layout->prog_generation != R.prog_generation) {
+		memset(layout->programs, 0, sizeof(layout->programs));
+		layout->next_program = 0;
+		layout->prog_generation = R.prog_generation;
+	}
+
+	for(uint i = 0; i < R_UNIFORM_LAYOUT_PROGRAMS; ++i) {
+		if(layout->programs[i].prog == prog) {
+			return layout->programs[i].uniforms;
+		}
+	}
+
+	// evict the oldest one
+	UniformLayoutProgram *p = layout->programs + layout->next_program;
+	layout->next_program = (layout->next_program + 1) % R_UNIFORM_LAYOUT_PROGRAMS;
+	p->prog = prog;
+
+	for(uint i = 0; i < R_UNIFORM_LAYOUT_MAX && layout->names[i]; ++i) {
+		p->uniforms[i] = B.shader_uniform(prog, layout->names[i]);
+	}
+
+	return p->uniforms;
+}
+
 UniformType r_uniform_type(Uniform *uniform) {
 	return B.uniform_type(uniform);
 }
 
 void r_draw(Primitive prim, uint first, uint count, uint32_t *indices, uint instances, uint base_instance) {
+	// pending sprites go first; this returns right away when called from r_flush_sprites itself
+	r_flush_sprites();
+
+	// set here rather than by the backend, so that a deferred draw sees the state at the time of the call
+	r_uniform_mat4("r_modelViewMatrix", *_r_matrices.modelview.head);
+	r_uniform_mat4("r_projectionMatrix", *_r_matrices.projection.head);
+	r_uniform_mat4("r_textureMatrix", *_r_matrices.texture.head);
+	r_uniform_vec4_rgba("r_color", r_color_current());
+
 	B.draw(prim, first, count, indices, instances, base_instance);
 }
 
@@ -466,6 +513,7 @@ uint r_framebuffer_get_attachment_mipmap(Framebuffer *fb, FramebufferAttachment
 }
 
 void r_framebuffer_clear(Framebuffer *fb, ClearBufferFlags flags, const Color *colorval, float depthval) {
+	r_flush_sprites();
 	B.framebuffer_clear(fb, flags, colorval, depthval);
 }
 
@@ -558,6 +606,10 @@ void r_vertex_array_set_debug_label(VertexArray *varr, const char* label) {
 }
 
 void r_vertex_array_destroy(VertexArray *varr) {
+	if(r_vertex_array_current() == varr && varr != r_vertex_array_static_models()) {
+		r_vertex_array(r_vertex_array_static_models());
+	}
+
 	B.vertex_array_destroy(varr);
 }
 
@@ -593,6 +645,7 @@ VsyncMode r_vsync_current(void) {
 
 void r_swap(SDL_Window *window) {
 	_r_sprite_batch_end_frame();
+	r_flush_sprites();
 	B.swap(window);
 }
 
@@ -36,6 +36,7 @@ typedef enum RendererFeature {
 	RFEAT_DEPTH_TEXTURE,
 	RFEAT_FRAMEBUFFER_MULTIPLE_OUTPUTS,
 	RFEAT_TEXTURE_BOTTOMLEFT_ORIGIN,
+	RFEAT_VERTEX_HALF_FLOAT,
 
 	NUM_RFEATS,
 } RendererFeature;
@@ -149,6 +150,7 @@ typedef enum VertexAttribType {
 	VA_USHORT,
 	VA_INT,
 	VA_UINT,
+	VA_HALF_FLOAT,
 } VertexAttribType;
 
 typedef struct VertexAttribTypeInfo {
@@ -163,7 +165,7 @@ typedef enum VertexAttribConversion {
 } VertexAttribConversion;
 
 typedef struct VertexAttribSpec {
-	uint8_t elements;
+	uint8_t elements; // 0 leaves this attribute location disabled
 	VertexAttribType type;
 	VertexAttribConversion coversion;
 	uint divisor;
@@ -382,6 +384,13 @@ typedef struct SpriteParams {
 SDL_Window* r_create_window(const char *title, int x, int y, int w, int h, uint32_t flags)
 	attr_nonnull(1) attr_nodiscard;
 
+/*
+ * Destroys a window created by r_create_window. Use this instead of SDL_DestroyWindow,
+ * so that the renderer can stop using the window first.
+ */
+
+void r_destroy_window(SDL_Window *window) attr_nonnull(1);
+
 /*
  *	TODO: Document these, and put them in an order that makes a little bit of sense.
  */
@@ -426,6 +435,38 @@ Uniform* r_shader_uniform(ShaderProgram *prog, const char *uniform_name) attr_no
 UniformType r_uniform_type(Uniform *uniform);
 void r_uniform_ptr_unsafe(Uniform *uniform, uint offset, uint count, void *data);
 
+/*
+ * A uniform layout maps a fixed list of uniform names to their handles in shader programs.
+ * The names are looked up the first time the layout is used with a program, and the handles
+ * are kept for the last R_UNIFORM_LAYOUT_PROGRAMS programs (until any program is destroyed),
+ * so hot draw paths can set their uniforms without a string lookup per call, even when they
+ * alternate between several programs.
+ *
+ *	enum { U_WIDTH, U_SPAN };
+ *	static UniformLayout layout = { .names = { [U_WIDTH] = "width", [U_SPAN] = "span" } };
+ *	Uniform **u = r_uniform_layout(&layout, r_shader_current());
+ *	r_uniform_float(u[U_WIDTH], w);
+ *
+ * Uniforms the program doesn't have resolve to NULL, which the setters ignore.
+ */
+
+#define R_UNIFORM_LAYOUT_MAX 16
+#define R_UNIFORM_LAYOUT_PROGRAMS 16
+
+typedef struct UniformLayoutProgram {
+	ShaderProgram *prog;
+	Uniform *uniforms[R_UNIFORM_LAYOUT_MAX];
+} UniformLayoutProgram;
+
+typedef struct UniformLayout {
+	const char *names[R_UNIFORM_LAYOUT_MAX];
+	UniformLayoutProgram programs[R_UNIFORM_LAYOUT_PROGRAMS];
+	uint next_program;
+	uint prog_generation;
+} UniformLayout;
+
+Uniform** r_uniform_layout(UniformLayout *layout, ShaderProgram *prog) attr_nonnull(1, 2) attr_returns_nonnull;
+
 #define _R_UNIFORM_GENERIC(suffix, uniform, ...) (_Generic((uniform), \
 	 char* : _r_uniform_##suffix, \
 	 Uniform* : _r_uniform_ptr_##suffix \
@@ -663,6 +704,11 @@ void r_shader_standard_notex(void);
 VertexBuffer* r_vertex_buffer_static_models(void) attr_returns_nonnull;
 VertexArray* r_vertex_array_static_models(void) attr_returns_nonnull;
 
+// Manage space for model vertices in the static models buffer, in units of GenericModelVertex.
+// Freed ranges are reused by later allocations.
+bool r_static_models_alloc(uint num_vertices, uint *out_first) attr_nonnull(2);
+void r_static_models_free(uint first, uint num_vertices);
+
 void r_state_push(void);
 void r_state_pop(void);
 
@@ -673,6 +719,11 @@ void r_draw_sprite(const SpriteParams *params) attr_nonnull(1);
 
 void r_flush_sprites(void);
 
+// Between these calls, sprites may be reordered to group them by texture, shader and blend mode,
+// as long as no two overlapping sprites swap places. Calls may be nested.
+void r_sprites_defer_begin(void);
+void r_sprites_defer_end(void);
+
 BlendMode r_blend_compose(
 	BlendFactor src_color, BlendFactor dst_color, BlendOp color_op,
 	BlendFactor src_alpha, BlendFactor dst_alpha, BlendOp alpha_op
@@ -9,6 +9,8 @@
 #include "taisei.h"
 
 #include "backend.h"
+#include "render_stats.h"
+#include "render_thread.h"
 
 #undef R
 #define R(x) extern RendererBackend _r_backend_##x;
@@ -55,5 +57,16 @@ void _r_backend_init(void) {
 	bptr->funcs.init();
 	_r_set_backend(bptr);
 
+	if(env_get("TAISEI_RENDER_THREAD", false)) {
+		_r_render_thread_wrap(&_r_backend);
+	}
+
+	// counts calls as the main thread makes them, so goes on top of the render thread
+	const char *stats_path = env_get("TAISEI_RENDER_STATS", "");
+
+	if(*stats_path) {
+		_r_render_stats_wrap(&_r_backend, stats_path);
+	}
+
 	initialized = true;
 }
@@ -17,6 +17,7 @@ typedef struct RendererFuncs {
 	void (*shutdown)(void);
 
 	SDL_Window* (*create_window)(const char *title, int x, int y, int w, int h, uint32_t flags);
+	void (*destroy_window)(SDL_Window *window);
 
 	bool (*supports)(RendererFeature feature);
 
@@ -11,9 +11,21 @@
 #include "models.h"
 #include "../api.h"
 
+typedef struct VertexRange {
+	uint first;
+	uint count;
+} VertexRange;
+
 static struct {
 	VertexBuffer *vbuf;
 	VertexArray *varr;
+
+	// unused parts of vbuf, sorted by first vertex, never adjacent
+	struct {
+		VertexRange *ranges;
+		uint num_ranges;
+		uint capacity;
+	} freelist;
 } _r_models;
 
 void _r_models_init(void) {
@@ -42,11 +54,17 @@ void _r_models_init(void) {
 
 	r_vertex_buffer_append(_r_models.vbuf, sizeof(quad), quad);
 	r_vertex_array(_r_models.varr);
+
+	uint num_quad_verts = sizeof(quad) / sizeof(*quad);
+	uint num_verts = r_vertex_buffer_get_capacity(_r_models.vbuf) / sizeof(GenericModelVertex);
+	r_static_models_free(num_quad_verts, num_verts - num_quad_verts);
 }
 
 void _r_models_shutdown(void) {
 	r_vertex_array_destroy(_r_models.varr);
 	r_vertex_buffer_destroy(_r_models.vbuf);
+	free(_r_models.freelist.ranges);
+	memset(&_r_models, 0, sizeof(_r_models));
 }
 
 VertexBuffer* r_vertex_buffer_static_models(void) {
@@ -57,6 +75,73 @@ VertexArray* r_vertex_array_static_models(void) {
 	return _r_models.varr;
 }
 
+bool r_static_models_alloc(uint num_vertices, uint *out_first) {
+	assert(num_vertices > 0);
+
+	// first fit; there are only a handful of models, so fragmentation isn't a concern
+	for(uint i = 0; i < _r_models.freelist.num_ranges; ++i) {
+		VertexRange *r = _r_models.freelist.ranges + i;
+
+		if(r->count < num_vertices) {
+			continue;
+		}
+
+		*out_first = r->first;
+		r->first += num_vertices;
+		r->count -= num_vertices;
+
+		if(r->count == 0) {
+			--_r_models.freelist.num_ranges;
+			memmove(r, r + 1, (_r_models.freelist.num_ranges - i) * sizeof(*r));
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+void r_static_models_free(uint first, uint num_vertices) {
+	VertexRange *ranges = _r_models.freelist.ranges;
+	uint num_ranges = _r_models.freelist.num_ranges;
+	uint i = 0;
+
+	if(num_vertices == 0) {
+		return;
+	}
+
+	while(i < num_ranges && ranges[i].first < first) {
+		++i;
+	}
+
+	assert(i == 0 || ranges[i - 1].first + ranges[i - 1].count <= first);
+	assert(i == num_ranges || first + num_vertices <= ranges[i].first);
+
+	bool merge_prev = i > 0 && ranges[i - 1].first + ranges[i - 1].count == first;
+	bool merge_next = i < num_ranges && first + num_vertices == ranges[i].first;
+
+	if(merge_prev && merge_next) {
+		ranges[i - 1].count += num_vertices + ranges[i].count;
+		memmove(ranges + i, ranges + i + 1, (num_ranges - i - 1) * sizeof(*ranges));
+		--_r_models.freelist.num_ranges;
+	} else if(merge_prev) {
+		ranges[i - 1].count += num_vertices;
+	} else if(merge_next) {
+		ranges[i].first = first;
+		ranges[i].count += num_vertices;
+	} else {
+		if(num_ranges == _r_models.freelist.capacity) {
+			_r_models.freelist.capacity = _r_models.freelist.capacity ? _r_models.freelist.capacity * 2 : 8;
+			ranges = _r_models.freelist.ranges = realloc(ranges, _r_models.freelist.capacity * sizeof(*ranges));
+		}
+
+		memmove(ranges + i + 1, ranges + i, (num_ranges - i) * sizeof(*ranges));
+		ranges[i].first = first;
+		ranges[i].count = num_vertices;
+		++_r_models.freelist.num_ranges;
+	}
+}
+
 void r_draw_quad(void) {
 	VertexArray *varr_saved = r_vertex_array_current();
 	r_vertex_array(_r_models.varr);
@@ -0,0 +1,455 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include "render_stats.h"
+#include "hashtable.h"
+#include "util.h"
+
+typedef struct RenderStatsFrame {
+	uint64_t counters[RSTAT_NUM];
+} RenderStatsFrame;
+
+typedef struct SamplerShadow {
+	uint num_elements;
+	Texture *textures[];
+} SamplerShadow;
+
+RenderStatsState _r_stats;
+
+static struct {
+	RendererFuncs real;
+	char *trace_path;
+
+	RenderStatsFrame *frames;
+	size_t num_frames;
+	size_t capacity;
+
+	// state changes are counted against what was last set through the wrapper
+	ShaderProgram *shader;
+	Framebuffer *framebuffer;
+	BlendMode blend;
+
+	// the keys are pointers
+	ht_int2int_t texture_types; // Texture* -> TextureType
+	ht_int2int_t samplers;      // Uniform* -> SamplerShadow*
+
+	// only the game's own calls are counted, see rs_enter()
+	SDL_threadID main_thread;
+	uint depth;
+} RS;
+
+static const char *const stat_names[] = {
+	#define RENDER_STAT(id, name) name,
+	RENDER_STATS
+	#undef RENDER_STAT
+};
+
+static inline int64_t ptrkey(const void *ptr) {
+	return (int64_t)(uintptr_t)ptr;
+}
+
+static inline void *keyptr(int64_t key) {
+	return (void*)(uintptr_t)key;
+}
+
+static size_t texture_pixel_size(TextureType type) {
+	static const size_t map[] = {
+		[TEX_TYPE_R]     = 1,
+		[TEX_TYPE_RG]    = 2,
+		[TEX_TYPE_RGB]   = 3,
+		[TEX_TYPE_RGBA]  = 4,
+		[TEX_TYPE_DEPTH] = 2, // stored as DEPTH_COMPONENT16
+	};
+
+	assert((uint)type < sizeof(map)/sizeof(*map));
+	return map[type];
+}
+
+static void rs_forget_samplers(void) {
+	ht_int2int_iter_t iter;
+	ht_iter_begin(&RS.samplers, &iter);
+
+	for(; iter.has_data; ht_iter_next(&iter)) {
+		free(keyptr(iter.value));
+	}
+
+	ht_iter_end(&iter);
+	ht_unset_all(&RS.samplers);
+}
+
+/*
+ * Counting proxies
+ */
+
+static inline bool rs_on_main_thread(void) {
+	return SDL_ThreadID() == RS.main_thread;
+}
+
+// Returns whether the call should be counted: only the outermost one on the main thread is.
+// Backends may serve a call through other entry points (e.g. appending through a buffer write),
+// and the resource loader may upload textures from its own threads.
+static bool rs_enter(void) {
+	if(!rs_on_main_thread()) {
+		return false;
+	}
+
+	return RS.depth++ == 0;
+}
+
+static void rs_leave(void) {
+	if(rs_on_main_thread()) {
+		assert(RS.depth > 0);
+		--RS.depth;
+	}
+}
+
+static void rs_post_init(void) {
+	RS.real.post_init();
+	RS.shader = RS.real.shader_current();
+	RS.framebuffer = RS.real.framebuffer_current();
+	RS.blend = RS.real.blend_current();
+}
+
+static void rs_draw(Primitive prim, uint first, uint count, uint32_t *indices, uint instances, uint base_instance) {
+	if(rs_enter()) {
+		uint64_t n = instances ? instances : 1;
+		_r_stats.frame[RSTAT_DRAWS]++;
+		_r_stats.frame[RSTAT_INSTANCES] += n;
+		_r_stats.frame[RSTAT_VERTICES] += n * count;
+	}
+
+	RS.real.draw(prim, first, count, indices, instances, base_instance);
+	rs_leave();
+}
+
+static void rs_blend(BlendMode mode) {
+	if(rs_enter() && mode != RS.blend) {
+		_r_stats.frame[RSTAT_BLEND_CHANGES]++;
+		RS.blend = mode;
+	}
+
+	RS.real.blend(mode);
+	rs_leave();
+}
+
+static void rs_shader(ShaderProgram *prog) {
+	if(rs_enter() && prog != RS.shader) {
+		_r_stats.frame[RSTAT_SHADER_CHANGES]++;
+		RS.shader = prog;
+	}
+
+	RS.real.shader(prog);
+	rs_leave();
+}
+
+static void rs_shader_program_destroy(ShaderProgram *prog) {
+	// its uniforms go away with it; programs are rarely destroyed, so just start over
+	rs_forget_samplers();
+
+	if(RS.shader == prog) {
+		RS.shader = NULL;
+	}
+
+	RS.real.shader_program_destroy(prog);
+}
+
+static void rs_count_sampler(Uniform *uniform, uint offset, uint count, Texture *const *textures) {
+	SamplerShadow *s = keyptr(ht_get(&RS.samplers, ptrkey(uniform), 0));
+
+	if(!s || s->num_elements < offset + count) {
+		uint old_num = s ? s->num_elements : 0;
+		s = realloc(s, sizeof(*s) + (offset + count) * sizeof(*s->textures));
+		memset(s->textures + old_num, 0, (offset + count - old_num) * sizeof(*s->textures));
+		s->num_elements = offset + count;
+		ht_set(&RS.samplers, ptrkey(uniform), ptrkey(s));
+	}
+
+	for(uint i = 0; i < count; ++i) {
+		if(s->textures[offset + i] != textures[i]) {
+			_r_stats.frame[RSTAT_TEXTURE_CHANGES]++;
+			s->textures[offset + i] = textures[i];
+		}
+	}
+}
+
+static void rs_uniform(Uniform *uniform, uint offset, uint count, const void *data) {
+	if(rs_enter()) {
+		_r_stats.frame[RSTAT_UNIFORM_UPDATES]++;
+
+		if(RS.real.uniform_type(uniform) == UNIFORM_SAMPLER) {
+			rs_count_sampler(uniform, offset, count, data);
+		}
+	}
+
+	RS.real.uniform(uniform, offset, count, data);
+	rs_leave();
+}
+
+static Texture* rs_texture_create(const TextureParams *params) {
+	Texture *tex = RS.real.texture_create(params);
+
+	if(tex) {
+		ht_set(&RS.texture_types, ptrkey(tex), params->type);
+	}
+
+	return tex;
+}
+
+static void rs_texture_destroy(Texture *tex) {
+	ht_unset(&RS.texture_types, ptrkey(tex));
+	RS.real.texture_destroy(tex);
+}
+
+static void rs_count_texture_upload(Texture *tex, uint w, uint h) {
+	TextureType type = ht_get(&RS.texture_types, ptrkey(tex), TEX_TYPE_RGBA);
+	_r_stats.frame[RSTAT_TEXTURE_BYTES] += (uint64_t)w * h * texture_pixel_size(type);
+}
+
+static void rs_texture_fill(Texture *tex, uint mipmap, void *image_data) {
+	if(rs_enter() && image_data) {
+		uint w, h;
+		RS.real.texture_get_size(tex, mipmap, &w, &h);
+		rs_count_texture_upload(tex, w, h);
+	}
+
+	RS.real.texture_fill(tex, mipmap, image_data);
+	rs_leave();
+}
+
+static void rs_texture_fill_region(Texture *tex, uint mipmap, uint x, uint y, uint w, uint h, void *image_data) {
+	if(rs_enter()) {
+		rs_count_texture_upload(tex, w, h);
+	}
+
+	RS.real.texture_fill_region(tex, mipmap, x, y, w, h, image_data);
+	rs_leave();
+}
+
+static void rs_framebuffer(Framebuffer *framebuffer) {
+	if(rs_enter() && framebuffer != RS.framebuffer) {
+		_r_stats.frame[RSTAT_FRAMEBUFFER_CHANGES]++;
+		RS.framebuffer = framebuffer;
+	}
+
+	RS.real.framebuffer(framebuffer);
+	rs_leave();
+}
+
+static void rs_framebuffer_destroy(Framebuffer *framebuffer) {
+	if(RS.framebuffer == framebuffer) {
+		RS.framebuffer = NULL;
+	}
+
+	RS.real.framebuffer_destroy(framebuffer);
+}
+
+static VertexBuffer* rs_vertex_buffer_create(size_t capacity, void *data) {
+	if(rs_enter() && data) {
+		_r_stats.frame[RSTAT_VERTEX_BYTES] += capacity;
+	}
+
+	VertexBuffer *vbuf = RS.real.vertex_buffer_create(capacity, data);
+	rs_leave();
+	return vbuf;
+}
+
+static void rs_vertex_buffer_write(VertexBuffer *vbuf, size_t offset, size_t data_size, void *data) {
+	if(rs_enter()) {
+		_r_stats.frame[RSTAT_VERTEX_BYTES] += data_size;
+	}
+
+	RS.real.vertex_buffer_write(vbuf, offset, data_size, data);
+	rs_leave();
+}
+
+static void rs_vertex_buffer_append(VertexBuffer *vbuf, size_t data_size, void *data) {
+	if(rs_enter()) {
+		_r_stats.frame[RSTAT_VERTEX_BYTES] += data_size;
+	}
+
+	RS.real.vertex_buffer_append(vbuf, data_size, data);
+	rs_leave();
+}
+
+static void rs_swap(SDL_Window *window) {
+	if(RS.num_frames == RS.capacity) {
+		RS.capacity = RS.capacity ? RS.capacity * 2 : 4096;
+		RS.frames = realloc(RS.frames, RS.capacity * sizeof(*RS.frames));
+	}
+
+	memcpy(RS.frames[RS.num_frames++].counters, _r_stats.frame, sizeof(_r_stats.frame));
+	memset(_r_stats.frame, 0, sizeof(_r_stats.frame));
+
+	RS.real.swap(window);
+}
+
+/*
+ * Reporting
+ */
+
+static int uint64_cmp(const void *p1, const void *p2) {
+	uint64_t a = *(const uint64_t*)p1;
+	uint64_t b = *(const uint64_t*)p2;
+	return (a > b) - (a < b);
+}
+
+static uint64_t percentile(const uint64_t *sorted, size_t num, double p) {
+	// nearest-rank method
+	size_t rank = ceil(p * num);
+	return sorted[rank ? rank - 1 : 0];
+}
+
+static void rs_report(void) {
+	size_t num = RS.num_frames;
+
+	if(!num) {
+		log_warn("No frames were rendered");
+		return;
+	}
+
+	uint64_t *values = calloc(num, sizeof(*values));
+
+	tsfprintf(stdout, "\nRender statistics: %zu frames\n\n", num);
+	tsfprintf(stdout, "%-20s %14s %12s %10s %10s %10s %10s\n",
+		"counter", "total", "mean", "p50", "p90", "p99", "max"
+	);
+
+	for(int s = 0; s < RSTAT_NUM; ++s) {
+		uint64_t total = 0;
+
+		for(size_t i = 0; i < num; ++i) {
+			total += values[i] = RS.frames[i].counters[s];
+		}
+
+		qsort(values, num, sizeof(*values), uint64_cmp);
+
+		tsfprintf(stdout, "%-20s %14"PRIu64" %12.2f %10"PRIu64" %10"PRIu64" %10"PRIu64" %10"PRIu64"\n",
+			stat_names[s],
+			total,
+			total / (double)num,
+			percentile(values, num, 0.50),
+			percentile(values, num, 0.90),
+			percentile(values, num, 0.99),
+			values[num - 1]
+		);
+	}
+
+	tsfprintf(stdout, "\n");
+	free(values);
+}
+
+static void write_trace_csv(SDL_RWops *out) {
+	SDL_RWprintf(out, "frame");
+
+	for(int s = 0; s < RSTAT_NUM; ++s) {
+		SDL_RWprintf(out, ",%s", stat_names[s]);
+	}
+
+	SDL_RWprintf(out, "\n");
+
+	for(size_t i = 0; i < RS.num_frames; ++i) {
+		SDL_RWprintf(out, "%zu", i);
+
+		for(int s = 0; s < RSTAT_NUM; ++s) {
+			SDL_RWprintf(out, ",%"PRIu64, RS.frames[i].counters[s]);
+		}
+
+		SDL_RWprintf(out, "\n");
+	}
+}
+
+static void write_trace_json(SDL_RWops *out) {
+	SDL_RWprintf(out, "{\n\t\"counters\": [");
+
+	for(int s = 0; s < RSTAT_NUM; ++s) {
+		SDL_RWprintf(out, "%s\"%s\"", s ? ", " : "", stat_names[s]);
+	}
+
+	SDL_RWprintf(out, "],\n\t\"frames\": [\n");
+
+	for(size_t i = 0; i < RS.num_frames; ++i) {
+		SDL_RWprintf(out, "\t\t[");
+
+		for(int s = 0; s < RSTAT_NUM; ++s) {
+			SDL_RWprintf(out, "%s%"PRIu64, s ? ", " : "", RS.frames[i].counters[s]);
+		}
+
+		SDL_RWprintf(out, "]%s\n", i + 1 < RS.num_frames ? "," : "");
+	}
+
+	SDL_RWprintf(out, "\t]\n}\n");
+}
+
+static void write_trace(const char *path) {
+	SDL_RWops *out = SDL_RWFromFile(path, "w");
+
+	if(!out) {
+		log_warn("Couldn't open %s for writing: %s", path, SDL_GetError());
+		return;
+	}
+
+	if(strendswith(path, ".json")) {
+		write_trace_json(out);
+	} else {
+		write_trace_csv(out);
+	}
+
+	SDL_RWclose(out);
+	log_info("Render statistics written to %s", path);
+}
+
+static void rs_shutdown(void) {
+	RS.real.shutdown();
+
+	rs_report();
+	write_trace(RS.trace_path);
+
+	rs_forget_samplers();
+	ht_destroy(&RS.samplers);
+	ht_destroy(&RS.texture_types);
+	free(RS.frames);
+	free(RS.trace_path);
+	memset(&RS, 0, sizeof(RS));
+	_r_stats.enabled = false;
+}
+
+void _r_render_stats_wrap(RendererBackend *backend, const char *trace_path) {
+	RendererFuncs *f = &backend->funcs;
+
+	memset(&RS, 0, sizeof(RS));
+	memset(&_r_stats, 0, sizeof(_r_stats));
+	RS.real = *f;
+	RS.trace_path = strdup(trace_path);
+	RS.main_thread = SDL_ThreadID();
+	ht_create(&RS.texture_types);
+	ht_create(&RS.samplers);
+	_r_stats.enabled = true;
+
+	// everything else goes straight to the backend
+	f->post_init = rs_post_init;
+	f->shutdown = rs_shutdown;
+	f->draw = rs_draw;
+	f->blend = rs_blend;
+	f->shader = rs_shader;
+	f->shader_program_destroy = rs_shader_program_destroy;
+	f->uniform = rs_uniform;
+	f->texture_create = rs_texture_create;
+	f->texture_destroy = rs_texture_destroy;
+	f->texture_fill = rs_texture_fill;
+	f->texture_fill_region = rs_texture_fill_region;
+	f->framebuffer = rs_framebuffer;
+	f->framebuffer_destroy = rs_framebuffer_destroy;
+	f->vertex_buffer_create = rs_vertex_buffer_create;
+	f->vertex_buffer_write = rs_vertex_buffer_write;
+	f->vertex_buffer_append = rs_vertex_buffer_append;
+	f->swap = rs_swap;
+
+	log_info("Counting render calls, statistics will be written to %s", trace_path);
+}
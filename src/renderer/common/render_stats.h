@@ -0,0 +1,58 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include "backend.h"
+
+/*
+ * Render path instrumentation. The backend is wrapped so that the calls that make up a
+ * frame are counted on their way through, from one swap to the next. When the renderer
+ * shuts down, a summary is printed and the per-frame counts are written to the file named
+ * by TAISEI_RENDER_STATS (CSV, or JSON if the name ends with .json).
+ *
+ * It works over any backend. Over the null backend it measures how much work the render
+ * path generates without needing a GPU; see --render-stats.
+ */
+
+#define RENDER_STATS \
+	RENDER_STAT(DRAWS, "draws") \
+	RENDER_STAT(INSTANCES, "instances") \
+	RENDER_STAT(VERTICES, "vertices") \
+	RENDER_STAT(SPRITE_FLUSHES, "sprite_flushes") \
+	RENDER_STAT(SPRITES, "sprites") \
+	RENDER_STAT(SHADER_CHANGES, "shader_changes") \
+	RENDER_STAT(TEXTURE_CHANGES, "texture_changes") \
+	RENDER_STAT(FRAMEBUFFER_CHANGES, "framebuffer_changes") \
+	RENDER_STAT(BLEND_CHANGES, "blend_changes") \
+	RENDER_STAT(UNIFORM_UPDATES, "uniform_updates") \
+	RENDER_STAT(VERTEX_BYTES, "vertex_bytes") \
+	RENDER_STAT(TEXTURE_BYTES, "texture_bytes") \
+
+typedef enum RenderStat {
+	#define RENDER_STAT(id, name) RSTAT_##id,
+	RENDER_STATS
+	#undef RENDER_STAT
+	RSTAT_NUM,
+} RenderStat;
+
+typedef struct RenderStatsState {
+	bool enabled;
+	uint64_t frame[RSTAT_NUM];
+} RenderStatsState;
+
+extern RenderStatsState _r_stats;
+
+void _r_render_stats_wrap(RendererBackend *backend, const char *trace_path) attr_nonnull(1, 2);
+
+static inline attr_must_inline void _r_stats_add(RenderStat stat, uint64_t amount) {
+	if(_r_stats.enabled) {
+		_r_stats.frame[stat] += amount;
+	}
+}
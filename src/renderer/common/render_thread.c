@@ -0,0 +1,1261 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include <stdalign.h>
+
+#include "render_thread.h"
+#include "hashtable.h"
+
+/*
+ * A command is a header followed by its payload. The proc receives a pointer to the
+ * payload and runs on the render thread. Payloads own copies of everything they point
+ * to, except for the payloads of synchronous calls, whose caller is blocked anyway.
+ */
+
+typedef void (*RenderCmdProc)(void *payload);
+
+typedef struct RenderCmdHeader {
+	alignas(max_align_t) RenderCmdProc proc;
+	size_t size;
+} RenderCmdHeader;
+
+#define RT_CMD_ALIGN alignof(RenderCmdHeader)
+
+typedef struct RenderCmdBuffer {
+	char *data;
+	size_t size;
+	size_t capacity;
+} RenderCmdBuffer;
+
+typedef struct FramebufferShadow {
+	struct {
+		Texture *texture;
+		uint mipmap;
+	} attachments[FRAMEBUFFER_MAX_ATTACHMENTS];
+
+	IntRect viewport;
+} FramebufferShadow;
+
+static struct {
+	RendererFuncs real;
+
+	SDL_Thread *thread;
+	SDL_threadID thread_id;
+	SDL_mutex *mutex;
+	SDL_cond *cond;
+	SDL_Window *window;
+	SDL_GLContext gl_context;
+
+	// at most one buffer is in flight: the render thread works on one frame while the next is recorded
+	RenderCmdBuffer buffers[2];
+	RenderCmdBuffer *recording;
+	RenderCmdBuffer *pending;
+	bool busy;
+	bool quit;
+
+	// what the main thread sees; the render thread may still be a frame behind
+	struct {
+		r_capability_bits_t capabilities;
+		Color color;
+		BlendMode blend;
+		CullFaceMode cull;
+		DepthTestFunc depth_func;
+		ShaderProgram *shader;
+		Framebuffer *framebuffer;
+		VertexArray *vertex_array;
+		VsyncMode vsync;
+		IntRect default_viewport;
+
+		// the keys are pointers
+		ht_int2int_t framebuffers;  // -> FramebufferShadow*
+		ht_int2int_t vbuf_cursors;  // -> size_t
+		ht_int2int_t programs;      // -> ht_str2ptr_t* of Uniform*
+		ht_int2int_t uniform_types; // -> UniformType
+	} shadow;
+} RT;
+
+static inline int64_t ptrkey(const void *ptr) {
+	return (int64_t)(uintptr_t)ptr;
+}
+
+static inline void *keyptr(int64_t key) {
+	return (void*)(uintptr_t)key;
+}
+
+/*
+ * Command buffers and the render thread
+ */
+
+static void *rt_cmd(RenderCmdProc proc, size_t payload_size) {
+	RenderCmdBuffer *cbuf = RT.recording;
+
+	// the backend must not call back into the r_* API while it's executing commands
+	assert(!RT.thread || SDL_ThreadID() != RT.thread_id);
+
+	payload_size = (payload_size + RT_CMD_ALIGN - 1) & ~(RT_CMD_ALIGN - 1);
+	size_t new_size = cbuf->size + sizeof(RenderCmdHeader) + payload_size;
+
+	if(new_size > cbuf->capacity) {
+		cbuf->capacity = cbuf->capacity ? cbuf->capacity * 2 : 1 << 16;
+
+		while(cbuf->capacity < new_size) {
+			cbuf->capacity *= 2;
+		}
+
+		cbuf->data = realloc(cbuf->data, cbuf->capacity);
+	}
+
+	RenderCmdHeader *hdr = (RenderCmdHeader*)(cbuf->data + cbuf->size);
+	hdr->proc = proc;
+	hdr->size = payload_size;
+	cbuf->size = new_size;
+
+	return hdr + 1;
+}
+
+#define RT_CMD(proc, type) ((type*)rt_cmd(proc, sizeof(type)))
+
+static void rt_execute(RenderCmdBuffer *cbuf) {
+	for(size_t ofs = 0; ofs < cbuf->size;) {
+		RenderCmdHeader *hdr = (RenderCmdHeader*)(cbuf->data + ofs);
+		hdr->proc(hdr + 1);
+		ofs += sizeof(*hdr) + hdr->size;
+	}
+
+	cbuf->size = 0;
+}
+
+static int rt_thread(void *arg) {
+	if(RT.gl_context) {
+		SDL_GL_MakeCurrent(RT.window, RT.gl_context);
+	}
+
+	SDL_LockMutex(RT.mutex);
+
+	while(true) {
+		while(!RT.pending && !RT.quit) {
+			SDL_CondWait(RT.cond, RT.mutex);
+		}
+
+		if(!RT.pending) {
+			break;
+		}
+
+		RenderCmdBuffer *cbuf = RT.pending;
+		RT.pending = NULL;
+		RT.busy = true;
+		SDL_UnlockMutex(RT.mutex);
+
+		rt_execute(cbuf);
+
+		SDL_LockMutex(RT.mutex);
+		RT.busy = false;
+		SDL_CondBroadcast(RT.cond);
+	}
+
+	SDL_UnlockMutex(RT.mutex);
+
+	if(RT.gl_context) {
+		SDL_GL_MakeCurrent(NULL, NULL);
+	}
+
+	return 0;
+}
+
+static void rt_wait_idle_locked(void) {
+	while(RT.pending || RT.busy) {
+		SDL_CondWait(RT.cond, RT.mutex);
+	}
+}
+
+// Hands the recorded commands over to the render thread. If wait is true, also waits until they're executed.
+static void rt_submit(bool wait) {
+	if(!RT.thread) {
+		// no window yet, or already shut down; just run everything here
+		rt_execute(RT.recording);
+		return;
+	}
+
+	SDL_LockMutex(RT.mutex);
+	rt_wait_idle_locked();
+
+	if(RT.recording->size) {
+		RT.pending = RT.recording;
+		RT.recording = RT.recording == RT.buffers ? RT.buffers + 1 : RT.buffers;
+		SDL_CondBroadcast(RT.cond);
+
+		if(wait) {
+			rt_wait_idle_locked();
+		}
+	}
+
+	SDL_UnlockMutex(RT.mutex);
+}
+
+typedef struct RenderCallPayload {
+	RenderCmdProc proc;
+	void *arg;
+} RenderCallPayload;
+
+static void rt_exec_call(void *payload) {
+	RenderCallPayload *p = payload;
+	p->proc(p->arg);
+}
+
+// Runs proc(arg) on the render thread, after everything recorded so far, and waits for it.
+static void rt_call(RenderCmdProc proc, void *arg) {
+	RenderCallPayload *p = RT_CMD(rt_exec_call, RenderCallPayload);
+	p->proc = proc;
+	p->arg = arg;
+	rt_submit(true);
+}
+
+static void rt_start_thread(void) {
+	assert(RT.thread == NULL);
+
+	RT.gl_context = SDL_GL_GetCurrentContext();
+
+	if(RT.gl_context) {
+		SDL_GL_MakeCurrent(NULL, NULL);
+	}
+
+	RT.quit = false;
+
+	if(!(RT.thread = SDL_CreateThread(rt_thread, "render", NULL))) {
+		log_fatal("SDL_CreateThread() failed: %s", SDL_GetError());
+	}
+
+	RT.thread_id = SDL_GetThreadID(RT.thread);
+
+	log_info("Rendering on a separate thread");
+}
+
+static void rt_stop_thread(void) {
+	if(!RT.thread) {
+		return;
+	}
+
+	rt_submit(true);
+
+	SDL_LockMutex(RT.mutex);
+	RT.quit = true;
+	SDL_CondBroadcast(RT.cond);
+	SDL_UnlockMutex(RT.mutex);
+
+	SDL_WaitThread(RT.thread, NULL);
+	RT.thread = NULL;
+	RT.thread_id = 0;
+
+	if(RT.gl_context && RT.window) {
+		SDL_GL_MakeCurrent(RT.window, RT.gl_context);
+	}
+}
+
+/*
+ * Shadow state
+ */
+
+static void rt_init_shadow_state(void) {
+	RT.shadow.capabilities = RT.real.capabilities_current();
+	RT.shadow.color = *RT.real.color_current();
+	RT.shadow.blend = RT.real.blend_current();
+	RT.shadow.cull = RT.real.cull_current();
+	RT.shadow.depth_func = RT.real.depth_func_current();
+	RT.shadow.shader = RT.real.shader_current();
+	RT.shadow.framebuffer = RT.real.framebuffer_current();
+	RT.shadow.vertex_array = RT.real.vertex_array_current();
+	RT.shadow.vsync = RT.real.vsync_current();
+	RT.real.framebuffer_viewport_current(NULL, &RT.shadow.default_viewport);
+}
+
+static FramebufferShadow *rt_framebuffer_shadow(Framebuffer *fb) {
+	FramebufferShadow *fbs = keyptr(ht_get(&RT.shadow.framebuffers, ptrkey(fb), 0));
+	assert(fbs != NULL);
+	return fbs;
+}
+
+static void rt_forget_program(ShaderProgram *prog) {
+	ht_str2ptr_t *uniforms = keyptr(ht_get(&RT.shadow.programs, ptrkey(prog), 0));
+
+	if(!uniforms) {
+		return;
+	}
+
+	ht_str2ptr_iter_t iter;
+	ht_iter_begin(uniforms, &iter);
+
+	for(; iter.has_data; ht_iter_next(&iter)) {
+		if(iter.value) {
+			ht_unset(&RT.shadow.uniform_types, ptrkey(iter.value));
+		}
+	}
+
+	ht_iter_end(&iter);
+	ht_destroy(uniforms);
+	free(uniforms);
+	ht_unset(&RT.shadow.programs, ptrkey(prog));
+}
+
+/*
+ * Window management, init and shutdown
+ */
+
+static SDL_Window* rt_create_window(const char *title, int x, int y, int w, int h, uint32_t flags) {
+	// the backend expects to set up the window and the context on this thread
+	rt_stop_thread();
+
+	SDL_Window *window = RT.real.create_window(title, x, y, w, h, flags);
+
+	if(!window) {
+		return NULL;
+	}
+
+	rt_execute(RT.recording);
+	rt_init_shadow_state();
+	RT.window = window;
+	rt_start_thread();
+
+	return window;
+}
+
+static void rt_destroy_window(SDL_Window *window) {
+	// make sure the render thread isn't drawing into it anymore
+	rt_submit(true);
+
+	if(window == RT.window) {
+		RT.window = NULL;
+	}
+
+	// the context stays current on the render thread, just like it would on the main thread without one
+	RT.real.destroy_window(window);
+}
+
+static void rt_call_post_init(void *arg) {
+	RT.real.post_init();
+}
+
+static void rt_post_init(void) {
+	rt_call(rt_call_post_init, NULL);
+}
+
+static void rt_call_shutdown(void *arg) {
+	RT.real.shutdown();
+}
+
+static void rt_shutdown(void) {
+	rt_call(rt_call_shutdown, NULL);
+
+	// the backend has already released the context
+	RT.gl_context = NULL;
+	rt_stop_thread();
+
+	SDL_DestroyCond(RT.cond);
+	SDL_DestroyMutex(RT.mutex);
+
+	for(uint i = 0; i < sizeof(RT.buffers)/sizeof(*RT.buffers); ++i) {
+		free(RT.buffers[i].data);
+	}
+
+	ht_int2int_iter_t iter;
+	ht_iter_begin(&RT.shadow.framebuffers, &iter);
+
+	for(; iter.has_data; ht_iter_next(&iter)) {
+		free(keyptr(iter.value));
+	}
+
+	ht_iter_end(&iter);
+
+	ht_iter_begin(&RT.shadow.programs, &iter);
+
+	for(; iter.has_data; ht_iter_next(&iter)) {
+		ht_str2ptr_t *uniforms = keyptr(iter.value);
+		ht_destroy(uniforms);
+		free(uniforms);
+	}
+
+	ht_iter_end(&iter);
+
+	ht_destroy(&RT.shadow.framebuffers);
+	ht_destroy(&RT.shadow.vbuf_cursors);
+	ht_destroy(&RT.shadow.programs);
+	ht_destroy(&RT.shadow.uniform_types);
+}
+
+/*
+ * Render state
+ */
+
+typedef union StateCmd {
+	r_capability_bits_t capabilities;
+	Color color;
+	BlendMode blend;
+	CullFaceMode cull;
+	DepthTestFunc depth_func;
+	ShaderProgram *shader;
+	Framebuffer *framebuffer;
+	VertexArray *vertex_array;
+	VsyncMode vsync;
+} StateCmd;
+
+static void rt_exec_capabilities(void *p) {
+	RT.real.capabilities(((StateCmd*)p)->capabilities);
+}
+
+static void rt_capabilities(r_capability_bits_t capbits) {
+	RT_CMD(rt_exec_capabilities, StateCmd)->capabilities = RT.shadow.capabilities = capbits;
+}
+
+static r_capability_bits_t rt_capabilities_current(void) {
+	return RT.shadow.capabilities;
+}
+
+static void rt_exec_color4(void *p) {
+	Color *c = &((StateCmd*)p)->color;
+	RT.real.color4(c->r, c->g, c->b, c->a);
+}
+
+static void rt_color4(float r, float g, float b, float a) {
+	RT.shadow.color = (Color) { r, g, b, a };
+	RT_CMD(rt_exec_color4, StateCmd)->color = RT.shadow.color;
+}
+
+static const Color* rt_color_current(void) {
+	return &RT.shadow.color;
+}
+
+static void rt_exec_blend(void *p) {
+	RT.real.blend(((StateCmd*)p)->blend);
+}
+
+static void rt_blend(BlendMode mode) {
+	RT_CMD(rt_exec_blend, StateCmd)->blend = RT.shadow.blend = mode;
+}
+
+static BlendMode rt_blend_current(void) {
+	return RT.shadow.blend;
+}
+
+static void rt_exec_cull(void *p) {
+	RT.real.cull(((StateCmd*)p)->cull);
+}
+
+static void rt_cull(CullFaceMode mode) {
+	RT_CMD(rt_exec_cull, StateCmd)->cull = RT.shadow.cull = mode;
+}
+
+static CullFaceMode rt_cull_current(void) {
+	return RT.shadow.cull;
+}
+
+static void rt_exec_depth_func(void *p) {
+	RT.real.depth_func(((StateCmd*)p)->depth_func);
+}
+
+static void rt_depth_func(DepthTestFunc func) {
+	RT_CMD(rt_exec_depth_func, StateCmd)->depth_func = RT.shadow.depth_func = func;
+}
+
+static DepthTestFunc rt_depth_func_current(void) {
+	return RT.shadow.depth_func;
+}
+
+static void rt_exec_shader(void *p) {
+	RT.real.shader(((StateCmd*)p)->shader);
+}
+
+static void rt_shader(ShaderProgram *prog) {
+	RT_CMD(rt_exec_shader, StateCmd)->shader = RT.shadow.shader = prog;
+}
+
+static ShaderProgram* rt_shader_current(void) {
+	return RT.shadow.shader;
+}
+
+static void rt_exec_framebuffer(void *p) {
+	RT.real.framebuffer(((StateCmd*)p)->framebuffer);
+}
+
+static void rt_framebuffer(Framebuffer *fb) {
+	RT_CMD(rt_exec_framebuffer, StateCmd)->framebuffer = RT.shadow.framebuffer = fb;
+}
+
+static Framebuffer* rt_framebuffer_current(void) {
+	return RT.shadow.framebuffer;
+}
+
+static void rt_exec_vertex_array(void *p) {
+	RT.real.vertex_array(((StateCmd*)p)->vertex_array);
+}
+
+static void rt_vertex_array(VertexArray *varr) {
+	RT_CMD(rt_exec_vertex_array, StateCmd)->vertex_array = RT.shadow.vertex_array = varr;
+}
+
+static VertexArray* rt_vertex_array_current(void) {
+	return RT.shadow.vertex_array;
+}
+
+static void rt_exec_vsync(void *p) {
+	RT.real.vsync(((StateCmd*)p)->vsync);
+}
+
+static void rt_vsync(VsyncMode mode) {
+	RT_CMD(rt_exec_vsync, StateCmd)->vsync = RT.shadow.vsync = mode;
+}
+
+static VsyncMode rt_vsync_current(void) {
+	return RT.shadow.vsync;
+}
+
+/*
+ * Drawing
+ */
+
+typedef struct DrawCmd {
+	Primitive prim;
+	uint first;
+	uint count;
+	uint instances;
+	uint base_instance;
+	bool indexed;
+	uint32_t indices[];
+} DrawCmd;
+
+static void rt_exec_draw(void *p) {
+	DrawCmd *cmd = p;
+	RT.real.draw(cmd->prim, cmd->first, cmd->count, cmd->indexed ? cmd->indices : NULL, cmd->instances, cmd->base_instance);
+}
+
+static void rt_draw(Primitive prim, uint first, uint count, uint32_t *indices, uint instances, uint base_instance) {
+	size_t indices_size = indices ? count * sizeof(*indices) : 0;
+	DrawCmd *cmd = rt_cmd(rt_exec_draw, sizeof(*cmd) + indices_size);
+	cmd->prim = prim;
+	cmd->first = first;
+	cmd->count = count;
+	cmd->instances = instances;
+	cmd->base_instance = base_instance;
+	cmd->indexed = indices != NULL;
+
+	if(indices) {
+		memcpy(cmd->indices, indices, indices_size);
+	}
+}
+
+typedef struct SwapCmd {
+	SDL_Window *window;
+} SwapCmd;
+
+static void rt_exec_swap(void *p) {
+	RT.real.swap(((SwapCmd*)p)->window);
+}
+
+static void rt_swap(SDL_Window *window) {
+	RT_CMD(rt_exec_swap, SwapCmd)->window = window;
+	rt_submit(false);
+}
+
+typedef struct ScreenshotCall {
+	uint *width;
+	uint *height;
+	uint8_t *result;
+} ScreenshotCall;
+
+static void rt_call_screenshot(void *arg) {
+	ScreenshotCall *call = arg;
+	call->result = RT.real.screenshot(call->width, call->height);
+}
+
+static uint8_t* rt_screenshot(uint *out_width, uint *out_height) {
+	ScreenshotCall call = { out_width, out_height };
+	rt_call(rt_call_screenshot, &call);
+	return call.result;
+}
+
+/*
+ * Debug labels. Setting one is deferred, getting one waits for the render thread.
+ * Also the calls that only take an object, like destroying it.
+ */
+
+typedef struct LabelCmd {
+	void *object;
+	char label[];
+} LabelCmd;
+
+typedef struct LabelCall {
+	void *object;
+	const char *result;
+} LabelCall;
+
+#define RT_LABEL_FUNCS(type, name) \
+	static void rt_exec_##name##_set_debug_label(void *p) { \
+		LabelCmd *cmd = p; \
+		RT.real.name##_set_debug_label(cmd->object, cmd->label); \
+	} \
+	static void rt_##name##_set_debug_label(type *obj, const char *label) { \
+		size_t len = strlen(label) + 1; \
+		LabelCmd *cmd = rt_cmd(rt_exec_##name##_set_debug_label, sizeof(*cmd) + len); \
+		cmd->object = obj; \
+		memcpy(cmd->label, label, len); \
+	} \
+	static void rt_call_##name##_get_debug_label(void *arg) { \
+		LabelCall *call = arg; \
+		call->result = RT.real.name##_get_debug_label(call->object); \
+	} \
+	static const char* rt_##name##_get_debug_label(type *obj) { \
+		LabelCall call = { obj }; \
+		rt_call(rt_call_##name##_get_debug_label, &call); \
+		return call.result; \
+	}
+
+RT_LABEL_FUNCS(ShaderObject, shader_object)
+RT_LABEL_FUNCS(ShaderProgram, shader_program)
+RT_LABEL_FUNCS(Texture, texture)
+RT_LABEL_FUNCS(Framebuffer, framebuffer)
+RT_LABEL_FUNCS(VertexBuffer, vertex_buffer)
+RT_LABEL_FUNCS(VertexArray, vertex_array)
+
+#define RT_OBJECT_CMD(type, name) \
+	static void rt_exec_##name(void *p) { \
+		RT.real.name(*(type**)p); \
+	} \
+	static void rt_##name##_cmd(type *obj) { \
+		*RT_CMD(rt_exec_##name, type*) = obj; \
+	}
+
+RT_OBJECT_CMD(ShaderObject, shader_object_destroy)
+RT_OBJECT_CMD(ShaderProgram, shader_program_destroy)
+RT_OBJECT_CMD(Texture, texture_destroy)
+RT_OBJECT_CMD(Texture, texture_invalidate)
+RT_OBJECT_CMD(Framebuffer, framebuffer_destroy)
+RT_OBJECT_CMD(VertexBuffer, vertex_buffer_destroy)
+RT_OBJECT_CMD(VertexBuffer, vertex_buffer_invalidate)
+RT_OBJECT_CMD(VertexArray, vertex_array_destroy)
+
+/*
+ * Shaders
+ */
+
+typedef struct ShaderObjectCompileCall {
+	ShaderSource *source;
+	ShaderObject *result;
+} ShaderObjectCompileCall;
+
+static void rt_call_shader_object_compile(void *arg) {
+	ShaderObjectCompileCall *call = arg;
+	call->result = RT.real.shader_object_compile(call->source);
+}
+
+static ShaderObject* rt_shader_object_compile(ShaderSource *source) {
+	ShaderObjectCompileCall call = { source };
+	rt_call(rt_call_shader_object_compile, &call);
+	return call.result;
+}
+
+static void rt_shader_object_destroy(ShaderObject *shobj) {
+	rt_shader_object_destroy_cmd(shobj);
+}
+
+typedef struct ShaderProgramLinkCall {
+	uint num_objects;
+	ShaderObject **shobjs;
+	ShaderProgram *result;
+} ShaderProgramLinkCall;
+
+static void rt_call_shader_program_link(void *arg) {
+	ShaderProgramLinkCall *call = arg;
+	call->result = RT.real.shader_program_link(call->num_objects, call->shobjs);
+}
+
+static ShaderProgram* rt_shader_program_link(uint num_objects, ShaderObject *shobjs[num_objects]) {
+	ShaderProgramLinkCall call = { num_objects, shobjs };
+	rt_call(rt_call_shader_program_link, &call);
+	return call.result;
+}
+
+static void rt_shader_program_destroy(ShaderProgram *prog) {
+	rt_forget_program(prog);
+	rt_shader_program_destroy_cmd(prog);
+}
+
+typedef struct ShaderUniformCall {
+	ShaderProgram *prog;
+	const char *name;
+	Uniform *result;
+	UniformType type;
+} ShaderUniformCall;
+
+static void rt_call_shader_uniform(void *arg) {
+	ShaderUniformCall *call = arg;
+	call->result = RT.real.shader_uniform(call->prog, call->name);
+
+	if(call->result) {
+		call->type = RT.real.uniform_type(call->result);
+	}
+}
+
+static Uniform* rt_shader_uniform(ShaderProgram *prog, const char *uniform_name) {
+	// uniforms are looked up by name all the time, but never change after linking
+	ht_str2ptr_t *uniforms = keyptr(ht_get(&RT.shadow.programs, ptrkey(prog), 0));
+	void *uniform;
+
+	if(!uniforms) {
+		uniforms = calloc(1, sizeof(*uniforms));
+		ht_create(uniforms);
+		ht_set(&RT.shadow.programs, ptrkey(prog), ptrkey(uniforms));
+	} else if(ht_lookup(uniforms, uniform_name, &uniform)) {
+		return uniform;
+	}
+
+	ShaderUniformCall call = { prog, uniform_name };
+	rt_call(rt_call_shader_uniform, &call);
+
+	if(call.result) {
+		ht_set(&RT.shadow.uniform_types, ptrkey(call.result), call.type);
+	}
+
+	ht_set(uniforms, uniform_name, call.result);
+	return call.result;
+}
+
+typedef struct UniformTypeCall {
+	Uniform *uniform;
+	UniformType result;
+} UniformTypeCall;
+
+static void rt_call_uniform_type(void *arg) {
+	UniformTypeCall *call = arg;
+	call->result = RT.real.uniform_type(call->uniform);
+}
+
+static UniformType rt_uniform_type(Uniform *uniform) {
+	int64_t type;
+
+	// normally cached by rt_shader_uniform
+	if(!ht_lookup(&RT.shadow.uniform_types, ptrkey(uniform), &type)) {
+		UniformTypeCall call = { uniform };
+		rt_call(rt_call_uniform_type, &call);
+		type = call.result;
+		ht_set(&RT.shadow.uniform_types, ptrkey(uniform), type);
+	}
+
+	return type;
+}
+
+typedef struct UniformCmd {
+	Uniform *uniform;
+	uint offset;
+	uint count;
+	alignas(max_align_t) char data[];
+} UniformCmd;
+
+static void rt_exec_uniform(void *p) {
+	UniformCmd *cmd = p;
+	RT.real.uniform(cmd->uniform, cmd->offset, cmd->count, cmd->data);
+}
+
+static void rt_uniform(Uniform *uniform, uint offset, uint count, const void *data) {
+	const UniformTypeInfo *info = r_uniform_type_info(rt_uniform_type(uniform));
+	size_t data_size = count * info->elements * info->element_size;
+
+	UniformCmd *cmd = rt_cmd(rt_exec_uniform, sizeof(*cmd) + data_size);
+	cmd->uniform = uniform;
+	cmd->offset = offset;
+	cmd->count = count;
+	memcpy(cmd->data, data, data_size);
+}
+
+/*
+ * Textures
+ */
+
+typedef struct TextureCreateCall {
+	const TextureParams *params;
+	Texture *result;
+} TextureCreateCall;
+
+static void rt_call_texture_create(void *arg) {
+	TextureCreateCall *call = arg;
+	call->result = RT.real.texture_create(call->params);
+}
+
+static Texture* rt_texture_create(const TextureParams *params) {
+	TextureCreateCall call = { params };
+	rt_call(rt_call_texture_create, &call);
+	return call.result;
+}
+
+typedef struct TextureGetParamsCall {
+	Texture *tex;
+	TextureParams *params;
+} TextureGetParamsCall;
+
+static void rt_call_texture_get_params(void *arg) {
+	TextureGetParamsCall *call = arg;
+	RT.real.texture_get_params(call->tex, call->params);
+}
+
+static void rt_texture_get_params(Texture *tex, TextureParams *params) {
+	// filtering and wrapping may still be changing on the render thread
+	rt_call(rt_call_texture_get_params, &(TextureGetParamsCall) { tex, params });
+}
+
+typedef struct TextureModeCmd {
+	Texture *tex;
+	uint a;
+	uint b;
+} TextureModeCmd;
+
+static void rt_exec_texture_set_filter(void *p) {
+	TextureModeCmd *cmd = p;
+	RT.real.texture_set_filter(cmd->tex, cmd->a, cmd->b);
+}
+
+static void rt_texture_set_filter(Texture *tex, TextureFilterMode fmin, TextureFilterMode fmag) {
+	*RT_CMD(rt_exec_texture_set_filter, TextureModeCmd) = (TextureModeCmd) { tex, fmin, fmag };
+}
+
+static void rt_exec_texture_set_wrap(void *p) {
+	TextureModeCmd *cmd = p;
+	RT.real.texture_set_wrap(cmd->tex, cmd->a, cmd->b);
+}
+
+static void rt_texture_set_wrap(Texture *tex, TextureWrapMode ws, TextureWrapMode wt) {
+	*RT_CMD(rt_exec_texture_set_wrap, TextureModeCmd) = (TextureModeCmd) { tex, ws, wt };
+}
+
+static void rt_texture_destroy(Texture *tex) {
+	rt_texture_destroy_cmd(tex);
+}
+
+static void rt_texture_invalidate(Texture *tex) {
+	rt_texture_invalidate_cmd(tex);
+}
+
+typedef struct TextureFillCall {
+	Texture *tex;
+	uint mipmap;
+	uint x, y, w, h;
+	void *image_data;
+	bool region;
+} TextureFillCall;
+
+static void rt_call_texture_fill(void *arg) {
+	TextureFillCall *call = arg;
+
+	if(call->region) {
+		RT.real.texture_fill_region(call->tex, call->mipmap, call->x, call->y, call->w, call->h, call->image_data);
+	} else {
+		RT.real.texture_fill(call->tex, call->mipmap, call->image_data);
+	}
+}
+
+// Uploads are rare after loading, so they are done in place rather than copying the image.
+
+static void rt_texture_fill(Texture *tex, uint mipmap, void *image_data) {
+	rt_call(rt_call_texture_fill, &(TextureFillCall) {
+		.tex = tex, .mipmap = mipmap, .image_data = image_data,
+	});
+}
+
+static void rt_texture_fill_region(Texture *tex, uint mipmap, uint x, uint y, uint w, uint h, void *image_data) {
+	rt_call(rt_call_texture_fill, &(TextureFillCall) {
+		.tex = tex, .mipmap = mipmap, .x = x, .y = y, .w = w, .h = h, .image_data = image_data, .region = true,
+	});
+}
+
+typedef struct TextureClearCmd {
+	Texture *tex;
+	Color color;
+} TextureClearCmd;
+
+static void rt_exec_texture_clear(void *p) {
+	TextureClearCmd *cmd = p;
+	RT.real.texture_clear(cmd->tex, &cmd->color);
+}
+
+static void rt_texture_clear(Texture *tex, const Color *clr) {
+	*RT_CMD(rt_exec_texture_clear, TextureClearCmd) = (TextureClearCmd) { tex, *clr };
+}
+
+/*
+ * Framebuffers
+ */
+
+typedef struct FramebufferCreateCall {
+	Framebuffer *result;
+	IntRect viewport;
+} FramebufferCreateCall;
+
+static void rt_call_framebuffer_create(void *arg) {
+	FramebufferCreateCall *call = arg;
+	call->result = RT.real.framebuffer_create();
+	RT.real.framebuffer_viewport_current(call->result, &call->viewport);
+}
+
+static Framebuffer* rt_framebuffer_create(void) {
+	FramebufferCreateCall call = { 0 };
+	rt_call(rt_call_framebuffer_create, &call);
+
+	FramebufferShadow *fbs = calloc(1, sizeof(*fbs));
+	fbs->viewport = call.viewport;
+	ht_set(&RT.shadow.framebuffers, ptrkey(call.result), ptrkey(fbs));
+
+	return call.result;
+}
+
+static void rt_framebuffer_destroy(Framebuffer *fb) {
+	free(rt_framebuffer_shadow(fb));
+	ht_unset(&RT.shadow.framebuffers, ptrkey(fb));
+	rt_framebuffer_destroy_cmd(fb);
+}
+
+typedef struct FramebufferAttachCmd {
+	Framebuffer *fb;
+	Texture *tex;
+	uint mipmap;
+	FramebufferAttachment attachment;
+} FramebufferAttachCmd;
+
+static void rt_exec_framebuffer_attach(void *p) {
+	FramebufferAttachCmd *cmd = p;
+	RT.real.framebuffer_attach(cmd->fb, cmd->tex, cmd->mipmap, cmd->attachment);
+}
+
+static void rt_framebuffer_attach(Framebuffer *fb, Texture *tex, uint mipmap, FramebufferAttachment attachment) {
+	FramebufferShadow *fbs = rt_framebuffer_shadow(fb);
+	fbs->attachments[attachment].texture = tex;
+	fbs->attachments[attachment].mipmap = mipmap;
+
+	*RT_CMD(rt_exec_framebuffer_attach, FramebufferAttachCmd) = (FramebufferAttachCmd) { fb, tex, mipmap, attachment };
+}
+
+static Texture* rt_framebuffer_get_attachment(Framebuffer *fb, FramebufferAttachment attachment) {
+	return rt_framebuffer_shadow(fb)->attachments[attachment].texture;
+}
+
+static uint rt_framebuffer_get_attachment_mipmap(Framebuffer *fb, FramebufferAttachment attachment) {
+	return rt_framebuffer_shadow(fb)->attachments[attachment].mipmap;
+}
+
+typedef struct FramebufferViewportCmd {
+	Framebuffer *fb;
+	IntRect vp;
+} FramebufferViewportCmd;
+
+static void rt_exec_framebuffer_viewport(void *p) {
+	FramebufferViewportCmd *cmd = p;
+	RT.real.framebuffer_viewport(cmd->fb, cmd->vp);
+}
+
+static void rt_framebuffer_viewport(Framebuffer *fb, IntRect vp) {
+	if(fb) {
+		rt_framebuffer_shadow(fb)->viewport = vp;
+	} else {
+		RT.shadow.default_viewport = vp;
+	}
+
+	*RT_CMD(rt_exec_framebuffer_viewport, FramebufferViewportCmd) = (FramebufferViewportCmd) { fb, vp };
+}
+
+static void rt_framebuffer_viewport_current(Framebuffer *fb, IntRect *vp) {
+	*vp = fb ? rt_framebuffer_shadow(fb)->viewport : RT.shadow.default_viewport;
+}
+
+typedef struct FramebufferClearCmd {
+	Framebuffer *fb;
+	ClearBufferFlags flags;
+	Color color;
+	float depth;
+} FramebufferClearCmd;
+
+static void rt_exec_framebuffer_clear(void *p) {
+	FramebufferClearCmd *cmd = p;
+	RT.real.framebuffer_clear(cmd->fb, cmd->flags, &cmd->color, cmd->depth);
+}
+
+static void rt_framebuffer_clear(Framebuffer *fb, ClearBufferFlags flags, const Color *colorval, float depthval) {
+	*RT_CMD(rt_exec_framebuffer_clear, FramebufferClearCmd) = (FramebufferClearCmd) {
+		fb, flags, colorval ? *colorval : (Color) { 0 }, depthval
+	};
+}
+
+/*
+ * Vertex buffers
+ */
+
+typedef struct VertexBufferCreateCall {
+	size_t capacity;
+	void *data;
+	VertexBuffer *result;
+} VertexBufferCreateCall;
+
+static void rt_call_vertex_buffer_create(void *arg) {
+	VertexBufferCreateCall *call = arg;
+	call->result = RT.real.vertex_buffer_create(call->capacity, call->data);
+}
+
+static VertexBuffer* rt_vertex_buffer_create(size_t capacity, void *data) {
+	VertexBufferCreateCall call = { capacity, data };
+	rt_call(rt_call_vertex_buffer_create, &call);
+	ht_set(&RT.shadow.vbuf_cursors, ptrkey(call.result), 0);
+	return call.result;
+}
+
+static void rt_vertex_buffer_destroy(VertexBuffer *vbuf) {
+	ht_unset(&RT.shadow.vbuf_cursors, ptrkey(vbuf));
+	rt_vertex_buffer_destroy_cmd(vbuf);
+}
+
+static void rt_vertex_buffer_invalidate(VertexBuffer *vbuf) {
+	ht_set(&RT.shadow.vbuf_cursors, ptrkey(vbuf), 0);
+	rt_vertex_buffer_invalidate_cmd(vbuf);
+}
+
+typedef struct VertexBufferWriteCmd {
+	VertexBuffer *vbuf;
+	size_t offset;
+	size_t size;
+	bool append;
+	alignas(max_align_t) char data[];
+} VertexBufferWriteCmd;
+
+static void rt_exec_vertex_buffer_write(void *p) {
+	VertexBufferWriteCmd *cmd = p;
+
+	if(cmd->append) {
+		RT.real.vertex_buffer_append(cmd->vbuf, cmd->size, cmd->data);
+	} else {
+		RT.real.vertex_buffer_write(cmd->vbuf, cmd->offset, cmd->size, cmd->data);
+	}
+}
+
+static VertexBufferWriteCmd *rt_vertex_buffer_write_cmd(VertexBuffer *vbuf, size_t data_size, void *data) {
+	VertexBufferWriteCmd *cmd = rt_cmd(rt_exec_vertex_buffer_write, sizeof(*cmd) + data_size);
+	cmd->vbuf = vbuf;
+	cmd->size = data_size;
+	memcpy(cmd->data, data, data_size);
+	return cmd;
+}
+
+static void rt_vertex_buffer_write(VertexBuffer *vbuf, size_t offset, size_t data_size, void *data) {
+	VertexBufferWriteCmd *cmd = rt_vertex_buffer_write_cmd(vbuf, data_size, data);
+	cmd->offset = offset;
+	cmd->append = false;
+}
+
+static void rt_vertex_buffer_append(VertexBuffer *vbuf, size_t data_size, void *data) {
+	VertexBufferWriteCmd *cmd = rt_vertex_buffer_write_cmd(vbuf, data_size, data);
+	cmd->offset = 0;
+	cmd->append = true;
+
+	int64_t cursor = ht_get(&RT.shadow.vbuf_cursors, ptrkey(vbuf), 0);
+	ht_set(&RT.shadow.vbuf_cursors, ptrkey(vbuf), cursor + data_size);
+}
+
+static size_t rt_vertex_buffer_get_capacity(VertexBuffer *vbuf) {
+	// fixed at creation, safe to read from here
+	return RT.real.vertex_buffer_get_capacity(vbuf);
+}
+
+static size_t rt_vertex_buffer_get_cursor(VertexBuffer *vbuf) {
+	return ht_get(&RT.shadow.vbuf_cursors, ptrkey(vbuf), 0);
+}
+
+typedef struct VertexBufferCursorCmd {
+	VertexBuffer *vbuf;
+	size_t pos;
+} VertexBufferCursorCmd;
+
+static void rt_exec_vertex_buffer_set_cursor(void *p) {
+	VertexBufferCursorCmd *cmd = p;
+	RT.real.vertex_buffer_set_cursor(cmd->vbuf, cmd->pos);
+}
+
+static void rt_vertex_buffer_set_cursor(VertexBuffer *vbuf, size_t pos) {
+	ht_set(&RT.shadow.vbuf_cursors, ptrkey(vbuf), pos);
+	*RT_CMD(rt_exec_vertex_buffer_set_cursor, VertexBufferCursorCmd) = (VertexBufferCursorCmd) { vbuf, pos };
+}
+
+/*
+ * Vertex arrays
+ */
+
+typedef struct VertexArrayCreateCall {
+	VertexArray *result;
+} VertexArrayCreateCall;
+
+static void rt_call_vertex_array_create(void *arg) {
+	VertexArrayCreateCall *call = arg;
+	call->result = RT.real.vertex_array_create();
+}
+
+static VertexArray* rt_vertex_array_create(void) {
+	VertexArrayCreateCall call = { 0 };
+	rt_call(rt_call_vertex_array_create, &call);
+	return call.result;
+}
+
+static void rt_vertex_array_destroy(VertexArray *varr) {
+	rt_vertex_array_destroy_cmd(varr);
+}
+
+typedef struct VertexArrayLayoutCmd {
+	VertexArray *varr;
+	uint nattribs;
+	VertexAttribFormat attribs[];
+} VertexArrayLayoutCmd;
+
+static void rt_exec_vertex_array_layout(void *p) {
+	VertexArrayLayoutCmd *cmd = p;
+	RT.real.vertex_array_layout(cmd->varr, cmd->nattribs, cmd->attribs);
+}
+
+static void rt_vertex_array_layout(VertexArray *varr, uint nattribs, VertexAttribFormat attribs[nattribs]) {
+	VertexArrayLayoutCmd *cmd = rt_cmd(rt_exec_vertex_array_layout, sizeof(*cmd) + nattribs * sizeof(*attribs));
+	cmd->varr = varr;
+	cmd->nattribs = nattribs;
+	memcpy(cmd->attribs, attribs, nattribs * sizeof(*attribs));
+}
+
+typedef struct VertexArrayAttachCmd {
+	VertexArray *varr;
+	VertexBuffer *vbuf;
+	uint attachment;
+} VertexArrayAttachCmd;
+
+static void rt_exec_vertex_array_attach_buffer(void *p) {
+	VertexArrayAttachCmd *cmd = p;
+	RT.real.vertex_array_attach_buffer(cmd->varr, cmd->vbuf, cmd->attachment);
+}
+
+static void rt_vertex_array_attach_buffer(VertexArray *varr, VertexBuffer *vbuf, uint attachment) {
+	*RT_CMD(rt_exec_vertex_array_attach_buffer, VertexArrayAttachCmd) = (VertexArrayAttachCmd) { varr, vbuf, attachment };
+}
+
+typedef struct VertexArrayGetAttachmentCall {
+	VertexArray *varr;
+	uint attachment;
+	VertexBuffer *result;
+} VertexArrayGetAttachmentCall;
+
+static void rt_call_vertex_array_get_attachment(void *arg) {
+	VertexArrayGetAttachmentCall *call = arg;
+	call->result = RT.real.vertex_array_get_attachment(call->varr, call->attachment);
+}
+
+static VertexBuffer* rt_vertex_array_get_attachment(VertexArray *varr, uint attachment) {
+	VertexArrayGetAttachmentCall call = { varr, attachment };
+	rt_call(rt_call_vertex_array_get_attachment, &call);
+	return call.result;
+}
+
+/*
+ * Calls that don't touch the rendering context or any mutable state go straight
+ * to the real backend: init, supports, shader_language_supported, texture_get_size
+ * (textures never change size) and vertex_buffer_get_capacity.
+ */
+
+static void rt_texture_get_size(Texture *tex, uint mipmap, uint *width, uint *height) {
+	RT.real.texture_get_size(tex, mipmap, width, height);
+}
+
+void _r_render_thread_wrap(RendererBackend *backend) {
+	memset(&RT, 0, sizeof(RT));
+	RT.real = backend->funcs;
+	RT.recording = RT.buffers;
+	RT.mutex = SDL_CreateMutex();
+	RT.cond = SDL_CreateCond();
+
+	ht_create(&RT.shadow.framebuffers);
+	ht_create(&RT.shadow.vbuf_cursors);
+	ht_create(&RT.shadow.programs);
+	ht_create(&RT.shadow.uniform_types);
+
+	backend->funcs = (RendererFuncs) {
+		.init = RT.real.init,
+		.post_init = rt_post_init,
+		.shutdown = rt_shutdown,
+		.create_window = rt_create_window,
+		.destroy_window = rt_destroy_window,
+		.supports = RT.real.supports,
+		.capabilities = rt_capabilities,
+		.capabilities_current = rt_capabilities_current,
+		.draw = rt_draw,
+		.color4 = rt_color4,
+		.color_current = rt_color_current,
+		.blend = rt_blend,
+		.blend_current = rt_blend_current,
+		.cull = rt_cull,
+		.cull_current = rt_cull_current,
+		.depth_func = rt_depth_func,
+		.depth_func_current = rt_depth_func_current,
+		.shader_language_supported = RT.real.shader_language_supported,
+		.shader_object_compile = rt_shader_object_compile,
+		.shader_object_destroy = rt_shader_object_destroy,
+		.shader_object_set_debug_label = rt_shader_object_set_debug_label,
+		.shader_object_get_debug_label = rt_shader_object_get_debug_label,
+		.shader_program_link = rt_shader_program_link,
+		.shader_program_destroy = rt_shader_program_destroy,
+		.shader_program_set_debug_label = rt_shader_program_set_debug_label,
+		.shader_program_get_debug_label = rt_shader_program_get_debug_label,
+		.shader = rt_shader,
+		.shader_current = rt_shader_current,
+		.shader_uniform = rt_shader_uniform,
+		.uniform = rt_uniform,
+		.uniform_type = rt_uniform_type,
+		.texture_create = rt_texture_create,
+		.texture_get_params = rt_texture_get_params,
+		.texture_get_size = rt_texture_get_size,
+		.texture_get_debug_label = rt_texture_get_debug_label,
+		.texture_set_debug_label = rt_texture_set_debug_label,
+		.texture_set_filter = rt_texture_set_filter,
+		.texture_set_wrap = rt_texture_set_wrap,
+		.texture_destroy = rt_texture_destroy,
+		.texture_invalidate = rt_texture_invalidate,
+		.texture_fill = rt_texture_fill,
+		.texture_fill_region = rt_texture_fill_region,
+		.texture_clear = rt_texture_clear,
+		.framebuffer_create = rt_framebuffer_create,
+		.framebuffer_get_debug_label = rt_framebuffer_get_debug_label,
+		.framebuffer_set_debug_label = rt_framebuffer_set_debug_label,
+		.framebuffer_destroy = rt_framebuffer_destroy,
+		.framebuffer_attach = rt_framebuffer_attach,
+		.framebuffer_viewport = rt_framebuffer_viewport,
+		.framebuffer_viewport_current = rt_framebuffer_viewport_current,
+		.framebuffer_get_attachment = rt_framebuffer_get_attachment,
+		.framebuffer_get_attachment_mipmap = rt_framebuffer_get_attachment_mipmap,
+		.framebuffer_clear = rt_framebuffer_clear,
+		.framebuffer = rt_framebuffer,
+		.framebuffer_current = rt_framebuffer_current,
+		.vertex_buffer_create = rt_vertex_buffer_create,
+		.vertex_buffer_get_debug_label = rt_vertex_buffer_get_debug_label,
+		.vertex_buffer_set_debug_label = rt_vertex_buffer_set_debug_label,
+		.vertex_buffer_destroy = rt_vertex_buffer_destroy,
+		.vertex_buffer_invalidate = rt_vertex_buffer_invalidate,
+		.vertex_buffer_write = rt_vertex_buffer_write,
+		.vertex_buffer_append = rt_vertex_buffer_append,
+		.vertex_buffer_get_capacity = rt_vertex_buffer_get_capacity,
+		.vertex_buffer_get_cursor = rt_vertex_buffer_get_cursor,
+		.vertex_buffer_set_cursor = rt_vertex_buffer_set_cursor,
+		.vertex_array_create = rt_vertex_array_create,
+		.vertex_array_get_debug_label = rt_vertex_array_get_debug_label,
+		.vertex_array_set_debug_label = rt_vertex_array_set_debug_label,
+		.vertex_array_destroy = rt_vertex_array_destroy,
+		.vertex_array_layout = rt_vertex_array_layout,
+		.vertex_array_attach_buffer = rt_vertex_array_attach_buffer,
+		.vertex_array_get_attachment = rt_vertex_array_get_attachment,
+		.vertex_array = rt_vertex_array,
+		.vertex_array_current = rt_vertex_array_current,
+		.vsync = rt_vsync,
+		.vsync_current = rt_vsync_current,
+		.swap = rt_swap,
+		.screenshot = rt_screenshot,
+	};
+}
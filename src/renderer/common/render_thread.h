@@ -0,0 +1,32 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include "backend.h"
+
+/*
+ * Pipelined rendering. The backend is wrapped so that calls made on the main thread are
+ * only recorded into a command buffer. At every swap the buffer is handed over to the
+ * render thread, which owns the rendering context and replays it against the real backend
+ * while the main thread simulates and records the next frame.
+ *
+ * State the main thread may query back (current shader, blend mode, framebuffer
+ * attachments, vertex buffer cursors, uniform locations...) is mirrored on the recording
+ * side. Calls that need a real answer from the backend, like object creation, wait until
+ * the render thread has caught up.
+ *
+ * Backends must not call back into the r_* API from their own functions, since those run
+ * on the render thread; anything that has to happen on the recording side (flushing the
+ * sprite batch, setting the built-in matrix uniforms) is done by the API before dispatch.
+ *
+ * Enabled with TAISEI_RENDER_THREAD=1.
+ */
+
+void _r_render_thread_wrap(RendererBackend *backend) attr_nonnull(1);
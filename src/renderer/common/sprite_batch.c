@@ -9,6 +9,7 @@
 #include "taisei.h"
 
 #include "sprite_batch.h"
+#include "render_stats.h"
 #include "../api.h"
 #include "util/glm.h"
 
@@ -26,10 +27,74 @@ typedef struct SpriteAttribs {
 
 #define SIZEOF_SPRITE_ATTRIBS (offsetof(SpriteAttribs, end_of_fields))
 
-static struct SpriteBatchState {
+// Instance format for sprites with a purely 2D transform, about a third of the size of
+// SpriteAttribs. The modelview is baked into a 2x2 linear part and a translation, so that
+// matrix changes between sprites don't force a flush. See interface/sprite.glslh.
+typedef struct SpriteAttribsCompact {
+	float transform[4];
+	float translation[3];
+	uint16_t rgba[4];        // half-precision floats
+	int16_t texrect[4];      // normalized
+	float sprite_size[2];
+	float custom[4];
+
+	char end_of_fields;
+} SpriteAttribsCompact;
+
+#define SIZEOF_SPRITE_ATTRIBS_COMPACT (offsetof(SpriteAttribsCompact, end_of_fields))
+
+typedef enum SpriteAttribsFormat {
+	SPRITE_ATTRIBS_FULL,
+	SPRITE_ATTRIBS_COMPACT,
+	NUM_SPRITE_ATTRIBS_FORMATS,
+} SpriteAttribsFormat;
+
+// State that deferred mode is allowed to reorder sprites by.
+// A NULL aux texture means "whatever is bound", same as in SpriteParams.
+typedef struct SpriteBatchKey {
+	Texture *primary_texture;
+	Texture *aux_textures[R_NUM_SPRITE_AUX_TEXTURES];
+	ShaderProgram *shader;
+	BlendMode blend;
+} SpriteBatchKey;
+
+#define DEFERRED_NONE UINT_MAX
+
+// How far back a deferred sprite may look for a bucket with a matching key.
+#define DEFERRED_MAX_BUCKETS_SCANNED 64
+#define DEFERRED_MAX_SPRITES_TESTED 256
+
+typedef struct DeferredSprite {
+	SpriteAttribsCompact attribs;
+	float bbox[4]; // x0, y0, x1, y1 in modelview space
+	uint next;
+} DeferredSprite;
+
+typedef struct DeferredBucket {
+	SpriteBatchKey key;
+	float bbox[4];
+	uint first;
+	uint last;
+} DeferredBucket;
+
+typedef struct SpriteStream {
 	VertexArray *varr;
 	VertexBuffer *vbuf;
 	uint base_instance;
+	size_t instance_size;
+} SpriteStream;
+
+enum {
+	SPRITE_U_COMPACT_ATTRIBS,
+	SPRITE_U_TEX,
+	SPRITE_U_TEX_AUX,
+};
+
+static struct SpriteBatchState {
+	SpriteStream streams[NUM_SPRITE_ATTRIBS_FORMATS];
+	SpriteAttribsFormat format;
+	bool compact_supported; // needs half float vertex attributes
+	UniformLayout uniforms;
 	Texture *primary_texture;
 	Texture *aux_textures[R_NUM_SPRITE_AUX_TEXTURES];
 	ShaderProgram *shader;
@@ -43,13 +108,53 @@ static struct SpriteBatchState {
 	uint depth_write_enabled : 1;
 	uint num_pending;
 
+	struct {
+		DeferredSprite *sprites;
+		DeferredBucket *buckets;
+		uint num_sprites;
+		uint num_buckets;
+		uint sprites_capacity;
+		uint buckets_capacity;
+		uint depth;
+		uint last_bucket;
+		uint key_changes;
+		bool enabled;
+		bool resolving;
+	} deferred;
+
 	struct {
 		uint flushes;
+		uint flushes_saved;
 		uint sprites;
+		uint compact_sprites;
+		uint deferred_sprites;
 		uint best_batch;
 		uint worst_batch;
 	} frame_stats;
-} _r_sprite_batch;
+} _r_sprite_batch = {
+	.uniforms.names = {
+		[SPRITE_U_COMPACT_ATTRIBS] = "spriteCompactAttribs",
+		[SPRITE_U_TEX]             = "tex",
+		[SPRITE_U_TEX_AUX]         = "tex_aux[0]",
+	},
+};
+
+static void _r_sprite_batch_init_stream(SpriteStream *stream, size_t instance_size, uint capacity, uint nattribs, VertexAttribFormat attribs[nattribs], const char *name) {
+	stream->instance_size = instance_size;
+
+	char buf[64];
+	snprintf(buf, sizeof(buf), "Sprite batch vertex buffer (%s)", name);
+	stream->vbuf = r_vertex_buffer_create(instance_size * capacity, NULL);
+	r_vertex_buffer_set_debug_label(stream->vbuf, buf);
+	r_vertex_buffer_invalidate(stream->vbuf);
+
+	snprintf(buf, sizeof(buf), "Sprite batch vertex array (%s)", name);
+	stream->varr = r_vertex_array_create();
+	r_vertex_array_set_debug_label(stream->varr, buf);
+	r_vertex_array_layout(stream->varr, nattribs, attribs);
+	r_vertex_array_attach_buffer(stream->varr, r_vertex_buffer_static_models(), 0);
+	r_vertex_array_attach_buffer(stream->varr, stream->vbuf, 1);
+}
 
 void _r_sprite_batch_init(void) {
 	#ifdef DEBUG
@@ -58,9 +163,11 @@ void _r_sprite_batch_init(void) {
 
 	size_t sz_vert = sizeof(GenericModelVertex);
 	size_t sz_attr = SIZEOF_SPRITE_ATTRIBS;
+	size_t sz_compact = SIZEOF_SPRITE_ATTRIBS_COMPACT;
 
 	#define VERTEX_OFS(attr)   offsetof(GenericModelVertex,  attr)
 	#define INSTANCE_OFS(attr) offsetof(SpriteAttribs, attr)
+	#define COMPACT_OFS(attr)  offsetof(SpriteAttribsCompact, attr)
 
 	VertexAttribFormat fmt[] = {
 		// Per-vertex attributes (for the static models buffer, bound at 0)
@@ -83,8 +190,29 @@ void _r_sprite_batch_init(void) {
 		{ { 4, VA_FLOAT, VA_CONVERT_FLOAT, 1 }, sz_attr, INSTANCE_OFS(custom),           1 },
 	};
 
+	// Same attribute locations as above; the unused ones (5-10) are left disabled.
+	VertexAttribFormat fmt_compact[] = {
+		{ { 3, VA_FLOAT,      VA_CONVERT_FLOAT,            0 }, sz_vert,    VERTEX_OFS(position),     0 },
+		{ { 3, VA_FLOAT,      VA_CONVERT_FLOAT,            0 }, sz_vert,    VERTEX_OFS(normal),       0 },
+		{ { 2, VA_FLOAT,      VA_CONVERT_FLOAT,            0 }, sz_vert,    VERTEX_OFS(uv),           0 },
+
+		{ { 4, VA_FLOAT,      VA_CONVERT_FLOAT,            1 }, sz_compact, COMPACT_OFS(transform),   1 },
+		{ { 3, VA_FLOAT,      VA_CONVERT_FLOAT,            1 }, sz_compact, COMPACT_OFS(translation), 1 },
+		{ { 0 } },
+		{ { 0 } },
+		{ { 0 } },
+		{ { 0 } },
+		{ { 0 } },
+		{ { 0 } },
+		{ { 4, VA_HALF_FLOAT, VA_CONVERT_FLOAT,            1 }, sz_compact, COMPACT_OFS(rgba),        1 },
+		{ { 4, VA_SHORT,      VA_CONVERT_FLOAT_NORMALIZED, 1 }, sz_compact, COMPACT_OFS(texrect),     1 },
+		{ { 2, VA_FLOAT,      VA_CONVERT_FLOAT,            1 }, sz_compact, COMPACT_OFS(sprite_size), 1 },
+		{ { 4, VA_FLOAT,      VA_CONVERT_FLOAT,            1 }, sz_compact, COMPACT_OFS(custom),      1 },
+	};
+
 	#undef VERTEX_OFS
 	#undef INSTANCE_OFS
+	#undef COMPACT_OFS
 
 	uint capacity;
 
@@ -94,23 +222,38 @@ void _r_sprite_batch_init(void) {
 		capacity = 1 << 11;
 	}
 
-	_r_sprite_batch.vbuf = r_vertex_buffer_create(sz_attr * capacity, NULL);
-	r_vertex_buffer_set_debug_label(_r_sprite_batch.vbuf, "Sprite batch vertex buffer");
-	r_vertex_buffer_invalidate(_r_sprite_batch.vbuf);
+	_r_sprite_batch_init_stream(_r_sprite_batch.streams + SPRITE_ATTRIBS_FULL, sz_attr, capacity, sizeof(fmt)/sizeof(*fmt), fmt, "full");
+	_r_sprite_batch.compact_supported = r_supports(RFEAT_VERTEX_HALF_FLOAT);
+
+	if(_r_sprite_batch.compact_supported) {
+		_r_sprite_batch_init_stream(_r_sprite_batch.streams + SPRITE_ATTRIBS_COMPACT, sz_compact, capacity, sizeof(fmt_compact)/sizeof(*fmt_compact), fmt_compact, "compact");
+	} else {
+		log_warn("Half float vertex attributes not supported, all sprites will use full transforms");
+	}
 
-	_r_sprite_batch.varr = r_vertex_array_create();
-	r_vertex_array_set_debug_label(_r_sprite_batch.varr, "Sprite batch vertex array");
-	r_vertex_array_layout(_r_sprite_batch.varr, sizeof(fmt)/sizeof(*fmt), fmt);
-	r_vertex_array_attach_buffer(_r_sprite_batch.varr, r_vertex_buffer_static_models(), 0);
-	r_vertex_array_attach_buffer(_r_sprite_batch.varr, _r_sprite_batch.vbuf, 1);
+	// deferred sprites are stored in the compact format
+	_r_sprite_batch.deferred.enabled = _r_sprite_batch.compact_supported && env_get("TAISEI_SPRITE_DEFER", false);
 }
 
 void _r_sprite_batch_shutdown(void) {
-	r_vertex_array_destroy(_r_sprite_batch.varr);
-	r_vertex_buffer_destroy(_r_sprite_batch.vbuf);
+	for(uint i = 0; i < NUM_SPRITE_ATTRIBS_FORMATS; ++i) {
+		if(_r_sprite_batch.streams[i].varr) {
+			r_vertex_array_destroy(_r_sprite_batch.streams[i].varr);
+			r_vertex_buffer_destroy(_r_sprite_batch.streams[i].vbuf);
+		}
+	}
+
+	free(_r_sprite_batch.deferred.sprites);
+	free(_r_sprite_batch.deferred.buckets);
 }
 
+static void _r_sprite_batch_resolve_deferred(void);
+
 void r_flush_sprites(void) {
+	if(_r_sprite_batch.deferred.num_sprites && !_r_sprite_batch.deferred.resolving) {
+		_r_sprite_batch_resolve_deferred();
+	}
+
 	if(_r_sprite_batch.num_pending == 0) {
 		return;
 	}
@@ -133,6 +276,10 @@ void r_flush_sprites(void) {
 
 	_r_sprite_batch.num_pending = 0;
 	_r_sprite_batch.frame_stats.flushes++;
+	_r_stats_add(RSTAT_SPRITE_FLUSHES, 1);
+	_r_stats_add(RSTAT_SPRITES, pending);
+
+	SpriteStream *stream = _r_sprite_batch.streams + _r_sprite_batch.format;
 
 	r_state_push();
 
@@ -140,10 +287,13 @@ void r_flush_sprites(void) {
 	r_mat_push();
 	glm_mat4_copy(_r_sprite_batch.projection, *r_mat_current_ptr(MM_PROJECTION));
 
-	r_vertex_array(_r_sprite_batch.varr);
+	r_vertex_array(stream->varr);
 	r_shader_ptr(_r_sprite_batch.shader);
-	r_uniform_sampler("tex", _r_sprite_batch.primary_texture);
-	r_uniform_sampler_array("tex_aux[0]", 0, R_NUM_SPRITE_AUX_TEXTURES, _r_sprite_batch.aux_textures);
+
+	Uniform **u = r_uniform_layout(&_r_sprite_batch.uniforms, _r_sprite_batch.shader);
+	r_uniform_int(u[SPRITE_U_COMPACT_ATTRIBS], _r_sprite_batch.format == SPRITE_ATTRIBS_COMPACT);
+	r_uniform_sampler(u[SPRITE_U_TEX], _r_sprite_batch.primary_texture);
+	r_uniform_sampler_array(u[SPRITE_U_TEX_AUX], 0, R_NUM_SPRITE_AUX_TEXTURES, _r_sprite_batch.aux_textures);
 	r_framebuffer(_r_sprite_batch.framebuffer);
 	r_blend(_r_sprite_batch.blend);
 	r_capability(RCAP_DEPTH_TEST, _r_sprite_batch.depth_test_enabled);
@@ -153,26 +303,26 @@ void r_flush_sprites(void) {
 	r_cull(_r_sprite_batch.cull_mode);
 
 	if(r_supports(RFEAT_DRAW_INSTANCED_BASE_INSTANCE)) {
-		r_draw(PRIM_TRIANGLE_FAN, 0, 4, NULL, pending, _r_sprite_batch.base_instance);
-		_r_sprite_batch.base_instance += pending;
+		r_draw(PRIM_TRIANGLE_FAN, 0, 4, NULL, pending, stream->base_instance);
+		stream->base_instance += pending;
 
-		size_t remaining = r_vertex_buffer_get_capacity(_r_sprite_batch.vbuf) - r_vertex_buffer_get_cursor(_r_sprite_batch.vbuf);
+		size_t remaining = r_vertex_buffer_get_capacity(stream->vbuf) - r_vertex_buffer_get_cursor(stream->vbuf);
 
-		if(remaining < SIZEOF_SPRITE_ATTRIBS) {
-			// log_debug("Invalidating after %u sprites", _r_sprite_batch.base_instance);
-			r_vertex_buffer_invalidate(_r_sprite_batch.vbuf);
-			_r_sprite_batch.base_instance = 0;
+		if(remaining < stream->instance_size) {
+			// log_debug("Invalidating after %u sprites", stream->base_instance);
+			r_vertex_buffer_invalidate(stream->vbuf);
+			stream->base_instance = 0;
 		}
 	} else {
 		r_draw(PRIM_TRIANGLE_FAN, 0, 4, NULL, pending, 0);
-		r_vertex_buffer_invalidate(_r_sprite_batch.vbuf);
+		r_vertex_buffer_invalidate(stream->vbuf);
 	}
 
 	r_mat_pop();
 	r_state_pop();
 }
 
-static void _r_sprite_batch_add(Sprite *spr, const SpriteParams *params, VertexBuffer *vbuf) {
+static void _r_sprite_batch_add_full(Sprite *spr, const SpriteParams *params, VertexBuffer *vbuf) {
 	SpriteAttribs alignas(32) attribs;
 	r_mat_current(MM_MODELVIEW, attribs.transform);
 	r_mat_current(MM_TEXTURE, attribs.tex_transform);
@@ -231,10 +381,142 @@ static void _r_sprite_batch_add(Sprite *spr, const SpriteParams *params, VertexB
 	}
 
 	r_vertex_buffer_append(vbuf, SIZEOF_SPRITE_ATTRIBS, &attribs);
-	_r_sprite_batch.frame_stats.sprites++;
 }
 
-void r_draw_sprite(const SpriteParams *params) {
+static uint16_t float_to_half(float f) {
+	union { float f; uint32_t u; } v = { f };
+	uint32_t sign = (v.u >> 16) & 0x8000;
+	int32_t exp = (int32_t)((v.u >> 23) & 0xff) - 127 + 15;
+	uint32_t mant = v.u & 0x7fffff;
+
+	if(exp <= 0) {
+		// too small for a normal half; colors don't need denormals
+		return sign;
+	}
+
+	if(exp >= 31) {
+		// overflow, infinity or NaN; clamp to the largest finite value
+		return sign | 0x7bff;
+	}
+
+	// round to nearest; a carry out of the mantissa correctly bumps the exponent
+	return (sign | (exp << 10) | (mant >> 13)) + ((mant >> 12) & 1);
+}
+
+static inline int16_t float_to_snorm16(float f) {
+	return (int16_t)(clamp(f, -1, 1) * 32767 + (f < 0 ? -0.5f : 0.5f));
+}
+
+static bool _r_sprite_batch_is_2d(const SpriteParams *params) {
+	if(params->rotation.angle) {
+		float *rvec = (float*)params->rotation.vector;
+
+		if(rvec[0] != 0 || rvec[1] != 0) {
+			return false;
+		}
+	}
+
+	mat4 *mv = r_mat_current_ptr(MM_MODELVIEW);
+
+	if(
+		(*mv)[0][2] != 0 || (*mv)[0][3] != 0 ||
+		(*mv)[1][2] != 0 || (*mv)[1][3] != 0 ||
+		(*mv)[3][3] != 1
+	) {
+		return false;
+	}
+
+	static const float identity[16] = {
+		1, 0, 0, 0,
+		0, 1, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1,
+	};
+
+	return !memcmp(*r_mat_current_ptr(MM_TEXTURE), identity, sizeof(identity));
+}
+
+static void _r_sprite_batch_fill_compact(Sprite *spr, const SpriteParams *params, SpriteAttribsCompact *attribs_out) {
+	SpriteAttribsCompact attribs;
+	mat4 *mv = r_mat_current_ptr(MM_MODELVIEW);
+
+	float scale_x = params->scale.x ? params->scale.x : 1;
+	float scale_y = params->scale.y ? params->scale.y : scale_x;
+	float kx = scale_x * spr->w;
+	float ky = scale_y * spr->h;
+
+	// Local transform: translate(pos) * rotate_z(angle) * scale(kx, ky), as in the full path.
+	float l00 = kx, l01 = 0, l10 = 0, l11 = ky;
+
+	if(params->rotation.angle) {
+		// _r_sprite_batch_is_2d allows any axis along z; rotating about -z is rotating backwards
+		float angle = params->rotation.vector[2] < 0 ? -params->rotation.angle : params->rotation.angle;
+		float c = cosf(angle);
+		float s = sinf(angle);
+		l00 = c * kx;
+		l01 = s * kx;
+		l10 = -s * ky;
+		l11 = c * ky;
+	}
+
+	float px = params->pos.x;
+	float py = params->pos.y;
+
+	attribs.transform[0] = (*mv)[0][0] * l00 + (*mv)[1][0] * l01;
+	attribs.transform[1] = (*mv)[0][1] * l00 + (*mv)[1][1] * l01;
+	attribs.transform[2] = (*mv)[0][0] * l10 + (*mv)[1][0] * l11;
+	attribs.transform[3] = (*mv)[0][1] * l10 + (*mv)[1][1] * l11;
+	attribs.translation[0] = (*mv)[0][0] * px + (*mv)[1][0] * py + (*mv)[3][0];
+	attribs.translation[1] = (*mv)[0][1] * px + (*mv)[1][1] * py + (*mv)[3][1];
+	attribs.translation[2] = (*mv)[3][2];
+
+	if(params->color == NULL) {
+		attribs.rgba[0] = attribs.rgba[1] = attribs.rgba[2] = attribs.rgba[3] = float_to_half(1);
+	} else {
+		attribs.rgba[0] = float_to_half(params->color->r);
+		attribs.rgba[1] = float_to_half(params->color->g);
+		attribs.rgba[2] = float_to_half(params->color->b);
+		attribs.rgba[3] = float_to_half(params->color->a);
+	}
+
+	uint tw, th;
+	r_texture_get_size(spr->tex, 0, &tw, &th);
+
+	FloatRect texrect = {
+		.x = spr->tex_area.x / tw,
+		.y = spr->tex_area.y / th,
+		.w = spr->tex_area.w / tw,
+		.h = spr->tex_area.h / th,
+	};
+
+	if(params->flip.x) {
+		texrect.x += texrect.w;
+		texrect.w *= -1;
+	}
+
+	if(params->flip.y) {
+		texrect.y += texrect.h;
+		texrect.h *= -1;
+	}
+
+	attribs.texrect[0] = float_to_snorm16(texrect.x);
+	attribs.texrect[1] = float_to_snorm16(texrect.y);
+	attribs.texrect[2] = float_to_snorm16(texrect.w);
+	attribs.texrect[3] = float_to_snorm16(texrect.h);
+
+	attribs.sprite_size[0] = spr->w;
+	attribs.sprite_size[1] = spr->h;
+
+	if(params->shader_params != NULL) {
+		memcpy(attribs.custom, params->shader_params, sizeof(attribs.custom));
+	} else {
+		memset(attribs.custom, 0, sizeof(attribs.custom));
+	}
+
+	*attribs_out = attribs;
+}
+
+static void _r_sprite_batch_resolve_key(const SpriteParams *params, Sprite **out_spr, SpriteBatchKey *key) {
 	assert(!(params->shader && params->shader_ptr));
 	assert(!(params->sprite && params->sprite_ptr));
 
@@ -245,13 +527,42 @@ void r_draw_sprite(const SpriteParams *params) {
 		spr = get_sprite(params->sprite);
 	}
 
-	if(spr->tex != _r_sprite_batch.primary_texture) {
+	ShaderProgram *prog = params->shader_ptr;
+
+	if(prog == NULL) {
+		if(params->shader == NULL) {
+			prog = r_shader_current();
+		} else {
+			prog = r_shader_get(params->shader);
+		}
+	}
+
+	assert(prog != NULL);
+
+	key->primary_texture = spr->tex;
+	memcpy(key->aux_textures, params->aux_textures, sizeof(key->aux_textures));
+	key->shader = prog;
+	key->blend = params->blend ? params->blend : r_blend_current();
+
+	*out_spr = spr;
+}
+
+static bool _r_sprite_batch_key_equal(const SpriteBatchKey *a, const SpriteBatchKey *b) {
+	return
+		a->primary_texture == b->primary_texture &&
+		!memcmp(a->aux_textures, b->aux_textures, sizeof(a->aux_textures)) &&
+		a->shader == b->shader &&
+		a->blend == b->blend;
+}
+
+static void _r_sprite_batch_apply_key(const SpriteBatchKey *key) {
+	if(key->primary_texture != _r_sprite_batch.primary_texture) {
 		r_flush_sprites();
-		_r_sprite_batch.primary_texture = spr->tex;
+		_r_sprite_batch.primary_texture = key->primary_texture;
 	}
 
 	for(uint i = 0; i < R_NUM_SPRITE_AUX_TEXTURES; ++i) {
-		Texture *aux_tex = params->aux_textures[i];
+		Texture *aux_tex = key->aux_textures[i];
 
 		if(aux_tex != NULL && aux_tex != _r_sprite_batch.aux_textures[i]) {
 			r_flush_sprites();
@@ -259,91 +570,298 @@ void r_draw_sprite(const SpriteParams *params) {
 		}
 	}
 
-	ShaderProgram *prog = params->shader_ptr;
+	if(key->shader != _r_sprite_batch.shader) {
+		r_flush_sprites();
+		_r_sprite_batch.shader = key->shader;
+	}
 
-	if(prog == NULL) {
-		if(params->shader == NULL) {
-			prog = r_shader_current();
-		} else {
-			prog = r_shader_get(params->shader);
-		}
+	if(key->blend != _r_sprite_batch.blend) {
+		r_flush_sprites();
+		_r_sprite_batch.blend = key->blend;
 	}
+}
 
-	assert(prog != NULL);
+static bool _r_sprite_batch_target_changed(void) {
+	return
+		_r_sprite_batch.framebuffer != r_framebuffer_current() ||
+		_r_sprite_batch.depth_test_enabled != r_capability_current(RCAP_DEPTH_TEST) ||
+		_r_sprite_batch.depth_write_enabled != r_capability_current(RCAP_DEPTH_WRITE) ||
+		_r_sprite_batch.cull_enabled != r_capability_current(RCAP_CULL_FACE) ||
+		_r_sprite_batch.depth_func != r_depth_func_current() ||
+		_r_sprite_batch.cull_mode != r_cull_current() ||
+		memcmp(*r_mat_current_ptr(MM_PROJECTION), _r_sprite_batch.projection, sizeof(mat4));
+}
+
+static void _r_sprite_batch_apply_target(void) {
+	if(!_r_sprite_batch_target_changed()) {
+		return;
+	}
+
+	r_flush_sprites();
+
+	_r_sprite_batch.framebuffer = r_framebuffer_current();
+	_r_sprite_batch.depth_test_enabled = r_capability_current(RCAP_DEPTH_TEST);
+	_r_sprite_batch.depth_write_enabled = r_capability_current(RCAP_DEPTH_WRITE);
+	_r_sprite_batch.cull_enabled = r_capability_current(RCAP_CULL_FACE);
+	_r_sprite_batch.depth_func = r_depth_func_current();
+	_r_sprite_batch.cull_mode = r_cull_current();
+	glm_mat4_copy(*r_mat_current_ptr(MM_PROJECTION), _r_sprite_batch.projection);
+}
 
-	if(prog != _r_sprite_batch.shader) {
+static void _r_sprite_batch_set_format(SpriteAttribsFormat format) {
+	if(format != _r_sprite_batch.format) {
 		r_flush_sprites();
-		_r_sprite_batch.shader = prog;
+		_r_sprite_batch.format = format;
 	}
+}
 
-	Framebuffer *fb = r_framebuffer_current();
+static SpriteStream* _r_sprite_batch_reserve(void) {
+	SpriteStream *stream = _r_sprite_batch.streams + _r_sprite_batch.format;
+	size_t remaining = r_vertex_buffer_get_capacity(stream->vbuf) - r_vertex_buffer_get_cursor(stream->vbuf);
+
+	if(remaining < stream->instance_size) {
+		if(!r_supports(RFEAT_DRAW_INSTANCED_BASE_INSTANCE)) {
+			log_warn("Vertex buffer exhausted (%zu needed for next sprite, %zu remaining), flush forced", stream->instance_size, remaining);
+		}
 
-	if(fb != _r_sprite_batch.framebuffer) {
 		r_flush_sprites();
-		_r_sprite_batch.framebuffer = fb;
 	}
 
-	BlendMode blend = params->blend;
+	_r_sprite_batch.num_pending++;
+	_r_sprite_batch.frame_stats.sprites++;
+
+	return stream;
+}
+
+static void _r_sprite_batch_append_compact(SpriteAttribsCompact *attribs) {
+	SpriteStream *stream = _r_sprite_batch_reserve();
+	r_vertex_buffer_append(stream->vbuf, SIZEOF_SPRITE_ATTRIBS_COMPACT, attribs);
+	_r_sprite_batch.frame_stats.compact_sprites++;
+}
+
+static void _r_sprite_batch_draw_immediate(Sprite *spr, const SpriteParams *params, const SpriteBatchKey *key) {
+	_r_sprite_batch_apply_key(key);
+	_r_sprite_batch_apply_target();
 
-	if(blend == 0) {
-		blend = r_blend_current();
+	// A batch that has already fallen back to full matrices keeps using them for 2D sprites too,
+	// so that interleaved 2D and 3D sprites don't flush on every switch.
+	if(_r_sprite_batch.num_pending == 0 || _r_sprite_batch.format == SPRITE_ATTRIBS_COMPACT) {
+		bool compact = _r_sprite_batch.compact_supported && _r_sprite_batch_is_2d(params);
+		_r_sprite_batch_set_format(compact ? SPRITE_ATTRIBS_COMPACT : SPRITE_ATTRIBS_FULL);
 	}
 
-	if(blend != _r_sprite_batch.blend) {
-		r_flush_sprites();
-		_r_sprite_batch.blend = blend;
+	if(_r_sprite_batch.format == SPRITE_ATTRIBS_COMPACT) {
+		SpriteAttribsCompact attribs;
+		_r_sprite_batch_fill_compact(spr, params, &attribs);
+		_r_sprite_batch_append_compact(&attribs);
+	} else {
+		SpriteStream *stream = _r_sprite_batch_reserve();
+		_r_sprite_batch_add_full(spr, params, stream->vbuf);
 	}
+}
 
-	bool depth_test_enabled = r_capability_current(RCAP_DEPTH_TEST);
-	bool depth_write_enabled = r_capability_current(RCAP_DEPTH_WRITE);
-	bool cull_enabled = r_capability_current(RCAP_CULL_FACE);
-	DepthTestFunc depth_func = r_depth_func_current();
-	CullFaceMode cull_mode = r_cull_current();
+/*
+ * Deferred mode
+ *
+ * Sprites are collected into buckets of equal SpriteBatchKey, kept in submission order. A new
+ * sprite joins the most recent bucket with its key, unless a sprite in any of the buckets after
+ * that one overlaps it, in which case it starts a new bucket at the end. So a sprite is only
+ * ever moved in front of sprites it doesn't touch, which makes the reordering invisible
+ * regardless of the blend modes involved.
+ *
+ * Only 2D sprites without depth testing under a projection whose x/y output doesn't depend on z
+ * are deferred; bounding boxes in modelview space are then conclusive. Anything else resolves
+ * the queue first and is drawn immediately.
+ */
 
-	if(_r_sprite_batch.depth_test_enabled != depth_test_enabled) {
-		r_flush_sprites();
-		_r_sprite_batch.depth_test_enabled = depth_test_enabled;
+static bool _r_sprite_batch_can_defer(const SpriteParams *params) {
+	if(
+		!_r_sprite_batch.deferred.depth ||
+		r_capability_current(RCAP_DEPTH_TEST) ||
+		r_capability_current(RCAP_DEPTH_WRITE) ||
+		!_r_sprite_batch_is_2d(params)
+	) {
+		return false;
 	}
 
-	if(_r_sprite_batch.depth_write_enabled != depth_write_enabled) {
-		r_flush_sprites();
-		_r_sprite_batch.depth_write_enabled = depth_write_enabled;
+	mat4 *p = r_mat_current_ptr(MM_PROJECTION);
+
+	return
+		(*p)[2][0] == 0 && (*p)[2][1] == 0 &&
+		(*p)[0][3] == 0 && (*p)[1][3] == 0 && (*p)[2][3] == 0;
+}
+
+static inline bool _r_sprite_batch_bbox_overlap(const float a[4], const float b[4]) {
+	return !(a[2] < b[0] || b[2] < a[0] || a[3] < b[1] || b[3] < a[1]);
+}
+
+static inline void _r_sprite_batch_bbox_union(float dst[4], const float src[4]) {
+	dst[0] = fminf(dst[0], src[0]);
+	dst[1] = fminf(dst[1], src[1]);
+	dst[2] = fmaxf(dst[2], src[2]);
+	dst[3] = fmaxf(dst[3], src[3]);
+}
+
+static bool _r_sprite_batch_bucket_blocks(DeferredBucket *b, const float bbox[4], uint *tests_left) {
+	if(!_r_sprite_batch_bbox_overlap(b->bbox, bbox)) {
+		return false;
 	}
 
-	if(_r_sprite_batch.cull_enabled != cull_enabled) {
-		r_flush_sprites();
-		_r_sprite_batch.cull_enabled = cull_enabled;
+	for(uint i = b->first; i != DEFERRED_NONE; i = _r_sprite_batch.deferred.sprites[i].next) {
+		if(*tests_left == 0) {
+			return true;
+		}
+
+		--*tests_left;
+
+		if(_r_sprite_batch_bbox_overlap(_r_sprite_batch.deferred.sprites[i].bbox, bbox)) {
+			return true;
+		}
 	}
 
-	if(_r_sprite_batch.depth_func != depth_func) {
-		r_flush_sprites();
-		_r_sprite_batch.depth_func = depth_func;
+	return false;
+}
+
+static DeferredBucket* _r_sprite_batch_find_bucket(const SpriteBatchKey *key, const float bbox[4]) {
+	uint num_buckets = _r_sprite_batch.deferred.num_buckets;
+	uint min_bucket = num_buckets > DEFERRED_MAX_BUCKETS_SCANNED ? num_buckets - DEFERRED_MAX_BUCKETS_SCANNED : 0;
+	uint tests_left = DEFERRED_MAX_SPRITES_TESTED;
+
+	for(uint i = num_buckets; i > min_bucket; --i) {
+		DeferredBucket *b = _r_sprite_batch.deferred.buckets + i - 1;
+
+		if(_r_sprite_batch_key_equal(&b->key, key)) {
+			return b;
+		}
+
+		if(_r_sprite_batch_bucket_blocks(b, bbox, &tests_left)) {
+			break;
+		}
 	}
 
-	if(_r_sprite_batch.cull_mode != cull_mode) {
-		r_flush_sprites();
-		_r_sprite_batch.cull_mode = cull_mode;
+	if(_r_sprite_batch.deferred.num_buckets == _r_sprite_batch.deferred.buckets_capacity) {
+		_r_sprite_batch.deferred.buckets_capacity = _r_sprite_batch.deferred.buckets_capacity ? _r_sprite_batch.deferred.buckets_capacity * 2 : 64;
+		_r_sprite_batch.deferred.buckets = realloc(_r_sprite_batch.deferred.buckets, _r_sprite_batch.deferred.buckets_capacity * sizeof(DeferredBucket));
 	}
 
-	mat4 *current_projection = r_mat_current_ptr(MM_PROJECTION);
+	DeferredBucket *b = _r_sprite_batch.deferred.buckets + _r_sprite_batch.deferred.num_buckets++;
+	b->key = *key;
+	memcpy(b->bbox, bbox, sizeof(b->bbox));
+	b->first = b->last = DEFERRED_NONE;
 
-	if(memcmp(*current_projection, _r_sprite_batch.projection, sizeof(mat4))) {
-		r_flush_sprites();
-		glm_mat4_copy(*current_projection, _r_sprite_batch.projection);
+	return b;
+}
+
+static void _r_sprite_batch_draw_deferred(Sprite *spr, const SpriteParams *params, const SpriteBatchKey *key) {
+	if(_r_sprite_batch.deferred.num_sprites && _r_sprite_batch_target_changed()) {
+		_r_sprite_batch_resolve_deferred();
 	}
 
-	size_t remaining = r_vertex_buffer_get_capacity(_r_sprite_batch.vbuf) - r_vertex_buffer_get_cursor(_r_sprite_batch.vbuf);
+	// Deferred sprites are drawn with whatever target state the batch holds when they are
+	// resolved, so it has to be the current one.
+	_r_sprite_batch_apply_target();
 
-	if(remaining < SIZEOF_SPRITE_ATTRIBS) {
-		if(!r_supports(RFEAT_DRAW_INSTANCED_BASE_INSTANCE)) {
-			log_warn("Vertex buffer exhausted (%zu needed for next sprite, %zu remaining), flush forced", SIZEOF_SPRITE_ATTRIBS, remaining);
+	if(_r_sprite_batch.deferred.num_sprites == _r_sprite_batch.deferred.sprites_capacity) {
+		_r_sprite_batch.deferred.sprites_capacity = _r_sprite_batch.deferred.sprites_capacity ? _r_sprite_batch.deferred.sprites_capacity * 2 : 1024;
+		_r_sprite_batch.deferred.sprites = realloc(_r_sprite_batch.deferred.sprites, _r_sprite_batch.deferred.sprites_capacity * sizeof(DeferredSprite));
+	}
+
+	uint idx = _r_sprite_batch.deferred.num_sprites;
+	DeferredSprite *ds = _r_sprite_batch.deferred.sprites + idx;
+	_r_sprite_batch_fill_compact(spr, params, &ds->attribs);
+	ds->next = DEFERRED_NONE;
+
+	// The quad spans [-0.5, 0.5] on both axes.
+	const float *m = ds->attribs.transform;
+	const float *t = ds->attribs.translation;
+	float ex = 0.5f * (fabsf(m[0]) + fabsf(m[2]));
+	float ey = 0.5f * (fabsf(m[1]) + fabsf(m[3]));
+	ds->bbox[0] = t[0] - ex;
+	ds->bbox[1] = t[1] - ey;
+	ds->bbox[2] = t[0] + ex;
+	ds->bbox[3] = t[1] + ey;
+
+	if(idx > 0 && !_r_sprite_batch_key_equal(&_r_sprite_batch.deferred.buckets[_r_sprite_batch.deferred.last_bucket].key, key)) {
+		// would have been a flush in submission order
+		_r_sprite_batch.deferred.key_changes++;
+	}
+
+	DeferredBucket *b = _r_sprite_batch_find_bucket(key, ds->bbox);
+	_r_sprite_batch.deferred.last_bucket = b - _r_sprite_batch.deferred.buckets;
+
+	if(b->last == DEFERRED_NONE) {
+		b->first = idx;
+	} else {
+		_r_sprite_batch.deferred.sprites[b->last].next = idx;
+		_r_sprite_batch_bbox_union(b->bbox, ds->bbox);
+	}
+
+	b->last = idx;
+	_r_sprite_batch.deferred.num_sprites++;
+}
+
+static void _r_sprite_batch_resolve_deferred(void) {
+	assert(!_r_sprite_batch.deferred.resolving);
+	_r_sprite_batch.deferred.resolving = true;
+
+	_r_sprite_batch_set_format(SPRITE_ATTRIBS_COMPACT);
+
+	for(uint b = 0; b < _r_sprite_batch.deferred.num_buckets; ++b) {
+		DeferredBucket *bucket = _r_sprite_batch.deferred.buckets + b;
+		_r_sprite_batch_apply_key(&bucket->key);
+
+		for(uint i = bucket->first; i != DEFERRED_NONE; i = _r_sprite_batch.deferred.sprites[i].next) {
+			_r_sprite_batch_append_compact(&_r_sprite_batch.deferred.sprites[i].attribs);
 		}
+	}
 
-		r_flush_sprites();
+	// Adjacent buckets never share a key, so each bucket boundary is one state change.
+	uint key_changes = _r_sprite_batch.deferred.num_buckets - 1;
+
+	if(_r_sprite_batch.deferred.key_changes > key_changes) {
+		_r_sprite_batch.frame_stats.flushes_saved += _r_sprite_batch.deferred.key_changes - key_changes;
 	}
 
-	_r_sprite_batch.num_pending++;
-	_r_sprite_batch_add(spr, params, _r_sprite_batch.vbuf);
+	_r_sprite_batch.frame_stats.deferred_sprites += _r_sprite_batch.deferred.num_sprites;
+	_r_sprite_batch.deferred.num_sprites = 0;
+	_r_sprite_batch.deferred.num_buckets = 0;
+	_r_sprite_batch.deferred.key_changes = 0;
+	_r_sprite_batch.deferred.resolving = false;
+}
+
+void r_sprites_defer_begin(void) {
+	if(_r_sprite_batch.deferred.enabled) {
+		_r_sprite_batch.deferred.depth++;
+	}
+}
+
+void r_sprites_defer_end(void) {
+	if(!_r_sprite_batch.deferred.enabled) {
+		return;
+	}
+
+	assert(_r_sprite_batch.deferred.depth > 0);
+
+	if(--_r_sprite_batch.deferred.depth == 0 && _r_sprite_batch.deferred.num_sprites) {
+		_r_sprite_batch_resolve_deferred();
+	}
+}
+
+void r_draw_sprite(const SpriteParams *params) {
+	Sprite *spr;
+	SpriteBatchKey key;
+	_r_sprite_batch_resolve_key(params, &spr, &key);
+
+	if(_r_sprite_batch_can_defer(params)) {
+		_r_sprite_batch_draw_deferred(spr, params, &key);
+		return;
+	}
+
+	if(_r_sprite_batch.deferred.num_sprites) {
+		_r_sprite_batch_resolve_deferred();
+	}
+
+	_r_sprite_batch_draw_immediate(spr, params, &key);
 }
 
 #include "resource/font.h"
@@ -357,9 +875,12 @@ void _r_sprite_batch_end_frame(void) {
 	r_flush_sprites();
 
 	static char buf[512];
-	snprintf(buf, sizeof(buf), "%6i sprites %6i flushes %9.02f spr/flush %6i best %6i worst",
+	snprintf(buf, sizeof(buf), "%6i sprites (%6i compact, %6i deferred) %6i flushes (%6i saved) %9.02f spr/flush %6i best %6i worst",
 		_r_sprite_batch.frame_stats.sprites,
+		_r_sprite_batch.frame_stats.compact_sprites,
+		_r_sprite_batch.frame_stats.deferred_sprites,
 		_r_sprite_batch.frame_stats.flushes,
+		_r_sprite_batch.frame_stats.flushes_saved,
 		_r_sprite_batch.frame_stats.sprites / (double)_r_sprite_batch.frame_stats.flushes,
 		_r_sprite_batch.frame_stats.best_batch,
 		_r_sprite_batch.frame_stats.worst_batch
@@ -379,6 +900,20 @@ void _r_sprite_batch_end_frame(void) {
 }
 
 void _r_sprite_batch_texture_deleted(Texture *tex) {
+	for(uint b = 0; b < _r_sprite_batch.deferred.num_buckets; ++b) {
+		SpriteBatchKey *key = &_r_sprite_batch.deferred.buckets[b].key;
+
+		if(key->primary_texture == tex) {
+			key->primary_texture = NULL;
+		}
+
+		for(uint i = 0; i < R_NUM_SPRITE_AUX_TEXTURES; ++i) {
+			if(key->aux_textures[i] == tex) {
+				key->aux_textures[i] = NULL;
+			}
+		}
+	}
+
 	if(_r_sprite_batch.primary_texture == tex) {
 		_r_sprite_batch.primary_texture = NULL;
 	}
@@ -10,7 +10,6 @@
 
 #include "core.h"
 #include "../api.h"
-#include "../common/matstack.h"
 #include "../common/backend.h"
 #include "../common/sprite_batch.h"
 #include "texture.h"
@@ -280,6 +279,10 @@ static void gl33_init_context(SDL_Window *window) {
 
 	R.features |= r_feature_bit(RFEAT_TEXTURE_BOTTOMLEFT_ORIGIN);
 
+	if(glext.vertex_half_float) {
+		R.features |= r_feature_bit(RFEAT_VERTEX_HALF_FLOAT);
+	}
+
 	if(glext.clear_texture) {
 		_r_backend.funcs.texture_clear = gl44_texture_clear;
 	}
@@ -323,10 +326,6 @@ static void gl33_sync_viewport(void) {
 static void gl33_sync_state(void) {
 	gl33_sync_capabilities();
 	gl33_sync_shader();
-	r_uniform_mat4("r_modelViewMatrix", *_r_matrices.modelview.head);
-	r_uniform_mat4("r_projectionMatrix", *_r_matrices.projection.head);
-	r_uniform_mat4("r_textureMatrix", *_r_matrices.texture.head);
-	r_uniform_vec4_rgba("r_color", &R.color);
 	gl33_sync_uniforms(R.progs.active);
 	gl33_sync_texunits(true);
 	gl33_sync_framebuffer();
@@ -720,13 +719,13 @@ void gl33_framebuffer_deleted(Framebuffer *fb) {
 }
 
 void gl33_shader_deleted(ShaderProgram *prog) {
-	if(R.progs.active == NULL) {
+	if(R.progs.active == prog) {
 		R.progs.active = NULL;
 	}
 
+	// r_shader_program_destroy has already switched away from it if it was current
 	if(R.progs.pending == prog) {
 		R.progs.pending = NULL;
-		r_shader_standard();
 	}
 
 	if(R.progs.gl_prog == prog->gl_handle) {
@@ -749,9 +748,9 @@ void gl33_vertex_array_deleted(VertexArray *varr) {
 		R.vertex_array.active = NULL;
 	}
 
+	// r_vertex_array_destroy has already switched away from it if it was current
 	if(R.vertex_array.pending == varr) {
 		R.vertex_array.pending = NULL;
-		r_vertex_array(r_vertex_array_static_models());
 	}
 
 	if(R.vao.active == varr->gl_handle) {
@@ -805,6 +804,10 @@ static SDL_Window* gl33_create_window(const char *title, int x, int y, int w, in
 	return window;
 }
 
+static void gl33_destroy_window(SDL_Window *window) {
+	SDL_DestroyWindow(window);
+}
+
 static bool gl33_supports(RendererFeature feature) {
 	return R.features & r_feature_bit(feature);
 }
@@ -876,8 +879,6 @@ static void gl33_draw(Primitive prim, uint first, uint count, uint32_t *indices,
 	assert(count > 0);
 	assert((uint)prim < sizeof(prim_to_gl_prim)/sizeof(GLenum));
 
-	r_flush_sprites();
-
 	GLuint gl_prim = prim_to_gl_prim[prim];
 	gl33_sync_state();
 
@@ -912,11 +913,11 @@ static void gl33_draw(Primitive prim, uint first, uint count, uint32_t *indices,
 	}
 }
 
-static void gl33_framebuffer(Framebuffer *fb) {
+void gl33_framebuffer(Framebuffer *fb) {
 	R.framebuffer.pending = fb;
 }
 
-static Framebuffer *gl33_framebuffer_current(void) {
+Framebuffer* gl33_framebuffer_current(void) {
 	return R.framebuffer.pending;
 }
 
@@ -953,7 +954,6 @@ void gl33_set_clear_depth(float depth) {
 }
 
 static void gl33_swap(SDL_Window *window) {
-	r_flush_sprites();
 	gl33_sync_framebuffer();
 	SDL_GL_SwapWindow(window);
 	gl33_stats_post_frame();
@@ -999,6 +999,7 @@ RendererBackend _r_backend_gl33 = {
 		.post_init = gl33_post_init,
 		.shutdown = gl33_shutdown,
 		.create_window = gl33_create_window,
+		.destroy_window = gl33_destroy_window,
 		.supports = gl33_supports,
 		.capabilities = gl33_capabilities,
 		.capabilities_current = gl33_capabilities_current,
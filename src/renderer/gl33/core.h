@@ -38,6 +38,9 @@ void gl33_sync_capabilities(void);
 void gl33_sync_vao(void);
 void gl33_sync_vbo(void);
 
+void gl33_framebuffer(Framebuffer *fb);
+Framebuffer* gl33_framebuffer_current(void);
+
 GLuint gl33_vao_current(void);
 GLuint gl33_vbo_current(void);
 
@@ -13,6 +13,7 @@
 #include "shader_object.h"
 #include "../glcommon/debug.h"
 #include "../glcommon/shaders.h"
+#include "../glcommon/program_cache.h"
 
 bool gl33_shader_language_supported(const ShaderLangInfo *lang, ShaderLangInfo *out_alternative) {
 	if(glcommon_shader_lang_table) {
@@ -58,11 +59,9 @@ static void print_info_log(GLuint shader) {
 	}
 }
 
-ShaderObject* gl33_shader_object_compile(ShaderSource *source) {
-	assert(r_shader_language_supported(&source->lang, NULL));
-
+static GLuint compile_source(ShaderStage stage, const char *content, size_t content_size) {
 	GLuint gl_handle = glCreateShader(
-		source->stage == SHADER_STAGE_VERTEX
+		stage == SHADER_STAGE_VERTEX
 			? GL_VERTEX_SHADER
 			: GL_FRAGMENT_SHADER
 	);
@@ -73,30 +72,74 @@ ShaderObject* gl33_shader_object_compile(ShaderSource *source) {
 
 	glShaderSource(
 		gl_handle, 1,
-		(const GLchar*[]) { source->content },
-		(GLint[])         { source->content_size - 1 }
+		(const GLchar*[]) { content },
+		(GLint[])         { content_size - 1 }
 	);
 
 	glCompileShader(gl_handle);
 	glGetShaderiv(gl_handle, GL_COMPILE_STATUS, &status);
 	print_info_log(gl_handle);
 
-	ShaderObject *shobj = NULL;
-
-	if(status) {
-		shobj = calloc(1, sizeof(*shobj));
-		shobj->gl_handle = gl_handle;
-		shobj->stage = source->stage;
-		snprintf(shobj->debug_label, sizeof(shobj->debug_label), "Shader object #%i", gl_handle);
-	} else {
+	if(!status) {
 		glDeleteShader(gl_handle);
+		return 0;
+	}
+
+	return gl_handle;
+}
+
+ShaderObject* gl33_shader_object_compile(ShaderSource *source) {
+	assert(r_shader_language_supported(&source->lang, NULL));
+
+	ShaderObject *shobj = calloc(1, sizeof(*shobj));
+	shobj->stage = source->stage;
+	shobj->source_hash = memhash64(source->content, source->content_size);
+
+	if(glcommon_program_cache_enabled()) {
+		shobj->deferred_source = memdup(source->content, source->content_size);
+		shobj->deferred_source_size = source->content_size;
+		snprintf(shobj->debug_label, sizeof(shobj->debug_label), "Shader object (deferred)");
+		return shobj;
+	}
+
+	if(!(shobj->gl_handle = compile_source(source->stage, source->content, source->content_size))) {
+		free(shobj);
+		return NULL;
 	}
 
+	snprintf(shobj->debug_label, sizeof(shobj->debug_label), "Shader object #%i", shobj->gl_handle);
 	return shobj;
 }
 
+bool gl33_shader_object_ensure_compiled(ShaderObject *shobj) {
+	if(shobj->gl_handle) {
+		return true;
+	}
+
+	if(shobj->compile_failed) {
+		return false;
+	}
+
+	assert(shobj->deferred_source != NULL);
+	shobj->gl_handle = compile_source(shobj->stage, shobj->deferred_source, shobj->deferred_source_size);
+	free(shobj->deferred_source);
+	shobj->deferred_source = NULL;
+
+	if(!shobj->gl_handle) {
+		log_warn("%s: failed to compile shader object", shobj->debug_label);
+		shobj->compile_failed = true;
+		return false;
+	}
+
+	return true;
+}
+
 void gl33_shader_object_destroy(ShaderObject *shobj) {
-	glDeleteShader(shobj->gl_handle);
+	if(shobj->gl_handle) {
+		glDeleteShader(shobj->gl_handle);
+	}
+
+	free(shobj->deferred_source);
 	free(shobj);
 }
 
@@ -16,11 +16,19 @@ struct ShaderObject {
 	GLuint gl_handle;
 	ShaderStage stage;
 	char debug_label[R_DEBUG_LABEL_SIZE];
+
+	// With the program binary cache on, compilation is deferred until a program that
+	// isn't in the cache gets linked. Until then, gl_handle is 0 and the source is kept.
+	uint64_t source_hash;
+	char *deferred_source;
+	size_t deferred_source_size;
+	bool compile_failed;
 };
 
 bool gl33_shader_language_supported(const ShaderLangInfo *lang, ShaderLangInfo *out_alternative);
 
 ShaderObject* gl33_shader_object_compile(ShaderSource *source);
+bool gl33_shader_object_ensure_compiled(ShaderObject *shobj);
 void gl33_shader_object_destroy(ShaderObject *shobj);
 void gl33_shader_object_set_debug_label(ShaderObject *shobj, const char *label);
 const char* gl33_shader_object_get_debug_label(ShaderObject *shobj);
@@ -12,6 +12,7 @@
 #include "shader_program.h"
 #include "shader_object.h"
 #include "../glcommon/debug.h"
+#include "../glcommon/program_cache.h"
 #include "../api.h"
 
 static Uniform *sampler_uniforms;
@@ -399,27 +400,65 @@ void gl33_shader_program_destroy(ShaderProgram *prog) {
 	free(prog);
 }
 
+static bool link_objects(GLuint gl_handle, uint num_objects, ShaderObject *shobjs[num_objects], bool retrievable) {
+	for(int i = 0; i < num_objects; ++i) {
+		if(!gl33_shader_object_ensure_compiled(shobjs[i])) {
+			return false;
+		}
+
+		glAttachShader(gl_handle, shobjs[i]->gl_handle);
+	}
+
+	if(retrievable) {
+		glProgramParameteri(gl_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	glLinkProgram(gl_handle);
+	print_info_log(gl_handle);
+
+	GLint link_status;
+	glGetProgramiv(gl_handle, GL_LINK_STATUS, &link_status);
+	return link_status;
+}
+
 ShaderProgram* gl33_shader_program_link(uint num_objects, ShaderObject *shobjs[num_objects]) {
 	ShaderProgram *prog = calloc(1, sizeof(*prog));
+	bool use_cache = glcommon_program_cache_enabled();
+	bool cached = false;
+	uint64_t cache_key = 0;
 
 	prog->gl_handle = glCreateProgram();
-	snprintf(prog->debug_label, sizeof(prog->debug_label), "Shader program #%i", prog->gl_handle);
 
-	for(int i = 0; i < num_objects; ++i) {
-		glAttachShader(prog->gl_handle, shobjs[i]->gl_handle);
+	if(use_cache) {
+		ProgramCacheStage stages[num_objects];
+
+		for(int i = 0; i < num_objects; ++i) {
+			stages[i].source_hash = shobjs[i]->source_hash;
+			stages[i].stage = shobjs[i]->stage;
+		}
+
+		cache_key = glcommon_program_cache_key(num_objects, stages);
+
+		if(!(cached = glcommon_program_cache_load(cache_key, prog->gl_handle))) {
+			// a program a binary was rejected for is in an unspecified state; start over
+			glDeleteProgram(prog->gl_handle);
+			prog->gl_handle = glCreateProgram();
+		}
 	}
 
-	glLinkProgram(prog->gl_handle);
-	print_info_log(prog->gl_handle);
+	snprintf(prog->debug_label, sizeof(prog->debug_label), "Shader program #%i", prog->gl_handle);
 
-	GLint link_status;
-	glGetProgramiv(prog->gl_handle, GL_LINK_STATUS, &link_status);
+	if(!cached) {
+		if(!link_objects(prog->gl_handle, num_objects, shobjs, use_cache)) {
+			log_warn("Failed to link the shader program");
+			glDeleteProgram(prog->gl_handle);
+			free(prog);
+			return NULL;
+		}
 
-	if(!link_status) {
-		log_warn("Failed to link the shader program");
-		glDeleteProgram(prog->gl_handle);
-		free(prog);
-		return NULL;
+		if(use_cache) {
+			glcommon_program_cache_store(cache_key, prog->gl_handle);
+		}
 	}
 
 	if(!cache_uniforms(prog)) {
@@ -12,6 +12,7 @@
 #include "../api.h"
 #include "opengl.h"
 #include "core.h"
+#include "framebuffer.h"
 #include "../glcommon/debug.h"
 
 static GLuint r_filter_to_gl_filter(TextureFilterMode mode) {
@@ -244,10 +245,10 @@ void gl44_texture_clear(Texture *tex, const Color *clr) {
 
 void gl33_texture_clear(Texture *tex, const Color *clr) {
 	// TODO: maybe find a more efficient method
-	Framebuffer *temp_fb = r_framebuffer_create();
-	r_framebuffer_attach(temp_fb, tex, 0, FRAMEBUFFER_ATTACH_COLOR0);
-	r_framebuffer_clear(temp_fb, CLEAR_COLOR, clr, 1);
-	r_framebuffer_destroy(temp_fb);
+	Framebuffer *temp_fb = gl33_framebuffer_create();
+	gl33_framebuffer_attach(temp_fb, tex, 0, FRAMEBUFFER_ATTACH_COLOR0);
+	gl33_framebuffer_clear(temp_fb, CLEAR_COLOR, clr, 1);
+	gl33_framebuffer_destroy(temp_fb);
 }
 
 void gl33_texture_destroy(Texture *tex) {
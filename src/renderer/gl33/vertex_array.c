@@ -21,6 +21,7 @@ static GLenum va_type_to_gl_type[] = {
 	[VA_USHORT] = GL_UNSIGNED_SHORT,
 	[VA_INT]    = GL_INT,
 	[VA_UINT]   = GL_UNSIGNED_INT,
+	[VA_HALF_FLOAT] = GL_HALF_FLOAT,
 };
 
 VertexArray* gl33_vertex_array_create(void) {
@@ -49,11 +50,17 @@ static void gl33_vertex_array_update_layout(VertexArray *varr, uint attachment,
 		VertexAttribFormat *a = varr->attribute_layout + i;
 		assert((uint)a->spec.type < sizeof(va_type_to_gl_type)/sizeof(GLenum));
 
+		if(a->spec.elements == 0) {
+			// placeholder for an unused attribute location
+			glDisableVertexAttribArray(i);
+			continue;
+		}
+
 		if(attachment != UINT_MAX && attachment != a->attachment) {
 			continue;
 		}
 
-		VertexBuffer *vbuf = r_vertex_array_get_attachment(varr, a->attachment);
+		VertexBuffer *vbuf = gl33_vertex_array_get_attachment(varr, a->attachment);
 
 		if(vbuf == NULL) {
 			continue;
@@ -64,13 +71,23 @@ static void gl33_vertex_array_update_layout(VertexArray *varr, uint attachment,
 
 		glEnableVertexAttribArray(i);
 
+		GLenum gl_type = va_type_to_gl_type[a->spec.type];
+
+		if(a->spec.type == VA_HALF_FLOAT) {
+			assert(glext.vertex_half_float);
+
+			if(glext.vertex_half_float == TSGL_EXTFLAG_OES) {
+				gl_type = GL_HALF_FLOAT_OES;
+			}
+		}
+
 		switch(a->spec.coversion) {
 			case VA_CONVERT_FLOAT:
 			case VA_CONVERT_FLOAT_NORMALIZED:
 				glVertexAttribPointer(
 					i,
 					a->spec.elements,
-					va_type_to_gl_type[a->spec.type],
+					gl_type,
 					a->spec.coversion == VA_CONVERT_FLOAT_NORMALIZED,
 					a->stride,
 					(void*)a->offset
@@ -82,7 +99,7 @@ static void gl33_vertex_array_update_layout(VertexArray *varr, uint attachment,
 				glVertexAttribIPointer(
 					i,
 					a->spec.elements,
-					va_type_to_gl_type[a->spec.type],
+					gl_type,
 					a->stride,
 					(void*)a->offset
 				);
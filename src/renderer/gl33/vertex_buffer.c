@@ -60,7 +60,7 @@ void gl33_vertex_buffer_write(VertexBuffer *vbuf, size_t offset, size_t data_siz
 
 void gl33_vertex_buffer_append(VertexBuffer *vbuf, size_t data_size, void *data) {
 	// log_debug("%u -> %u / %u", (uint)vbuf->offset, (uint)(vbuf->offset + data_size), (uint)vbuf->size);
-	r_vertex_buffer_write(vbuf, vbuf->offset, data_size, data);
+	gl33_vertex_buffer_write(vbuf, vbuf->offset, data_size, data);
 	vbuf->offset += data_size;
 }
 
@@ -337,6 +337,74 @@ static void glcommon_ext_clear_texture(void) {
 	log_warn("Extension not supported");
 }
 
+static void glcommon_ext_get_program_binary(void) {
+	if(
+		GLES_ATLEAST(3, 0)
+		&& (glext.GetProgramBinary = glad_glGetProgramBinary)
+		&& (glext.ProgramBinary = glad_glProgramBinary)
+		&& (glext.ProgramParameteri = glad_glProgramParameteri)
+	) {
+		glext.get_program_binary = TSGL_EXTFLAG_NATIVE;
+	} else if(!glext.version.is_es) {
+		// Our glad is generated for GL 3.3, so it doesn't load these on desktop.
+		// The ARB extension uses the core entrypoint names.
+
+		if(GL_ATLEAST(4, 1)) {
+			glext.get_program_binary = TSGL_EXTFLAG_NATIVE;
+		} else {
+			glext.get_program_binary = glcommon_check_extension("GL_ARB_get_program_binary");
+		}
+
+		if(
+			!glext.get_program_binary
+			|| !(glext.GetProgramBinary = SDL_GL_GetProcAddress("glGetProgramBinary"))
+			|| !(glext.ProgramBinary = SDL_GL_GetProcAddress("glProgramBinary"))
+			|| !(glext.ProgramParameteri = SDL_GL_GetProcAddress("glProgramParameteri"))
+		) {
+			glext.get_program_binary = 0;
+		}
+	}
+
+	if(glext.get_program_binary) {
+		// drivers are allowed to support the API but no actual binary formats
+		GLint num_formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+
+		if(num_formats > 0) {
+			log_info("Using %s", glext.get_program_binary == TSGL_EXTFLAG_NATIVE ? "core functionality" : "GL_ARB_get_program_binary");
+			return;
+		}
+
+		log_warn("No program binary formats supported by the driver");
+		glext.get_program_binary = 0;
+		return;
+	}
+
+	glext.get_program_binary = 0;
+	log_warn("Extension not supported");
+}
+
+static void glcommon_ext_vertex_half_float(void) {
+	if(GL_ATLEAST(3, 0) || GLES_ATLEAST(3, 0)) {
+		glext.vertex_half_float = TSGL_EXTFLAG_NATIVE;
+		log_info("Using core functionality");
+		return;
+	}
+
+	if((glext.vertex_half_float = glcommon_check_extension("GL_ARB_half_float_vertex"))) {
+		log_info("Using GL_ARB_half_float_vertex");
+		return;
+	}
+
+	if((glext.vertex_half_float = glcommon_check_extension("GL_OES_vertex_half_float"))) {
+		log_info("Using GL_OES_vertex_half_float");
+		return;
+	}
+
+	glext.vertex_half_float = 0;
+	log_warn("Extension not supported");
+}
+
 void shim_glClearDepth(GLdouble depthval) {
 	glClearDepthf(depthval);
 }
@@ -391,9 +459,11 @@ void glcommon_check_extensions(void) {
 	glcommon_ext_debug_output();
 	glcommon_ext_depth_texture();
 	glcommon_ext_draw_buffers();
+	glcommon_ext_get_program_binary();
 	glcommon_ext_instanced_arrays();
 	glcommon_ext_pixel_buffer_object();
 	glcommon_ext_texture_filter_anisotropic();
+	glcommon_ext_vertex_half_float();
 
 	// GLES has only glClearDepthf
 	// Core has only glClearDepth until GL 4.1
@@ -19,6 +19,11 @@
 	#define GL_NUM_SHADING_LANGUAGE_VERSIONS  0x82E9
 #endif
 
+// GL_OES_vertex_half_float uses a different value than GL_HALF_FLOAT
+#ifndef GL_HALF_FLOAT_OES
+	#define GL_HALF_FLOAT_OES 0x8D61
+#endif
+
 #define TSGL_EXT_VENDORS \
 	TSGL_EXT_VENDOR(NATIVE) \
 	TSGL_EXT_VENDOR(KHR) \
@@ -75,6 +80,8 @@ struct glext_s {
 	ext_flag_t draw_buffers;
 	ext_flag_t texture_filter_anisotropic;
 	ext_flag_t clear_texture;
+	ext_flag_t get_program_binary;
+	ext_flag_t vertex_half_float;
 
 	//
 	// debug_output
@@ -126,6 +133,22 @@ struct glext_s {
 	#undef glDrawBuffers
 	#define glDrawBuffers (glext.DrawBuffers)
 
+	//
+	// get_program_binary
+	//
+
+	PFNGLGETPROGRAMBINARYPROC GetProgramBinary;
+	#undef glGetProgramBinary
+	#define glGetProgramBinary (glext.GetProgramBinary)
+
+	PFNGLPROGRAMBINARYPROC ProgramBinary;
+	#undef glProgramBinary
+	#define glProgramBinary (glext.ProgramBinary)
+
+	PFNGLPROGRAMPARAMETERIPROC ProgramParameteri;
+	#undef glProgramParameteri
+	#define glProgramParameteri (glext.ProgramParameteri)
+
 	//
 	// clear_texture
 	// NOTE: no need for indirection here; the entrypoint names are the same.
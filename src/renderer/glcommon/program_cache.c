@@ -0,0 +1,149 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include "program_cache.h"
+#include "util.h"
+#include "util/cachefile.h"
+#include "../common/backend.h"
+
+// sanity limit; real binaries are a few hundred KiB at most
+#define PROGCACHE_MAX_SIZE (16 * 1024 * 1024)
+
+static const CacheFileFormat progcache_format = {
+	.subdir = "shaders",
+	.extension = ".progbin",
+	.magic = "TAIPROG",
+	.version = 2,
+};
+
+// follows the CacheFileHeader, whose key is the program cache key
+typedef struct ProgramCacheHeader {
+	uint32_t format;
+	uint32_t reserved;
+	uint64_t size;
+} ProgramCacheHeader;
+
+static struct {
+	uint64_t driver_hash;
+	bool driver_hash_valid;
+} progcache;
+
+bool glcommon_program_cache_enabled(void) {
+	return glext.get_program_binary && env_get("TAISEI_SHADER_CACHE", true);
+}
+
+static uint64_t driver_hash(void) {
+	// computed lazily: the backend isn't registered yet while extensions are being checked
+	if(!progcache.driver_hash_valid) {
+		char *id = strjoin(
+			_r_backend.name, "\n",
+			(const char*)glGetString(GL_VENDOR), "\n",
+			(const char*)glGetString(GL_RENDERER), "\n",
+			(const char*)glGetString(GL_VERSION),
+		NULL);
+
+		progcache.driver_hash = memhash64(id, strlen(id));
+		progcache.driver_hash_valid = true;
+		free(id);
+	}
+
+	return progcache.driver_hash;
+}
+
+uint64_t glcommon_program_cache_key(uint num_stages, const ProgramCacheStage stages[num_stages]) {
+	uint64_t data[1 + num_stages * 2];
+	uint64_t *p = data;
+
+	*p++ = driver_hash();
+
+	for(uint i = 0; i < num_stages; ++i) {
+		*p++ = stages[i].source_hash;
+		*p++ = stages[i].stage;
+	}
+
+	return memhash64(data, sizeof(data));
+}
+
+bool glcommon_program_cache_load(uint64_t key, GLuint prog) {
+	CacheFile cf;
+
+	if(!cachefile_open_read(&cf, &progcache_format, key, key)) {
+		return false;
+	}
+
+	ProgramCacheHeader hdr;
+
+	if(
+		!cachefile_read(&cf, &hdr, sizeof(hdr)) ||
+		hdr.size == 0 || hdr.size > PROGCACHE_MAX_SIZE
+	) {
+		cachefile_close(&cf);
+		return false;
+	}
+
+	void *binary = malloc(hdr.size);
+
+	if(!cachefile_read(&cf, binary, hdr.size)) {
+		free(binary);
+		cachefile_close(&cf);
+		return false;
+	}
+
+	cachefile_close(&cf);
+
+	glProgramBinary(prog, hdr.format, binary, hdr.size);
+	free(binary);
+
+	GLint link_status;
+	glGetProgramiv(prog, GL_LINK_STATUS, &link_status);
+
+	if(!link_status) {
+		log_debug("Driver rejected cached program binary %016"PRIx64, key);
+		return false;
+	}
+
+	return true;
+}
+
+void glcommon_program_cache_store(uint64_t key, GLuint prog) {
+	GLint size = 0;
+	glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &size);
+
+	if(size <= 0 || size > PROGCACHE_MAX_SIZE) {
+		return;
+	}
+
+	void *binary = malloc(size);
+	GLenum format;
+	GLsizei written = 0;
+	glGetProgramBinary(prog, size, &written, &format, binary);
+
+	if(written <= 0) {
+		free(binary);
+		return;
+	}
+
+	CacheFile cf;
+
+	if(!cachefile_open_write(&cf, &progcache_format, key, key, "program binary")) {
+		free(binary);
+		return;
+	}
+
+	ProgramCacheHeader hdr = {
+		.format = format,
+		.size = written,
+	};
+
+	cachefile_write(&cf, &hdr, sizeof(hdr));
+	cachefile_write(&cf, binary, written);
+	cachefile_close(&cf);
+	free(binary);
+}
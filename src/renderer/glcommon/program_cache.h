@@ -0,0 +1,33 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include "opengl.h"
+
+/*
+ * Linked program binaries are cached in storage/cache/shaders, one file per program.
+ * A program is keyed by the hashes of its preprocessed shader sources, plus the renderer
+ * backend and the GL vendor, renderer and version strings, so a driver update invalidates
+ * the whole cache. Binaries the driver rejects anyway are rebuilt from source and replaced.
+ */
+
+typedef struct ProgramCacheStage {
+	uint64_t source_hash;
+	uint32_t stage;
+} ProgramCacheStage;
+
+bool glcommon_program_cache_enabled(void);
+uint64_t glcommon_program_cache_key(uint num_stages, const ProgramCacheStage stages[num_stages]);
+
+// On success, prog is linked and ready to use. On failure, prog must not be reused.
+bool glcommon_program_cache_load(uint64_t key, GLuint prog);
+
+// prog should have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+void glcommon_program_cache_store(uint64_t key, GLuint prog);
@@ -11,12 +11,82 @@
 #include "../api.h"
 #include "resource/shader_object.h"
 #include "../common/backend.h"
+#include "hashtable.h"
+#include "util.h"
 
-static char placeholder;
-static Color dummycolor;
+/*
+ * Nothing is ever drawn, but objects and state behave like they would on a real backend:
+ * textures remember their parameters, vertex buffers their capacity and cursor, programs
+ * their uniforms (scanned from the GLSL source) and queries return what was last set.
+ * This keeps the rest of the renderer on the same code paths as with a GPU, which is what
+ * makes TAISEI_RENDER_STATS meaningful with this backend.
+ */
+
+typedef struct NullTexture {
+	TextureParams params;
+} NullTexture;
+
+typedef struct NullUniform {
+	UniformType type;
+} NullUniform;
+
+typedef struct NullShaderObject {
+	ht_str2int_t uniforms; // -> UniformType
+} NullShaderObject;
+
+typedef struct NullShaderProgram {
+	ht_str2ptr_t uniforms; // -> NullUniform*
+} NullShaderProgram;
+
+typedef struct NullFramebuffer {
+	struct {
+		Texture *texture;
+		uint mipmap;
+	} attachments[FRAMEBUFFER_MAX_ATTACHMENTS];
+
+	IntRect viewport;
+} NullFramebuffer;
+
+typedef struct NullVertexBuffer {
+	size_t capacity;
+	size_t cursor;
+} NullVertexBuffer;
+
+typedef struct NullVertexArray {
+	VertexBuffer **attachments;
+	uint num_attachments;
+} NullVertexArray;
+
+static struct {
+	r_capability_bits_t capabilities;
+	Color color;
+	Color clear_color;
+	BlendMode blend;
+	CullFaceMode cull;
+	DepthTestFunc depth_func;
+	ShaderProgram *shader;
+	Framebuffer *framebuffer;
+	VertexArray *vertex_array;
+	VsyncMode vsync;
+	IntRect default_fb_viewport;
+} N = {
+	.blend = BLEND_NONE,
+	.cull = CULL_BACK,
+	.depth_func = DEPTH_LESS,
+};
 
 SDL_Window* null_create_window(const char *title, int x, int y, int w, int h, uint32_t flags) {
-	return SDL_CreateWindow(title, x, y, w, h, flags);
+	SDL_Window *window = SDL_CreateWindow(title, x, y, w, h, flags);
+
+	if(window) {
+		N.default_fb_viewport = (IntRect) { 0, 0, w, h };
+	}
+
+	return window;
+}
+
+void null_destroy_window(SDL_Window *window) {
+	SDL_DestroyWindow(window);
 }
 
 void null_init(void) { }
@@ -27,114 +97,369 @@ bool null_supports(RendererFeature feature) {
 	return true;
 }
 
-void null_capabilities(r_capability_bits_t capbits) { }
-r_capability_bits_t null_capabilities_current(void) { return (r_capability_bits_t)-1; }
+void null_capabilities(r_capability_bits_t capbits) { N.capabilities = capbits; }
+r_capability_bits_t null_capabilities_current(void) { return N.capabilities; }
 
-void null_color4(float r, float g, float b, float a) { }
-const Color* null_color_current(void) { return &dummycolor; }
+void null_color4(float r, float g, float b, float a) { N.color = *RGBA(r, g, b, a); }
+const Color* null_color_current(void) { return &N.color; }
 
-void null_blend(BlendMode mode) { }
-BlendMode null_blend_current(void) { return BLEND_NONE; }
+void null_blend(BlendMode mode) { N.blend = mode; }
+BlendMode null_blend_current(void) { return N.blend; }
 
-void null_cull(CullFaceMode mode) { }
-CullFaceMode null_cull_current(void) { return CULL_BACK; }
+void null_cull(CullFaceMode mode) { N.cull = mode; }
+CullFaceMode null_cull_current(void) { return N.cull; }
 
-void null_depth_func(DepthTestFunc func) { }
-DepthTestFunc null_depth_func_current(void) { return DEPTH_LESS; }
+void null_depth_func(DepthTestFunc func) { N.depth_func = func; }
+DepthTestFunc null_depth_func_current(void) { return N.depth_func; }
 
 bool null_shader_language_supported(const ShaderLangInfo *lang, ShaderLangInfo *out_alternative) { return true; }
 
-ShaderObject* null_shader_object_compile(ShaderSource *source) { return (void*)&placeholder; }
-void null_shader_object_destroy(ShaderObject *shobj) { }
+static inline bool null_glsl_ident_char(char c) {
+	return
+		(c >= 'a' && c <= 'z') ||
+		(c >= 'A' && c <= 'Z') ||
+		(c >= '0' && c <= '9') ||
+		c == '_';
+}
+
+static const char* null_glsl_ident(const char *p, const char *end, char *out, size_t outsize) {
+	size_t len = 0;
+
+	while(p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+		++p;
+	}
+
+	for(; p < end && null_glsl_ident_char(*p); ++p) {
+		if(len < outsize - 1) {
+			out[len++] = *p;
+		}
+	}
+
+	out[len] = 0;
+	return p;
+}
+
+static UniformType null_glsl_uniform_type(const char *glsl_type) {
+	static const struct {
+		const char *name;
+		UniformType type;
+	} typemap[] = {
+		{ "float",     UNIFORM_FLOAT },
+		{ "vec2",      UNIFORM_VEC2 },
+		{ "vec3",      UNIFORM_VEC3 },
+		{ "vec4",      UNIFORM_VEC4 },
+		{ "int",       UNIFORM_INT },
+		{ "ivec2",     UNIFORM_IVEC2 },
+		{ "ivec3",     UNIFORM_IVEC3 },
+		{ "ivec4",     UNIFORM_IVEC4 },
+		{ "sampler2D", UNIFORM_SAMPLER },
+		{ "mat3",      UNIFORM_MAT3 },
+		{ "mat4",      UNIFORM_MAT4 },
+	};
+
+	for(uint i = 0; i < sizeof(typemap)/sizeof(*typemap); ++i) {
+		if(!strcmp(typemap[i].name, glsl_type)) {
+			return typemap[i].type;
+		}
+	}
+
+	return UNIFORM_UNKNOWN;
+}
+
+// Finds "uniform <type> <name>" and "UNIFORM(<loc>) <type> <name>" declarations.
+// Anything that doesn't name a known type after the keyword is ignored, which also
+// takes care of the definitions of the UNIFORM macro itself.
+static void null_scan_uniforms(const char *src, ht_str2int_t *uniforms) {
+	const char *p = src, *end = src + strlen(src);
+	char word[64], type[64], name[64];
+
+	while(p < end) {
+		if(!null_glsl_ident_char(*p)) {
+			++p;
+			continue;
+		}
+
+		p = null_glsl_ident(p, end, word, sizeof(word));
+
+		if(!strcmp(word, "UNIFORM")) {
+			if(p >= end || *p != '(' || !(p = memchr(p, ')', end - p))) {
+				continue;
+			}
+
+			++p;
+		} else if(strcmp(word, "uniform")) {
+			continue;
+		}
+
+		p = null_glsl_ident(p, end, type, sizeof(type));
+		p = null_glsl_ident(p, end, name, sizeof(name));
+
+		UniformType utype = null_glsl_uniform_type(type);
+
+		if(utype == UNIFORM_UNKNOWN || !*name) {
+			continue;
+		}
+
+		ht_set(uniforms, name, utype);
+
+		if(p < end && *p == '[') {
+			// arrays are also looked up by their first element
+			char elem[sizeof(name) + 3];
+			snprintf(elem, sizeof(elem), "%s[0]", name);
+			ht_set(uniforms, elem, utype);
+		}
+	}
+}
+
+ShaderObject* null_shader_object_compile(ShaderSource *source) {
+	NullShaderObject *shobj = calloc(1, sizeof(*shobj));
+	ht_create(&shobj->uniforms);
+
+	if(source->content) {
+		null_scan_uniforms(source->content, &shobj->uniforms);
+	}
+
+	return (ShaderObject*)shobj;
+}
+
+void null_shader_object_destroy(ShaderObject *shobj) {
+	NullShaderObject *nshobj = (NullShaderObject*)shobj;
+	ht_destroy(&nshobj->uniforms);
+	free(nshobj);
+}
+
 void null_shader_object_set_debug_label(ShaderObject *shobj, const char *label) { }
 const char* null_shader_object_get_debug_label(ShaderObject *shobj) { return "Null shader object"; }
 
-ShaderProgram* null_shader_program_link(uint num_objects, ShaderObject *shobjs[num_objects]) { return (void*)&placeholder; }
-void null_shader_program_destroy(ShaderProgram *prog) { }
+ShaderProgram* null_shader_program_link(uint num_objects, ShaderObject *shobjs[num_objects]) {
+	NullShaderProgram *prog = calloc(1, sizeof(*prog));
+	ht_create(&prog->uniforms);
+
+	for(uint i = 0; i < num_objects; ++i) {
+		ht_str2int_iter_t iter;
+		ht_iter_begin(&((NullShaderObject*)shobjs[i])->uniforms, &iter);
+
+		for(; iter.has_data; ht_iter_next(&iter)) {
+			if(!ht_get(&prog->uniforms, iter.key, NULL)) {
+				NullUniform *uni = calloc(1, sizeof(*uni));
+				uni->type = iter.value;
+				ht_set(&prog->uniforms, iter.key, uni);
+			}
+		}
+
+		ht_iter_end(&iter);
+	}
+
+	return (ShaderProgram*)prog;
+}
+
+void null_shader_program_destroy(ShaderProgram *prog) {
+	NullShaderProgram *nprog = (NullShaderProgram*)prog;
+	ht_str2ptr_iter_t iter;
+	ht_iter_begin(&nprog->uniforms, &iter);
+
+	for(; iter.has_data; ht_iter_next(&iter)) {
+		free(iter.value);
+	}
+
+	ht_iter_end(&iter);
+	ht_destroy(&nprog->uniforms);
+	free(nprog);
+
+	if(N.shader == prog) {
+		N.shader = NULL;
+	}
+}
+
 void null_shader_program_set_debug_label(ShaderProgram *prog, const char *label) { }
 const char* null_shader_program_get_debug_label(ShaderProgram *prog) { return "Null shader program"; }
 
-void null_shader(ShaderProgram *prog) { }
-ShaderProgram* null_shader_current(void) { return (void*)&placeholder; }
+void null_shader(ShaderProgram *prog) { N.shader = prog; }
+ShaderProgram* null_shader_current(void) { return N.shader; }
 
 Uniform* null_shader_uniform(ShaderProgram *prog, const char *uniform_name) {
-	return NULL;
+	return ht_get(&((NullShaderProgram*)prog)->uniforms, uniform_name, NULL);
 }
 
 void null_uniform(Uniform *uniform, uint offset, uint count, const void *data) { }
 
-UniformType null_uniform_type(Uniform *uniform) { return UNIFORM_FLOAT; }
+UniformType null_uniform_type(Uniform *uniform) {
+	return ((NullUniform*)uniform)->type;
+}
 
 void null_draw(Primitive prim, uint first, uint count, uint32_t *indices, uint instances, uint base_instance) { }
 
 Texture* null_texture_create(const TextureParams *params) {
-	return (void*)&placeholder;
+	NullTexture *tex = calloc(1, sizeof(*tex));
+	TextureParams *p = &tex->params;
+	*p = *params;
+
+	uint max_mipmaps = 1 + floor(log2(imax(imax(p->width, p->height), 1)));
+
+	if(p->mipmaps == 0) {
+		p->mipmaps = p->mipmap_mode == TEX_MIPMAP_AUTO ? TEX_MIPMAPS_MAX : 1;
+	}
+
+	if(p->mipmaps == TEX_MIPMAPS_MAX || p->mipmaps > max_mipmaps) {
+		p->mipmaps = max_mipmaps;
+	}
+
+	if(p->anisotropy == 0) {
+		p->anisotropy = TEX_ANISOTROPY_DEFAULT;
+	}
+
+	return (Texture*)tex;
 }
 
 void null_texture_get_size(Texture *tex, uint mipmap, uint *width, uint *height) {
-	if(width) *width = 1;
-	if(height) *height = 1;
+	TextureParams *p = &((NullTexture*)tex)->params;
+	mipmap = imin(mipmap, p->mipmaps - 1);
+
+	if(width) *width = imax(1, p->width >> mipmap);
+	if(height) *height = imax(1, p->height >> mipmap);
 }
 
 void null_texture_get_params(Texture *tex, TextureParams *params) {
-	memset(params, 0, sizeof(*params));
-	params->width = 1;
-	params->height = 1;
-	params->type = TEX_TYPE_RGBA;
+	*params = ((NullTexture*)tex)->params;
 }
 
 void null_texture_set_debug_label(Texture *tex, const char *label) { }
 const char* null_texture_get_debug_label(Texture *tex) { return "null texture"; }
-void null_texture_set_filter(Texture *tex, TextureFilterMode fmin, TextureFilterMode fmag) { }
-void null_texture_set_wrap(Texture *tex, TextureWrapMode fmin, TextureWrapMode fmag) { }
+
+void null_texture_set_filter(Texture *tex, TextureFilterMode fmin, TextureFilterMode fmag) {
+	TextureParams *p = &((NullTexture*)tex)->params;
+	p->filter.min = fmin;
+	p->filter.mag = fmag;
+}
+
+void null_texture_set_wrap(Texture *tex, TextureWrapMode ws, TextureWrapMode wt) {
+	TextureParams *p = &((NullTexture*)tex)->params;
+	p->wrap.s = ws;
+	p->wrap.t = wt;
+}
+
 void null_texture_fill(Texture *tex, uint mipmap, void *image_data) { }
 void null_texture_fill_region(Texture *tex, uint mipmap, uint x, uint y, uint w, uint h, void *image_data) { }
 void null_texture_invalidate(Texture *tex) { }
-void null_texture_destroy(Texture *tex) { }
+void null_texture_destroy(Texture *tex) { free(tex); }
 void null_texture_clear(Texture *tex, const Color *color) { }
 
-static IntRect default_fb_viewport;
+Framebuffer* null_framebuffer_create(void) {
+	return (Framebuffer*)calloc(1, sizeof(NullFramebuffer));
+}
 
-Framebuffer* null_framebuffer_create(void) { return (void*)&placeholder; }
 void null_framebuffer_set_debug_label(Framebuffer *fb, const char *label) { }
 const char* null_framebuffer_get_debug_label(Framebuffer *fb) { return "null framebuffer"; }
-void null_framebuffer_attach(Framebuffer *framebuffer, Texture *tex, uint mipmap, FramebufferAttachment attachment) { }
-Texture* null_framebuffer_attachment(Framebuffer *framebuffer, FramebufferAttachment attachment) { return (void*)&placeholder; }
-uint null_framebuffer_attachment_mipmap(Framebuffer *framebuffer, FramebufferAttachment attachment) { return 0; }
-void null_framebuffer_destroy(Framebuffer *framebuffer) { }
-void null_framebuffer_viewport(Framebuffer *framebuffer, IntRect vp) { }
-void null_framebuffer_viewport_current(Framebuffer *framebuffer, IntRect *vp) { *vp = default_fb_viewport; }
-void null_framebuffer(Framebuffer *framebuffer) { }
-Framebuffer* null_framebuffer_current(void) { return (void*)&placeholder; }
+
+void null_framebuffer_attach(Framebuffer *framebuffer, Texture *tex, uint mipmap, FramebufferAttachment attachment) {
+	NullFramebuffer *fb = (NullFramebuffer*)framebuffer;
+	assert((uint)attachment < FRAMEBUFFER_MAX_ATTACHMENTS);
+	fb->attachments[attachment].texture = tex;
+	fb->attachments[attachment].mipmap = mipmap;
+}
+
+Texture* null_framebuffer_attachment(Framebuffer *framebuffer, FramebufferAttachment attachment) {
+	assert((uint)attachment < FRAMEBUFFER_MAX_ATTACHMENTS);
+	return ((NullFramebuffer*)framebuffer)->attachments[attachment].texture;
+}
+
+uint null_framebuffer_attachment_mipmap(Framebuffer *framebuffer, FramebufferAttachment attachment) {
+	assert((uint)attachment < FRAMEBUFFER_MAX_ATTACHMENTS);
+	return ((NullFramebuffer*)framebuffer)->attachments[attachment].mipmap;
+}
+
+void null_framebuffer_destroy(Framebuffer *framebuffer) {
+	if(N.framebuffer == framebuffer) {
+		N.framebuffer = NULL;
+	}
+
+	free(framebuffer);
+}
+
+void null_framebuffer_viewport(Framebuffer *framebuffer, IntRect vp) {
+	if(framebuffer) {
+		((NullFramebuffer*)framebuffer)->viewport = vp;
+	} else {
+		N.default_fb_viewport = vp;
+	}
+}
+
+void null_framebuffer_viewport_current(Framebuffer *framebuffer, IntRect *vp) {
+	*vp = framebuffer ? ((NullFramebuffer*)framebuffer)->viewport : N.default_fb_viewport;
+}
+
+void null_framebuffer(Framebuffer *framebuffer) { N.framebuffer = framebuffer; }
+Framebuffer* null_framebuffer_current(void) { return N.framebuffer; }
 void null_framebuffer_clear(Framebuffer *framebuffer, ClearBufferFlags flags, const Color *colorval, float depthval) { }
 
-VertexBuffer* null_vertex_buffer_create(size_t capacity, void *data) { return (void*)&placeholder; }
+VertexBuffer* null_vertex_buffer_create(size_t capacity, void *data) {
+	NullVertexBuffer *vbuf = calloc(1, sizeof(*vbuf));
+	vbuf->capacity = topow2(capacity);
+	return (VertexBuffer*)vbuf;
+}
+
 void null_vertex_buffer_set_debug_label(VertexBuffer *vbuf, const char *label) { }
 const char* null_vertex_buffer_get_debug_label(VertexBuffer *vbuf) { return "null vertex buffer"; }
-void null_vertex_buffer_destroy(VertexBuffer *vbuf) { }
-void null_vertex_buffer_invalidate(VertexBuffer *vbuf) { }
-void null_vertex_buffer_write(VertexBuffer *vbuf, size_t offset, size_t data_size, void *data) { }
-void null_vertex_buffer_append(VertexBuffer *vbuf, size_t data_size, void *data) { }
-size_t null_vertex_buffer_get_capacity(VertexBuffer *vbuf) { return 1 << 16; }
-size_t null_vertex_buffer_get_cursor(VertexBuffer *vbuf) { return 0; }
-void null_vertex_buffer_set_cursor(VertexBuffer *vbuf, size_t pos) { }
-
-VertexArray* null_vertex_array_create(void) { return (void*)&placeholder; }
+void null_vertex_buffer_destroy(VertexBuffer *vbuf) { free(vbuf); }
+void null_vertex_buffer_invalidate(VertexBuffer *vbuf) { ((NullVertexBuffer*)vbuf)->cursor = 0; }
+
+void null_vertex_buffer_write(VertexBuffer *vbuf, size_t offset, size_t data_size, void *data) {
+	assert(offset + data_size <= ((NullVertexBuffer*)vbuf)->capacity);
+}
+
+void null_vertex_buffer_append(VertexBuffer *vbuf, size_t data_size, void *data) {
+	NullVertexBuffer *nvbuf = (NullVertexBuffer*)vbuf;
+	assert(nvbuf->cursor + data_size <= nvbuf->capacity);
+	nvbuf->cursor += data_size;
+}
+
+size_t null_vertex_buffer_get_capacity(VertexBuffer *vbuf) { return ((NullVertexBuffer*)vbuf)->capacity; }
+size_t null_vertex_buffer_get_cursor(VertexBuffer *vbuf) { return ((NullVertexBuffer*)vbuf)->cursor; }
+void null_vertex_buffer_set_cursor(VertexBuffer *vbuf, size_t pos) { ((NullVertexBuffer*)vbuf)->cursor = pos; }
+
+VertexArray* null_vertex_array_create(void) {
+	return (VertexArray*)calloc(1, sizeof(NullVertexArray));
+}
+
 void null_vertex_array_set_debug_label(VertexArray *varr, const char *label) { }
 const char* null_vertex_array_get_debug_label(VertexArray *varr) { return "null vertex array"; }
-void null_vertex_array_destroy(VertexArray *varr) { }
-void null_vertex_array_attach_buffer(VertexArray *varr, VertexBuffer *vbuf, uint attachment) { }
-VertexBuffer* null_vertex_array_get_attachment(VertexArray *varr, uint attachment) { return (void*)&placeholder; }
+
+void null_vertex_array_destroy(VertexArray *varr) {
+	if(N.vertex_array == varr) {
+		N.vertex_array = NULL;
+	}
+
+	free(((NullVertexArray*)varr)->attachments);
+	free(varr);
+}
+
+void null_vertex_array_attach_buffer(VertexArray *varr, VertexBuffer *vbuf, uint attachment) {
+	NullVertexArray *nvarr = (NullVertexArray*)varr;
+
+	if(attachment >= nvarr->num_attachments) {
+		nvarr->attachments = realloc(nvarr->attachments, (attachment + 1) * sizeof(*nvarr->attachments));
+		memset(nvarr->attachments + nvarr->num_attachments, 0, (attachment + 1 - nvarr->num_attachments) * sizeof(*nvarr->attachments));
+		nvarr->num_attachments = attachment + 1;
+	}
+
+	nvarr->attachments[attachment] = vbuf;
+}
+
+VertexBuffer* null_vertex_array_get_attachment(VertexArray *varr, uint attachment) {
+	NullVertexArray *nvarr = (NullVertexArray*)varr;
+	return attachment < nvarr->num_attachments ? nvarr->attachments[attachment] : NULL;
+}
+
 void null_vertex_array_layout(VertexArray *varr, uint nattribs, VertexAttribFormat attribs[nattribs]) { }
-void null_vertex_array(VertexArray *varr) { }
-VertexArray* null_vertex_array_current(void) { return (void*)&placeholder; }
+void null_vertex_array(VertexArray *varr) { N.vertex_array = varr; }
+VertexArray* null_vertex_array_current(void) { return N.vertex_array; }
 
 void null_clear(ClearBufferFlags flags) { }
-void null_clear_color4(float r, float g, float b, float a) { }
-const Color* null_clear_color_current(void) { return &dummycolor; }
+void null_clear_color4(float r, float g, float b, float a) { N.clear_color = *RGBA(r, g, b, a); }
+const Color* null_clear_color_current(void) { return &N.clear_color; }
 
-void null_vsync(VsyncMode mode) { }
-VsyncMode null_vsync_current(void) { return VSYNC_NONE; }
+void null_vsync(VsyncMode mode) { N.vsync = mode; }
+VsyncMode null_vsync_current(void) { return N.vsync; }
 
 void null_swap(SDL_Window *window) { }
 
@@ -147,6 +472,7 @@ RendererBackend _r_backend_null = {
 		.post_init = null_post_init,
 		.shutdown = null_shutdown,
 		.create_window = null_create_window,
+		.destroy_window = null_destroy_window,
 		.supports = null_supports,
 		.capabilities = null_capabilities,
 		.capabilities_current = null_capabilities_current,
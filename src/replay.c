@@ -19,6 +19,12 @@
 
 static uint8_t replay_magic_header[] = REPLAY_MAGIC_HEADER;
 
+// frame (4) + type (1) + value (2)
+#define REPLAY_EVENT_SIZE 7
+
+// upper bound for the size of a stored chunk; deflate may slightly expand incompressible data
+#define REPLAY_CHUNK_MAX_SIZE(numevents) ((numevents) * REPLAY_EVENT_SIZE * 2 + 64)
+
 void replay_init(Replay *rpy) {
 	memset(rpy, 0, sizeof(Replay));
 	log_debug("Replay at %p initialized for writing", (void*)rpy);
@@ -56,6 +62,10 @@ ReplayStage* replay_create_stage(Replay *rpy, StageInfo *stage, uint64_t seed, D
 	s->plr_graze = plr->graze;
 	s->plr_inputflags = plr->inputflags;
 
+	if(dmath_is_deterministic()) {
+		s->flags |= REPLAY_SFLAG_DETERMINISTIC_MATH;
+	}
+
 	log_debug("Created a new stage %p in replay %p", (void*)s, (void*)rpy);
 	return s;
 }
@@ -77,9 +87,21 @@ void replay_stage_sync_player_state(ReplayStage *stg, Player *plr) {
 
 static void replay_destroy_stage(ReplayStage *stage) {
 	free(stage->events);
+	free(stage->chunks);
 	memset(stage, 0, sizeof(ReplayStage));
 }
 
+static void replay_close_event_source(Replay *rpy) {
+	ReplayEventSource *src = rpy->event_source;
+
+	if(src) {
+		SDL_RWclose(src->file);
+		free(src->name);
+		free(src);
+		rpy->event_source = NULL;
+	}
+}
+
 void replay_destroy_events(Replay *rpy) {
 	if(!rpy) {
 		return;
@@ -90,8 +112,14 @@ void replay_destroy_events(Replay *rpy) {
 			ReplayStage *stg = rpy->stages + i;
 			free(stg->events);
 			stg->events = NULL;
+			stg->events_base = 0;
+			stg->events_loaded = 0;
+			stg->capacity = 0;
+			stg->event_source = NULL;
 		}
 	}
+
+	replay_close_event_source(rpy);
 }
 
 void replay_destroy(Replay *rpy) {
@@ -107,6 +135,7 @@ void replay_destroy(Replay *rpy) {
 		free(rpy->stages);
 	}
 
+	replay_close_event_source(rpy);
 	free(rpy->playername);
 
 	memset(rpy, 0, sizeof(Replay));
@@ -120,6 +149,8 @@ void replay_stage_event(ReplayStage *stg, uint32_t frame, uint8_t type, uint16_t
 	e->frame = frame;
 	e->type = type;
 	e->value = value;
+	s->events_loaded = s->numevents;
+	s->final_frame = frame;
 
 	if(s->numevents >= s->capacity) {
 		log_debug("Replay stage reached its capacity of %d, reallocating", s->capacity);
@@ -133,6 +164,180 @@ void replay_stage_event(ReplayStage *stg, uint32_t frame, uint8_t type, uint16_t
 	}
 }
 
+static bool replay_read_chunk(ReplayEventSource *src, ReplayChunk *chunk, ReplayEvent *events, bool seek) {
+	if(seek && SDL_RWseek(src->file, (int64_t)src->offset + chunk->offset, RW_SEEK_SET) < 0) {
+		log_warn("%s: SDL_RWseek() failed: %s", src->name, SDL_GetError());
+		return false;
+	}
+
+	uint8_t *data = malloc(chunk->size);
+
+	if(SDL_RWread(src->file, data, chunk->size, 1) != 1) {
+		log_warn("%s: Premature EOF", src->name);
+		free(data);
+		return false;
+	}
+
+	SDL_RWops *rw = SDL_RWFromConstMem(data, chunk->size);
+
+	if(src->compressed) {
+		rw = SDL_RWWrapZReader(rw, REPLAY_COMPRESSION_CHUNK_SIZE, true);
+	}
+
+	bool ok = true;
+
+	for(int i = 0; i < chunk->numevents; ++i) {
+		uint8_t raw[REPLAY_EVENT_SIZE];
+
+		if(SDL_RWread(rw, raw, sizeof(raw), 1) != 1) {
+			ok = false;
+			break;
+		}
+
+		uint32_t frame;
+		uint16_t value;
+		memcpy(&frame, raw, sizeof(frame));
+		memcpy(&value, raw + 5, sizeof(value));
+
+		events[i].frame = SDL_SwapLE32(frame);
+		events[i].type = raw[4];
+		events[i].value = SDL_SwapLE16(value);
+	}
+
+	SDL_RWclose(rw);
+	free(data);
+
+	if(
+		!ok ||
+		events[0].frame != chunk->first_frame ||
+		events[chunk->numevents - 1].frame != chunk->last_frame
+	) {
+		log_warn("%s: Event chunk at offset %u is corrupt", src->name, chunk->offset);
+		return false;
+	}
+
+	return true;
+}
+
+static int replay_stage_find_chunk(ReplayStage *stg, int event) {
+	int lo = 0, hi = stg->numchunks - 1;
+
+	while(lo < hi) {
+		int mid = (lo + hi + 1) / 2;
+
+		if(stg->chunks[mid].first_event <= event) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return lo;
+}
+
+static bool replay_stage_load_chunk(ReplayStage *stg, int idx) {
+	ReplayChunk *c = stg->chunks + idx;
+
+	if(stg->capacity < c->numevents) {
+		stg->capacity = c->numevents;
+		stg->events = realloc(stg->events, sizeof(ReplayEvent) * stg->capacity);
+	}
+
+	// invalidate the window first, in case the read fails halfway through
+	stg->events_loaded = 0;
+
+	if(!replay_read_chunk(stg->event_source, c, stg->events, true)) {
+		return false;
+	}
+
+	stg->events_base = c->first_event;
+	stg->events_loaded = c->numevents;
+	return true;
+}
+
+static bool replay_stage_load_all_events(ReplayStage *stg) {
+	if(stg->events_base == 0 && stg->events_loaded == stg->numevents) {
+		return true;
+	}
+
+	if(!stg->event_source) {
+		log_warn("Stage %X of the replay has no events loaded", stg->stage);
+		return false;
+	}
+
+	// one extra slot, so that replay_stage_event() can still append
+	ReplayEvent *events = malloc(sizeof(ReplayEvent) * (stg->numevents + 1));
+
+	for(int i = 0; i < stg->numchunks; ++i) {
+		ReplayChunk *c = stg->chunks + i;
+
+		if(!replay_read_chunk(stg->event_source, c, events + c->first_event, true)) {
+			free(events);
+			return false;
+		}
+	}
+
+	free(stg->events);
+	stg->events = events;
+	stg->capacity = stg->numevents + 1;
+	stg->events_base = 0;
+	stg->events_loaded = stg->numevents;
+	return true;
+}
+
+ReplayEvent* replay_stage_current_event(ReplayStage *stg) {
+	if(stg->playpos >= stg->numevents) {
+		return NULL;
+	}
+
+	int rel = stg->playpos - stg->events_base;
+
+	if(rel < 0 || rel >= stg->events_loaded) {
+		if(!stg->event_source || !replay_stage_load_chunk(stg, replay_stage_find_chunk(stg, stg->playpos))) {
+			log_warn("Replay events of stage %X are unavailable past event %i", stg->stage, stg->playpos);
+			stg->playpos = stg->numevents;
+			stg->desynced = true;
+			return NULL;
+		}
+
+		rel = stg->playpos - stg->events_base;
+	}
+
+	return stg->events + rel;
+}
+
+void replay_stage_seek(ReplayStage *stg, uint32_t frame) {
+	stg->playpos = 0;
+
+	if(stg->chunks) {
+		// skip straight to the first chunk that can contain the frame
+		int lo = 0, hi = stg->numchunks;
+
+		while(lo < hi) {
+			int mid = (lo + hi) / 2;
+
+			if(stg->chunks[mid].last_frame < frame) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+
+		if(lo == stg->numchunks) {
+			stg->playpos = stg->numevents;
+			return;
+		}
+
+		stg->playpos = stg->chunks[lo].first_event;
+	}
+
+	ReplayEvent *e;
+
+	while((e = replay_stage_current_event(stg)) && e->frame < frame) {
+		++stg->playpos;
+	}
+}
+
 static void replay_write_string(SDL_RWops *file, char *str, uint16_t version) {
 	if(version >= REPLAY_STRUCT_VERSION_TS102000_REV1) {
 		SDL_WriteU8(file, strlen(str));
@@ -171,6 +376,10 @@ static uint32_t replay_calc_stageinfo_checksum(ReplayStage *stg, uint16_t versio
 	cs += stg->plr_inputflags;
 	cs += stg->numevents;
 
+	if(version >= REPLAY_STRUCT_VERSION_TS102000_REV3) {
+		cs += stg->numchunks;
+	}
+
 	if(version >= REPLAY_STRUCT_VERSION_TS102000_REV1) {
 		cs += stg->plr_continues_used;
 		cs += stg->flags;
@@ -215,11 +424,61 @@ static bool replay_write_stage(ReplayStage *stg, SDL_RWops *file, uint16_t versi
 	}
 
 	SDL_WriteLE16(file, stg->numevents);
+
+	if(version >= REPLAY_STRUCT_VERSION_TS102000_REV3) {
+		SDL_WriteLE16(file, stg->numchunks);
+	}
+
 	SDL_WriteLE32(file, 1 + ~replay_calc_stageinfo_checksum(stg, version));
 
+	if(version >= REPLAY_STRUCT_VERSION_TS102000_REV3) {
+		for(int i = 0; i < stg->numchunks; ++i) {
+			ReplayChunk *c = stg->chunks + i;
+			SDL_WriteLE32(file, c->first_frame);
+			SDL_WriteLE32(file, c->last_frame);
+			SDL_WriteLE16(file, c->numevents);
+			SDL_WriteLE32(file, c->offset);
+			SDL_WriteLE32(file, c->size);
+		}
+	}
+
 	return true;
 }
 
+// Splits the events into chunks, appends them to dest and builds the chunk index.
+static void replay_write_chunks(ReplayStage *stg, SDL_RWops *dest, bool compression) {
+	int numchunks = (stg->numevents + REPLAY_CHUNK_EVENTS - 1) / REPLAY_CHUNK_EVENTS;
+
+	free(stg->chunks);
+	stg->chunks = calloc(numchunks ? numchunks : 1, sizeof(ReplayChunk));
+	stg->numchunks = numchunks;
+
+	for(int i = 0; i < numchunks; ++i) {
+		ReplayChunk *c = stg->chunks + i;
+		c->first_event = i * REPLAY_CHUNK_EVENTS;
+		c->numevents = imin(REPLAY_CHUNK_EVENTS, stg->numevents - c->first_event);
+		c->first_frame = stg->events[c->first_event].frame;
+		c->last_frame = stg->events[c->first_event + c->numevents - 1].frame;
+		c->offset = SDL_RWtell(dest);
+
+		SDL_RWops *vfile = dest;
+
+		if(compression) {
+			vfile = SDL_RWWrapZWriter(dest, REPLAY_COMPRESSION_CHUNK_SIZE, false);
+		}
+
+		for(int j = 0; j < c->numevents; ++j) {
+			replay_write_stage_event(stg->events + c->first_event + j, vfile);
+		}
+
+		if(compression) {
+			SDL_RWclose(vfile);
+		}
+
+		c->size = SDL_RWtell(dest) - c->offset;
+	}
+}
+
 static void fix_flags(Replay *rpy) {
 	rpy->flags |= REPLAY_GFLAG_CLEAR;
 
@@ -236,6 +495,24 @@ bool replay_write(Replay *rpy, SDL_RWops *file, uint16_t version) {
 	bool compression = (version & REPLAY_VERSION_COMPRESSION_BIT);
 	int i, j;
 
+	for(i = 0; i < rpy->numstages; ++i) {
+		if(!replay_stage_load_all_events(rpy->stages + i)) {
+			return false;
+		}
+	}
+
+	// Chunked events have to be laid out before the metadata, because it contains the chunk index.
+	void *events_buf;
+	SDL_RWops *events_abuf = NULL;
+
+	if(base_version >= REPLAY_STRUCT_VERSION_TS102000_REV3) {
+		events_abuf = SDL_RWAutoBuffer(&events_buf, 1024);
+
+		for(i = 0; i < rpy->numstages; ++i) {
+			replay_write_chunks(rpy->stages + i, events_abuf, compression);
+		}
+	}
+
 	SDL_RWwrite(file, replay_magic_header, sizeof(replay_magic_header), 1);
 	SDL_WriteLE16(file, version);
 
@@ -245,6 +522,11 @@ bool replay_write(Replay *rpy, SDL_RWops *file, uint16_t version) {
 
 		if(taisei_version_write(file, &v) != TAISEI_VERSION_SIZE) {
 			log_warn("Failed to write game version: %s", SDL_GetError());
+
+			if(events_abuf) {
+				SDL_RWclose(events_abuf);
+			}
+
 			return false;
 		}
 	}
@@ -274,6 +556,10 @@ bool replay_write(Replay *rpy, SDL_RWops *file, uint16_t version) {
 				SDL_RWclose(abuf);
 			}
 
+			if(events_abuf) {
+				SDL_RWclose(events_abuf);
+			}
+
 			return false;
 		}
 	}
@@ -283,24 +569,32 @@ bool replay_write(Replay *rpy, SDL_RWops *file, uint16_t version) {
 		SDL_WriteLE32(file, SDL_RWtell(file) + SDL_RWtell(abuf) + 4);
 		SDL_RWwrite(file, buf, SDL_RWtell(abuf), 1);
 		SDL_RWclose(abuf);
-		vfile = SDL_RWWrapZWriter(file, REPLAY_COMPRESSION_CHUNK_SIZE, false);
 	}
 
-	for(i = 0; i < rpy->numstages; ++i) {
-		ReplayStage *stg = rpy->stages + i;
-		for(j = 0; j < stg->numevents; ++j) {
-			if(!replay_write_stage_event(stg->events + j, vfile)) {
-				if(compression) {
-					SDL_RWclose(vfile);
-				}
+	if(events_abuf) {
+		SDL_RWwrite(file, events_buf, SDL_RWtell(events_abuf), 1);
+		SDL_RWclose(events_abuf);
+	} else {
+		if(compression) {
+			vfile = SDL_RWWrapZWriter(file, REPLAY_COMPRESSION_CHUNK_SIZE, false);
+		}
 
-				return false;
+		for(i = 0; i < rpy->numstages; ++i) {
+			ReplayStage *stg = rpy->stages + i;
+			for(j = 0; j < stg->numevents; ++j) {
+				if(!replay_write_stage_event(stg->events + j, vfile)) {
+					if(compression) {
+						SDL_RWclose(vfile);
+					}
+
+					return false;
+				}
 			}
 		}
-	}
 
-	if(compression) {
-		SDL_RWclose(vfile);
+		if(compression) {
+			SDL_RWclose(vfile);
+		}
 	}
 
 	// useless byte to simplify the premature EOF check, can be anything
@@ -361,6 +655,7 @@ static bool replay_read_header(Replay *rpy, SDL_RWops *file, int64_t filesize, s
 		case REPLAY_STRUCT_VERSION_TS102000_REV0:
 		case REPLAY_STRUCT_VERSION_TS102000_REV1:
 		case REPLAY_STRUCT_VERSION_TS102000_REV2:
+		case REPLAY_STRUCT_VERSION_TS102000_REV3:
 		{
 			if(taisei_version_read(file, &rpy->game_version) != TAISEI_VERSION_SIZE) {
 				log_warn("%s: Failed to read game version", source);
@@ -390,8 +685,53 @@ static bool replay_read_header(Replay *rpy, SDL_RWops *file, int64_t filesize, s
 	return true;
 }
 
+static bool replay_read_chunk_index(ReplayStage *stg, SDL_RWops *file, int64_t filesize, uint32_t *offset, const char *source) {
+	if(!stg->numchunks || stg->numchunks > stg->numevents) {
+		log_warn("%s: Invalid number of event chunks (%u) in stage %X", source, stg->numchunks, stg->stage);
+		return false;
+	}
+
+	stg->chunks = calloc(stg->numchunks, sizeof(ReplayChunk));
+	int first_event = 0;
+
+	for(int i = 0; i < stg->numchunks; ++i) {
+		ReplayChunk *c = stg->chunks + i;
+
+		CHECKPROP(c->first_frame = SDL_ReadLE32(file), u);
+		CHECKPROP(c->last_frame = SDL_ReadLE32(file), u);
+		CHECKPROP(c->numevents = SDL_ReadLE16(file), u);
+		CHECKPROP(c->offset = SDL_ReadLE32(file), u);
+		CHECKPROP(c->size = SDL_ReadLE32(file), u);
+
+		if(
+			!c->numevents ||
+			!c->size ||
+			c->size > REPLAY_CHUNK_MAX_SIZE(c->numevents) ||
+			c->offset != *offset ||
+			c->first_frame > c->last_frame ||
+			(i > 0 && c->first_frame < c[-1].last_frame)
+		) {
+			log_warn("%s: Event chunk %i of stage %X is corrupt", source, i, stg->stage);
+			return false;
+		}
+
+		c->first_event = first_event;
+		first_event += c->numevents;
+		*offset += c->size;
+	}
+
+	if(first_event != stg->numevents) {
+		log_warn("%s: Event chunks of stage %X contain %i events, expected %u", source, stg->stage, first_event, stg->numevents);
+		return false;
+	}
+
+	stg->final_frame = stg->chunks[stg->numchunks - 1].last_frame;
+	return true;
+}
+
 static bool replay_read_meta(Replay *rpy, SDL_RWops *file, int64_t filesize, const char *source) {
 	uint16_t version = rpy->version & ~REPLAY_VERSION_COMPRESSION_BIT;
+	uint32_t chunk_offset = 0;
 
 	replay_read_string(file, &rpy->playername, version);
 	PRINTPROP(rpy->playername, s);
@@ -444,10 +784,21 @@ static bool replay_read_meta(Replay *rpy, SDL_RWops *file, int64_t filesize, con
 
 		CHECKPROP(stg->numevents = SDL_ReadLE16(file), u);
 
+		if(version >= REPLAY_STRUCT_VERSION_TS102000_REV3) {
+			CHECKPROP(stg->numchunks = SDL_ReadLE16(file), u);
+		}
+
 		if(replay_calc_stageinfo_checksum(stg, version) + SDL_ReadLE32(file)) {
 			log_warn("%s: Stageinfo is corrupt", source);
 			return false;
 		}
+
+		if(
+			version >= REPLAY_STRUCT_VERSION_TS102000_REV3 &&
+			!replay_read_chunk_index(stg, file, filesize, &chunk_offset, source)
+		) {
+			return false;
+		}
 	}
 
 	return true;
@@ -472,11 +823,89 @@ static bool replay_read_events(Replay *rpy, SDL_RWops *file, int64_t filesize, c
 			CHECKPROP(evt->type = SDL_ReadU8(file), u);
 			CHECKPROP(evt->value = SDL_ReadLE16(file), u);
 		}
+
+		stg->capacity = stg->numevents;
+		stg->events_base = 0;
+		stg->events_loaded = stg->numevents;
+		stg->final_frame = stg->events[stg->numevents - 1].frame;
+	}
+
+	return true;
+}
+
+static bool replay_read_chunked_events(Replay *rpy, SDL_RWops *file, bool stream, const char *source) {
+	ReplayEventSource src = {
+		.file = file,
+		.name = (char*)source,
+		.offset = rpy->fileoffset,
+		.compressed = rpy->version & REPLAY_VERSION_COMPRESSION_BIT,
+	};
+
+	if(stream && SDL_RWseek(file, 0, RW_SEEK_CUR) >= 0) {
+		// Chunks are loaded lazily as playback reaches them, see replay_stage_current_event()
+		rpy->event_source = memdup(&src, sizeof(src));
+		rpy->event_source->name = strdup(source);
+
+		for(int i = 0; i < rpy->numstages; ++i) {
+			rpy->stages[i].event_source = rpy->event_source;
+		}
+
+		return true;
+	}
+
+	// Not seekable, or streaming wasn't asked for. The chunks are stored back to back, so read them all in order.
+	// Like with the legacy format, a non-seekable stream is assumed to be at the start of the events already.
+	SDL_RWseek(file, rpy->fileoffset, RW_SEEK_SET);
+
+	for(int i = 0; i < rpy->numstages; ++i) {
+		ReplayStage *stg = rpy->stages + i;
+
+		stg->events = malloc(sizeof(ReplayEvent) * stg->numevents);
+		stg->capacity = stg->numevents;
+
+		for(int j = 0; j < stg->numchunks; ++j) {
+			ReplayChunk *c = stg->chunks + j;
+
+			if(!replay_read_chunk(&src, c, stg->events + c->first_event, false)) {
+				return false;
+			}
+		}
+
+		stg->events_base = 0;
+		stg->events_loaded = stg->numevents;
 	}
 
 	return true;
 }
 
+static bool replay_read_legacy_events(Replay *rpy, SDL_RWops *file, int64_t filesize, const char *source) {
+	SDL_RWops *vfile = file;
+	bool compression = false;
+
+	if(rpy->version & REPLAY_VERSION_COMPRESSION_BIT) {
+		vfile = SDL_RWWrapZReader(file, REPLAY_COMPRESSION_CHUNK_SIZE, false);
+		filesize = -1;
+		compression = true;
+	}
+
+	if(!replay_read_events(rpy, vfile, filesize, source)) {
+		if(compression) {
+			SDL_RWclose(vfile);
+		}
+
+		replay_destroy_events(rpy);
+		return false;
+	}
+
+	if(compression) {
+		SDL_RWclose(vfile);
+	}
+
+	// useless byte to simplify the premature EOF check, can be anything
+	SDL_ReadU8(file);
+	return true;
+}
+
 bool replay_read(Replay *rpy, SDL_RWops *file, ReplayReadMode mode, const char *source) {
 	int64_t filesize; // must be signed
 	SDL_RWops *vfile = file;
@@ -489,6 +918,8 @@ bool replay_read(Replay *rpy, SDL_RWops *file, ReplayReadMode mode, const char *
 		log_fatal("%s: Called with invalid read mode %x", source, mode);
 	}
 
+	bool stream = mode & REPLAY_READ_STREAM;
+	bool streaming = false;
 	mode &= REPLAY_READ_ALL;
 	filesize = SDL_RWsize(file);
 
@@ -547,7 +978,7 @@ bool replay_read(Replay *rpy, SDL_RWops *file, ReplayReadMode mode, const char *
 			}
 
 			for(int i = 0; i < rpy->numstages; ++i) {
-				if(rpy->stages[i].events) {
+				if(rpy->stages[i].events || rpy->event_source) {
 					log_warn("%s: BUG: Reading events into a replay that already had events, call replay_destroy_events() if this is intended", source);
 					replay_destroy_events(rpy);
 					break;
@@ -560,29 +991,20 @@ bool replay_read(Replay *rpy, SDL_RWops *file, ReplayReadMode mode, const char *
 			}
 		}
 
-		bool compression = false;
-
-		if(rpy->version & REPLAY_VERSION_COMPRESSION_BIT) {
-			vfile = SDL_RWWrapZReader(file, REPLAY_COMPRESSION_CHUNK_SIZE, false);
-			filesize = -1;
-			compression = true;
-		}
-
-		if(!replay_read_events(rpy, vfile, filesize, source)) {
-			if(compression) {
-				SDL_RWclose(vfile);
+		if((rpy->version & ~REPLAY_VERSION_COMPRESSION_BIT) >= REPLAY_STRUCT_VERSION_TS102000_REV3) {
+			if(!replay_read_chunked_events(rpy, file, stream, source)) {
+				replay_destroy_events(rpy);
+				return false;
 			}
 
-			replay_destroy_events(rpy);
+			streaming = rpy->event_source != NULL;
+		} else if(!replay_read_legacy_events(rpy, file, filesize, source)) {
 			return false;
 		}
+	}
 
-		if(compression) {
-			SDL_RWclose(vfile);
-		}
-
-		// useless byte to simplify the premature EOF check, can be anything
-		SDL_ReadU8(file);
+	if(stream && !streaming) {
+		SDL_RWclose(file);
 	}
 
 	return true;
@@ -645,14 +1067,20 @@ bool replay_load(Replay *rpy, const char *name, ReplayReadMode mode) {
 		return false;
 	}
 
-	bool result = replay_read(rpy, file, mode, sp);
+	// when streaming, the replay keeps the file open for as long as it holds its events
+	bool stream = mode & REPLAY_READ_EVENTS;
+	bool result = replay_read(rpy, file, stream ? mode | REPLAY_READ_STREAM : mode, sp);
 
 	if(!result) {
 		replay_destroy(rpy);
 	}
 
 	free(sp);
-	SDL_RWclose(file);
+
+	if(!result || !stream) {
+		SDL_RWclose(file);
+	}
+
 	return result;
 }
 
@@ -674,13 +1102,17 @@ bool replay_load_syspath(Replay *rpy, const char *path, ReplayReadMode mode) {
 		return false;
 	}
 
-	bool result = replay_read(rpy, file, mode, path);
+	bool stream = mode & REPLAY_READ_EVENTS;
+	bool result = replay_read(rpy, file, stream ? mode | REPLAY_READ_STREAM : mode, path);
 
 	if(!result) {
 		replay_destroy(rpy);
 	}
 
-	SDL_RWclose(file);
+	if(!result || !stream) {
+		SDL_RWclose(file);
+	}
+
 	return result;
 }
 
@@ -701,14 +1133,34 @@ void replay_copy(Replay *dst, Replay *src, bool steal_events) {
 		s = src->stages + i;
 		d = dst->stages + i;
 
+		// the chunk index is metadata, so both replays need their own copy
+		if(s->chunks) {
+			d->chunks = memdup(s->chunks, sizeof(ReplayChunk) * s->numchunks);
+		}
+
 		if(steal_events) {
 			s->events = NULL;
+			s->events_base = 0;
+			s->events_loaded = 0;
+			s->capacity = 0;
+			s->event_source = NULL;
 		} else {
-			d->capacity = s->numevents;
+			if(!replay_stage_load_all_events(s)) {
+				log_warn("Copying a replay with some of its events missing");
+			}
+
+			d->capacity = s->events_loaded;
 			d->events = (ReplayEvent*)malloc(sizeof(ReplayEvent) * d->capacity);
 			memcpy(d->events, s->events, sizeof(ReplayEvent) * d->capacity);
+			d->event_source = NULL;
 		}
 	}
+
+	if(steal_events) {
+		src->event_source = NULL;
+	} else {
+		dst->event_source = NULL;
+	}
 }
 
 void replay_stage_check_desync(ReplayStage *stg, int time, uint16_t check, ReplayMode mode) {
@@ -753,6 +1205,57 @@ int replay_find_stage_idx(Replay *rpy, uint8_t stageid) {
 	return -1;
 }
 
+void replay_seek_playback(uint32_t frame) {
+	ReplayStage *stg = global.replay_stage;
+	assert(global.replaymode == REPLAY_PLAY);
+	assert(stg != NULL);
+
+	if(frame < global.frames) {
+		global.game_over = GAMEOVER_RESTART;
+		stg->seek_restart = true;
+	}
+
+	log_debug("Seeking from frame %i to %u", global.frames, frame);
+	stg->seek_frame = frame;
+}
+
+void replay_stage_seek_on_start(ReplayStage *stg, uint32_t frame) {
+	// same as a backward seek that restarts the stage, so that replay_seek_stage_begin keeps it
+	stg->seek_frame = frame;
+	stg->seek_restart = frame > 0;
+}
+
+void replay_seek_stage_begin(ReplayStage *stg) {
+	if(!stg->seek_restart) {
+		stg->seek_frame = 0;
+	} else if(stg->seek_frame) {
+		log_info("Fast-forwarding to frame %u", stg->seek_frame);
+	}
+
+	stg->seek_restart = false;
+}
+
+void replay_seek_update(void) {
+	ReplayStage *stg = global.replay_stage;
+
+	if(
+		global.replaymode == REPLAY_PLAY &&
+		stg != NULL &&
+		stg->seek_frame != 0 &&
+		global.frames >= stg->seek_frame
+	) {
+		log_debug("Reached frame %u, seek finished", stg->seek_frame);
+		stg->seek_frame = 0;
+	}
+}
+
+bool replay_is_seeking(void) {
+	return
+		global.replaymode == REPLAY_PLAY &&
+		global.replay_stage != NULL &&
+		global.frames < global.replay_stage->seek_frame;
+}
+
 void replay_play(Replay *rpy, int firstidx) {
 	if(rpy != &global.replay) {
 		replay_copy(&global.replay, rpy, true);
@@ -777,6 +1280,11 @@ void replay_play(Replay *rpy, int firstidx) {
 		global.plr.mode = plrmode_find(rstg->plr_char, rstg->plr_shot);
 		stage_loop(gstg);
 
+		if(rstg->seek_frame && !rstg->seek_restart) {
+			log_warn("Stage ended at frame %i, before reaching seek target %u", global.frames, rstg->seek_frame);
+			rstg->seek_frame = 0;
+		}
+
 		if(global.game_over == GAMEOVER_ABORT) {
 			break;
 		}
@@ -38,13 +38,19 @@
 
 	// Taisei v1.2 revision 2: adds graze points
 	#define REPLAY_STRUCT_VERSION_TS102000_REV2 8
+
+	// Taisei v1.2 revision 3: events are split into independently compressed chunks, with a per-stage index
+	#define REPLAY_STRUCT_VERSION_TS102000_REV3 9
 /* END supported struct versions */
 
 #define REPLAY_VERSION_COMPRESSION_BIT 0x8000
 #define REPLAY_COMPRESSION_CHUNK_SIZE 4096
 
 // What struct version to use when saving recorded replays
-#define REPLAY_STRUCT_VERSION_WRITE (REPLAY_STRUCT_VERSION_TS102000_REV2 | REPLAY_VERSION_COMPRESSION_BIT)
+#define REPLAY_STRUCT_VERSION_WRITE (REPLAY_STRUCT_VERSION_TS102000_REV3 | REPLAY_VERSION_COMPRESSION_BIT)
+
+// Maximum number of events per chunk (REPLAY_STRUCT_VERSION_TS102000_REV3 and above)
+#define REPLAY_CHUNK_EVENTS 512
 
 #define REPLAY_ALLOC_INITIAL 256
 
@@ -68,6 +74,33 @@ typedef struct ReplayEvent {
 	/* END stored fields */
 } ReplayEvent;
 
+typedef struct ReplayChunk {
+	/* BEGIN stored fields */
+
+	// frames of the first and last events in this chunk
+	uint32_t first_frame;
+	uint32_t last_frame;
+
+	uint16_t numevents;
+
+	// location of the chunk data, relative to Replay.fileoffset
+	uint32_t offset;
+	uint32_t size;
+
+	/* END stored fields */
+
+	// index of the first event of this chunk within the stage
+	int first_event;
+} ReplayChunk;
+
+// Where the events of a chunked replay are streamed from. Shared by all stages of a replay.
+typedef struct ReplayEventSource {
+	SDL_RWops *file;
+	char *name;
+	uint32_t offset;
+	bool compressed;
+} ReplayEventSource;
+
 typedef struct ReplayStage {
 	/* BEGIN stored fields */
 
@@ -107,22 +140,47 @@ typedef struct ReplayStage {
 	// player input
 	uint16_t numevents;
 
+	/* BEGIN REPLAY_STRUCT_VERSION_TS102000_REV3 and above */
+	uint16_t numchunks;
+	/* END REPLAY_STRUCT_VERSION_TS102000_REV3 and above */
+
 	// checksum of all of the above -- 2's complement of value returned by replay_calc_stageinfo_checksum()
 	// uint32_t checksum;
 
+	/* BEGIN REPLAY_STRUCT_VERSION_TS102000_REV3 and above */
+	// Array, contains {numchunks} elements
+	ReplayChunk *chunks;
+	/* END REPLAY_STRUCT_VERSION_TS102000_REV3 and above */
+
 	/* END stored fields */
 
 	SystemTime init_time;
+
+	// Events [events_base, events_base + events_loaded) of this stage.
+	// When streaming, this is a single chunk; otherwise it's all of them.
 	ReplayEvent *events;
+	int events_base;
+	int events_loaded;
 
-	// events allocated (may be higher than numevents)
+	// events allocated (may be higher than events_loaded)
 	int capacity;
 
+	// when not NULL, events are loaded chunk by chunk from here as playback progresses
+	ReplayEventSource *event_source;
+
+	// frame of the last event (EV_OVER), known once events or the chunk index are loaded
+	uint32_t final_frame;
+
 	// used during playback
 	int playpos;
 	int fps;
 	uint16_t desync_check;
 	bool desynced;
+
+	// playback runs without rendering or sound until this frame, see replay_seek_playback()
+	uint32_t seek_frame;
+	// set while a backward seek restarts the stage, so that the restart keeps seek_frame
+	bool seek_restart;
 } ReplayStage;
 
 typedef struct Replay {
@@ -173,12 +231,17 @@ typedef struct Replay {
 	// All input events are stored at the very end of the replay so that we can save some time and memory
 	// by only loading them when necessary without seeking around the file too much.
 	//
+	// REPLAY_STRUCT_VERSION_TS102000_REV2 and below: one stream, compressed as a whole
+	// REPLAY_STRUCT_VERSION_TS102000_REV3 and above: chunks as described by ReplayStage.chunks, each compressed separately
+	//
 	// ReplayStage input_events[];
 
 	// at least one trailing byte, value doesn't matter
 	// uint8_t useless;
 
 	/* END stored fields */
+
+	ReplayEventSource *event_source;
 } Replay;
 
 typedef enum {
@@ -191,6 +254,10 @@ typedef enum ReplayReadMode {
 	REPLAY_READ_META = 1,
 	REPLAY_READ_EVENTS = 2,
 	REPLAY_READ_ALL = 3, // includes the other two
+
+	// Chunked replays only: keep the file open and load events as playback reaches them.
+	// If set, the replay takes ownership of the file when replay_read succeeds.
+	REPLAY_READ_STREAM = 4,
 } ReplayReadMode;
 
 typedef enum ReplayGlobalFlags {
@@ -205,6 +272,7 @@ typedef enum ReplayStageFlags {
 	REPLAY_SFLAG_CONTINUES          = (1 << 0), // a continue was used in this stage
 	REPLAY_SFLAG_CHEATS             = (1 << 1), // a cheat was used in this stage
 	REPLAY_SFLAG_CLEAR              = (1 << 2), // this stage was cleared
+	REPLAY_SFLAG_DETERMINISTIC_MATH = (1 << 3), // simulated with util/dmath.h kernels instead of libm
 } ReplayStageFlags;
 
 void replay_init(Replay *rpy);
@@ -217,6 +285,12 @@ void replay_stage_event(ReplayStage *stg, uint32_t frame, uint8_t type, uint16_t
 void replay_stage_check_desync(ReplayStage *stg, int time, uint16_t check, ReplayMode mode);
 void replay_stage_sync_player_state(ReplayStage *stg, Player *plr);
 
+// Returns the event at stg->playpos, loading its chunk if needed, or NULL past the last event.
+ReplayEvent* replay_stage_current_event(ReplayStage *stg);
+
+// Moves stg->playpos to the first event at or after frame.
+void replay_stage_seek(ReplayStage *stg, uint32_t frame);
+
 bool replay_write(Replay *rpy, SDL_RWops *file, uint16_t version);
 bool replay_read(Replay *rpy, SDL_RWops *file, ReplayReadMode mode, const char *source);
 
@@ -228,4 +302,18 @@ void replay_copy(Replay *dst, Replay *src, bool steal_events);
 
 void replay_play(Replay *rpy, int firstidx);
 
+// Fast-forwards the stage being played back to the given frame.
+// Seeking backwards restarts the stage and simulates it up to that point again.
+void replay_seek_playback(uint32_t frame);
+bool replay_is_seeking(void);
+
+// Makes the next playback of stg start by fast-forwarding to frame (used by --seek).
+void replay_stage_seek_on_start(ReplayStage *stg, uint32_t frame);
+
+// Called when playback of a stage (re)starts; drops the seek target unless a seek caused the restart.
+void replay_seek_stage_begin(ReplayStage *stg);
+
+// Called after every logic frame; ends the seek once the target frame has been reached.
+void replay_seek_update(void);
+
 int replay_find_stage_idx(Replay *rpy, uint8_t stageid);
@@ -10,6 +10,7 @@
 
 #include "animation.h"
 #include "texture.h"
+#include "manifest.h"
 #include "resource.h"
 #include "list.h"
 #include "renderer/api.h"
@@ -193,7 +194,7 @@ void* load_animation_begin(const char *filename, uint flags) {
 	Animation *ani = calloc(1, sizeof(Animation));
 	ht_create(&ani->sequences);
 
-	if(!parse_keyvalue_file_cb(filename, animation_parse_callback, ani)) {
+	if(!parse_keyvalue_resource_cb(filename, animation_parse_callback, ani)) {
 		ht_foreach(&ani->sequences, free_sequence_callback, NULL);
 		ht_destroy(&ani->sequences);
 		free(ani);
@@ -210,6 +211,13 @@ void* load_animation_begin(const char *filename, uint flags) {
 		return NULL;
 	}
 
+	char buf[strlen(basename) + sizeof(".frame0000")];
+
+	for(int i = 0; i < ani->sprite_count; ++i) {
+		snprintf(buf, sizeof(buf), "%s.frame%04d", basename, i);
+		preload_resource(RES_SPRITE, buf, flags);
+	}
+
 	AnimationLoadData *data = malloc(sizeof(AnimationLoadData));
 	data->ani = ani;
 	data->basename = basename;
@@ -13,6 +13,7 @@
 
 #include "resource.h"
 #include "bgm.h"
+#include "manifest.h"
 #include "audio_mixer.h"
 #include "util.h"
 
@@ -29,7 +30,8 @@ static Mix_Music* load_mix_music(const char *path) {
 		return NULL;
 	}
 
-	SDL_RWops *rwops = vfs_open(path, VFS_MODE_READ | VFS_MODE_SEEKABLE);
+	// streamed by the audio thread
+	SDL_RWops *rwops = vfs_open(path, VFS_MODE_READ | VFS_MODE_SEEKABLE | VFS_MODE_ANY_THREAD);
 
 	if(!rwops) {
 		log_warn("VFS error: %s", vfs_get_error());
@@ -55,7 +57,7 @@ void* load_bgm_begin(const char *path, uint flags) {
 		char *intro = NULL;
 		char *loop = NULL;
 
-		if(!parse_keyvalue_file_with_spec(path, (KVSpec[]) {
+		if(!parse_keyvalue_resource_with_spec(path, (KVSpec[]) {
 			{ "artist" }, // don’t print a warning because this field is supposed to be here
 			{ "intro",      .out_str    = &intro            },
 			{ "loop",       .out_str    = &loop             },
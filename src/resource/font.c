@@ -101,12 +101,48 @@ struct Font {
 	ht_int2int_t charcodes_to_glyph_ofs;
 	ht_int2int_t ftindex_to_glyph_ofs;
 	FontMetrics metrics;
+	uint layout_epoch;
 
 #ifdef DEBUG
 	char debug_label[64];
 #endif
 };
 
+/*
+ * A text layout is the result of shaping a string: its bounding box, and the position of
+ * every visible glyph with kerning and alignment already applied. It depends only on the
+ * font, the text and the alignment, so drawing it again is just a run of sprites.
+ *
+ * Layouts refer to glyphs by their offset into the font's glyph array, which stays valid
+ * until the glyph cache is wiped. Every wipe moves the font to a new layout epoch, which
+ * invalidates all layouts made from it.
+ */
+
+typedef struct TextLayoutGlyph {
+	charcode_t charcode;
+	uint glyph_ofs;
+	double x;
+	double y;
+} TextLayoutGlyph;
+
+struct TextLayout {
+	Font *font;
+	char *text;
+	TextLayoutGlyph *glyphs;
+	uint num_glyphs;
+	uint glyphs_allocated;
+	uint epoch;
+	hash_t text_hash;
+	Alignment align;
+	BBox bbox;
+	double line0_x;
+	double end_x;
+	uint64_t last_used;
+};
+
+// Ad-hoc strings passed to text_draw are laid out into this LRU cache.
+#define TEXT_LAYOUT_CACHE_SIZE 64
+
 static struct {
 	FT_Library lib;
 	ShaderProgram *default_shader;
@@ -117,6 +153,13 @@ static struct {
 		SDL_mutex *new_face;
 		SDL_mutex *done_face;
 	} mutex;
+
+	struct {
+		TextLayout entries[TEXT_LAYOUT_CACHE_SIZE];
+		uint64_t clock;
+	} layout_cache;
+
+	SDL_atomic_t layout_epoch;
 } globals;
 
 static double global_font_scale(void) {
@@ -202,7 +245,13 @@ static void post_init_fonts(void) {
 	globals.default_shader = get_resource_data(RES_SHADER_PROGRAM, "text_default", RESF_PERMANENT | RESF_PRELOAD);
 }
 
+static void text_layout_clear(TextLayout *layout);
+
 static void shutdown_fonts(void) {
+	for(int i = 0; i < TEXT_LAYOUT_CACHE_SIZE; ++i) {
+		text_layout_clear(globals.layout_cache.entries + i);
+	}
+
 	r_texture_destroy(globals.render_tex);
 	r_framebuffer_destroy(globals.render_buf);
 	events_unregister_handler(fonts_event);
@@ -255,7 +304,8 @@ static FT_Error FT_Done_Face_Thread_Safe(FT_Face face) {
 static FT_Face load_font_face(char *vfspath, long index) {
 	char *syspath = vfs_repr(vfspath, true);
 
-	SDL_RWops *rwops = vfs_open(vfspath, VFS_MODE_READ | VFS_MODE_SEEKABLE);
+	// FreeType keeps reading it after the loader thread is done
+	SDL_RWops *rwops = vfs_open(vfspath, VFS_MODE_READ | VFS_MODE_SEEKABLE | VFS_MODE_ANY_THREAD);
 
 	if(!rwops) {
 		log_warn("VFS error: %s", vfs_get_error());
@@ -534,6 +584,7 @@ static void wipe_glyph_cache(Font *font) {
 	}
 
 	font->glyphs_used = 0;
+	font->layout_epoch = SDL_AtomicIncRef(&globals.layout_epoch) + 1;
 }
 
 static void free_font_resources(Font *font) {
@@ -585,6 +636,7 @@ void* load_font_begin(const char *path, uint flags) {
 
 	font.glyphs_allocated = 32;
 	font.glyphs = calloc(font.glyphs_allocated, sizeof(Glyph));
+	font.layout_epoch = SDL_AtomicIncRef(&globals.layout_epoch) + 1;
 
 #ifdef DEBUG
 	char *basename = resource_util_basename(FONT_PATH_PREFIX, path);
@@ -806,15 +858,120 @@ static Font* font_from_params(const TextParams *params) {
 	return font;
 }
 
+static void text_layout_clear(TextLayout *layout) {
+	free(layout->text);
+	free(layout->glyphs);
+	memset(layout, 0, sizeof(*layout));
+}
+
+static inline bool text_layout_matches(TextLayout *layout, Font *font, const char *text, hash_t text_hash, Alignment align) {
+	return
+		layout->text != NULL &&
+		layout->font == font &&
+		layout->epoch == font->layout_epoch &&
+		layout->align == align &&
+		layout->text_hash == text_hash &&
+		!strcmp(layout->text, text);
+}
+
+static void text_layout_add_glyph(TextLayout *layout, charcode_t charcode, uint glyph_ofs, double x, double y) {
+	if(layout->num_glyphs == layout->glyphs_allocated) {
+		layout->glyphs_allocated = layout->glyphs_allocated ? layout->glyphs_allocated * 2 : 8;
+		layout->glyphs = realloc(layout->glyphs, sizeof(*layout->glyphs) * layout->glyphs_allocated);
+	}
+
+	layout->glyphs[layout->num_glyphs++] = (TextLayoutGlyph) {
+		.charcode = charcode,
+		.glyph_ofs = glyph_ofs,
+		.x = x,
+		.y = y,
+	};
+}
+
+static void text_layout_build(TextLayout *layout, Font *font, const char *text, hash_t text_hash, Alignment align) {
+	if(layout->text == NULL || strcmp(layout->text, text)) {
+		free(layout->text);
+		layout->text = strdup(text);
+	}
+
+	layout->font = font;
+	layout->epoch = font->layout_epoch;
+	layout->text_hash = text_hash;
+	layout->align = align;
+	layout->num_glyphs = 0;
+
+	text_bbox(font, text, 0, &layout->bbox);
+
+	double x = 0, y = 0;
+	adjust_xpos(font, text, align, 0, &x);
+	layout->line0_x = x;
+
+	bool keming = FT_HAS_KERNING(font->face);
+	uint prev_glyph_idx = 0;
+	const char *tptr = text;
+
+	while(*tptr) {
+		uint32_t uchar = utf8_getch(&tptr);
+
+		if(uchar == '\n') {
+			adjust_xpos(font, tptr, align, 0, &x);
+			y += font->metrics.lineskip;
+			continue;
+		}
+
+		Glyph *glyph = get_glyph(font, uchar);
+
+		if(glyph == NULL) {
+			continue;
+		}
+
+		if(keming && prev_glyph_idx) {
+			x += apply_kerning(font, prev_glyph_idx, glyph);
+		}
+
+		if(glyph->sprite.tex != NULL) {
+			text_layout_add_glyph(layout, uchar, glyph - font->glyphs,
+				x + glyph->metrics.bearing_x + glyph->sprite.w * 0.5,
+				y - glyph->metrics.bearing_y + glyph->sprite.h * 0.5 - font->metrics.descent
+			);
+		}
+
+		x += glyph->metrics.advance;
+		prev_glyph_idx = glyph->ft_index;
+	}
+
+	layout->end_x = x;
+}
+
+static TextLayout* text_layout_cached(Font *font, const char *text, Alignment align) {
+	hash_t text_hash = htutil_hashfunc_string(0, text);
+	TextLayout *lru = globals.layout_cache.entries;
+	uint64_t now = ++globals.layout_cache.clock;
+
+	for(int i = 0; i < TEXT_LAYOUT_CACHE_SIZE; ++i) {
+		TextLayout *layout = globals.layout_cache.entries + i;
+
+		if(text_layout_matches(layout, font, text, text_hash, align)) {
+			layout->last_used = now;
+			return layout;
+		}
+
+		if(layout->last_used < lru->last_used) {
+			lru = layout;
+		}
+	}
+
+	text_layout_build(lru, font, text, text_hash, align);
+	lru->last_used = now;
+	return lru;
+}
+
 attr_nonnull(1, 2, 3)
-static double _text_draw(Font *font, const char *text, const TextParams *params) {
+static double text_layout_draw_internal(TextLayout *layout, Font *font, const TextParams *params) {
 	SpriteParams sp = { .sprite = NULL };
-	BBox bbox;
-	double x = params->pos.x;
-	double y = params->pos.y;
+	const BBox *bbox = &layout->bbox;
 	double iscale = 1 / font->metrics.scale;
 
-	text_bbox(font, text, 0, &bbox);
 	sp.shader_ptr = params->shader_ptr;
 
 	if(sp.shader_ptr == NULL) {
@@ -840,20 +997,16 @@ static double _text_draw(Font *font, const char *text, const TextParams *params)
 	MatrixMode mm_prev = r_mat_mode_current();
 	r_mat_mode(MM_MODELVIEW);
 	r_mat_push();
-	r_mat_translate(x, y, 0);
+	r_mat_translate(params->pos.x, params->pos.y, 0);
 	r_mat_scale(iscale, iscale, 1);
-	x = y = 0;
 
-	double x_orig = x;
-	adjust_xpos(font, text, params->align, x_orig, &x);
-
-	double bbox_w = bbox.x.max - bbox.x.min;
-	double bbox_h = bbox.y.max - bbox.y.min;
+	double bbox_w = bbox->x.max - bbox->x.min;
+	double bbox_h = bbox->y.max - bbox->y.min;
 
 	#ifdef TEXT_DRAW_BBOX
 	// TODO: align this correctly in the multi-line case
-	double bbox_x_mid = x + bbox.x.min + bbox_w * 0.5;
-	double bbox_y_mid = y + bbox.y.min - font->metrics.descent + bbox_h * 0.5;
+	double bbox_x_mid = layout->line0_x + bbox->x.min + bbox_w * 0.5;
+	double bbox_y_mid = bbox->y.min - font->metrics.descent + bbox_h * 0.5;
 
 	r_state_push();
 	r_shader_standard_notex();
@@ -870,7 +1023,7 @@ static double _text_draw(Font *font, const char *text, const TextParams *params)
 	r_mat_push();
 	r_mat_translate(0, 0.0, 0);
 	r_mat_scale(1/bbox_w, 1/bbox_h, 1.0);
-	r_mat_translate(-bbox.x.min - (x - x_orig), -bbox.y.min + font->metrics.descent, 0);
+	r_mat_translate(-bbox->x.min - layout->line0_x, -bbox->y.min + font->metrics.descent, 0);
 
 	// FIXME: is there a better way?
 	float texmat_offset_sign;
@@ -881,62 +1034,38 @@ static double _text_draw(Font *font, const char *text, const TextParams *params)
 		texmat_offset_sign = 1;
 	}
 
-	bool keming = FT_HAS_KERNING(font->face);
-	uint prev_glyph_idx = 0;
-	const char *tptr = text;
-
-	while(*tptr) {
-		uint32_t uchar = utf8_getch(&tptr);
-
-		if(uchar == '\n') {
-			adjust_xpos(font, tptr, params->align, x_orig, &x);
-			y += font->metrics.lineskip;
-			continue;
-		}
-
-		Glyph *glyph = get_glyph(font, uchar);
-
-		if(glyph == NULL) {
-			continue;
-		}
-
-		if(keming && prev_glyph_idx) {
-			x += apply_kerning(font, prev_glyph_idx, glyph);
+	for(uint i = 0; i < layout->num_glyphs; ++i) {
+		TextLayoutGlyph *lg = layout->glyphs + i;
+		Glyph *glyph = font->glyphs + lg->glyph_ofs;
+
+		sp.sprite_ptr = &glyph->sprite;
+		sp.pos.x = lg->x;
+		sp.pos.y = lg->y;
+
+		// HACK/FIXME: Glyphs have their sprite w/h unadjusted for scale.
+		// We have to temporarily fix that up here so that the shader gets resolution-independent dimensions.
+		float w_saved = sp.sprite_ptr->w;
+		float h_saved = sp.sprite_ptr->h;
+		sp.sprite_ptr->w /= font->metrics.scale;
+		sp.sprite_ptr->h /= font->metrics.scale;
+		sp.scale.both = font->metrics.scale;
+
+		r_mat_push();
+		r_mat_translate(sp.pos.x, sp.pos.y * texmat_offset_sign, 0);
+		r_mat_scale(w_saved, h_saved, 1.0);
+		r_mat_translate(-0.5, -0.5, 0);
+
+		if(params->glyph_callback.func != NULL) {
+			params->glyph_callback.func(font, lg->charcode, &sp, params->glyph_callback.userdata);
 		}
 
-		if(glyph->sprite.tex != NULL) {
-			sp.sprite_ptr = &glyph->sprite;
-			sp.pos.x = x + glyph->metrics.bearing_x + glyph->sprite.w * 0.5;
-			sp.pos.y = y - glyph->metrics.bearing_y + glyph->sprite.h * 0.5 - font->metrics.descent;
-
-			// HACK/FIXME: Glyphs have their sprite w/h unadjusted for scale.
-			// We have to temporarily fix that up here so that the shader gets resolution-independent dimensions.
-			float w_saved = sp.sprite_ptr->w;
-			float h_saved = sp.sprite_ptr->h;
-			sp.sprite_ptr->w /= font->metrics.scale;
-			sp.sprite_ptr->h /= font->metrics.scale;
-			sp.scale.both = font->metrics.scale;
-
-			r_mat_push();
-			r_mat_translate(sp.pos.x - x_orig, sp.pos.y * texmat_offset_sign, 0);
-			r_mat_scale(w_saved, h_saved, 1.0);
-			r_mat_translate(-0.5, -0.5, 0);
-
-			if(params->glyph_callback.func != NULL) {
-				params->glyph_callback.func(font, uchar, &sp, params->glyph_callback.userdata);
-			}
-
-			r_draw_sprite(&sp);
+		r_draw_sprite(&sp);
 
-			// HACK/FIXME: See above.
-			sp.sprite_ptr->w = w_saved;
-			sp.sprite_ptr->h = h_saved;
+		// HACK/FIXME: See above.
+		sp.sprite_ptr->w = w_saved;
+		sp.sprite_ptr->h = h_saved;
 
-			r_mat_pop();
-		}
-
-		x += glyph->metrics.advance;
-		prev_glyph_idx = glyph->ft_index;
+		r_mat_pop();
 	}
 
 	r_mat_pop();
@@ -944,18 +1073,46 @@ static double _text_draw(Font *font, const char *text, const TextParams *params)
 	r_mat_pop();
 	r_mat_mode(mm_prev);
 
-	return x_orig + (x - x_orig) / font->metrics.scale;
+	return layout->end_x / font->metrics.scale;
+}
+
+TextLayout* text_layout_new(void) {
+	return calloc(1, sizeof(TextLayout));
+}
+
+void text_layout_free(TextLayout *layout) {
+	if(layout) {
+		text_layout_clear(layout);
+		free(layout);
+	}
+}
+
+double text_layout_draw(TextLayout *layout, const char *text, const TextParams *params) {
+	Font *font = font_from_params(params);
+
+	if(
+		layout->text == NULL ||
+		layout->font != font ||
+		layout->epoch != font->layout_epoch ||
+		layout->align != params->align ||
+		strcmp(layout->text, text)
+	) {
+		text_layout_build(layout, font, text, htutil_hashfunc_string(0, text), params->align);
+	}
+
+	return text_layout_draw_internal(layout, font, params);
 }
 
 double text_draw(const char *text, const TextParams *params) {
-	return _text_draw(font_from_params(params), text, params);
+	Font *font = font_from_params(params);
+	return text_layout_draw_internal(text_layout_cached(font, text, params->align), font, params);
 }
 
 double text_draw_wrapped(const char *text, double max_width, const TextParams *params) {
 	Font *font = font_from_params(params);
 	char buf[strlen(text) * 2 + 1];
 	text_wrap(font, text, max_width, buf, sizeof(buf));
-	return _text_draw(font, buf, params);
+	return text_layout_draw_internal(text_layout_cached(font, buf, params->align), font, params);
 }
 
 void text_render(const char *text, Font *font, Sprite *out_sprite, BBox *out_bbox) {
@@ -22,6 +22,7 @@ typedef enum {
 
 typedef ulong charcode_t;
 typedef struct Font Font;
+typedef struct TextLayout TextLayout;
 
 typedef struct FontMetrics {
 	int ascent;
@@ -92,6 +93,16 @@ double text_draw(const char *text, const TextParams *params)
 double text_draw_wrapped(const char *text, double max_width, const TextParams *params)
 	attr_nonnull(1, 3);
 
+// A text layout caches the shaped glyphs of a string, and only redoes the work when the
+// text, font or alignment changes. text_draw keeps a small cache of these internally.
+TextLayout* text_layout_new(void)
+	attr_returns_nonnull;
+
+void text_layout_free(TextLayout *layout);
+
+double text_layout_draw(TextLayout *layout, const char *text, const TextParams *params)
+	attr_nonnull(1, 2, 3);
+
 void text_render(const char *text, Font *font, Sprite *out_sprite, BBox *out_bbox)
 	attr_nonnull(1, 2, 3, 4);
 
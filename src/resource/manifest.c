@@ -0,0 +1,342 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include "manifest.h"
+#include "util.h"
+#include "vfs/public.h"
+
+#define MANIFEST_MAGIC "TAIKVM\0"
+#define MANIFEST_VERSION 1
+
+// sanity limit; the real thing is a few dozen KiB
+#define MANIFEST_MAX_SIZE (16 * 1024 * 1024)
+
+typedef struct ManifestHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t num_entries;
+	uint32_t num_pairs;
+	uint32_t strings_size;
+} ManifestHeader;
+
+typedef struct ManifestEntry {
+	uint32_t path;
+	uint32_t first_pair;
+	uint32_t num_pairs;
+} ManifestEntry;
+
+typedef struct ManifestPair {
+	uint32_t key;
+	uint32_t value;
+} ManifestPair;
+
+static struct {
+	void *data;
+	ManifestEntry *entries;
+	ManifestPair *pairs;
+	const char *strings;
+	uint32_t num_entries;
+	uint32_t num_pairs;
+	uint32_t strings_size;
+	bool *usable;
+	char *origin;
+	size_t origin_len;
+} manifest;
+
+static void swap_words(uint32_t *words, size_t num) {
+	for(size_t i = 0; i < num; ++i) {
+		words[i] = SDL_SwapLE32(words[i]);
+	}
+}
+
+static bool validate(void) {
+	if(manifest.strings_size == 0 || manifest.strings[manifest.strings_size - 1]) {
+		return false;
+	}
+
+	for(uint32_t i = 0; i < manifest.num_pairs; ++i) {
+		ManifestPair *p = manifest.pairs + i;
+
+		if(p->key >= manifest.strings_size || p->value >= manifest.strings_size) {
+			return false;
+		}
+	}
+
+	for(uint32_t i = 0; i < manifest.num_entries; ++i) {
+		ManifestEntry *e = manifest.entries + i;
+
+		if(
+			e->path >= manifest.strings_size ||
+			e->first_pair > manifest.num_pairs ||
+			e->num_pairs > manifest.num_pairs - e->first_pair
+		) {
+			return false;
+		}
+
+		if(i > 0 && strcmp(manifest.strings + e[-1].path, manifest.strings + e->path) >= 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Syspaths are only compared against each other, so the separator style doesn't matter.
+static void normalize_separators(char *p) {
+	for(; *p; ++p) {
+		if(*p == '\\') {
+			*p = '/';
+		}
+	}
+}
+
+// The directory or package the manifest was installed into, as a syspath prefix.
+static char* find_origin(void) {
+	char *syspath = vfs_repr(RES_MANIFEST_PATH, true);
+	const char *name = RES_MANIFEST_PATH + strlen("res/");
+
+	if(!syspath) {
+		return NULL;
+	}
+
+	normalize_separators(syspath);
+
+	if(!strendswith(syspath, name)) {
+		// not backed by anything on disk, so there's nothing to compare resources against
+		free(syspath);
+		return NULL;
+	}
+
+	syspath[strlen(syspath) - strlen(name)] = 0;
+	return syspath;
+}
+
+// Whether path resolves to origin + path minus the "res/" prefix.
+static bool comes_from_origin(const char *path) {
+	char *syspath = vfs_repr(path, true);
+
+	if(!syspath) {
+		return false;
+	}
+
+	normalize_separators(syspath);
+
+	// directories in zip packages are named with a trailing slash
+	for(char *p = strchr(syspath, 0); p > syspath && p[-1] == '/';) {
+		*--p = 0;
+	}
+
+	const char *relpath = path + strlen("res/");
+	bool same_origin =
+		!strncmp(syspath, manifest.origin, manifest.origin_len) &&
+		!strcmp(syspath + manifest.origin_len, relpath);
+
+	if(!same_origin) {
+		log_debug("%s is overridden by %s, ignoring the manifest", path, syspath);
+	}
+
+	free(syspath);
+	return same_origin;
+}
+
+enum {
+	DIR_OTHER,
+	DIR_ORIGIN,
+	DIR_MERGED,
+};
+
+/*
+ * An entry is only used if its file would come from the same directory or package as the
+ * manifest itself, so that anything dropped into storage/resources or a later package still
+ * overrides the build-time copy. This is decided once for every directory: usually a directory
+ * has a single source, and then all of its files come from there. Only the files in directories
+ * merged from several sources are resolved one by one.
+ */
+static uint32_t check_origins(void) {
+	ht_str2int_t dirs;
+	ht_create(&dirs);
+
+	uint32_t num_usable = 0;
+	manifest.usable = calloc(manifest.num_entries, sizeof(*manifest.usable));
+
+	for(uint32_t i = 0; i < manifest.num_entries; ++i) {
+		const char *path = manifest.strings + manifest.entries[i].path;
+
+		if(!strstartswith(path, "res/")) {
+			continue;
+		}
+
+		char dir[strlen(path) + 1];
+		strcpy(dir, path);
+		*strrchr(dir, '/') = 0;
+
+		int64_t verdict = ht_get(&dirs, dir, -1);
+
+		if(verdict < 0) {
+			if(vfs_dir_is_merged(dir)) {
+				verdict = DIR_MERGED;
+			} else {
+				verdict = comes_from_origin(dir) ? DIR_ORIGIN : DIR_OTHER;
+			}
+
+			ht_set(&dirs, dir, verdict);
+		}
+
+		manifest.usable[i] = verdict == DIR_ORIGIN || (verdict == DIR_MERGED && comes_from_origin(path));
+		num_usable += manifest.usable[i];
+	}
+
+	ht_destroy(&dirs);
+	return num_usable;
+}
+
+static bool load(SDL_RWops *rw) {
+	int64_t size = SDL_RWsize(rw);
+
+	if(size < (int64_t)sizeof(ManifestHeader) || size > MANIFEST_MAX_SIZE) {
+		return false;
+	}
+
+	manifest.data = malloc(size);
+
+	if(SDL_RWread(rw, manifest.data, size, 1) != 1) {
+		return false;
+	}
+
+	ManifestHeader *hdr = manifest.data;
+	swap_words(&hdr->version, 4);
+
+	if(memcmp(hdr->magic, MANIFEST_MAGIC, sizeof(hdr->magic)) || hdr->version != MANIFEST_VERSION) {
+		return false;
+	}
+
+	uint64_t entries_size = (uint64_t)hdr->num_entries * sizeof(ManifestEntry);
+	uint64_t pairs_size = (uint64_t)hdr->num_pairs * sizeof(ManifestPair);
+
+	if(sizeof(*hdr) + entries_size + pairs_size + hdr->strings_size != (uint64_t)size) {
+		return false;
+	}
+
+	manifest.entries = (ManifestEntry*)(hdr + 1);
+	manifest.pairs = (ManifestPair*)(manifest.entries + hdr->num_entries);
+	manifest.strings = (const char*)(manifest.pairs + hdr->num_pairs);
+	manifest.num_entries = hdr->num_entries;
+	manifest.num_pairs = hdr->num_pairs;
+	manifest.strings_size = hdr->strings_size;
+
+	swap_words((uint32_t*)manifest.entries, entries_size / sizeof(uint32_t));
+	swap_words((uint32_t*)manifest.pairs, pairs_size / sizeof(uint32_t));
+
+	return validate();
+}
+
+void res_manifest_init(void) {
+	if(!env_get("TAISEI_RES_MANIFEST", true)) {
+		log_info("Resource manifest disabled by TAISEI_RES_MANIFEST");
+		return;
+	}
+
+	SDL_RWops *rw = vfs_open(RES_MANIFEST_PATH, VFS_MODE_READ);
+
+	if(!rw) {
+		log_debug("No resource manifest, using loose files: %s", vfs_get_error());
+		return;
+	}
+
+	bool ok = load(rw);
+	SDL_RWclose(rw);
+
+	if(!ok) {
+		log_warn("Resource manifest %s is corrupt or outdated, using loose files", RES_MANIFEST_PATH);
+		res_manifest_shutdown();
+		return;
+	}
+
+	if(!(manifest.origin = find_origin())) {
+		log_warn("Couldn't tell where resource manifest %s comes from, using loose files", RES_MANIFEST_PATH);
+		res_manifest_shutdown();
+		return;
+	}
+
+	manifest.origin_len = strlen(manifest.origin);
+	uint32_t num_usable = check_origins();
+
+	log_info("Resource manifest loaded: %u files, %u overridden", num_usable, manifest.num_entries - num_usable);
+}
+
+void res_manifest_shutdown(void) {
+	free(manifest.data);
+	free(manifest.usable);
+	free(manifest.origin);
+	memset(&manifest, 0, sizeof(manifest));
+}
+
+static ManifestEntry* find_entry(const char *path) {
+	uint32_t lo = 0, hi = manifest.num_entries;
+
+	while(lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		int cmp = strcmp(path, manifest.strings + manifest.entries[mid].path);
+
+		if(cmp == 0) {
+			return manifest.entries + mid;
+		}
+
+		if(cmp < 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	return NULL;
+}
+
+static ManifestEntry* find_usable_entry(const char *path) {
+	ManifestEntry *e = find_entry(path);
+
+	if(e && manifest.usable[e - manifest.entries]) {
+		return e;
+	}
+
+	return NULL;
+}
+
+static void get_pairs(ManifestEntry *e, const char *pairs[]) {
+	for(uint32_t i = 0; i < e->num_pairs; ++i) {
+		ManifestPair *p = manifest.pairs + e->first_pair + i;
+		pairs[i * 2] = manifest.strings + p->key;
+		pairs[i * 2 + 1] = manifest.strings + p->value;
+	}
+}
+
+bool parse_keyvalue_resource_cb(const char *path, KVCallback callback, void *data) {
+	ManifestEntry *e = find_usable_entry(path);
+
+	if(!e) {
+		return parse_keyvalue_file_cb(path, callback, data);
+	}
+
+	const char *pairs[e->num_pairs * 2 + 1];
+	get_pairs(e, pairs);
+	return parse_keyvalue_pairs_cb(e->num_pairs, pairs, callback, data);
+}
+
+bool parse_keyvalue_resource_with_spec(const char *path, KVSpec *spec) {
+	ManifestEntry *e = find_usable_entry(path);
+
+	if(!e) {
+		return parse_keyvalue_file_with_spec(path, spec);
+	}
+
+	const char *pairs[e->num_pairs * 2 + 1];
+	get_pairs(e, pairs);
+	return parse_keyvalue_pairs_with_spec(e->num_pairs, pairs, spec);
+}
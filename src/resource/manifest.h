@@ -0,0 +1,42 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include "util/kvparser.h"
+
+/*
+ * The resource manifest holds the contents of all the small key-value definition files
+ * (.spr, .tex, .ani, .bgm), already split into pairs. It's generated at build time by
+ * scripts/gen-res-manifest.py and shipped in the same place as the files it describes: inside
+ * the data package when there is one, otherwise next to the resource directories.
+ *
+ * Layout, all integers little-endian uint32:
+ *
+ *     char magic[8];              "TAIKVM\0\0"
+ *     version, num_entries, num_pairs, strings_size;
+ *     entries[num_entries];       { path, first_pair, num_pairs }, sorted by path
+ *     pairs[num_pairs];           { key, value }
+ *     char strings[strings_size]; null-terminated; the fields above are offsets into this
+ *
+ * Entries are keyed by VFS path. When the manifest is loaded, every entry is checked to come
+ * from the same directory or package as the manifest itself; anything else (files that aren't
+ * in it, overrides in storage/resources or later packages) is read from the VFS as usual.
+ * Setting TAISEI_RES_MANIFEST=0 ignores the manifest entirely, so that edited files next to
+ * it take effect.
+ */
+
+#define RES_MANIFEST_PATH "res/kvmanifest.bin"
+
+void res_manifest_init(void);
+void res_manifest_shutdown(void);
+
+// Like parse_keyvalue_file_*, but served from the manifest if possible.
+bool parse_keyvalue_resource_cb(const char *path, KVCallback callback, void *data) attr_nonnull(1, 2);
+bool parse_keyvalue_resource_with_spec(const char *path, KVSpec *spec) attr_nonnull(1, 2);
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include "model.h"
+#include "model_cache.h"
 #include "list.h"
 #include "resource.h"
 #include "renderer/api.h"
@@ -31,7 +32,7 @@ ResourceHandler model_res_handler = {
 	},
 };
 
-static void parse_obj(const char *filename, ObjFileData *data);
+static void parse_obj(const char *filename, SDL_RWops *rw, ObjFileData *data);
 static void free_obj(ObjFileData *data);
 
 char* model_path(const char *name) {
@@ -42,107 +43,86 @@ bool check_model_path(const char *path) {
 	return strendswith(path, MDL_EXTENSION);
 }
 
-typedef struct ModelLoadData {
-	ObjFileData *obj;
-	GenericModelVertex *verts;
-	Model *model;
-} ModelLoadData;
-
 void* load_model_begin(const char *path, uint flags) {
-	Model *m = malloc(sizeof(Model));
-	ObjFileData *data = malloc(sizeof(ObjFileData));
-	GenericModelVertex *verts;
-
-	parse_obj(path, data);
-
-	m->fverts = data->fverts;
-	m->indices = calloc(data->icount, sizeof(uint));
-	m->icount = data->icount;
-
-	verts = calloc(data->icount, sizeof(GenericModelVertex));
-
-#define BADREF(filename,aux,n) { \
-	log_warn("OBJ file '%s': Index %d: bad %s index reference\n", filename, n, aux); \
-	goto fail; \
-}
+	int source_size;
+	char *source = read_all(path, &source_size);
 
-	memset(verts, 0, data->icount*sizeof(GenericModelVertex));
-
-	for(uint i = 0; i < data->icount; i++) {
-		int xi, ni, ti;
+	if(!source) {
+		return NULL;
+	}
 
-		xi = data->indices[i][0]-1;
-		if(xi < 0 || xi >= data->xcount)
-			BADREF(path, "vertex", i);
+	bool use_cache = env_get("TAISEI_MODEL_CACHE", true);
+	uint64_t source_hash = memhash64(source, source_size);
+	CookedMesh mesh;
 
-		memcpy(verts[i].position, data->xs[xi], sizeof(vec3_noalign));
+	if(!use_cache || !model_cache_load(path, source_hash, &mesh)) {
+		ObjFileData data;
+		SDL_RWops *rw = SDL_RWFromConstMem(source, source_size);
+		parse_obj(path, rw, &data);
+		SDL_RWclose(rw);
 
-		if(data->tcount) {
-			ti = data->indices[i][1]-1;
-			if(ti < 0 || ti >= data->tcount)
-				BADREF(path, "texcoord", i);
+		bool ok = model_cache_cook(path, &data, &mesh);
+		free_obj(&data);
 
-			verts[i].uv.s = data->texcoords[ti][0];
-			verts[i].uv.t = data->texcoords[ti][1];
+		if(!ok) {
+			free(source);
+			return NULL;
 		}
 
-		if(data->ncount) {
-			ni = data->indices[i][2]-1;
-			if(ni < 0 || ni >= data->ncount)
-				BADREF(path, "normal", ni);
-
-			memcpy(verts[i].normal, data->normals[ni], sizeof(vec3_noalign));
+		if(use_cache) {
+			model_cache_store(path, source_hash, &mesh);
 		}
-
-		m->indices[i] = i;
 	}
 
-#undef BADREF
-
-	ModelLoadData *ldata = malloc(sizeof(ModelLoadData));
-	ldata->obj = data;
-	ldata->verts = verts;
-	ldata->model = m;
-
-	return ldata;
-
-fail:
-	free(m->indices);
-	free(m);
-	free(verts);
-	free_obj(data);
-	free(data);
-	return NULL;
+	free(source);
+	return memdup(&mesh, sizeof(mesh));
 }
 
 void* load_model_end(void *opaque, const char *path, uint flags) {
-	VertexBuffer *vbuf= r_vertex_buffer_static_models();
-	ModelLoadData *ldata = opaque;
+	CookedMesh *mesh = opaque;
 
-	if(!ldata) {
+	if(!mesh) {
 		return NULL;
 	}
 
-	size_t ioffset = r_vertex_buffer_get_cursor(vbuf);
+	uint first_vertex;
 
-	for(int i = 0; i < ldata->obj->icount; ++i) {
-		ldata->model->indices[i] += ioffset / sizeof(GenericModelVertex);
+	if(!r_static_models_alloc(mesh->num_vertices, &first_vertex)) {
+		log_warn("%s: No space left in the static models buffer for %u vertices", path, mesh->num_vertices);
+		cooked_mesh_free(mesh);
+		free(mesh);
+		return NULL;
 	}
 
-	r_vertex_buffer_append(vbuf, sizeof(GenericModelVertex) * ldata->obj->icount, ldata->verts);
+	r_vertex_buffer_write(
+		r_vertex_buffer_static_models(),
+		first_vertex * sizeof(GenericModelVertex),
+		mesh->num_vertices * sizeof(GenericModelVertex),
+		mesh->vertices
+	);
+
+	Model *m = malloc(sizeof(Model));
+	m->icount = mesh->num_indices;
+	m->fverts = 3;
+	m->first_vertex = first_vertex;
+	m->num_vertices = mesh->num_vertices;
+	m->indices = malloc(m->icount * sizeof(*m->indices));
+
+	for(int i = 0; i < m->icount; ++i) {
+		m->indices[i] = first_vertex + mesh->indices[i];
+	}
 
-	free(ldata->verts);
-	free_obj(ldata->obj);
-	free(ldata->obj);
-	Model *m = ldata->model;
-	free(ldata);
+	cooked_mesh_free(mesh);
+	free(mesh);
 
 	return m;
 }
 
-void unload_model(void *model) { // Does not delete elements from the VBO, so doing this at runtime is leaking VBO space
-	free(((Model*)model)->indices);
-	free(model);
+void unload_model(void *model) {
+	Model *m = model;
+	r_static_models_free(m->first_vertex, m->num_vertices);
+	free(m->indices);
+	free(m);
 }
 
 static void free_obj(ObjFileData *data) {
@@ -152,14 +132,7 @@ static void free_obj(ObjFileData *data) {
 	free(data->indices);
 }
 
-static void parse_obj(const char *filename, ObjFileData *data) {
-	SDL_RWops *rw = vfs_open(filename, VFS_MODE_READ);
-
-	if(!rw) {
-		log_warn("VFS error: %s", vfs_get_error());
-		return;
-	}
-
+static void parse_obj(const char *filename, SDL_RWops *rw, ObjFileData *data) {
 	char line[256], *save;
 	vec3_noalign buf;
 	char mode;
@@ -250,8 +223,6 @@ static void parse_obj(const char *filename, ObjFileData *data) {
 				log_fatal("OBJ file '%s:%d': Parsing error: face vertex count must be 3", filename, linen);
 		}
 	}
-
-	SDL_RWclose(rw);
 }
 
 Model* get_model(const char *name) {
@@ -32,13 +32,15 @@ typedef struct Model {
 	uint *indices;
 	int icount;
 	int fverts;
+	uint first_vertex;
+	uint num_vertices;
 } Model;
 
 char* model_path(const char *name);
 bool check_model_path(const char *path);
 void* load_model_begin(const char *path, uint flags);
 void* load_model_end(void *opaque, const char *path, uint flags);
-void unload_model(void*); // Does not delete elements from the VBO, so doing this at runtime is leaking VBO space
+void unload_model(void*);
 
 Model* get_model(const char *name);
 
@@ -0,0 +1,371 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include "model_cache.h"
+#include "util.h"
+#include "hashtable.h"
+#include "util/cachefile.h"
+
+static const CacheFileFormat mdlcache_format = {
+	.subdir = "models",
+	.extension = ".mdlcache",
+	.magic = "TAIMDLC",
+	.version = 2,
+};
+
+// size of the simulated LRU cache used for triangle reordering
+#define VCACHE_SIZE 32
+
+// OBJ indices are packed into a 64-bit hashtable key, 21 bits each
+#define OBJ_MAX_INDEX ((1 << 21) - 1)
+
+// follows the CacheFileHeader, whose key is the source file hash
+typedef struct ModelCacheHeader {
+	uint32_t num_vertices;
+	uint32_t num_indices;
+} ModelCacheHeader;
+
+static_assert((sizeof(CacheFileHeader) + sizeof(ModelCacheHeader)) % alignof(GenericModelVertex) == 0, "Model cache header breaks vertex alignment");
+
+static void cooked_mesh_alloc(CookedMesh *mesh, uint32_t num_vertices, uint32_t num_indices) {
+	mesh->num_vertices = num_vertices;
+	mesh->num_indices = num_indices;
+	mesh->data = malloc(num_vertices * sizeof(*mesh->vertices) + num_indices * sizeof(*mesh->indices));
+	mesh->vertices = mesh->data;
+	mesh->indices = (uint32_t*)(mesh->vertices + num_vertices);
+}
+
+static size_t cooked_mesh_data_size(const CookedMesh *mesh) {
+	return mesh->num_vertices * sizeof(*mesh->vertices) + mesh->num_indices * sizeof(*mesh->indices);
+}
+
+/*
+ * Vertex cache optimization, after Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+ * Vertices are scored by their position in a simulated LRU cache and by how many triangles
+ * still use them; the next triangle is always the best-scoring one among those touching
+ * a cached vertex. Our meshes are a few thousand triangles at most, so this doesn't bother
+ * with the incremental bookkeeping a general-purpose implementation would need.
+ */
+
+static float vcache_score(int cache_pos, uint remaining_tris) {
+	if(remaining_tris == 0) {
+		return -1;
+	}
+
+	float score = 0;
+
+	if(cache_pos >= 0) {
+		if(cache_pos < 3) {
+			// the triangle just emitted; don't reward reusing it twice in a row too much
+			score = 0.75f;
+		} else {
+			score = powf(1.0f - (cache_pos - 3) / (float)(VCACHE_SIZE - 3), 1.5f);
+		}
+	}
+
+	// prefer finishing off vertices with few triangles left
+	return score + 2.0f * powf(remaining_tris, -0.5f);
+}
+
+static void optimize_vertex_cache(uint32_t *indices, uint num_indices, uint num_vertices) {
+	uint num_tris = num_indices / 3;
+	uint *remaining = calloc(num_vertices, sizeof(*remaining));
+	uint *adj_offsets = calloc(num_vertices + 1, sizeof(*adj_offsets));
+	uint *adj_fill = calloc(num_vertices, sizeof(*adj_fill));
+	uint *adj = malloc(num_indices * sizeof(*adj));
+	int *cache_pos = malloc(num_vertices * sizeof(*cache_pos));
+	float *vscore = malloc(num_vertices * sizeof(*vscore));
+	float *tscore = malloc(num_tris * sizeof(*tscore));
+	bool *emitted = calloc(num_tris, sizeof(*emitted));
+	uint32_t *out = malloc(num_indices * sizeof(*out));
+
+	for(uint i = 0; i < num_indices; ++i) {
+		++remaining[indices[i]];
+	}
+
+	for(uint v = 0; v < num_vertices; ++v) {
+		adj_offsets[v + 1] = adj_offsets[v] + remaining[v];
+		cache_pos[v] = -1;
+		vscore[v] = vcache_score(-1, remaining[v]);
+	}
+
+	for(uint i = 0; i < num_indices; ++i) {
+		uint v = indices[i];
+		adj[adj_offsets[v] + adj_fill[v]++] = i / 3;
+	}
+
+	for(uint t = 0; t < num_tris; ++t) {
+		tscore[t] = vscore[indices[t * 3]] + vscore[indices[t * 3 + 1]] + vscore[indices[t * 3 + 2]];
+	}
+
+	uint32_t cache[VCACHE_SIZE + 3];
+	uint cache_size = 0;
+
+	for(uint n = 0; n < num_tris; ++n) {
+		int best = -1;
+		float best_score = -INFINITY;
+
+		for(uint c = 0; c < cache_size; ++c) {
+			uint v = cache[c];
+
+			for(uint a = adj_offsets[v]; a < adj_offsets[v + 1]; ++a) {
+				uint t = adj[a];
+
+				if(!emitted[t] && tscore[t] > best_score) {
+					best = t;
+					best_score = tscore[t];
+				}
+			}
+		}
+
+		if(best < 0) {
+			// nothing in the cache connects to the rest of the mesh, start over elsewhere
+			for(uint t = 0; t < num_tris; ++t) {
+				if(!emitted[t] && tscore[t] > best_score) {
+					best = t;
+					best_score = tscore[t];
+				}
+			}
+		}
+
+		assert(best >= 0);
+		emitted[best] = true;
+
+		uint32_t new_cache[VCACHE_SIZE + 3];
+		uint new_cache_size = 0;
+
+		for(uint k = 0; k < 3; ++k) {
+			uint32_t v = indices[best * 3 + k];
+			out[n * 3 + k] = v;
+			--remaining[v];
+			new_cache[new_cache_size++] = v;
+		}
+
+		for(uint c = 0; c < cache_size; ++c) {
+			uint32_t v = cache[c];
+
+			if(v != new_cache[0] && v != new_cache[1] && v != new_cache[2]) {
+				new_cache[new_cache_size++] = v;
+			}
+		}
+
+		// rescore everything that moved, including the vertices that just fell out
+		for(uint c = 0; c < new_cache_size; ++c) {
+			uint32_t v = new_cache[c];
+			cache_pos[v] = c < VCACHE_SIZE ? (int)c : -1;
+			vscore[v] = vcache_score(cache_pos[v], remaining[v]);
+		}
+
+		for(uint c = 0; c < new_cache_size; ++c) {
+			uint32_t v = new_cache[c];
+
+			for(uint a = adj_offsets[v]; a < adj_offsets[v + 1]; ++a) {
+				uint t = adj[a];
+
+				if(!emitted[t]) {
+					tscore[t] = vscore[indices[t * 3]] + vscore[indices[t * 3 + 1]] + vscore[indices[t * 3 + 2]];
+				}
+			}
+		}
+
+		cache_size = imin(new_cache_size, VCACHE_SIZE);
+		memcpy(cache, new_cache, cache_size * sizeof(*cache));
+	}
+
+	memcpy(indices, out, num_indices * sizeof(*indices));
+
+	free(remaining);
+	free(adj_offsets);
+	free(adj_fill);
+	free(adj);
+	free(cache_pos);
+	free(vscore);
+	free(tscore);
+	free(emitted);
+	free(out);
+}
+
+static void reorder_vertices(CookedMesh *mesh) {
+	uint32_t *remap = malloc(mesh->num_vertices * sizeof(*remap));
+	GenericModelVertex *verts = malloc(mesh->num_vertices * sizeof(*verts));
+	uint32_t next = 0;
+
+	memset(remap, 0xff, mesh->num_vertices * sizeof(*remap));
+
+	for(uint i = 0; i < mesh->num_indices; ++i) {
+		uint32_t v = mesh->indices[i];
+
+		if(remap[v] == UINT32_MAX) {
+			remap[v] = next;
+			verts[next++] = mesh->vertices[v];
+		}
+
+		mesh->indices[i] = remap[v];
+	}
+
+	assert(next == mesh->num_vertices);
+	memcpy(mesh->vertices, verts, mesh->num_vertices * sizeof(*verts));
+
+	free(verts);
+	free(remap);
+}
+
+static bool obj_index(const char *res_path, const char *what, int ref, int count, uint i, int *out) {
+	// OBJ references are 1-based
+	if(ref < 1 || ref > count) {
+		log_warn("OBJ file '%s': Index %u: bad %s index reference", res_path, i, what);
+		return false;
+	}
+
+	*out = ref;
+	return true;
+}
+
+bool model_cache_cook(const char *res_path, ObjFileData *obj, CookedMesh *out) {
+	if(obj->icount == 0 || obj->icount % 3) {
+		log_warn("OBJ file '%s': No triangles", res_path);
+		return false;
+	}
+
+	if(obj->xcount > OBJ_MAX_INDEX || obj->tcount > OBJ_MAX_INDEX || obj->ncount > OBJ_MAX_INDEX) {
+		log_warn("OBJ file '%s': Too many vertex attributes", res_path);
+		return false;
+	}
+
+	GenericModelVertex *verts = calloc(obj->icount, sizeof(*verts));
+	uint32_t *indices = malloc(obj->icount * sizeof(*indices));
+	uint32_t num_verts = 0;
+	bool ok = true;
+
+	ht_int2int_t vertmap;
+	ht_create(&vertmap);
+
+	for(uint i = 0; i < (uint)obj->icount; ++i) {
+		int xi = 0, ti = 0, ni = 0;
+
+		if(
+			!obj_index(res_path, "vertex", obj->indices[i][0], obj->xcount, i, &xi) ||
+			(obj->tcount && !obj_index(res_path, "texcoord", obj->indices[i][1], obj->tcount, i, &ti)) ||
+			(obj->ncount && !obj_index(res_path, "normal", obj->indices[i][2], obj->ncount, i, &ni))
+		) {
+			ok = false;
+			break;
+		}
+
+		int64_t key = (int64_t)xi | ((int64_t)ti << 21) | ((int64_t)ni << 42);
+		int64_t idx;
+
+		if(!ht_lookup(&vertmap, key, &idx)) {
+			GenericModelVertex *v = verts + num_verts;
+			memcpy(v->position, obj->xs[xi - 1], sizeof(vec3_noalign));
+
+			if(ti) {
+				v->uv.s = obj->texcoords[ti - 1][0];
+				v->uv.t = obj->texcoords[ti - 1][1];
+			}
+
+			if(ni) {
+				memcpy(v->normal, obj->normals[ni - 1], sizeof(vec3_noalign));
+			}
+
+			idx = num_verts++;
+			ht_set(&vertmap, key, idx);
+		}
+
+		indices[i] = idx;
+	}
+
+	ht_destroy(&vertmap);
+
+	if(ok) {
+		cooked_mesh_alloc(out, num_verts, obj->icount);
+		memcpy(out->vertices, verts, num_verts * sizeof(*verts));
+		memcpy(out->indices, indices, obj->icount * sizeof(*indices));
+
+		optimize_vertex_cache(out->indices, out->num_indices, out->num_vertices);
+		reorder_vertices(out);
+
+		log_debug("%s: %u vertices, %u triangles (%i vertices unindexed)", res_path, out->num_vertices, out->num_indices / 3, obj->icount);
+	}
+
+	free(verts);
+	free(indices);
+	return ok;
+}
+
+static inline uint64_t model_cache_id(const char *res_path) {
+	return memhash64(res_path, strlen(res_path));
+}
+
+bool model_cache_load(const char *res_path, uint64_t source_hash, CookedMesh *out) {
+	CacheFile cf;
+
+	if(!cachefile_open_read(&cf, &mdlcache_format, model_cache_id(res_path), source_hash)) {
+		return false;
+	}
+
+	ModelCacheHeader hdr;
+
+	if(
+		!cachefile_read(&cf, &hdr, sizeof(hdr)) ||
+		hdr.num_vertices == 0 || hdr.num_vertices > hdr.num_indices ||
+		hdr.num_indices == 0 || hdr.num_indices % 3
+	) {
+		cachefile_close(&cf);
+		return false;
+	}
+
+	cooked_mesh_alloc(out, hdr.num_vertices, hdr.num_indices);
+
+	if(!cachefile_read(&cf, out->data, cooked_mesh_data_size(out))) {
+		cooked_mesh_free(out);
+		cachefile_close(&cf);
+		return false;
+	}
+
+	cachefile_close(&cf);
+
+	// these go straight to the GPU; don't let a corrupt file index out of bounds
+	for(uint i = 0; i < out->num_indices; ++i) {
+		if(out->indices[i] >= out->num_vertices) {
+			cooked_mesh_free(out);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void model_cache_store(const char *res_path, uint64_t source_hash, const CookedMesh *mesh) {
+	char what[strlen(res_path) + sizeof("model ")];
+	snprintf(what, sizeof(what), "model %s", res_path);
+
+	CacheFile cf;
+
+	if(!cachefile_open_write(&cf, &mdlcache_format, model_cache_id(res_path), source_hash, what)) {
+		return;
+	}
+
+	ModelCacheHeader hdr = {
+		.num_vertices = mesh->num_vertices,
+		.num_indices = mesh->num_indices,
+	};
+
+	cachefile_write(&cf, &hdr, sizeof(hdr));
+	cachefile_write(&cf, mesh->data, cooked_mesh_data_size(mesh));
+	cachefile_close(&cf);
+}
+
+void cooked_mesh_free(CookedMesh *mesh) {
+	free(mesh->data);
+	mesh->data = NULL;
+	mesh->vertices = NULL;
+	mesh->indices = NULL;
+}
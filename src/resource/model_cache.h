@@ -0,0 +1,38 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include "model.h"
+#include "renderer/api.h"
+
+/*
+ * Cooked meshes are indexed triangle lists. Every distinct position/texcoord/normal
+ * combination of the OBJ file becomes one vertex, triangles are reordered for the GPU's
+ * post-transform vertex cache, and vertices are renumbered in order of first use.
+ *
+ * They are cached in storage/cache/models, one file per model resource. A cache file is
+ * a fixed-size header followed by the vertex array and then the index array, exactly as
+ * they are laid out in CookedMesh::data, so the vertices can be uploaded in one call.
+ */
+
+typedef struct CookedMesh {
+	void *data;
+	GenericModelVertex *vertices;
+	uint32_t *indices;
+	uint32_t num_vertices;
+	uint32_t num_indices;
+} CookedMesh;
+
+bool model_cache_cook(const char *res_path, ObjFileData *obj, CookedMesh *out) attr_nonnull(1, 2, 3);
+
+bool model_cache_load(const char *res_path, uint64_t source_hash, CookedMesh *out) attr_nonnull(1, 3);
+void model_cache_store(const char *res_path, uint64_t source_hash, const CookedMesh *mesh) attr_nonnull(1, 3);
+
+void cooked_mesh_free(CookedMesh *mesh);
@@ -228,7 +228,17 @@ bool check_postprocess_path(const char *path) {
 	return strendswith(path, PP_EXTENSION);
 }
 
+static bool postprocess_preload_callback(const char *key, const char *value, void *data) {
+	if(!strcmp(key, "@shader")) {
+		preload_resource(RES_SHADER_PROGRAM, value, *(uint*)data);
+	}
+
+	return true;
+}
+
 void* load_postprocess_begin(const char *path, uint flags) {
+	// The chain itself can only be set up on the main thread, but the shaders can be loaded in advance.
+	parse_keyvalue_file_cb(path, postprocess_preload_callback, &flags);
 	return (void*)true;
 }
 
@@ -27,6 +27,7 @@
 #include "postprocess.h"
 #include "sprite.h"
 #include "font.h"
+#include "manifest.h"
 
 #include "renderer/common/backend.h"
 
@@ -50,13 +51,20 @@ typedef enum ResourceStatus {
 } ResourceStatus;
 
 typedef struct InternalResource {
-	Resource res;
+	Resource res; // must be the first member, see get_resource_by_id()
 	ResourceStatus status;
 	SDL_mutex *mutex;
 	SDL_cond *cond;
 	Task *async_task;
+	ResourceID id; // main thread only
 } InternalResource;
 
+struct ResourceSlot {
+	ResourceType type;
+	char *name;
+	InternalResource *ires; // main thread only; set once the resource has been looked up there
+};
+
 typedef struct ResourceAsyncLoadData {
 	InternalResource *ires;
 	char *path;
@@ -67,6 +75,11 @@ typedef struct ResourceAsyncLoadData {
 
 static SDL_threadID main_thread_id; // TODO: move this somewhere else
 
+static struct {
+	SDL_atomic_t num_started;
+	SDL_atomic_t num_finished;
+} async_load_stats;
+
 static inline ResourceHandler* get_handler(ResourceType type) {
 	return *(_handlers + type);
 }
@@ -78,6 +91,35 @@ static inline ResourceHandler* get_ires_handler(InternalResource *ires) {
 static void alloc_handler(ResourceHandler *h) {
 	assert(h != NULL);
 	ht_create(&h->private.mapping);
+	ht_create(&h->private.published);
+	ht_create(&h->private.ids);
+}
+
+static inline bool is_main_thread(void) {
+	return SDL_ThreadID() == main_thread_id;
+}
+
+// Flag promotions have to go through wait_for_resource_load(), which locks.
+static inline bool can_skip_promotion(InternalResource *ires, ResourceFlags flags) {
+	return !(flags & RESF_PERMANENT & ~ires->res.flags);
+}
+
+static Resource* publish_resource(ResourceHandler *handler, const char *name, InternalResource *ires) {
+	if(is_main_thread()) {
+		ht_set(&handler->private.published, name, ires);
+	}
+
+	return &ires->res;
+}
+
+static void unpublish_resource(ResourceHandler *handler, const char *name, InternalResource *ires) {
+	assert(is_main_thread());
+	ht_unset(&handler->private.published, name);
+
+	if(ires->id) {
+		ires->id->ires = NULL;
+		ires->id = NULL;
+	}
 }
 
 static const char* type_name(ResourceType type) {
@@ -115,6 +157,7 @@ static void finish_async_load(InternalResource *ires, ResourceAsyncLoadData *dat
 	SDL_CondBroadcast(data->ires->cond);
 	assert(ires->status != RES_STATUS_LOADING);
 	free(data);
+	SDL_AtomicIncRef(&async_load_stats.num_finished);
 }
 
 static ResourceStatus wait_for_resource_load(InternalResource *ires, uint32_t want_flags) {
@@ -233,6 +276,7 @@ static void load_resource_async(InternalResource *ires, char *path, char *name,
 	data->path = path;
 	data->name = name;
 	data->flags = flags;
+	SDL_AtomicIncRef(&async_load_stats.num_started);
 	ires->async_task = taskmgr_global_submit((TaskParams) { load_resource_async_task, data });
 }
 
@@ -329,9 +373,18 @@ static void load_resource_finish(InternalResource *ires, void *opaque, const cha
 }
 
 Resource* get_resource(ResourceType type, const char *name, ResourceFlags flags) {
+	ResourceHandler *handler = get_handler(type);
 	InternalResource *ires;
 	Resource *res;
 
+	if(is_main_thread()) {
+		ires = ht_get(&handler->private.published, name, NULL);
+
+		if(ires != NULL && can_skip_promotion(ires, flags)) {
+			return &ires->res;
+		}
+	}
+
 	if(flags & RESF_UNSAFE) {
 		// FIXME: I'm not sure we actually need this functionality.
 
@@ -361,7 +414,7 @@ Resource* get_resource(ResourceType type, const char *name, ResourceFlags flags)
 		} else {
 			assert(ires->status == RES_STATUS_LOADED);
 			assert(ires->res.data != NULL);
-			res = &ires->res;
+			res = publish_resource(handler, name, ires);
 		}
 
 		SDL_UnlockMutex(ires->mutex);
@@ -377,7 +430,7 @@ Resource* get_resource(ResourceType type, const char *name, ResourceFlags flags)
 		assert(status == RES_STATUS_LOADED);
 		assert(ires->res.data != NULL);
 
-		return &ires->res;
+		return publish_resource(handler, name, ires);
 	}
 }
 
@@ -391,6 +444,58 @@ void* get_resource_data(ResourceType type, const char *name, ResourceFlags flags
 	return NULL;
 }
 
+struct valfunc_id_arg {
+	ResourceType type;
+	const char *name;
+};
+
+static void* valfunc_new_id(void *arg) {
+	struct valfunc_id_arg *a = arg;
+	ResourceID id = calloc(1, sizeof(*id));
+	id->type = a->type;
+	id->name = strdup(a->name);
+	return id;
+}
+
+ResourceID res_id(ResourceType type, const char *name) {
+	ResourceID id;
+	struct valfunc_id_arg arg = { type, name };
+	ht_try_set(&get_handler(type)->private.ids, name, &arg, valfunc_new_id, (void**)&id);
+	return id;
+}
+
+Resource* get_resource_by_id(ResourceID id, ResourceFlags flags) {
+	if(!is_main_thread()) {
+		return get_resource(id->type, id->name, flags);
+	}
+
+	InternalResource *ires = id->ires;
+
+	if(ires != NULL && can_skip_promotion(ires, flags)) {
+		return &ires->res;
+	}
+
+	Resource *res = get_resource(id->type, id->name, flags);
+
+	if(res != NULL) {
+		ires = (InternalResource*)res;
+		ires->id = id;
+		id->ires = ires;
+	}
+
+	return res;
+}
+
+void* get_resource_data_by_id(ResourceID id, ResourceFlags flags) {
+	Resource *res = get_resource_by_id(id, flags);
+
+	if(res) {
+		return res->data;
+	}
+
+	return NULL;
+}
+
 void preload_resource(ResourceType type, const char *name, ResourceFlags flags) {
 	if(env_get("TAISEI_NOPRELOAD", false))
 		return;
@@ -415,8 +520,50 @@ void preload_resources(ResourceType type, ResourceFlags flags, const char *first
 	va_end(args);
 }
 
+void resource_get_load_progress(ResourceLoadProgress *progress) {
+	// Read finished first, so that it can never appear to be ahead of started.
+	progress->loaded = SDL_AtomicGet(&async_load_stats.num_finished);
+	progress->total = SDL_AtomicGet(&async_load_stats.num_started);
+}
+
+static void* collect_pending_resource(const char *key, void *value, void *arg) {
+	InternalResource *ires = value;
+	ListContainer **pending = arg;
+
+	if(ires->status == RES_STATUS_LOADING) {
+		list_push(pending, list_wrap_container(ires));
+	}
+
+	return NULL;
+}
+
+void resource_finish_preloads(void) {
+	assert(SDL_ThreadID() == main_thread_id);
+
+	ResourceLoadProgress progress;
+	resource_get_load_progress(&progress);
+
+	while(progress.loaded < progress.total) {
+		ListContainer *pending = NULL;
+
+		// Collect first: finishing a resource may start loading its dependencies, which needs to
+		// modify the hashtables we'd be iterating over.
+		for(ResourceType type = 0; type < RES_NUMTYPES; ++type) {
+			ht_foreach(&get_handler(type)->private.mapping, collect_pending_resource, &pending);
+		}
+
+		for(ListContainer *c; (c = list_pop(&pending));) {
+			wait_for_resource_load(c->data, 0);
+			free(c);
+		}
+
+		resource_get_load_progress(&progress);
+	}
+}
+
 void init_resources(void) {
 	main_thread_id = SDL_ThreadID();
+	res_manifest_init();
 
 	for(int i = 0; i < RES_NUMTYPES; ++i) {
 		ResourceHandler *h = get_handler(i);
@@ -549,6 +696,7 @@ void free_resources(bool all) {
 			assert(ires != NULL);
 
 			attr_unused ResourceFlags flags = ires->res.flags;
+			unpublish_resource(handler, name, ires);
 
 			if(!all) {
 				ht_unset(&handler->private.mapping, name);
@@ -571,6 +719,18 @@ void free_resources(bool all) {
 			}
 
 			ht_destroy(&handler->private.mapping);
+			ht_destroy(&handler->private.published);
+
+			ht_iter_begin(&handler->private.ids, &iter);
+
+			for(; iter.has_data; ht_iter_next(&iter)) {
+				ResourceID id = iter.value;
+				free(id->name);
+				free(id);
+			}
+
+			ht_iter_end(&iter);
+			ht_destroy(&handler->private.ids);
 		}
 	}
 
@@ -578,6 +738,8 @@ void free_resources(bool all) {
 		return;
 	}
 
+	res_manifest_shutdown();
+
 	if(!env_get("TAISEI_NOASYNC", 0)) {
 		events_unregister_handler(resource_asyncload_handler);
 	}
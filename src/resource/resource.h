@@ -90,6 +90,13 @@ typedef struct ResourceHandler {
 
 	struct {
 		ht_str2ptr_ts_t mapping;
+
+		// Loaded resources, as seen by the main thread. Only ever touched from the main thread,
+		// so lookups there don't need to lock anything.
+		ht_str2ptr_t published;
+
+		// ResourceIDs interned for this type, by name
+		ht_str2ptr_ts_t ids;
 	} private;
 } ResourceHandler;
 
@@ -99,14 +106,43 @@ typedef struct Resource {
 	void *data;
 } Resource;
 
+// An interned (type, name) pair. Interning takes a hashtable lookup; after that, getting the
+// resource through the ID is O(1) and lock-free on the main thread. IDs stay valid across unloads,
+// until the resource subsystem is shut down.
+typedef struct ResourceSlot *ResourceID;
+
+typedef struct ResourceLoadProgress {
+	uint loaded;  // asynchronous loads that have been completed
+	uint total;   // asynchronous loads that have been started
+} ResourceLoadProgress;
+
 void init_resources(void);
 void load_resources(void);
 void free_resources(bool all);
 
 Resource* get_resource(ResourceType type, const char *name, ResourceFlags flags);
 void* get_resource_data(ResourceType type, const char *name, ResourceFlags flags);
+
+ResourceID res_id(ResourceType type, const char *name) attr_nonnull(2);
+Resource* get_resource_by_id(ResourceID id, ResourceFlags flags) attr_nonnull(1);
+void* get_resource_data_by_id(ResourceID id, ResourceFlags flags) attr_nonnull(1);
+
+// Interns a resource name once per call site, e.g. get_resource_data_by_id(RES_ID(RES_SPRITE, "star"), 0).
+#ifdef USE_GNU_EXTENSIONS
+	#define RES_ID(type, name) (__extension__({ \
+		static ResourceID _res_id; \
+		_res_id ? _res_id : (_res_id = res_id((type), (name))); \
+	}))
+#else
+	#define RES_ID(type, name) res_id((type), (name))
+#endif
 void preload_resource(ResourceType type, const char *name, ResourceFlags flags);
 void preload_resources(ResourceType type, ResourceFlags flags, const char *firstname, ...) attr_sentinel;
+// Both counters only ever grow; take a snapshot before preloading to measure the progress of one batch.
+void resource_get_load_progress(ResourceLoadProgress *progress);
+// Waits for every pending asynchronous load, including dependencies discovered along the way,
+// and finalizes them. Must be called from the main thread.
+void resource_finish_preloads(void);
 void* resource_for_each(ResourceType type, void* (*callback)(const char *name, Resource *res, void *arg), void *arg);
 
 void resource_util_strip_ext(char *path);
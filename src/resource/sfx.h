@@ -20,6 +20,7 @@ typedef enum {
 typedef struct Sound {
 	int lastplayframe;
 	LoopState islooping;
+	bool tracked;
 	void *impl;
 } Sound;
 
@@ -67,6 +67,7 @@ void* load_sound_end(void *opaque, const char *path, uint flags) {
 
 void unload_sound(void *vsnd) {
 	Sound *snd = vsnd;
+	audio_sound_unloaded(snd);
 	Mix_FreeChunk(((MixerInternalSound *)snd->impl)->ch);
 	free(snd->impl);
 	free(snd);
@@ -9,6 +9,7 @@
 #include "taisei.h"
 
 #include "sprite.h"
+#include "manifest.h"
 #include "video.h"
 #include "renderer/api.h"
 
@@ -57,10 +58,10 @@ void* load_sprite_begin(const char *path, uint flags) {
 
 	if(check_texture_path(path)) {
 		state->texture_name = resource_util_basename(TEX_PATH_PREFIX, path);
-		return state;
+		goto done;
 	}
 
-	if(!parse_keyvalue_file_with_spec(path, (KVSpec[]) {
+	if(!parse_keyvalue_resource_with_spec(path, (KVSpec[]) {
 		{ "texture",  .out_str   = &state->texture_name },
 		{ "region_x", .out_float = &spr->tex_area.x },
 		{ "region_y", .out_float = &spr->tex_area.y },
@@ -82,6 +83,9 @@ void* load_sprite_begin(const char *path, uint flags) {
 		log_warn("%s: inferred texture name from sprite name", state->texture_name);
 	}
 
+done:
+	// Start decoding the texture right away, instead of when load_sprite_end asks for it.
+	preload_resource(RES_TEXTURE, state->texture_name, flags);
 	return state;
 }
 
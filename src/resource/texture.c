@@ -11,6 +11,8 @@
 #include <SDL_image.h>
 
 #include "texture.h"
+#include "texture_cache.h"
+#include "manifest.h"
 #include "resource.h"
 #include "global.h"
 #include "video.h"
@@ -93,11 +95,6 @@ bool check_texture_path(const char *path) {
 	return strendswith_any(path, texture_image_exts);
 }
 
-typedef struct TexLoadData {
-	SDL_Surface *surf;
-	TextureParams params;
-} TexLoadData;
-
 static void parse_filter(const char *val, TextureFilterMode *out, bool allow_mipmaps) {
 	if(!val) {
 		return;
@@ -178,15 +175,41 @@ static void parse_wrap(const char *val, TextureWrapMode *out) {
 }
 
 typedef struct TextureLoadData {
-	SDL_Surface *surf;
+	PrecookedTexture image;
 	TextureParams params;
 } TextureLoadData;
 
+static SDL_Surface *texture_decode(const char *source, void *data, size_t size) {
+	SDL_Surface *surf;
+	SDL_RWops *rw = SDL_RWFromConstMem(data, size);
+
+	if(strendswith(source, ".tga")) {
+		surf = IMG_LoadTGA_RW(rw);
+	} else {
+		surf = IMG_Load_RW(rw, false);
+	}
+
+	SDL_RWclose(rw);
+
+	if(!surf) {
+		log_warn("IMG_Load_RW failed: %s", IMG_GetError());
+		return NULL;
+	}
+
+	SDL_Surface *converted_surf = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(surf);
+
+	if(!converted_surf) {
+		log_warn("SDL_ConvertSurfaceFormat(): failed: %s", SDL_GetError());
+		return NULL;
+	}
+
+	return converted_surf;
+}
+
 static void* load_texture_begin(const char *path, uint flags) {
 	const char *source = path;
 	char *source_allocated = NULL;
-	SDL_Surface *surf = NULL;
-	SDL_RWops *srcrw = NULL;
 
 	TextureLoadData ld = {
 		.params = {
@@ -202,8 +225,7 @@ static void* load_texture_begin(const char *path, uint flags) {
 			.mipmaps = TEX_MIPMAPS_MAX,
 			.anisotropy = TEX_ANISOTROPY_DEFAULT,
 
-			// Manual because we don't want mipmaps generated until we've applied the
-			// post-load shader, which will premultiply alpha.
+			// Manual because all mip levels come precooked with premultiplied alpha.
 			// Mipmaps and filtering are basically broken without premultiplied alpha.
 			.mipmap_mode = TEX_MIPMAP_MANUAL,
 		}
@@ -215,7 +237,7 @@ static void* load_texture_begin(const char *path, uint flags) {
 		char *str_wrap_s = NULL;
 		char *str_wrap_t = NULL;
 
-		if(!parse_keyvalue_file_with_spec(path, (KVSpec[]) {
+		if(!parse_keyvalue_resource_with_spec(path, (KVSpec[]) {
 			{ "source",     .out_str  = &source_allocated },
 			{ "filter_min", .out_str  = &str_filter_min },
 			{ "filter_mag", .out_str  = &str_filter_mag },
@@ -261,101 +283,57 @@ static void* load_texture_begin(const char *path, uint flags) {
 		free(str_wrap_t);
 	}
 
-	srcrw = vfs_open(source, VFS_MODE_READ | VFS_MODE_SEEKABLE);
+	int source_size;
+	char *source_data = read_all(source, &source_size);
 
-	if(!srcrw) {
-		log_warn("VFS error: %s", vfs_get_error());
+	if(!source_data) {
 		free(source_allocated);
 		return NULL;
 	}
 
-	if(strendswith(source, ".tga")) {
-		surf = IMG_LoadTGA_RW(srcrw);
-	} else {
-		surf = IMG_Load_RW(srcrw, false);
+	if(ld.params.mipmaps == 0) {
+		ld.params.mipmaps = TEX_MIPMAPS_MAX;
 	}
 
-	free(source_allocated);
+	bool use_cache = env_get("TAISEI_TEXTURE_CACHE", true);
 
-	if(!surf) {
-		log_warn("IMG_Load_RW failed: %s", IMG_GetError());
-		return NULL;
-	}
+	TextureCacheKey cache_key = {
+		.source_hash = memhash64(source_data, source_size),
+		.mipmaps = ld.params.mipmaps,
+		.flipped = r_supports(RFEAT_TEXTURE_BOTTOMLEFT_ORIGIN),
+	};
 
-	SDL_RWclose(srcrw);
+	if(!use_cache || !texture_cache_load(path, &cache_key, &ld.image)) {
+		SDL_Surface *surf = texture_decode(source, source_data, source_size);
 
-	SDL_Surface *converted_surf = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0);
-	SDL_FreeSurface(surf);
+		if(!surf) {
+			free(source_data);
+			free(source_allocated);
+			return NULL;
+		}
 
-	if(!converted_surf) {
-		log_warn("SDL_ConvertSurfaceFormat(): failed: %s", SDL_GetError());
-		return NULL;
-	}
+		if(cache_key.flipped) {
+			SDL_LockSurface(surf);
+			flip_bitmap(surf->pixels, surf->h, surf->pitch);
+			SDL_UnlockSurface(surf);
+		}
 
-	if(r_supports(RFEAT_TEXTURE_BOTTOMLEFT_ORIGIN)) {
-		SDL_LockSurface(converted_surf);
-		flip_bitmap(converted_surf->pixels, converted_surf->h, converted_surf->w * 4);
-		SDL_UnlockSurface(converted_surf);
-	}
+		texture_cache_cook(surf, ld.params.mipmaps, &ld.image);
+		SDL_FreeSurface(surf);
 
-	if(ld.params.mipmaps == 0) {
-		ld.params.mipmaps = TEX_MIPMAPS_MAX;
+		if(use_cache) {
+			texture_cache_store(path, &cache_key, &ld.image);
+		}
 	}
 
-	ld.params.width = converted_surf->w;
-	ld.params.height = converted_surf->h;
-	ld.surf = converted_surf;
-
-	return memdup(&ld, sizeof(ld));
-}
-
-static Texture* texture_post_load(Texture *tex) {
-	// this is a bit hacky and not very efficient,
-	// but it's still much faster than fixing up the texture on the CPU
-
-	ShaderProgram *shader_saved = r_shader_current();
-	Framebuffer *fb_saved = r_framebuffer_current();
-	BlendMode blend_saved = r_blend_current();
-	bool cullcap_saved = r_capability_current(RCAP_CULL_FACE);
+	free(source_data);
+	free(source_allocated);
 
-	Texture *fbo_tex;
-	TextureParams params;
-	Framebuffer *fb;
-
-	r_blend(BLEND_NONE);
-	r_disable(RCAP_CULL_FACE);
-	r_texture_get_params(tex, &params);
-	params.mipmap_mode = TEX_MIPMAP_AUTO;
-	r_texture_set_filter(tex, TEX_FILTER_NEAREST, TEX_FILTER_NEAREST);
-	fbo_tex = r_texture_create(&params);
-	r_shader("texture_post_load");
-	r_uniform_sampler("tex", tex);
-	r_mat_push();
-	r_mat_identity();
-	r_mat_mode(MM_PROJECTION);
-	r_mat_push();
-	r_mat_identity();
-	r_mat_ortho(0, params.width, params.height, 0, -100, 100);
-	r_mat_mode(MM_MODELVIEW);
-	r_mat_scale(params.width, params.height, 1);
-	r_mat_translate(0.5, 0.5, 0);
-	fb = r_framebuffer_create();
-	r_framebuffer_attach(fb, fbo_tex, 0, FRAMEBUFFER_ATTACH_COLOR0);
-	r_framebuffer_viewport(fb, 0, 0, params.width, params.height);
-	r_framebuffer(fb);
-	r_draw_quad();
-	r_mat_pop();
-	r_mat_mode(MM_PROJECTION);
-	r_mat_pop();
-	r_mat_mode(MM_MODELVIEW);
-	r_framebuffer(fb_saved);
-	r_shader_ptr(shader_saved);
-	r_blend(blend_saved);
-	r_capability(RCAP_CULL_FACE, cullcap_saved);
-	r_framebuffer_destroy(fb);
-	r_texture_destroy(tex);
+	ld.params.width = ld.image.width;
+	ld.params.height = ld.image.height;
+	ld.params.mipmaps = ld.image.num_levels;
 
-	return fbo_tex;
+	return memdup(&ld, sizeof(ld));
 }
 
 static void* load_texture_end(void *opaque, const char *path, uint flags) {
@@ -369,16 +347,15 @@ static void* load_texture_end(void *opaque, const char *path, uint flags) {
 	Texture *texture = r_texture_create(&ld->params);
 	r_texture_set_debug_label(texture, basename);
 
-	SDL_LockSurface(ld->surf);
-	r_texture_fill(texture, 0, ld->surf->pixels);
-	SDL_UnlockSurface(ld->surf);
-	SDL_FreeSurface(ld->surf);
-	free(ld);
-
-	texture = texture_post_load(texture);
-	r_texture_set_debug_label(texture, basename);
 	free(basename);
 
+	for(uint i = 0; i < ld->image.num_levels; ++i) {
+		r_texture_fill(texture, i, precooked_texture_level(&ld->image, i));
+	}
+
+	precooked_texture_free(&ld->image);
+	free(ld);
+
 	return texture;
 }
 
@@ -0,0 +1,198 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include "texture_cache.h"
+#include "util.h"
+#include "util/cachefile.h"
+
+#define TEXCACHE_FLAG_FLIPPED 0x1
+
+static const CacheFileFormat texcache_format = {
+	.subdir = "textures",
+	.extension = ".texcache",
+	.magic = "TAITEXC",
+	.version = 2,
+};
+
+// follows the CacheFileHeader, whose key is the source image hash
+typedef struct TextureCacheHeader {
+	uint32_t flags;
+	uint32_t mipmaps;
+	uint32_t width;
+	uint32_t height;
+	uint32_t num_levels;
+	uint32_t reserved[3];
+	uint64_t data_size;
+} TextureCacheHeader;
+
+static_assert((sizeof(CacheFileHeader) + sizeof(TextureCacheHeader)) % 16 == 0, "Texture cache header breaks level alignment");
+
+static uint texture_cache_num_levels(uint width, uint height, uint max_levels) {
+	uint num_levels = 1 + floor(log2(max(width, height)));
+
+	if(max_levels == 0) {
+		max_levels = 1;
+	}
+
+	return min(num_levels, min(max_levels, PRECOOKED_TEXTURE_MAX_LEVELS));
+}
+
+static inline uint level_dimension(uint base, uint level) {
+	return max(1, base >> level);
+}
+
+static size_t texture_cache_layout(PrecookedTexture *tex) {
+	size_t ofs = 0;
+
+	for(uint i = 0; i < tex->num_levels; ++i) {
+		tex->level_offsets[i] = ofs;
+		ofs += (size_t)level_dimension(tex->width, i) * level_dimension(tex->height, i) * 4;
+	}
+
+	return ofs;
+}
+
+static void downsample_level(const uint8_t *src, uint sw, uint sh, uint8_t *dst, uint dw, uint dh) {
+	for(uint y = 0; y < dh; ++y) {
+		uint y0 = min(y * 2, sh - 1);
+		uint y1 = min(y * 2 + 1, sh - 1);
+
+		for(uint x = 0; x < dw; ++x) {
+			uint x0 = min(x * 2, sw - 1);
+			uint x1 = min(x * 2 + 1, sw - 1);
+
+			const uint8_t *p00 = src + (y0 * sw + x0) * 4;
+			const uint8_t *p01 = src + (y0 * sw + x1) * 4;
+			const uint8_t *p10 = src + (y1 * sw + x0) * 4;
+			const uint8_t *p11 = src + (y1 * sw + x1) * 4;
+
+			for(uint c = 0; c < 4; ++c) {
+				*dst++ = (p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4;
+			}
+		}
+	}
+}
+
+void texture_cache_cook(SDL_Surface *surf, uint max_levels, PrecookedTexture *out) {
+	assert(surf->format->format == SDL_PIXELFORMAT_RGBA32);
+
+	memset(out, 0, sizeof(*out));
+	out->width = surf->w;
+	out->height = surf->h;
+	out->num_levels = texture_cache_num_levels(surf->w, surf->h, max_levels);
+	out->data_size = texture_cache_layout(out);
+	out->data = malloc(out->data_size);
+
+	SDL_LockSurface(surf);
+
+	// premultiply alpha, rounding the same way the GPU does when storing to an 8-bit target
+	for(uint y = 0; y < out->height; ++y) {
+		const uint8_t *src = (uint8_t*)surf->pixels + y * surf->pitch;
+		uint8_t *dst = out->data + y * out->width * 4;
+
+		for(uint x = 0; x < out->width; ++x, src += 4, dst += 4) {
+			uint a = src[3];
+			dst[0] = (src[0] * a + 127) / 255;
+			dst[1] = (src[1] * a + 127) / 255;
+			dst[2] = (src[2] * a + 127) / 255;
+			dst[3] = a;
+		}
+	}
+
+	SDL_UnlockSurface(surf);
+
+	// box filtering premultiplied texels is correct, unlike with straight alpha
+	for(uint i = 1; i < out->num_levels; ++i) {
+		downsample_level(
+			precooked_texture_level(out, i - 1), level_dimension(out->width, i - 1), level_dimension(out->height, i - 1),
+			precooked_texture_level(out, i),     level_dimension(out->width, i),     level_dimension(out->height, i)
+		);
+	}
+}
+
+static inline uint64_t texture_cache_id(const char *res_path) {
+	return memhash64(res_path, strlen(res_path));
+}
+
+static inline uint32_t texture_cache_flags(const TextureCacheKey *key) {
+	return key->flipped ? TEXCACHE_FLAG_FLIPPED : 0;
+}
+
+bool texture_cache_load(const char *res_path, const TextureCacheKey *key, PrecookedTexture *out) {
+	CacheFile cf;
+
+	if(!cachefile_open_read(&cf, &texcache_format, texture_cache_id(res_path), key->source_hash)) {
+		return false;
+	}
+
+	TextureCacheHeader hdr;
+
+	if(
+		!cachefile_read(&cf, &hdr, sizeof(hdr)) ||
+		hdr.flags != texture_cache_flags(key) ||
+		hdr.mipmaps != key->mipmaps ||
+		hdr.width == 0 || hdr.height == 0 ||
+		hdr.num_levels != texture_cache_num_levels(hdr.width, hdr.height, hdr.mipmaps)
+	) {
+		cachefile_close(&cf);
+		return false;
+	}
+
+	memset(out, 0, sizeof(*out));
+	out->width = hdr.width;
+	out->height = hdr.height;
+	out->num_levels = hdr.num_levels;
+	out->data_size = texture_cache_layout(out);
+
+	if(hdr.data_size != out->data_size) {
+		cachefile_close(&cf);
+		return false;
+	}
+
+	out->data = malloc(out->data_size);
+
+	if(!cachefile_read(&cf, out->data, out->data_size)) {
+		precooked_texture_free(out);
+		cachefile_close(&cf);
+		return false;
+	}
+
+	cachefile_close(&cf);
+	return true;
+}
+
+void texture_cache_store(const char *res_path, const TextureCacheKey *key, const PrecookedTexture *tex) {
+	char what[strlen(res_path) + sizeof("texture ")];
+	snprintf(what, sizeof(what), "texture %s", res_path);
+
+	CacheFile cf;
+
+	if(!cachefile_open_write(&cf, &texcache_format, texture_cache_id(res_path), key->source_hash, what)) {
+		return;
+	}
+
+	TextureCacheHeader hdr = {
+		.flags = texture_cache_flags(key),
+		.mipmaps = key->mipmaps,
+		.width = tex->width,
+		.height = tex->height,
+		.num_levels = tex->num_levels,
+		.data_size = tex->data_size,
+	};
+
+	cachefile_write(&cf, &hdr, sizeof(hdr));
+	cachefile_write(&cf, tex->data, tex->data_size);
+	cachefile_close(&cf);
+}
+
+void precooked_texture_free(PrecookedTexture *tex) {
+	free(tex->data);
+	tex->data = NULL;
+}
@@ -0,0 +1,50 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include <SDL.h>
+
+/*
+ * Precooked textures are RGBA8 images with premultiplied alpha and a full mip chain,
+ * already flipped for the renderer's texture origin, so they can be uploaded as-is.
+ *
+ * They are cached in storage/cache/textures, one file per texture resource. A cache file
+ * is a fixed-size header followed by all mip levels, tightly packed in order, so every
+ * level lives at an offset computable from the header alone.
+ */
+
+#define PRECOOKED_TEXTURE_MAX_LEVELS 32
+
+typedef struct PrecookedTexture {
+	uint8_t *data;
+	uint32_t width;
+	uint32_t height;
+	uint32_t num_levels;
+	size_t level_offsets[PRECOOKED_TEXTURE_MAX_LEVELS];
+	size_t data_size;
+} PrecookedTexture;
+
+typedef struct TextureCacheKey {
+	uint64_t source_hash;
+	uint32_t mipmaps;
+	bool flipped;
+} TextureCacheKey;
+
+// surf must be SDL_PIXELFORMAT_RGBA32. max_levels may be TEX_MIPMAPS_MAX.
+void texture_cache_cook(SDL_Surface *surf, uint max_levels, PrecookedTexture *out) attr_nonnull(1, 3);
+
+bool texture_cache_load(const char *res_path, const TextureCacheKey *key, PrecookedTexture *out) attr_nonnull(1, 2, 3);
+void texture_cache_store(const char *res_path, const TextureCacheKey *key, const PrecookedTexture *tex) attr_nonnull(1, 2, 3);
+
+void precooked_texture_free(PrecookedTexture *tex);
+
+static inline attr_must_inline void *precooked_texture_level(PrecookedTexture *tex, uint level) {
+	return tex->data + tex->level_offsets[level];
+}
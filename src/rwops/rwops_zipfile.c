@@ -11,32 +11,218 @@
 #include "rwops_zipfile.h"
 #include "util.h"
 
+/*
+ * Stored entries are seeked natively by libzip, which reads straight from the package
+ * stream, so nothing is ever buffered.
+ *
+ * Compressed entries can only be inflated forwards. The last ZIPRW_WINDOW_SIZE bytes of
+ * inflated data are kept in a ring buffer, so that the short backward seeks decoders like
+ * to do when probing headers don't restart decompression. Seeking forward inflates and
+ * discards; seeking backward past the window reopens the entry.
+ */
+
+#define ZIPRW_WINDOW_SIZE (64 * 1024)
+
+typedef struct ZipRW {
+	zip_t *zip;
+	zip_file_t *file;
+	zip_uint64_t index;
+	int64_t size;
+	int64_t pos;
+	bool autoclose;
+	bool close_archive;
+	bool stored;
+
+	// compressed entries only
+	int64_t stream_pos;
+	size_t window_fill;
+	uint8_t *window;
+} ZipRW;
+
+#define ZIPRW(rw) ((ZipRW*)((rw)->hidden.unknown.data1))
+
 static int ziprw_close(SDL_RWops *rw) {
 	if(rw) {
-		if(rw->hidden.unknown.data2) {
-			zip_fclose(rw->hidden.unknown.data1);
+		ZipRW *z = ZIPRW(rw);
+
+		if(z->autoclose && z->file) {
+			zip_fclose(z->file);
+		}
+
+		if(z->close_archive) {
+			zip_discard(z->zip);
 		}
 
+		free(z->window);
+		free(z);
 		SDL_FreeRW(rw);
 	}
 
 	return 0;
 }
 
-static int64_t ziprw_seek(SDL_RWops *rw, int64_t offset, int whence) {
-	SDL_SetError("Not implemented");
-	return -1;
+static int64_t ziprw_size(SDL_RWops *rw) {
+	return ZIPRW(rw)->size;
 }
 
-static int64_t ziprw_size(SDL_RWops *rw) {
-	SDL_SetError("Not implemented");
-	return -1;
+static bool ziprw_reopen(ZipRW *z) {
+	zip_file_t *file = zip_fopen_index(z->zip, z->index, 0);
+
+	if(!file) {
+		SDL_SetError("ZIP error: %s", zip_strerror(z->zip));
+		return false;
+	}
+
+	if(z->autoclose && z->file) {
+		zip_fclose(z->file);
+	}
+
+	z->file = file;
+	z->autoclose = true;
+	z->stream_pos = 0;
+	z->window_fill = 0;
+	return true;
+}
+
+static void ziprw_window_append(ZipRW *z, const uint8_t *data, size_t size) {
+	// the ring is indexed by stream position, so the data just needs to land in the right place
+	if(size > ZIPRW_WINDOW_SIZE) {
+		data += size - ZIPRW_WINDOW_SIZE;
+		z->stream_pos += size - ZIPRW_WINDOW_SIZE;
+		size = ZIPRW_WINDOW_SIZE;
+	}
+
+	size_t ofs = z->stream_pos % ZIPRW_WINDOW_SIZE;
+	size_t first = min(size, ZIPRW_WINDOW_SIZE - ofs);
+	memcpy(z->window + ofs, data, first);
+	memcpy(z->window, data + first, size - first);
+
+	z->stream_pos += size;
+	z->window_fill = min(z->window_fill + size, ZIPRW_WINDOW_SIZE);
+}
+
+static void ziprw_window_copy(ZipRW *z, int64_t pos, uint8_t *dest, size_t size) {
+	size_t ofs = pos % ZIPRW_WINDOW_SIZE;
+	size_t first = min(size, ZIPRW_WINDOW_SIZE - ofs);
+	memcpy(dest, z->window + ofs, first);
+	memcpy(dest + first, z->window, size - first);
+}
+
+// Inflates up to size bytes at the current stream position into dest, and remembers them.
+static int64_t ziprw_inflate(ZipRW *z, uint8_t *dest, size_t size) {
+	zip_int64_t got = zip_fread(z->file, dest, size);
+
+	if(got < 0) {
+		SDL_SetError("ZIP error: %s", zip_file_strerror(z->file));
+		return -1;
+	}
+
+	ziprw_window_append(z, dest, got);
+	return got;
+}
+
+static size_t ziprw_read_compressed(ZipRW *z, uint8_t *dest, size_t size) {
+	size_t total = 0;
+
+	while(size > 0 && z->pos < z->size) {
+		int64_t window_start = z->stream_pos - z->window_fill;
+
+		if(z->pos < window_start && !ziprw_reopen(z)) {
+			break;
+		}
+
+		if(z->pos < z->stream_pos) {
+			size_t n = min(size, z->stream_pos - z->pos);
+			ziprw_window_copy(z, z->pos, dest, n);
+			z->pos += n;
+			dest += n;
+			size -= n;
+			total += n;
+			continue;
+		}
+
+		if(z->pos > z->stream_pos) {
+			// skip forward, keeping only the tail of the skipped data
+			uint8_t skipbuf[4096];
+			int64_t got = ziprw_inflate(z, skipbuf, min(sizeof(skipbuf), z->pos - z->stream_pos));
+
+			if(got <= 0) {
+				break;
+			}
+
+			continue;
+		}
+
+		int64_t got = ziprw_inflate(z, dest, size);
+
+		if(got <= 0) {
+			break;
+		}
+
+		z->pos += got;
+		dest += got;
+		size -= got;
+		total += got;
+	}
+
+	return total;
+}
+
+static int64_t ziprw_seek(SDL_RWops *rw, int64_t offset, int whence) {
+	ZipRW *z = ZIPRW(rw);
+	int64_t pos;
+
+	switch(whence) {
+		case RW_SEEK_SET: pos = offset; break;
+		case RW_SEEK_CUR: pos = z->pos + offset; break;
+		case RW_SEEK_END: pos = z->size + offset; break;
+		default: {
+			SDL_SetError("Bad whence value %i", whence);
+			return -1;
+		}
+	}
+
+	if(pos < 0) {
+		SDL_SetError("Can't seek before the start of the file");
+		return -1;
+	}
+
+	if(z->stored) {
+		if(zip_fseek(z->file, pos, SEEK_SET) < 0) {
+			SDL_SetError("ZIP error: %s", zip_file_strerror(z->file));
+			return -1;
+		}
+	}
+
+	// compressed streams catch up lazily on the next read
+	z->pos = pos;
+	return pos;
 }
 
 static size_t ziprw_read(SDL_RWops *rw, void *ptr, size_t size, size_t maxnum) {
-	zip_file_t *zipfile = rw->hidden.unknown.data1;
-	// XXX: possible size overflow
-	return zip_fread(zipfile, ptr, size * maxnum);
+	ZipRW *z = ZIPRW(rw);
+
+	if(size == 0 || maxnum > SIZE_MAX / size) {
+		return 0;
+	}
+
+	size_t total;
+
+	if(z->stored) {
+		zip_int64_t got = zip_fread(z->file, ptr, size * maxnum);
+
+		if(got < 0) {
+			SDL_SetError("ZIP error: %s", zip_file_strerror(z->file));
+			return 0;
+		}
+
+		total = got;
+		z->pos += got;
+	} else {
+		total = ziprw_read_compressed(z, ptr, size * maxnum);
+	}
+
+	return total / size;
 }
 
 static size_t ziprw_write(SDL_RWops *rw, const void *ptr, size_t size, size_t maxnum) {
@@ -44,12 +230,36 @@ static size_t ziprw_write(SDL_RWops *rw, const void *ptr, size_t size, size_t ma
 	return -1;
 }
 
-SDL_RWops* SDL_RWFromZipFile(zip_file_t *zipfile, bool autoclose) {
+SDL_RWops* SDL_RWFromZipFile(zip_t *zip, zip_uint64_t index, zip_file_t *zipfile, bool autoclose, bool close_archive) {
+	zip_stat_t stat;
+
+	if(zip_stat_index(zip, index, 0, &stat) < 0) {
+		SDL_SetError("ZIP error: %s", zip_strerror(zip));
+		return NULL;
+	}
+
+	if(!(stat.valid & ZIP_STAT_SIZE) || !(stat.valid & ZIP_STAT_COMP_METHOD)) {
+		SDL_SetError("ZIP entry %"PRIu64" has an unknown size or compression method", (uint64_t)index);
+		return NULL;
+	}
+
+	ZipRW *z = calloc(1, sizeof(ZipRW));
+	z->zip = zip;
+	z->file = zipfile;
+	z->index = index;
+	z->size = stat.size;
+	z->autoclose = autoclose;
+	z->close_archive = close_archive;
+	z->stored = stat.comp_method == ZIP_CM_STORE;
+
+	if(!z->stored) {
+		z->window = malloc(ZIPRW_WINDOW_SIZE);
+	}
+
 	SDL_RWops *rw = SDL_AllocRW();
 	memset(rw, 0, sizeof(SDL_RWops));
 
-	rw->hidden.unknown.data1 = zipfile;
-	rw->hidden.unknown.data2 = (void*)(intptr_t)autoclose;
+	rw->hidden.unknown.data1 = z;
 	rw->type = SDL_RWOPS_UNKNOWN;
 
 	rw->size = ziprw_size;
@@ -12,4 +12,5 @@
 #include <SDL.h>
 #include <zip.h>
 
-SDL_RWops* SDL_RWFromZipFile(zip_file_t *zipfile, bool autoclose);
+// If close_archive is true, the RWops owns zip and discards it when closed.
+SDL_RWops* SDL_RWFromZipFile(zip_t *zip, zip_uint64_t index, zip_file_t *zipfile, bool autoclose, bool close_archive);
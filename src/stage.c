@@ -25,6 +25,8 @@
 #include "stagetext.h"
 #include "stagedraw.h"
 #include "stageobjects.h"
+#include "enemygrid.h"
+#include "benchmark.h"
 
 #ifdef DEBUG
 	#define DPSTEST
@@ -203,6 +205,7 @@ StageProgress* stage_get_progress(uint16_t id, Difficulty diff, bool allocate) {
 
 static void stage_start(StageInfo *stage) {
 	ent_init();
+	enemygrid_init();
 
 	global.timer = 0;
 	global.frames = 0;
@@ -371,16 +374,14 @@ bool stage_input_handler_replay(SDL_Event *event, void *arg) {
 
 void replay_input(void) {
 	ReplayStage *s = global.replay_stage;
-	int i;
+	ReplayEvent *e;
 
 	events_poll((EventHandler[]){
 		{ .proc = stage_input_handler_replay },
 		{NULL}
 	}, EFLAG_GAME);
 
-	for(i = s->playpos; i < s->numevents; ++i) {
-		ReplayEvent *e = s->events + i;
-
+	for(; (e = replay_stage_current_event(s)); ++s->playpos) {
 		if(e->frame != global.frames)
 			break;
 
@@ -404,7 +405,6 @@ void replay_input(void) {
 		}
 	}
 
-	s->playpos = i;
 	player_applymovement(&global.plr);
 }
 
@@ -418,26 +418,53 @@ void stage_input(void) {
 }
 
 static void stage_logic(void) {
+	// Enemies may have been moved around by the stage events since the last frame.
+	enemygrid_invalidate();
+
+	bench_section_begin(BENCH_PLAYER_LOGIC);
 	player_logic(&global.plr);
+	bench_section_end(BENCH_PLAYER_LOGIC);
 
+	bench_section_begin(BENCH_PROCESS_BOSS);
 	process_boss(&global.boss);
+	bench_section_end(BENCH_PROCESS_BOSS);
+
+	bench_section_begin(BENCH_PROCESS_ENEMIES);
 	process_enemies(&global.enemies);
+	bench_section_end(BENCH_PROCESS_ENEMIES);
+
+	// Enemy positions are final for this frame now, so the grid will be built just once for all the
+	// collision queries below (unless enemies get spawned or deleted in the meantime).
+	enemygrid_invalidate();
+
+	bench_section_begin(BENCH_PROCESS_PROJECTILES);
 	process_projectiles(&global.projs, true);
+	bench_section_end(BENCH_PROCESS_PROJECTILES);
+
+	bench_section_begin(BENCH_PROCESS_ITEMS);
 	process_items();
+	bench_section_end(BENCH_PROCESS_ITEMS);
+
+	bench_section_begin(BENCH_PROCESS_LASERS);
 	process_lasers();
+	bench_section_end(BENCH_PROCESS_LASERS);
+
+	bench_section_begin(BENCH_PROCESS_PARTICLES);
 	process_projectiles(&global.particles, false);
+	bench_section_end(BENCH_PROCESS_PARTICLES);
 	process_dialog(&global.dialog);
 
 	update_sounds();
 
 	global.frames++;
+	replay_seek_update();
 
 	if(!global.dialog && (!global.boss || boss_is_fleeing(global.boss))) {
 		global.timer++;
 	}
 
 	if(global.replaymode == REPLAY_PLAY &&
-		global.frames == global.replay_stage->events[global.replay_stage->numevents-1].frame - FADE_TIME &&
+		global.frames == global.replay_stage->final_frame - FADE_TIME &&
 		global.game_over != GAMEOVER_TRANSITIONING) {
 		stage_finish(GAMEOVER_DEFEAT);
 	}
@@ -477,7 +504,7 @@ static bool proximity_predicate(EntityInterface *ent, void *varg) {
 	switch(ent->type) {
 		case ENT_PROJECTILE: {
 			Projectile *p = ENT_CAST(ent, Projectile);
-			return cabs(p->pos - area->origin) < area->radius;
+			return sim_cabs(p->pos - area->origin) < area->radius;
 		}
 
 		case ENT_LASER: {
@@ -557,6 +584,10 @@ static void stage_preload(void) {
 	}
 
 	global.stage->procs->preload();
+
+	// Let the decoding run in parallel and do all the uploads now, rather than during the first
+	// few seconds of gameplay, whenever something happens to be needed.
+	resource_finish_preloads();
 }
 
 static void display_stage_title(StageInfo *info) {
@@ -602,11 +633,15 @@ static void stage_update_fps(StageFrameState *fstate) {
 static FrameAction stage_logic_frame(void *arg) {
 	StageFrameState *fstate = arg;
 	StageInfo *stage = fstate->stage;
+	int frame = global.frames;
 
+	bench_frame_begin();
 	stage_update_fps(fstate);
 	((global.replaymode == REPLAY_PLAY) ? replay_input : stage_input)();
 
 	if(global.game_over != GAMEOVER_TRANSITIONING) {
+		bench_section_begin(BENCH_STAGE_EVENTS);
+
 		if((!global.boss || boss_is_fleeing(global.boss)) && !global.dialog) {
 			stage->procs->event();
 		}
@@ -616,6 +651,7 @@ static FrameAction stage_logic_frame(void *arg) {
 		}
 
 		stage->procs->update();
+		bench_section_end(BENCH_STAGE_EVENTS);
 	}
 
 	replay_stage_check_desync(global.replay_stage, global.frames, (tsrand() ^ global.plr.points) & 0xFFFF, global.replaymode);
@@ -633,11 +669,13 @@ static FrameAction stage_logic_frame(void *arg) {
 		progress.hiscore = global.plr.points;
 	}
 
+	bench_frame_end(stage->id, frame);
+
 	if(global.game_over > 0) {
 		return LFRAME_STOP;
 	}
 
-	if(global.frameskip || (global.replaymode == REPLAY_PLAY && gamekeypressed(KEY_SKIP))) {
+	if(global.frameskip || replay_is_seeking() || (global.replaymode == REPLAY_PLAY && gamekeypressed(KEY_SKIP))) {
 		return LFRAME_SKIP;
 	}
 
@@ -648,6 +686,10 @@ static FrameAction stage_render_frame(void *arg) {
 	StageFrameState *fstate = arg;
 	StageInfo *stage = fstate->stage;
 
+	if(replay_is_seeking()) {
+		return RFRAME_DROP;
+	}
+
 	tsrand_lock(&global.rand_game);
 	tsrand_switch(&global.rand_visual);
 	BEGIN_DRAW_CODE();
@@ -684,6 +726,13 @@ void stage_loop(StageInfo *stage) {
 	stage_preload();
 	stage_draw_init();
 
+	// New recordings always use deterministic math; older replays are played back with libm.
+	if(global.replaymode == REPLAY_RECORD) {
+		dmath_set_deterministic(true);
+	} else if(global.replay_stage) {
+		dmath_set_deterministic(global.replay_stage->flags & REPLAY_SFLAG_DETERMINISTIC_MATH);
+	}
+
 	uint32_t seed = (uint32_t)time(0);
 	tsrand_switch(&global.rand_game);
 	tsrand_seed_p(&global.rand_game, seed);
@@ -725,7 +774,8 @@ void stage_loop(StageInfo *stage) {
 		global.diff = stg->diff;
 		player_init(&global.plr);
 		replay_stage_sync_player_state(stg, &global.plr);
-		stg->playpos = 0;
+		replay_stage_seek(stg, 0);
+		replay_seek_stage_begin(stg);
 	}
 
 	player_stage_post_init(&global.plr);
@@ -753,6 +803,7 @@ void stage_loop(StageInfo *stage) {
 	tsrand_switch(&global.rand_visual);
 	free_all_refs();
 	ent_shutdown();
+	enemygrid_shutdown();
 	stage_objpools_free();
 	stop_sounds();
 
@@ -30,6 +30,18 @@ typedef struct CustomFramebuffer {
 	StageFBPair scaling_base;
 } CustomFramebuffer;
 
+enum {
+	SPELLCARD_U_RATIO,
+	SPELLCARD_U_ORIGIN,
+	SPELLCARD_U_T,
+};
+
+#define SPELLCARD_UNIFORM_NAMES { \
+	[SPELLCARD_U_RATIO]  = "ratio", \
+	[SPELLCARD_U_ORIGIN] = "origin", \
+	[SPELLCARD_U_T]      = "t", \
+}
+
 static struct {
 	struct {
 		ShaderProgram *shader;
@@ -40,6 +52,14 @@ static struct {
 			Color inactive;
 			Color label;
 		} color;
+
+		// these values change often; pinned layouts keep them from churning the font layout cache
+		struct {
+			TextLayout *hiscore;
+			TextLayout *score;
+			TextLayout *power;
+			TextLayout *graze;
+		} layouts;
 	} hud_text;
 
 	struct {
@@ -51,6 +71,11 @@ static struct {
 	FBPair fb_pairs[NUM_FBPAIRS];
 	CustomFramebuffer *custom_fbs;
 
+	struct {
+		UniformLayout spellcard_intro;
+		UniformLayout spellcard_outro;
+	} uniforms;
+
 	bool framerate_graphs;
 	bool objpool_stats;
 
@@ -63,7 +88,11 @@ static struct {
 		.active   = { 1.00, 1.00, 1.00, 1.00 },
 		.inactive = { 0.49, 0.49, 0.49, 0.70 },
 		.label    = { 0.49, 0.49, 0.49, 0.70 },
-	}
+	},
+	.uniforms = {
+		.spellcard_intro.names = SPELLCARD_UNIFORM_NAMES,
+		.spellcard_outro.names = SPELLCARD_UNIFORM_NAMES,
+	},
 };
 
 static double fb_scale(void) {
@@ -297,6 +326,10 @@ void stage_draw_init(void) {
 	stagedraw.viewport_pp = get_resource_data(RES_POSTPROCESS, "viewport", RESF_OPTIONAL);
 	stagedraw.hud_text.shader = r_shader_get("text_hud");
 	stagedraw.hud_text.font = get_font("hud");
+	stagedraw.hud_text.layouts.hiscore = text_layout_new();
+	stagedraw.hud_text.layouts.score = text_layout_new();
+	stagedraw.hud_text.layouts.power = text_layout_new();
+	stagedraw.hud_text.layouts.graze = text_layout_new();
 	stagedraw.shaders.fxaa = r_shader_get("fxaa");
 	stagedraw.shaders.copy_depth = r_shader_get("copy_depth");
 
@@ -318,6 +351,10 @@ void stage_draw_init(void) {
 void stage_draw_shutdown(void) {
 	events_unregister_handler(stage_draw_event);
 	stage_draw_destroy_framebuffers();
+	text_layout_free(stagedraw.hud_text.layouts.hiscore);
+	text_layout_free(stagedraw.hud_text.layouts.score);
+	text_layout_free(stagedraw.hud_text.layouts.power);
+	text_layout_free(stagedraw.hud_text.layouts.graze);
 }
 
 FBPair* stage_get_fbpair(StageFBPair id) {
@@ -557,17 +594,19 @@ static void apply_bg_shaders(ShaderRule *shaderrules, FBPair *fbos) {
 		float ratio = (float)VIEWPORT_H/VIEWPORT_W;
 
 		if(t<ATTACK_START_DELAY) {
-			r_shader("spellcard_intro");
+			ShaderProgram *shader = r_shader_get("spellcard_intro");
+			r_shader_ptr(shader);
 
-			r_uniform_float("ratio", ratio);
-			r_uniform_vec2("origin", creal(pos)/VIEWPORT_W, 1-cimag(pos)/VIEWPORT_H);
+			Uniform **u = r_uniform_layout(&stagedraw.uniforms.spellcard_intro, shader);
+			r_uniform_float(u[SPELLCARD_U_RATIO], ratio);
+			r_uniform_vec2(u[SPELLCARD_U_ORIGIN], creal(pos)/VIEWPORT_W, 1-cimag(pos)/VIEWPORT_H);
 
 			float delay = ATTACK_START_DELAY;
 			if(b->current->type == AT_ExtraSpell)
 				delay = ATTACK_START_DELAY_EXTRA;
 			float duration = ATTACK_START_DELAY_EXTRA;
 
-			r_uniform_float("t", (t+delay)/duration);
+			r_uniform_float(u[SPELLCARD_U_T], (t+delay)/duration);
 		} else if(b->current->endtime) {
 			int tn = global.frames - b->current->endtime;
 			ShaderProgram *shader = r_shader_get("spellcard_outro");
@@ -581,9 +620,10 @@ static void apply_bg_shaders(ShaderRule *shaderrules, FBPair *fbos) {
 				delay = ATTACK_END_DELAY_EXTRA;
 			}
 
-			r_uniform_float("ratio", ratio);
-			r_uniform_vec2("origin", creal(pos)/VIEWPORT_W, 1-cimag(pos)/VIEWPORT_H);
-			r_uniform_float("t", max(0,tn/delay+1));
+			Uniform **u = r_uniform_layout(&stagedraw.uniforms.spellcard_outro, shader);
+			r_uniform_float(u[SPELLCARD_U_RATIO], ratio);
+			r_uniform_vec2(u[SPELLCARD_U_ORIGIN], creal(pos)/VIEWPORT_W, 1-cimag(pos)/VIEWPORT_H);
+			r_uniform_float(u[SPELLCARD_U_T], max(0,tn/delay+1));
 		} else {
 			r_shader_standard();
 		}
@@ -832,7 +872,7 @@ static void draw_numeric_callback(Font *font, charcode_t charcode, SpriteParams
 
 static inline void stage_draw_hud_power_value(float ypos, char *buf, size_t bufsize) {
 	snprintf(buf, bufsize, "%i.%02i", global.plr.power / 100, global.plr.power % 100);
-	text_draw(buf, &(TextParams) {
+	text_layout_draw(stagedraw.hud_text.layouts.power, buf, &(TextParams) {
 		.pos = { 170, ypos },
 		.font = "mono",
 		.align = ALIGN_RIGHT,
@@ -843,9 +883,9 @@ static inline void stage_draw_hud_power_value(float ypos, char *buf, size_t bufs
 	});
 }
 
-static void stage_draw_hud_score(Alignment a, float xpos, float ypos, char *buf, size_t bufsize, uint32_t score) {
+static void stage_draw_hud_score(TextLayout *layout, float xpos, float ypos, char *buf, size_t bufsize, uint32_t score) {
 	snprintf(buf, bufsize, "%010u", score);
-	text_draw(buf, &(TextParams) {
+	text_layout_draw(layout, buf, &(TextParams) {
 		.pos = { xpos, ypos },
 		.font = "mono",
 		.align = ALIGN_RIGHT,
@@ -857,8 +897,8 @@ static void stage_draw_hud_score(Alignment a, float xpos, float ypos, char *buf,
 }
 
 static void stage_draw_hud_scores(float ypos_hiscore, float ypos_score, char *buf, size_t bufsize) {
-	stage_draw_hud_score(ALIGN_RIGHT, 170, (int)ypos_hiscore, buf, bufsize, progress.hiscore);
-	stage_draw_hud_score(ALIGN_RIGHT, 170, (int)ypos_score,   buf, bufsize, global.plr.points);
+	stage_draw_hud_score(stagedraw.hud_text.layouts.hiscore, 170, (int)ypos_hiscore, buf, bufsize, progress.hiscore);
+	stage_draw_hud_score(stagedraw.hud_text.layouts.score,   170, (int)ypos_score,   buf, bufsize, global.plr.points);
 }
 
 static void stage_draw_hud_objpool_stats(float x, float y, float width) {
@@ -961,7 +1001,7 @@ void stage_draw_hud_text(struct labels_s* labels) {
 
 	// Graze value
 	snprintf(buf, sizeof(buf), "%05i", global.plr.graze);
-	text_draw(buf, &(TextParams) {
+	text_layout_draw(stagedraw.hud_text.layouts.graze, buf, &(TextParams) {
 		.pos = { -6, labels->y.graze },
 		.shader_ptr = stagedraw.hud_text.shader,
 		.font = "mono",
@@ -16,12 +16,14 @@
 #include "aniplayer.h"
 
 #define MAX_projectiles             1024
+#define MAX_particles               MAX_projectiles
 #define MAX_items                   MAX_projectiles
 #define MAX_enemies                 64
 #define MAX_lasers                  64
 
 #define OBJECT_POOLS \
 	OBJECT_POOL(Projectile, projectiles) \
+	OBJECT_POOL(Projectile, particles) \
 	OBJECT_POOL(Item, items) \
 	OBJECT_POOL(Enemy, enemies) \
 	OBJECT_POOL(Laser, lasers) \
@@ -14,7 +14,8 @@
 typedef struct StageObjectPools {
 	union {
 		struct {
-			ObjectPool *projectiles;    // includes particles as well
+			ObjectPool *projectiles;
+			ObjectPool *particles;      // only those spawned into global.particles
 			ObjectPool *items;
 			ObjectPool *enemies;
 			ObjectPool *lasers;
@@ -54,7 +54,7 @@ static void stage_dpstest_multi_events(void) {
 
 static void stage_dpstest_boss_rule(Boss *b, int t) {
 	if(t >= 0) {
-		double x = pow((b->current->maxhp - b->current->hp) / b->current->maxhp, 0.75) * b->current->maxhp;
+		double x = sim_pow((b->current->maxhp - b->current->hp) / b->current->maxhp, 0.75) * b->current->maxhp;
 		b->current->hp = clamp(b->current->hp + x * 0.0025, b->current->maxhp * 0.05, b->current->maxhp);
 	}
 }
@@ -58,7 +58,7 @@ int cirno_snowflake_proj(Projectile *p, int time) {
 			);
 		}
 
-		p->pos -= cabs(p->args[0]) * cexp(I*p->angle);
+		p->pos -= sim_cabs(p->args[0]) * sim_cexp(I*p->angle);
 	}
 
 	return 1;
@@ -68,7 +68,7 @@ void cirno_icy(Boss *b, int time) {
 	int interval = 70 - 8 * global.diff;
 	int t = time % interval;
 	int run = time / interval;
-	int size = 5+3*sin(337*run);
+	int size = 5+3*sim_sin(337*run);
 
 	TIMER(&t);
 
@@ -76,14 +76,14 @@ void cirno_icy(Boss *b, int time) {
 		return;
 	}
 
-	complex vel = (1+0.125*global.diff)*cexp(I*fmod(200*run,M_PI));
+	complex vel = (1+0.125*global.diff)*sim_cexp(I*fmod(200*run,M_PI));
 	int c = 6;
 	double dr = 15;
 
 	FROM_TO_SND("shot1_loop", 0, 3*size, 3) {
 		for(int i = 0; i < c; i++) {
 			double ang = 2*M_PI/c*i+run*515;
-			complex phase = cexp(I*ang);
+			complex phase = sim_cexp(I*ang);
 
 			complex pos = b->pos+vel*t+dr*_i*phase;
 
@@ -111,7 +111,7 @@ void cirno_icy(Boss *b, int time) {
 			if(_i > split) {
 				complex pos0 = b->pos+vel*t+dr*split*phase;
 				for(int j = -1; j <= 1; j+=2) {
-					complex phase2 = cexp(I*M_PI/4*j)*phase;
+					complex phase2 = sim_cexp(I*M_PI/4*j)*phase;
 					complex pos = pos0+(dr*(_i-split))*phase2;
 
 					PROJECTILE(
@@ -169,7 +169,7 @@ int cirno_pfreeze_frogs(Projectile *p, int t) {
 
 	if(t == 240) {
 		p->pos0 = p->pos;
-		p->args[0] = (1.8+0.2*global.diff)*cexp(I*2*M_PI*frand());
+		p->args[0] = (1.8+0.2*global.diff)*sim_cexp(I*2*M_PI*frand());
 		spawn_stain(p->pos, p->angle, 30);
 		play_sound_ex("shot2", 0, false);
 	}
@@ -203,7 +203,7 @@ void cirno_perfect_freeze(Boss *c, int time) {
 				.pos = c->pos,
 				.color = RGB(r, g, b),
 				.rule = cirno_pfreeze_frogs,
-				.args = { 4*cexp(I*tsrand()) },
+				.args = { 4*sim_cexp(I*tsrand()) },
 			);
 		}
 	}
@@ -219,8 +219,8 @@ void cirno_perfect_freeze(Boss *c, int time) {
 		float r1, r2;
 
 		if(global.diff > D_Normal) {
-			r1 = sin(time/M_PI*5.3) * cos(2*time/M_PI*5.3);
-			r2 = cos(time/M_PI*5.3) * sin(2*time/M_PI*5.3);
+			r1 = sim_sin(time/M_PI*5.3) * sim_cos(2*time/M_PI*5.3);
+			r2 = sim_cos(time/M_PI*5.3) * sim_sin(2*time/M_PI*5.3);
 		} else {
 			r1 = nfrand();
 			r2 = nfrand();
@@ -231,14 +231,14 @@ void cirno_perfect_freeze(Boss *c, int time) {
 			.pos = c->pos + 60,
 			.color = RGB(0.3, 0.4, 0.9),
 			.rule = asymptotic,
-			.args = { (2.+0.2*global.diff)*cexp(I*(carg(global.plr.pos - c->pos) + 0.5*r1)), 2.5 }
+			.args = { (2.+0.2*global.diff)*sim_cexp(I*(sim_carg(global.plr.pos - c->pos) + 0.5*r1)), 2.5 }
 		);
 		PROJECTILE(
 			.proto = pp_rice,
 			.pos = c->pos - 60,
 			.color = RGB(0.3, 0.4, 0.9),
 			.rule = asymptotic,
-			.args = { (2.+0.2*global.diff)*cexp(I*(carg(global.plr.pos - c->pos) + 0.5*r2)), 2.5 }
+			.args = { (2.+0.2*global.diff)*sim_cexp(I*(sim_carg(global.plr.pos - c->pos) + 0.5*r2)), 2.5 }
 		);
 	}
 
@@ -317,7 +317,7 @@ void cirno_iceplosion0(Boss *c, int time) {
 				.pos = c->pos,
 				.color = RGB(0,0,0.5),
 				.rule = asymptotic,
-				.args = { (3+_i/3.0)*cexp(I*(2*M_PI/n*i + carg(global.plr.pos-c->pos))), _i*0.7 }
+				.args = { (3+_i/3.0)*sim_cexp(I*(2*M_PI/n*i + sim_carg(global.plr.pos-c->pos))), _i*0.7 }
 			);
 		}
 	}
@@ -328,7 +328,7 @@ void cirno_iceplosion0(Boss *c, int time) {
 			.pos = c->pos,
 			.color = RGB(0.3,0.3,0.8),
 			.rule = accelerated,
-			.args = { global.diff/4.*cexp(2.0*I*M_PI*frand()) + 2.0*I, 0.002*cexp(I*(M_PI/10.0*(_i%20))) }
+			.args = { global.diff/4.*sim_cexp(2.0*I*M_PI*frand()) + 2.0*I, 0.002*sim_cexp(I*(M_PI/10.0*(_i%20))) }
 		);
 	}
 
@@ -342,7 +342,7 @@ void cirno_iceplosion0(Boss *c, int time) {
 				.pos = c->pos,
 				.color = RGB(0.04*_i,0.04*_i,0.4+0.04*_i),
 				.rule = asymptotic,
-				.args = { (3+_i/4.0)*cexp(I*(2*M_PI/8.0*i + dif)), 2.5 }
+				.args = { (3+_i/4.0)*sim_cexp(I*(2*M_PI/8.0*i + dif)), 2.5 }
 			);
 		}
 	}
@@ -390,7 +390,7 @@ void cirno_crystal_rain(Boss *c, int time) {
 				.pos = c->pos,
 				.color = RGB(0.2,0.2,0.9),
 				.rule = asymptotic,
-				.args = { 2*cexp(I*carg(global.plr.pos-c->pos)+0.3*I*i), 2.3 }
+				.args = { 2*sim_cexp(I*sim_carg(global.plr.pos-c->pos)+0.3*I*i), 2.3 }
 			);
 		}
 	}
@@ -421,13 +421,13 @@ void cirno_iceplosion1(Boss *c, int time) {
 	FROM_TO(20,30,2) {
 		int i;
 		for(i = 0; i < 15+global.diff; i++) {
-			PROJECTILE("plainball", c->pos, RGB(0,0,0.5), asymptotic, { (3+_i/3.0)*cexp(I*((2)*M_PI/8.0*i + (0.1+0.03*global.diff)*(1 - 2*frand()))), _i*0.7 });
+			PROJECTILE("plainball", c->pos, RGB(0,0,0.5), asymptotic, { (3+_i/3.0)*sim_cexp(I*((2)*M_PI/8.0*i + (0.1+0.03*global.diff)*(1 - 2*frand()))), _i*0.7 });
 		}
 	}
 
 	FROM_TO_SND("shot1_loop",40,100,2+2*(global.diff<D_Hard)) {
-		PROJECTILE("crystal", c->pos + 100, RGB(0.3,0.3,0.8), accelerated, { 1.5*cexp(2.0*I*M_PI*frand()) - 0.4 + 2.0*I*global.diff/4., 0.002*cexp(I*(M_PI/10.0*(_i%20))) });
-		PROJECTILE("crystal", c->pos - 100, RGB(0.3,0.3,0.8), accelerated, { 1.5*cexp(2.0*I*M_PI*frand()) + 0.4 + 2.0*I*global.diff/4., 0.002*cexp(I*(M_PI/10.0*(_i%20))) });
+		PROJECTILE("crystal", c->pos + 100, RGB(0.3,0.3,0.8), accelerated, { 1.5*sim_cexp(2.0*I*M_PI*frand()) - 0.4 + 2.0*I*global.diff/4., 0.002*sim_cexp(I*(M_PI/10.0*(_i%20))) });
+		PROJECTILE("crystal", c->pos - 100, RGB(0.3,0.3,0.8), accelerated, { 1.5*sim_cexp(2.0*I*M_PI*frand()) + 0.4 + 2.0*I*global.diff/4., 0.002*sim_cexp(I*(M_PI/10.0*(_i%20))) });
 	}
 
 	FROM_TO(150, 300, 30 - 6 * global.diff) {
@@ -440,7 +440,7 @@ void cirno_iceplosion1(Boss *c, int time) {
 
 		play_sound("shot1");
 		for(i = 0; i < 20; i++) {
-			PROJECTILE("plainball", c->pos, RGB(0.04*_i,0.04*_i,0.4+0.04*_i), asymptotic, { (3+_i/3.0)*cexp(I*(2*M_PI/8.0*i + dif)), 2.5 });
+			PROJECTILE("plainball", c->pos, RGB(0.04*_i,0.04*_i,0.4+0.04*_i), asymptotic, { (3+_i/3.0)*sim_cexp(I*(2*M_PI/8.0*i + dif)), 2.5 });
 		}
 	}
 }
@@ -474,7 +474,7 @@ static void halation_laser(Laser *l, int time) {
 
 static complex halation_calc_orb_pos(complex center, float rotation, int proj, int projs) {
 	double f = (double)((proj % projs)+0.5)/projs;
-	return 200 * cexp(I*(rotation + f * 2 * M_PI)) + center;
+	return 200 * sim_cexp(I*(rotation + f * 2 * M_PI)) + center;
 }
 
 static int halation_orb(Projectile *p, int time) {
@@ -541,7 +541,7 @@ static int halation_orb(Projectile *p, int time) {
 		float rot = frand() * 2 * M_PI;
 
 		for(int i = 0; i < pcount; ++i) {
-			PROJECTILE("crystal", p->pos, colors+i, asymptotic, { cexp(I*(rot + M_PI * 2 * (float)(i+1)/pcount)), 3 });
+			PROJECTILE("crystal", p->pos, colors+i, asymptotic, { sim_cexp(I*(rot + M_PI * 2 * (float)(i+1)/pcount)), 3 });
 		}
 
 		return ACTION_DESTROY;
@@ -610,7 +610,7 @@ void cirno_snow_halation(Boss *c, int time) {
 	AT(100 + interval * projs/2) {
 		aniplayer_queue(&c->ani,"main",0);
 
-		if(cabs(global.plr.pos-center)>cabs(halation_calc_orb_pos(0,0,0,projs))) {
+		if(sim_cabs(global.plr.pos-center)>sim_cabs(halation_calc_orb_pos(0,0,0,projs))) {
 			char *text[] = {
 				"",
 				"What are you doing??",
@@ -635,16 +635,16 @@ int cirno_icicles(Projectile *p, int t) {
 
 	if(t < 0) {
 		if(t == EVENT_BIRTH) {
-			p->angle = carg(p->args[0]);
+			p->angle = sim_carg(p->args[0]);
 		}
 
 		return ACTION_ACK;
 	}
 
 	if(t < turn) {
-		p->pos += p->args[0]*pow(0.9,t);
+		p->pos += p->args[0]*sim_pow(0.9,t);
 	} else if(t == turn) {
-		p->args[0] = 2.5*cexp(I*(carg(p->args[0])-M_PI/2.0+M_PI*(creal(p->args[0]) > 0)));
+		p->args[0] = 2.5*sim_cexp(I*(sim_carg(p->args[0])-M_PI/2.0+M_PI*(creal(p->args[0]) > 0)));
 		if(global.diff > D_Normal)
 			p->args[0] += 0.05*nfrand();
 		play_sound("redirect");
@@ -652,7 +652,7 @@ int cirno_icicles(Projectile *p, int t) {
 		p->pos += p->args[0];
 	}
 
-	p->angle = carg(p->args[0]);
+	p->angle = sim_carg(p->args[0]);
 
 	return ACTION_NONE;
 }
@@ -674,8 +674,8 @@ void cirno_icicle_fall(Boss *c, int time) {
 	FROM_TO(20,200,30-3*global.diff) {
 		play_sound("shot1");
 		for(float i = 2-0.2*global.diff; i < 5; i+=1./(1+global.diff)) {
-			PROJECTILE("crystal", c->pos, RGB(0.3,0.3,0.9), cirno_icicles, { 6*i*cexp(I*(-0.1+0.1*_i)) });
-			PROJECTILE("crystal", c->pos, RGB(0.3,0.3,0.9), cirno_icicles, { 6*i*cexp(I*(M_PI+0.1-0.1*_i)) });
+			PROJECTILE("crystal", c->pos, RGB(0.3,0.3,0.9), cirno_icicles, { 6*i*sim_cexp(I*(-0.1+0.1*_i)) });
+			PROJECTILE("crystal", c->pos, RGB(0.3,0.3,0.9), cirno_icicles, { 6*i*sim_cexp(I*(M_PI+0.1-0.1*_i)) });
 		}
 	}
 
@@ -695,12 +695,12 @@ void cirno_icicle_fall(Boss *c, int time) {
 			float angle2 = M_PI/10*frand();
 			for(float i = 1; i < 5; i++) {
 				PROJECTILE("ball", x, RGB(0.,0.,0.3), accelerated, {
-					i*I*0.5*cexp(I*angle1),
+					i*I*0.5*sim_cexp(I*angle1),
 					0.001*I-(global.diff == D_Lunatic)*0.001*frand()
 				});
 
 				PROJECTILE("ball", VIEWPORT_W-x, RGB(0.,0.,0.3), accelerated, {
-					i*I*0.5*cexp(-I*angle2),
+					i*I*0.5*sim_cexp(-I*angle2),
 					0.001*I+(global.diff == D_Lunatic)*0.001*frand()
 				});
 			}
@@ -745,7 +745,7 @@ void cirno_crystal_blizzard(Boss *c, int time) {
 				.color = i % 2? RGB(0.2,0.2,0.4) : RGB(0.5,0.5,0.5),
 				.rule = accelerated,
 				.args = {
-					0, 0.02*I + 0.01*I * (i % 2? 1 : -1) * sin((i*3+global.frames)/30.0)
+					0, 0.02*I + 0.01*I * (i % 2? 1 : -1) * sim_sin((i*3+global.frames)/30.0)
 				},
 			);
 		}
@@ -766,7 +766,7 @@ void cirno_crystal_blizzard(Boss *c, int time) {
 				.color = RGBA(0.2, 0.2, 0.4, 0.0),
 				.rule = cirno_crystal_blizzard_proj,
 				.args = {
-					20 * (0.1 + 0.1 * anfrand(0)) * cexp(I*(carg(global.plr.pos - c->pos) + anfrand(1) * 0.2)),
+					20 * (0.1 + 0.1 * anfrand(0)) * sim_cexp(I*(sim_carg(global.plr.pos - c->pos) + anfrand(1) * 0.2)),
 					5
 				},
 			);
@@ -781,7 +781,7 @@ void cirno_crystal_blizzard(Boss *c, int time) {
 					.pos = c->pos,
 					.color = RGBA(0.1, 0.1, 0.5, 0.0),
 					.rule = accelerated,
-					.args = { 0, 0.01 * cexp(I*(global.frames/20.0 + 2*i*M_PI/cnt)) },
+					.args = { 0, 0.01 * sim_cexp(I*(global.frames/20.0 + 2*i*M_PI/cnt)) },
 				);
 			}
 		}
@@ -870,7 +870,7 @@ int stage1_burst(Enemy *e, int time) {
 		play_sound("shot1");
 		for(i = -n; i <= n; i++) {
 			PROJECTILE("crystal", e->pos, RGB(0.2, 0.3, 0.5), asymptotic, {
-				(2+0.1*global.diff)*cexp(I*(carg(global.plr.pos - e->pos) + 0.2*i)),
+				(2+0.1*global.diff)*sim_cexp(I*(sim_carg(global.plr.pos - e->pos) + 0.2*i)),
 				5
 			});
 		}
@@ -902,7 +902,7 @@ int stage1_circletoss(Enemy *e, int time) {
 	FROM_TO_SND("shot1_loop",60,60+dur,inter) {
 		e->args[0] = 0.8*e->args[0];
 		PROJECTILE("rice", e->pos, RGB(0.6, 0.2, 0.7), asymptotic, {
-			2*cexp(I*2*M_PI*inter/dur*_i),
+			2*sim_cexp(I*2*M_PI*inter/dur*_i),
 			_i/2.0
 		});
 	}
@@ -911,7 +911,7 @@ int stage1_circletoss(Enemy *e, int time) {
 		FROM_TO_INT_SND("shot1_loop",90,500,150,5+7*global.diff,1) {
 			tsrand_fill(2);
 			PROJECTILE("thickrice", e->pos, RGB(0.2, 0.4, 0.8), asymptotic, {
-				(1+afrand(0)*2)*cexp(I*carg(global.plr.pos - e->pos)+0.05*I*global.diff*anfrand(1)),
+				(1+afrand(0)*2)*sim_cexp(I*sim_carg(global.plr.pos - e->pos)+0.05*I*global.diff*anfrand(1)),
 				3
 			});
 		}
@@ -937,7 +937,7 @@ int stage1_sinepass(Enemy *e, int time) {
 	if(frand() > 0.997-0.005*(global.diff-1)) {
 		play_sound("shot1");
 		PROJECTILE("ball", e->pos, RGB(0.8,0.8,0.4), linear, {
-			(1+0.2*global.diff+frand())*cexp(I*carg(global.plr.pos - e->pos))
+			(1+0.2*global.diff+frand())*sim_cexp(I*sim_carg(global.plr.pos - e->pos))
 		});
 	}
 
@@ -959,7 +959,7 @@ int stage1_drop(Enemy *e, int t) {
 		if(frand() > 0.997-0.007*(global.diff-1)) {
 			play_sound("shot1");
 			PROJECTILE("ball", e->pos, RGB(0.8,0.8,0.4), linear, {
-				(1+0.3*global.diff+frand())*cexp(I*carg(global.plr.pos - e->pos))
+				(1+0.3*global.diff+frand())*sim_cexp(I*sim_carg(global.plr.pos - e->pos))
 			});
 		}
 	}
@@ -979,7 +979,7 @@ int stage1_circle(Enemy *e, int t) {
 
 	FROM_TO_INT_SND("shot1_loop",150, 550, 40, 40, 2+2*(global.diff<D_Hard)) {
 		PROJECTILE("rice", e->pos, RGB(0.6, 0.2, 0.7), asymptotic, {
-			(1.7+0.2*global.diff)*cexp(I*M_PI/10*_ni),
+			(1.7+0.2*global.diff)*sim_cexp(I*M_PI/10*_ni),
 			_ni/2.0
 		});
 	}
@@ -1007,7 +1007,7 @@ int stage1_multiburst(Enemy *e, int t) {
 		int n = global.diff-1;
 		for(i = -n; i <= n; i++) {
 			PROJECTILE("crystal", e->pos, RGB(0.2, 0.3, 0.5), linear, {
-				2.5*cexp(I*(carg(global.plr.pos - e->pos) + i/5.0))
+				2.5*sim_cexp(I*(sim_carg(global.plr.pos - e->pos) + i/5.0))
 			});
 		}
 	}
@@ -1031,7 +1031,7 @@ int stage1_instantcircle(Enemy *e, int t) {
 		play_sound("shot_special1");
 		for(int i = 0; i < 20+2*global.diff; i++) {
 			PROJECTILE("rice", e->pos, RGB(0.6, 0.2, 0.7), asymptotic, {
-				1.5*cexp(I*2*M_PI/(20.0+global.diff)*i),
+				1.5*sim_cexp(I*2*M_PI/(20.0+global.diff)*i),
 				2.0
 			});
 		}
@@ -1042,7 +1042,7 @@ int stage1_instantcircle(Enemy *e, int t) {
 			play_sound("shot_special1");
 			for(int i = 0; i < 20+3*global.diff; i++) {
 				PROJECTILE("rice", e->pos, RGB(0.6, 0.2, 0.7), asymptotic, {
-					3*cexp(I*2*M_PI/(20.0+global.diff)*i),
+					3*sim_cexp(I*2*M_PI/(20.0+global.diff)*i),
 					3.0
 				});
 			}
@@ -1077,7 +1077,7 @@ int stage1_tritoss(Enemy *e, int t) {
 
 		for(i = 0; i < n; i++){
 			PROJECTILE("thickrice", e->pos, RGB(0.2, 0.4, 0.8), asymptotic, {
-				2*cexp(I*a+2.0*I*M_PI/n*i),
+				2*sim_cexp(I*a+2.0*I*M_PI/n*i),
 				3
 			});
 		}
@@ -1088,13 +1088,13 @@ int stage1_tritoss(Enemy *e, int t) {
 		int i, n = 15 + global.diff*3;
 		for(i = 0; i < n; i++) {
 			PROJECTILE("rice", e->pos, RGB(0.6, 0.2, 0.7), asymptotic, {
-				1.5*cexp(I*2*M_PI/n*i),
+				1.5*sim_cexp(I*2*M_PI/n*i),
 				2.0
 			});
 
 			if(global.diff > D_Easy) {
 				PROJECTILE("rice", e->pos, RGB(0.6, 0.2, 0.7), asymptotic, {
-					3*cexp(I*2*M_PI/n*i),
+					3*sim_cexp(I*2*M_PI/n*i),
 					3.0
 				});
 			}
@@ -1200,7 +1200,7 @@ void stage1_events(void) {
 
 	// bursts
 	FROM_TO(1250, 1800, 60) {
-		create_enemy1c(VIEWPORT_W/2 - 200 * sin(1.17*global.frames), 500, Fairy, stage1_burst, nfrand());
+		create_enemy1c(VIEWPORT_W/2 - 200 * sim_sin(1.17*global.frames), 500, Fairy, stage1_burst, nfrand());
 	}
 
 	// circle - multi burst combo
@@ -1225,12 +1225,12 @@ void stage1_events(void) {
 	}
 
 	FROM_TO(2900, 3750, 190-30*global.diff) {
-		create_enemy2c(VIEWPORT_W/2 + 205 * sin(2.13*global.frames), 1200, Fairy, stage1_instantcircle, 2.0*I, 3.0 - 6*frand() - 1.0*I);
+		create_enemy2c(VIEWPORT_W/2 + 205 * sim_sin(2.13*global.frames), 1200, Fairy, stage1_instantcircle, 2.0*I, 3.0 - 6*frand() - 1.0*I);
 	}
 
 	// multiburst + normal circletoss, later tri-toss
 	FROM_TO(3900, 4800, 200) {
-		create_enemy1c(VIEWPORT_W/2 - 195 * cos(2.43*global.frames), 1000, Fairy, stage1_multiburst, 2.5*frand());
+		create_enemy1c(VIEWPORT_W/2 - 195 * sim_cos(2.43*global.frames), 1000, Fairy, stage1_multiburst, 2.5*frand());
 	}
 
 	FROM_TO(4000, 4100, 20)
@@ -49,7 +49,7 @@ int stage2_great_circle(Enemy *e, int t) {
 
 
 		for(n = 0; n < c; n++) {
-			complex dir = cexp(I*(2*M_PI/c*n+partdist*(_i%c2-c2/2)+bunchdist*(_i/c2)));
+			complex dir = sim_cexp(I*(2*M_PI/c*n+partdist*(_i%c2-c2/2)+bunchdist*(_i/c2)));
 
 			PROJECTILE("rice", e->pos+30*dir, RGB(0.6,0.0,0.3), asymptotic, {
 				1.5*dir,
@@ -59,7 +59,7 @@ int stage2_great_circle(Enemy *e, int t) {
 			if(global.diff > D_Easy && _i%7 == 0) {
 				play_sound("shot1");
 				PROJECTILE("bigball", e->pos+30*dir, RGB(0.3,0.0,0.6), linear, {
-					1.7*dir*cexp(0.3*I*frand())
+					1.7*dir*sim_cexp(0.3*I*frand())
 				});
 			}
 		}
@@ -99,7 +99,7 @@ int stage2_small_spin_circle(Enemy *e, int t) {
 		}
 
 		PROJECTILE("ball", e->pos, RGB(0.9,0.0,0.3), linear, {
-			pow(global.diff,0.7)*(conj(e->pos-VIEWPORT_W/2)/100 + ((1-2*e->dir)+3.0*I))
+			sim_pow(global.diff,0.7)*(conj(e->pos-VIEWPORT_W/2)/100 + ((1-2*e->dir)+3.0*I))
 		});
 	}
 
@@ -122,12 +122,12 @@ int stage2_aim(Enemy *e, int t) {
 		if(global.diff > D_Normal) {
 			play_sound("shot1");
 			PROJECTILE("plainball", e->pos, RGB(0.6,0.0,0.8), asymptotic, {
-				5*cexp(I*carg(global.plr.pos-e->pos)),
+				5*sim_cexp(I*sim_carg(global.plr.pos-e->pos)),
 				-1
 			});
 
 			PROJECTILE("plainball", e->pos, RGB(0.2,0.0,0.1), linear, {
-				3*cexp(I*carg(global.plr.pos-e->pos))
+				3*sim_cexp(I*sim_carg(global.plr.pos-e->pos))
 			});
 		}
 	}
@@ -142,7 +142,7 @@ int stage2_sidebox_trail(Enemy *e, int t) { // creal(a[0]): velocity, cimag(a[0]
 		return 1;
 	}
 
-	e->pos += creal(e->args[0])*cexp(I*cimag(e->args[0]));
+	e->pos += creal(e->args[0])*sim_cexp(I*cimag(e->args[0]));
 
 	FROM_TO((int) creal(e->args[2]),(int) creal(e->args[2])+M_PI*0.5/fabs(creal(e->args[1])),1)
 		e->args[0] += creal(e->args[1])*I;
@@ -154,8 +154,8 @@ int stage2_sidebox_trail(Enemy *e, int t) { // creal(a[0]): velocity, cimag(a[0]
 		if(global.diff > D_Normal)
 			f = 0.03*global.diff*frand();
 
-		PROJECTILE("rice", e->pos, RGB(0.9,0.0,0.9), linear, { 3*cexp(I*(cimag(e->args[0])+f+0.5*M_PI)) });
-		PROJECTILE("rice", e->pos, RGB(0.9,0.0,0.9), linear, { 3*cexp(I*(cimag(e->args[0])-f-0.5*M_PI)) });
+		PROJECTILE("rice", e->pos, RGB(0.9,0.0,0.9), linear, { 3*sim_cexp(I*(cimag(e->args[0])+f+0.5*M_PI)) });
+		PROJECTILE("rice", e->pos, RGB(0.9,0.0,0.9), linear, { 3*sim_cexp(I*(cimag(e->args[0])-f-0.5*M_PI)) });
 	}
 
 	return 1;
@@ -181,7 +181,7 @@ int stage2_flea(Enemy *e, int t) {
 		if(global.diff != D_Easy) {
 			play_sound("shot1");
 			PROJECTILE("flea", e->pos, RGB(0.3,0.2,1), asymptotic, {
-				1.5*cexp(2.0*I*M_PI*frand()),
+				1.5*sim_cexp(2.0*I*M_PI*frand()),
 				1.5
 			});
 		}
@@ -206,8 +206,8 @@ int stage2_accel_circle(Enemy *e, int t) {
 		for(i = 0; i < 6; i++) {
 			play_sound("redirect");
 			PROJECTILE("ball", e->pos, RGB(0.9,0.1,0.2), accelerated, {
-				1.5*cexp(2.0*I*M_PI/6*i)+cexp(I*carg(global.plr.pos - e->pos)),
-				-0.02*cexp(I*(2*M_PI/6*i+0.02*frand()*global.diff))
+				1.5*sim_cexp(2.0*I*M_PI/6*i)+sim_cexp(I*sim_carg(global.plr.pos - e->pos)),
+				-0.02*sim_cexp(I*(2*M_PI/6*i+0.02*frand()*global.diff))
 			});
 		}
 	}
@@ -226,7 +226,7 @@ static void wriggle_ani_flyin(Boss *w) {
 static void wriggle_intro_stage2(Boss *w, int t) {
 	if(t < 0)
 		return;
-	w->pos = VIEWPORT_W/2 + 100.0*I + 300*(1.0-t/(4.0*FPS))*cexp(I*(3-t*0.04));
+	w->pos = VIEWPORT_W/2 + 100.0*I + 300*(1.0-t/(4.0*FPS))*sim_cexp(I*(3-t*0.04));
 }
 
 int wriggle_bug(Projectile *p, int t) {
@@ -235,11 +235,11 @@ int wriggle_bug(Projectile *p, int t) {
 	}
 
 	p->pos += p->args[0];
-	p->angle = carg(p->args[0]);
+	p->angle = sim_carg(p->args[0]);
 
 	if(global.boss && global.boss->current && !((global.frames - global.boss->current->starttime - 30) % 200)) {
 		play_sound("redirect");
-		p->args[0] *= cexp(I*(M_PI/3)*nfrand());
+		p->args[0] *= sim_cexp(I*(M_PI/3)*nfrand());
 		PARTICLE(
 			.sprite = "flare",
 			.pos = p->pos,
@@ -260,8 +260,8 @@ void wriggle_small_storm(Boss *w, int time) {
 		return;
 
 	FROM_TO_SND("shot1_loop", 0,400,5-global.diff) {
-		PROJECTILE("rice", w->pos, RGB(1,0.5,0.2), wriggle_bug, { 2*cexp(I*_i*2*M_PI/20) });
-		PROJECTILE("rice", w->pos, RGB(1,0.5,0.2), wriggle_bug, { 2*cexp(I*_i*2*M_PI/20+I*M_PI) });
+		PROJECTILE("rice", w->pos, RGB(1,0.5,0.2), wriggle_bug, { 2*sim_cexp(I*_i*2*M_PI/20) });
+		PROJECTILE("rice", w->pos, RGB(1,0.5,0.2), wriggle_bug, { 2*sim_cexp(I*_i*2*M_PI/20+I*M_PI) });
 	}
 
 	GO_AT(w, 60, 120, 1)
@@ -280,7 +280,7 @@ void wriggle_small_storm(Boss *w, int time) {
 
 		for(i = 0; i < 10+global.diff; i++) {
 			PROJECTILE("bigball", w->pos, RGB(0.1,0.3,0.0), asymptotic, {
-				2*cexp(I*i*2*M_PI/(10+global.diff)),
+				2*sim_cexp(I*i*2*M_PI/(10+global.diff)),
 				2
 			});
 		}
@@ -329,8 +329,8 @@ void hina_cards1(Boss *h, int time) {
 	}
 	FROM_TO(0, 500, 2-(global.diff > D_Normal)) {
 		play_sound_ex("shot1", 4, false);
-		PROJECTILE("card", h->pos+50*cexp(I*t/10), RGB(0.8,0.0,0.0), asymptotic, { (1.6+0.4*global.diff)*cexp(I*t/5.0), 3 });
-		PROJECTILE("card", h->pos-50*cexp(I*t/10), RGB(0.0,0.0,0.8), asymptotic, {-(1.6+0.4*global.diff)*cexp(I*t/5.0), 3 });
+		PROJECTILE("card", h->pos+50*sim_cexp(I*t/10), RGB(0.8,0.0,0.0), asymptotic, { (1.6+0.4*global.diff)*sim_cexp(I*t/5.0), 3 });
+		PROJECTILE("card", h->pos-50*sim_cexp(I*t/10), RGB(0.0,0.0,0.8), asymptotic, {-(1.6+0.4*global.diff)*sim_cexp(I*t/5.0), 3 });
 	}
 }
 
@@ -352,12 +352,12 @@ void hina_amulet(Boss *h, int time) {
 	}
 	FROM_TO_SND("shot1_loop", 0,loopduration,1) {
 		float f = _i/30.0;
-		complex n = cexp(I*2*M_PI*f+I*carg(d)+0.7*time/200*I)/sqrt(0.5+global.diff);
+		complex n = sim_cexp(I*2*M_PI*f+I*sim_carg(d)+0.7*time/200*I)/sqrt(0.5+global.diff);
 
 		float speed = 1.0 + 0.75 * max(0, (int)global.diff - D_Normal);
 		float accel = 1.0 + 1.20 * max(0, (int)global.diff - D_Normal);
 
-		complex p = h->pos+30*log(1+_i/2.0)*n;
+		complex p = h->pos+30*sim_log(1+_i/2.0)*n;
 
 		const char *t0 = "ball";
 		const char *t1 = global.diff == D_Easy ? t0 : "crystal";
@@ -385,7 +385,7 @@ void hina_cards2(Boss *h, int time) {
 		for(i = 0; i < 30; i++) {
 			play_sound("shot_special1");
 			PROJECTILE("bigball", h->pos, RGB(0.7, 0, 0.7), asymptotic, {
-				2*cexp(I*2*M_PI*i/20.0),
+				2*sim_cexp(I*2*M_PI*i/20.0),
 				3
 			});
 		}
@@ -499,13 +499,13 @@ void hina_wheel(Boss *h, int time) {
 		int i;
 		float speed = 10;
 		if(time > 500)
-			speed = 1+9*exp(-(time-500)/100.0);
+			speed = 1+9*sim_exp(-(time-500)/100.0);
 
 		float d = max(0, (int)global.diff - D_Normal);
 
 		for(i = 1; i < 6+d; i++) {
 			float a = dir * 2*M_PI/(5+d)*(i+(1 + 0.4 * d)*time/100.0+(1 + 0.2 * d)*frand()*time/1700.0);
-			PROJECTILE("crystal", h->pos, RGB(log(1+time*1e-3),0,0.2), linear, { speed*cexp(I*a) });
+			PROJECTILE("crystal", h->pos, RGB(sim_log(1+time*1e-3),0,0.2), linear, { speed*sim_cexp(I*a) });
 		}
 	}
 }
@@ -522,7 +522,7 @@ static int timeout_deadproj_linear(Projectile *p, int time) {
 	}
 
 	p->pos += p->args[1];
-	p->angle = carg(p->args[1]);
+	p->angle = sim_carg(p->args[1]);
 	return ACTION_NONE;
 }
 
@@ -538,7 +538,7 @@ int hina_monty_slave(Enemy *s, int time) {
 			.color = RGB(0.5 + 0.5 * psin(time*0.2), 0.3, 1.0 - 0.5 * psin(time*0.2)),
 			.rule = asymptotic,
 			.args = {
-				5*I + 1 * (sin(time) + I * cos(time)),
+				5*I + 1 * (sim_sin(time) + I * sim_cos(time)),
 				4
 			}
 		);
@@ -549,7 +549,7 @@ int hina_monty_slave(Enemy *s, int time) {
 				.rule = timeout_deadproj_linear,
 				.args = {
 					500,
-					-0.5*I + 1 * (sin(time) + I * cos(time))
+					-0.5*I + 1 * (sim_sin(time) + I * sim_cos(time))
 				}
 			);
 		}
@@ -676,7 +676,7 @@ void hina_monty(Boss *h, int time) {
 				.rule = accelerated,
 				.args = {
 					0,
-					(top ? -0.5 : 1) * 0.004 * (sin((M_PI * 4 * i / (cnt - 1)))*0.1*global.diff - I*(1 + psin(i + global.frames)))
+					(top ? -0.5 : 1) * 0.004 * (sim_sin((M_PI * 4 * i / (cnt - 1)))*0.1*global.diff - I*(1 + psin(i + global.frames)))
 				},
 			);
 		}
@@ -46,7 +46,7 @@ static int stage3_enterswirl(Enemy *e, int t) {
 		int cnt = 24 - (D_Lunatic - global.diff) * 4;
 		for(int i = 0; i < cnt; ++i) {
 			double a = (M_PI * 2.0 * i) / cnt;
-			complex dir = cexp(I*a);
+			complex dir = sim_cexp(I*a);
 
 			PROJECTILE(e->args[1]? "ball" : "rice", e->pos, RGB(r, g, 1.0), asymptotic, {
 				1.5 * dir,
@@ -87,7 +87,7 @@ static int stage3_slavefairy(Enemy *e, int t) {
 
 	FROM_TO_SND("shot1_loop", 30, 120, 5 - global.diff) {
 		float a = _i * 0.5;
-		complex dir = cexp(I*a);
+		complex dir = sim_cexp(I*a);
 
 		PROJECTILE("wave",
 			.pos = e->pos + dir * 10,
@@ -100,7 +100,7 @@ static int stage3_slavefairy(Enemy *e, int t) {
 		);
 
 		if(global.diff > D_Easy && e->args[1]) {
-			PROJECTILE("ball", e->pos + dir * 10, RGB(1.0, 0.6, 0.3), linear, { dir * (1.0 + 0.5 * sin(a)) });
+			PROJECTILE("ball", e->pos + dir * 10, RGB(1.0, 0.6, 0.3), linear, { dir * (1.0 + 0.5 * sim_sin(a)) });
 		}
 	}
 
@@ -134,7 +134,7 @@ static int stage3_slavefairy2(Enemy *e, int t) {
 			a *= -1;
 		}
 
-		complex dir = cexp(I*a);
+		complex dir = sim_cexp(I*a);
 		PROJECTILE("wave", e->pos, (_i&1) ? RGB(1.0,0.3,0.3) : RGB(0.3,0.3,1.0), linear, { 2*dir });
 
 		if(global.diff > D_Normal && _i % 3 == 0) {
@@ -153,7 +153,7 @@ static void charge_effect(Enemy *e, int t, int chargetime) {
 	TIMER(&t);
 
 	FROM_TO(chargetime - 30, chargetime, 1) {
-		complex n = cexp(2.0*I*M_PI*frand());
+		complex n = sim_cexp(2.0*I*M_PI*frand());
 		float l = 50*frand()+25;
 		float s = 4+_i*0.01;
 
@@ -195,7 +195,7 @@ static int stage3_burstfairy(Enemy *e, int t) {
 
 			int cnt = 6 + 4 * global.diff;
 			for(int p = 0; p < cnt; ++p) {
-				complex dir = cexp(I*M_PI*2*p/cnt);
+				complex dir = sim_cexp(I*M_PI*2*p/cnt);
 				PROJECTILE("ball", e->args[0], RGB(0.2, 0.1, 0.5), asymptotic, {
 					dir,
 					10 + 4 * global.diff
@@ -214,7 +214,7 @@ static int stage3_burstfairy(Enemy *e, int t) {
 
 	FROM_TO_SND("shot1_loop", bursttime, bursttime + burstspan, step) {
 		double phase = (t - bursttime) / (double)burstspan;
-		complex dir = cexp(I*M_PI*phase);
+		complex dir = sim_cexp(I*M_PI*phase);
 
 		int cnt = 5 + global.diff;
 		for(int p = 0; p < cnt; ++p) {
@@ -254,7 +254,7 @@ static int stage3_chargefairy_proj(Projectile *p, int t) {
 	}
 	*/
 
-	p->angle = carg(p->args[0]);
+	p->angle = sim_carg(p->args[0]);
 	t -= creal(p->args[2]);
 
 	if(t == 0) {
@@ -294,7 +294,7 @@ static int stage3_chargefairy(Enemy *e, int t) {
 
 	FROM_TO_SND("shot1_loop", chargetime, chargetime + cnt * step - 1, step) {
 		complex aim = e->args[3] - e->pos;
-		aim /= cabs(aim);
+		aim /= sim_cabs(aim);
 		complex aim_norm = -cimag(aim) + I*creal(aim);
 
 		int layers = 1 + global.diff;
@@ -309,7 +309,7 @@ static int stage3_chargefairy(Enemy *e, int t) {
 			int w = 100 - 20 * layer;
 			complex o = e->pos + w * psin(M_PI*f) * aim + aim_norm * w*0.8 * (f - 0.5);
 			complex paim = e->pos + (w+1) * aim - o;
-			paim /= cabs(paim);
+			paim /= sim_cabs(paim);
 
 			PROJECTILE("wave", o,
 				.color = color_lerp(RGB(0.0, 0.0, 1.0), RGB(1.0, 0.0, 0.0), f),
@@ -325,7 +325,7 @@ static int stage3_chargefairy(Enemy *e, int t) {
 	if(t > chargetime + step * cnt * 2) {
 		/*
 		complex dir = e->pos - (VIEWPORT_W+VIEWPORT_H*I)/2;
-		dir /= cabs(dir);
+		dir /= sim_cabs(dir);
 		e->pos += dir;
 		*/
 		e->pos += e->args[2];
@@ -382,8 +382,8 @@ static int stage3_bitchswirl(Enemy *e, int t) {
 
 	FROM_TO(0, 120, 20) {
 		PROJECTILE("flea", e->pos, RGB(0.7, 0.0, 0.5), accelerated, {
-			2*cexp(I*carg(global.plr.pos - e->pos)),
-			0.005*cexp(I*(M_PI*2 * frand())) * (global.diff > D_Easy)
+			2*sim_cexp(I*sim_carg(global.plr.pos - e->pos)),
+			0.005*sim_cexp(I*(M_PI*2 * frand())) * (global.diff > D_Easy)
 		});
 		play_sound("shot1");
 	}
@@ -417,17 +417,17 @@ static int stage3_cornerfairy(Enemy *e, int t) {
 
 			for(i = 0; i < cnt; ++i) {
 				float c = psin(t / 15.0);
-				bool wave = global.diff > D_Easy && cabs(e->args[2]);
+				bool wave = global.diff > D_Easy && sim_cabs(e->args[2]);
 
 				PROJECTILE(
 					.sprite = wave ? "wave" : "thickrice",
 					.pos = e->pos,
-					.color = cabs(e->args[2])
+					.color = sim_cabs(e->args[2])
 							? RGB(0.5 - c*0.2, 0.3 + c*0.7, 1.0)
 							: RGB(1.0 - c*0.5, 0.6, 0.5 + c*0.5),
 					.rule = asymptotic,
 					.args = {
-						(1.8-0.4*wave*!!(e->args[2]))*cexp(I*((2*i*M_PI/cnt)+carg((VIEWPORT_W+I*VIEWPORT_H)/2 - e->pos))),
+						(1.8-0.4*wave*!!(e->args[2]))*sim_cexp(I*((2*i*M_PI/cnt)+sim_carg((VIEWPORT_W+I*VIEWPORT_H)/2 - e->pos))),
 						1.5
 					},
 				);
@@ -451,7 +451,7 @@ static void scuttle_outro(Boss *boss, int time) {
 		spawn_items(boss->pos, Point, 10, Power, 10, Life, 1, NULL);
 	}
 
-	boss->pos += pow(max(0, time)/30.0, 2) * cexp(I*(3*M_PI/2 + 0.5 * sin(time / 20.0)));
+	boss->pos += sim_pow(max(0, time)/30.0, 2) * sim_cexp(I*(3*M_PI/2 + 0.5 * sim_sin(time / 20.0)));
 }
 
 static int scuttle_poison(Projectile *p, int time) {
@@ -471,7 +471,7 @@ static int scuttle_poison(Projectile *p, int time) {
 			.rule = accelerated,
 			.args = {
 				0,
-				0.005*cexp(I*(M_PI*2 * sin(a/5.0 + t/20.0))),
+				0.005*sim_cexp(I*(M_PI*2 * sim_sin(a/5.0 + t/20.0))),
 			},
 		);
 
@@ -495,7 +495,7 @@ static int scuttle_lethbite_proj(Projectile *p, int time) {
 
 	AT(A0_PROJ_START + A0_PROJ_CHARGE + 1) if(p->type != DeadProj) {
 		p->args[1] = 3;
-		p->args[0] = (3 + 2 * global.diff / (float)D_Lunatic) * cexp(I*carg(global.plr.pos - p->pos));
+		p->args[0] = (3 + 2 * global.diff / (float)D_Lunatic) * sim_cexp(I*sim_carg(global.plr.pos - p->pos));
 
 		int cnt = 3, i;
 		for(i = 0; i < cnt; ++i) {
@@ -508,18 +508,18 @@ static int scuttle_lethbite_proj(Projectile *p, int time) {
 				.rule = enemy_flare,
 				.timeout = 100,
 				.args = {
-					cexp(I*(M_PI*anfrand(0))) * (1 + afrand(1)),
+					sim_cexp(I*(M_PI*anfrand(0))) * (1 + afrand(1)),
 					add_ref(p)
 				},
 			);
 
 			float offset = global.frames/15.0;
 			if(global.diff > D_Hard && global.boss) {
-				offset = M_PI+carg(global.plr.pos-global.boss->pos);
+				offset = M_PI+sim_carg(global.plr.pos-global.boss->pos);
 			}
 
 			PROJECTILE("thickrice", p->pos, RGB(0.4, 0.3, 1.0), linear, {
-				-cexp(I*(i*2*M_PI/cnt + offset)) * (1.0 + (global.diff > D_Normal))
+				-sim_cexp(I*(i*2*M_PI/cnt + offset)) * (1.0 + (global.diff > D_Normal))
 			});
 		}
 
@@ -536,13 +536,13 @@ static void scuttle_lethbite(Boss *boss, int time) {
 	int i;
 	TIMER(&time)
 
-	GO_TO(boss, VIEWPORT_W/2+VIEWPORT_W/3*sin(time/300) + I*cimag(boss->pos), 0.01)
+	GO_TO(boss, VIEWPORT_W/2+VIEWPORT_W/3*sim_sin(time/300) + I*cimag(boss->pos), 0.01)
 
 	FROM_TO_INT(0, 90000, 72 + 6 * (D_Lunatic - global.diff), 0, 1) {
 		int cnt = 21 - 1 * (D_Lunatic - global.diff);
 
 		for(i = 0; i < cnt; ++i) {
-			complex v = (2 - psin((max(3, global.diff+1)*2*M_PI*i/(float)cnt) + time)) * cexp(I*2*M_PI/cnt*i);
+			complex v = (2 - psin((max(3, global.diff+1)*2*M_PI*i/(float)cnt) + time)) * sim_cexp(I*2*M_PI/cnt*i);
 			PROJECTILE(
 				.sprite = "wave",
 				.pos = boss->pos - v * 50,
@@ -577,7 +577,7 @@ void scuttle_deadly_dance(Boss *boss, int time) {
 		float angle_ofs = frand() * M_PI * 2;
 		double t = time * 1.5 * (0.4 + 0.3 * global.diff);
 		double moverad = min(160, time/2.7);
-		GO_TO(boss, VIEWPORT_W/2 + VIEWPORT_H*I/2 + sin(t/50.0) * moverad * cexp(I * M_PI_2 * t/100.0), 0.03)
+		GO_TO(boss, VIEWPORT_W/2 + VIEWPORT_H*I/2 + sim_sin(t/50.0) * moverad * sim_cexp(I * M_PI_2 * t/100.0), 0.03)
 
 		if(!(time % 70)) {
 			for(i = 0; i < 15; ++i) {
@@ -589,7 +589,7 @@ void scuttle_deadly_dance(Boss *boss, int time) {
 					.rule = scuttle_poison,
 					.args = {
 						0,
-						0.02 * cexp(I*(angle_ofs+a+time/10.0)),
+						0.02 * sim_cexp(I*(angle_ofs+a+time/10.0)),
 						a,
 						time
 					}
@@ -603,7 +603,7 @@ void scuttle_deadly_dance(Boss *boss, int time) {
 			int cnt = global.diff * 2;
 			for(i = 0; i < cnt; ++i) {
 				PROJECTILE("ball", boss->pos, RGB(1.0, 1.0, 0.3), asymptotic, {
-					(0.5 + 3 * psin(time + M_PI/3*2*i)) * cexp(I*(angle_ofs + time / 20.0 + M_PI/cnt*i*2)),
+					(0.5 + 3 * psin(time + M_PI/3*2*i)) * sim_cexp(I*(angle_ofs + time / 20.0 + M_PI/cnt*i*2)),
 					1.5
 				});
 			}
@@ -621,7 +621,7 @@ void scuttle_deadly_dance(Boss *boss, int time) {
 				.color = RGBA_MUL_ALPHA(0.3 + c * 0.7, 0.6 - c * 0.3, 0.3, 0.7),
 				.rule = linear,
 				.args = {
-					10 * cexp(I*(carg(global.plr.pos - boss->pos) + (M_PI/4.0 * i * (1-time/2500.0)) * (1 - 0.5 * psin(time/15.0))))
+					10 * sim_cexp(I*(sim_carg(global.plr.pos - boss->pos) + (M_PI/4.0 * i * (1-time/2500.0)) * (1 - 0.5 * psin(time/15.0))))
 				}
 			);
 		}
@@ -659,7 +659,7 @@ void wriggle_spellbg(Boss *b, int time) {
 		BLENDFACTOR_SRC_ALPHA, BLENDFACTOR_ONE, BLENDOP_SUB,
 		BLENDFACTOR_SRC_ALPHA, BLENDFACTOR_ONE, BLENDOP_SUB
 	));
-	fill_viewport(sin(time) * 0.015, time / 50.0, 1, "stage3/wspellclouds");
+	fill_viewport(sim_sin(time) * 0.015, time / 50.0, 1, "stage3/wspellclouds");
 	r_blend(BLEND_PREMUL_ALPHA);
 	r_color4(0.5, 0.5, 0.5, 0.0);
 	fill_viewport(0, time / 70.0, 1, "stage3/wspellswarm");
@@ -668,7 +668,7 @@ void wriggle_spellbg(Boss *b, int time) {
 		BLENDFACTOR_SRC_ALPHA, BLENDFACTOR_ONE, BLENDOP_SUB
 	));
 	r_color4(1,1,1,0.4);
-	fill_viewport(cos(time) * 0.02, time / 30.0, 1, "stage3/wspellclouds");
+	fill_viewport(sim_cos(time) * 0.02, time / 30.0, 1, "stage3/wspellclouds");
 
 	r_blend(BLEND_PREMUL_ALPHA);
 	r_color4(1, 1, 1, 1);
@@ -734,8 +734,8 @@ static int wriggle_rocket_laserbullet(Projectile *p, int time) {
 	if(time >= creal(p->args[1])) {
 		if(p->args[2]) {
 			complex dist = global.plr.pos - p->pos;
-			complex accel = (0.1 + 0.2 * (global.diff / (float)D_Lunatic)) * dist / cabs(dist);
-			float deathtime = sqrt(2*cabs(dist)/cabs(accel));
+			complex accel = (0.1 + 0.2 * (global.diff / (float)D_Lunatic)) * dist / sim_cabs(dist);
+			float deathtime = sqrt(2*sim_cabs(dist)/sim_cabs(accel));
 
 			Laser *l = create_lasercurve2c(p->pos, deathtime, deathtime, RGBA(0.4, 0.9, 1.0, 0.0), las_accel, 0, accel);
 			l->width = 15;
@@ -768,7 +768,7 @@ static int wriggle_rocket_laserbullet(Projectile *p, int time) {
 					.color = c,
 					.rule = asymptotic,
 					.args = {
-						(1.0 + psin(M_PI*18*f)) * cexp(I*(2.0*M_PI*f+rot)),
+						(1.0 + psin(M_PI*18*f)) * sim_cexp(I*(2.0*M_PI*f+rot)),
 						2 + 2 * global.diff
 					},
 				);
@@ -794,7 +794,7 @@ static int wriggle_rocket_laserbullet(Projectile *p, int time) {
 	} else if(time < 0)
 		return 1;
 
-	Laser *laser = (Laser*)REF(p->args[0]);
+	Laser *laser = REF_ENT(p->args[0], Laser);
 
 	if(!laser)
 		return ACTION_DESTROY;
@@ -816,8 +816,8 @@ static int wriggle_spell_slave(Enemy *e, int time) {
 	TIMER(&time)
 
 	float angle = e->args[2] * (time / 70.0 + e->args[1]);
-	complex dir = cexp(I*angle);
-	Boss *boss = (Boss*)REF(e->args[0]);
+	complex dir = sim_cexp(I*angle);
+	Boss *boss = REF_ENT(e->args[0], Boss);
 
 	if(!boss)
 		return ACTION_DESTROY;
@@ -827,7 +827,7 @@ static int wriggle_spell_slave(Enemy *e, int time) {
 		return 1;
 	}
 
-	GO_TO(e, boss->pos + 100 * sin(time / 100.0) * dir, 0.03)
+	GO_TO(e, boss->pos + 100 * sim_sin(time / 100.0) * dir, 0.03)
 
 	if(!(time % 2)) {
 		float c = 0.5 * psin(time / 25.0);
@@ -875,14 +875,14 @@ static int wriggle_spell_slave(Enemy *e, int time) {
 			for(i = 0; i < cnt; ++i) {
 				PROJECTILE("ball", e->pos, RGBA(0.5, 1.0, 0.5, 0), accelerated,
 					.args = {
-						0, 0.02 * cexp(I*i*2*M_PI/cnt)
+						0, 0.02 * sim_cexp(I*i*2*M_PI/cnt)
 					},
 				);
 
 				if(global.diff > D_Hard) {
 					PROJECTILE("ball", e->pos, RGBA(1.0, 1.0, 0.5, 0), accelerated,
 						.args = {
-							0, 0.01 * cexp(I*i*2*M_PI/cnt)
+							0, 0.01 * sim_cexp(I*i*2*M_PI/cnt)
 						},
 					);
 				}
@@ -921,13 +921,13 @@ static int wriggle_ignite_laserbullet(Projectile *p, int time) {
 		return ACTION_ACK;
 	}
 
-	Laser *laser = (Laser*)REF(p->args[0]);
+	Laser *laser = REF_ENT(p->args[0], Laser);
 
 	if(laser) {
 		p->args[3] = laser->prule(laser, time - p->args[1]) - p->pos;
 	}
 
-	p->angle = carg(p->args[3]);
+	p->angle = sim_carg(p->args[3]);
 	p->pos = p->pos + p->args[3];
 
 	return ACTION_NONE;
@@ -983,7 +983,7 @@ void wriggle_night_ignite(Boss *boss, int time) {
 		float b = 0.3;
 		float c = 0.3;
 
-		complex vel = 2 * cexp(I*a);
+		complex vel = 2 * sim_cexp(I*a);
 		double amp = M_PI/5;
 		double freq = 0.05;
 
@@ -1025,9 +1025,9 @@ static void wriggle_singularity_laser_logic(Laser *l, int time) {
 
 	l->width = laser_charge(l, time, 150, 10 + 10 * psin(l->args[0] + time / 60.0));
 	l->args[3] = time / 10.0;
-	l->args[0] *= cexp(I*(M_PI/500.0) * (0.7 + 0.35 * global.diff));
+	l->args[0] *= sim_cexp(I*(M_PI/500.0) * (0.7 + 0.35 * global.diff));
 
-	l->color = *HSLA((carg(l->args[0]) + M_PI) / (M_PI * 2), 1.0, 0.5, 0.0);
+	l->color = *HSLA((sim_carg(l->args[0]) + M_PI) / (M_PI * 2), 1.0, 0.5, 0.0);
 }
 
 void wriggle_light_singularity(Boss *boss, int time) {
@@ -1053,7 +1053,7 @@ void wriggle_light_singularity(Boss *boss, int time) {
 				aofs = 0.7;
 			}
 
-			complex vel = 2 * cexp(I*(aofs + M_PI / 4 + M_PI * 2 * i / (double)cnt));
+			complex vel = 2 * sim_cexp(I*(aofs + M_PI / 4 + M_PI * 2 * i / (double)cnt));
 			double amp = (4.0/cnt) * (M_PI/5.0);
 			double freq = 0.05;
 
@@ -1098,7 +1098,7 @@ void wriggle_light_singularity(Boss *boss, int time) {
 
 		for(int i = 0; i < cnt; ++i) {
 			double a = ((M_PI*2.0*i)/cnt);
-			complex dir = cexp(I*a);
+			complex dir = sim_cexp(I*a);
 
 			PROJECTILE(
 				.sprite = ptype,
@@ -1146,7 +1146,7 @@ static int wriggle_fstorm_proj(Projectile *p, int time) {
 		return ACTION_ACK;
 	}
 
-	if(cabs(global.plr.pos-p->pos) > 100) {
+	if(sim_cabs(global.plr.pos-p->pos) > 100) {
 		p->args[2]+=1;
 	} else {
 		p->args[2]-=1;
@@ -1158,13 +1158,13 @@ static int wriggle_fstorm_proj(Projectile *p, int time) {
 	int t = rint(creal(p->args[2]));
 	if(t < turntime) {
 		float f = t/(float)turntime;
-		p->color = *RGB(0.3+0.7*(1 - pow(1 - f, 4)), 0.3+0.3*f*f, 0.7-0.7*f);
+		p->color = *RGB(0.3+0.7*(1 - sim_pow(1 - f, 4)), 0.3+0.3*f*f, 0.7-0.7*f);
 	}
 
 	if(t == turntime && global.boss) {
 		p->args[1] = global.boss->pos-p->pos;
-		p->args[1] *= 2/cabs(p->args[1]);
-		p->angle = carg(p->args[1]);
+		p->args[1] *= 2/sim_cabs(p->args[1]);
+		p->angle = sim_carg(p->args[1]);
 		p->birthtime = global.frames;
 		p->draw_rule = wriggle_fstorm_proj_draw;
 		p->sprite = NULL;
@@ -1177,7 +1177,7 @@ static int wriggle_fstorm_proj(Projectile *p, int time) {
 				.pos = p->pos,
 				.rule = linear,
 				.timeout = 60,
-				.args = { (1+afrand(0))*cexp(I*tsrand_a(1)) },
+				.args = { (1+afrand(0))*sim_cexp(I*tsrand_a(1)) },
 				.draw_rule = Shrink,
 			);
 		}
@@ -1206,9 +1206,9 @@ void wriggle_firefly_storm(Boss *boss, int time) {
 	FROM_TO_SND("shot1_loop", 30, 9000, 2) {
 		int i, cnt = 2;
 		for(i = 0; i < cnt; ++i) {
-			float r = tanh(sin(_i/200.));
-			float v = lun ? cos(_i/150.)/pow(cosh(atanh(r)),2) : 0.5;
-			complex pos = 230*cexp(I*(_i*0.301+2*M_PI/cnt*i))*r;
+			float r = sim_tanh(sim_sin(_i/200.));
+			float v = lun ? sim_cos(_i/150.)/sim_pow(sim_cosh(sim_atanh(r)),2) : 0.5;
+			complex pos = 230*sim_cexp(I*(_i*0.301+2*M_PI/cnt*i))*r;
 
 			PROJECTILE(
 				.proto = (global.diff >= D_Hard) && !(i%10) ? pp_bigball : pp_ball,
@@ -1217,7 +1217,7 @@ void wriggle_firefly_storm(Boss *boss, int time) {
 				.rule = wriggle_fstorm_proj,
 				.args = {
 					(global.diff == D_Easy) ? 40 : 100-25*(!lun)-20*(global.diff == D_Normal),
-					cexp(I*(!lun)*0.6)*pos/cabs(pos)*(1+v)
+					sim_cexp(I*(!lun)*0.6)*pos/sim_cabs(pos)*(1+v)
 				},
 			);
 		}
@@ -1229,8 +1229,8 @@ static int wriggle_nonspell_slave(Enemy *e, int time) {
 
 	int level = e->args[3];
 	float angle = e->args[2] * (time / 70.0 + e->args[1]);
-	complex dir = cexp(I*angle);
-	Boss *boss = (Boss*)REF(e->args[0]);
+	complex dir = sim_cexp(I*angle);
+	Boss *boss = REF_ENT(e->args[0], Boss);
 
 	if(!boss)
 		return ACTION_DESTROY;
@@ -1243,7 +1243,7 @@ static int wriggle_nonspell_slave(Enemy *e, int time) {
 	if(time < 0)
 		return 1;
 
-	GO_TO(e, boss->pos + (100 + 20 * e->args[2] * sin(time / 100.0)) * dir, 0.03)
+	GO_TO(e, boss->pos + (100 + 20 * e->args[2] * sim_sin(time / 100.0)) * dir, 0.03)
 
 	int d = 10 - global.diff;
 	if(level > 2)
@@ -1252,14 +1252,14 @@ static int wriggle_nonspell_slave(Enemy *e, int time) {
 	if(!(time % d)) {
 		play_sound("shot1");
 
-		PROJECTILE("rice", e->pos, RGB(0.7, 0.2, 0.1), linear, { 3 * cexp(I*carg(boss->pos - e->pos)) });
+		PROJECTILE("rice", e->pos, RGB(0.7, 0.2, 0.1), linear, { 3 * sim_cexp(I*sim_carg(boss->pos - e->pos)) });
 
 		if(!(time % (d*2)) || level > 1) {
-			PROJECTILE("thickrice", e->pos, RGB(0.7, 0.7, 0.1), linear, { 2.5 * cexp(I*carg(boss->pos - e->pos)) });
+			PROJECTILE("thickrice", e->pos, RGB(0.7, 0.7, 0.1), linear, { 2.5 * sim_cexp(I*sim_carg(boss->pos - e->pos)) });
 		}
 
 		if(level > 2) {
-			PROJECTILE("wave", e->pos, RGB(0.3, 0.1 + 0.6 * psin(time / 25.0), 0.7), linear, { 2 * cexp(I*carg(boss->pos - e->pos)) });
+			PROJECTILE("wave", e->pos, RGB(0.3, 0.1 + 0.6 * psin(time / 25.0), 0.7), linear, { 2 * sim_cexp(I*sim_carg(boss->pos - e->pos)) });
 		}
 	}
 
@@ -1347,7 +1347,7 @@ void stage3_events(void) {
 
 	FROM_TO(160, 300, 10) {
 		tsrand_fill(2);
-		create_enemy1c(VIEWPORT_W/2 + 20 * anfrand(0) + (VIEWPORT_H/4 + 20 * anfrand(1))*I, 200, Swirl, stage3_enterswirl, 3 * (I + sin(M_PI*global.frames/15.0)));
+		create_enemy1c(VIEWPORT_W/2 + 20 * anfrand(0) + (VIEWPORT_H/4 + 20 * anfrand(1))*I, 200, Swirl, stage3_enterswirl, 3 * (I + sim_sin(M_PI*global.frames/15.0)));
 	}
 
 	AT(360) {
@@ -1387,7 +1387,7 @@ void stage3_events(void) {
 			complex pos = VIEWPORT_W/2 + span * (-0.5 + (i&1)) + (VIEWPORT_H/3 + 100*(i/2))*I;
 
 			complex exitdir = pos - (VIEWPORT_W+VIEWPORT_H*I)/2;
-			exitdir /= cabs(exitdir);
+			exitdir /= sim_cabs(exitdir);
 
 			create_enemy3c(pos, 1000, Fairy, stage3_chargefairy, pos, 30, exitdir);
 		}
@@ -87,7 +87,7 @@ int stage4_fodder(Enemy *e, int t) {
 	FROM_TO(100, 200, 22-global.diff*3) {
 		play_sound_ex("shot3",5,false);
 		PROJECTILE("ball", e->pos, RGB(1, 0.3, 0.5), asymptotic, {
-			2*cexp(I*M_PI*2*frand()),
+			2*sim_cexp(I*M_PI*2*frand()),
 			3
 		});
 	}
@@ -113,7 +113,7 @@ int stage4_partcircle(Enemy *e, int t) {
 		int i;
 		for(i = 0; i < global.diff; i++) {
 			play_sound("shot2");
-			complex n = cexp(I*M_PI/16.0*_i + I*carg(e->args[0])-I*M_PI/4.0 + 0.01*I*i*(1-2*(creal(e->args[0]) > 0)));
+			complex n = sim_cexp(I*M_PI/16.0*_i + I*sim_carg(e->args[0])-I*M_PI/4.0 + 0.01*I*i*(1-2*(creal(e->args[0]) > 0)));
 			PROJECTILE("wave", e->pos + (30)*n, RGB(1-0.2*i,0.5,0.7), asymptotic, { 2*n, 2+2*i });
 		}
 	}
@@ -141,7 +141,7 @@ int stage4_cardbuster(Enemy *e, int t) {
 		e->pos += (e->args[2]-e->args[1])/200.0;
 
 	int c = 40;
-	complex n = cexp(I*carg(global.plr.pos - e->pos) + 4*M_PI/(c+1)*I*_i);
+	complex n = sim_cexp(I*sim_carg(global.plr.pos - e->pos) + 4*M_PI/(c+1)*I*_i);
 
 	FROM_TO_SND("shot1_loop", 120, 120+c*global.diff, 1) {
 		if(_i&1)
@@ -176,7 +176,7 @@ int stage4_backfire(Enemy *e, int t) {
 
 	FROM_TO(20,180+global.diff*20,2) {
 		play_sound("shot2");
-		complex n = cexp(I*M_PI*frand()-I*copysign(M_PI/2.0, creal(e->args[0])));
+		complex n = sim_cexp(I*M_PI*frand()-I*copysign(M_PI/2.0, creal(e->args[0])));
 		int i;
 		for(i = 0; i < global.diff; i++)
 			PROJECTILE("wave", e->pos, RGB(0.2, 0.2, 1-0.2*i), asymptotic, { 2*n, 2+2*i });
@@ -211,8 +211,8 @@ int stage4_bigcircle(Enemy *e, int t) {
 				.color = RGBA(0, 0.8 - 0.4 * _i, 0, 0),
 				.rule = asymptotic,
 				.args = {
-					2*cexp(2.0*I*M_PI/n*i+I*3*_i),
-					3*sin(6*M_PI/n*i)
+					2*sim_cexp(2.0*I*M_PI/n*i+I*3*_i),
+					3*sim_sin(6*M_PI/n*i)
 				},
 			);
 
@@ -223,8 +223,8 @@ int stage4_bigcircle(Enemy *e, int t) {
 					.color = RGBA(0, 0.3 * _i, 0.4, 0),
 					.rule = asymptotic,
 					.args = {
-						(1.5+global.diff*0.2)*cexp(I*3*(i+frand())),
-						I*5*sin(6*M_PI/n*i)
+						(1.5+global.diff*0.2)*sim_cexp(I*3*(i+frand())),
+						I*5*sim_sin(6*M_PI/n*i)
 					},
 				);
 			}
@@ -242,18 +242,18 @@ int stage4_explosive(Enemy *e, int t) {
 
 		int n = 10*global.diff;
 		complex phase = global.plr.pos-e->pos;
-		phase /= cabs(phase);
+		phase /= sim_cabs(phase);
 
 		for(i = 0; i < n; i++) {
-			double angle = 2*M_PI*i/n+carg(phase);
+			double angle = 2*M_PI*i/n+sim_carg(phase);
 			PROJECTILE(
 				.sprite = "ball",
 				.pos = e->pos,
 				.color = RGB(0.1+0.6*(i&1), 0.2, 1-0.6*(i&1)),
 				.rule = accelerated,
 				.args = {
-					1.5*(1.1+0.3*global.diff)*cexp(I*angle),
-					0.001*cexp(I*angle)
+					1.5*(1.1+0.3*global.diff)*sim_cexp(I*angle),
+					0.001*sim_cexp(I*angle)
 				}
 			);
 		}
@@ -304,7 +304,7 @@ int kurumi_burstslave(Enemy *e, int t) {
 	if(t == 600 || REF(e->args[2]) == NULL)
 		return ACTION_DESTROY;
 
-	e->pos += 2*e->args[1]*(sin(t/10.0)+1.5);
+	e->pos += 2*e->args[1]*(sim_sin(t/10.0)+1.5);
 
 	FROM_TO(0, 600, 18-2*global.diff) {
 		float r = cimag(e->pos)/VIEWPORT_H;
@@ -315,7 +315,7 @@ int kurumi_burstslave(Enemy *e, int t) {
 
 	FROM_TO(40, 100,1) {
 		e->args[1] -= e->args[0]*0.02;
-		e->args[1] *= cexp(0.02*I);
+		e->args[1] *= sim_cexp(0.02*I);
 	}
 
 	return 1;
@@ -336,7 +336,7 @@ void kurumi_slaveburst(Boss *b, int time) {
 		int i;
 		int n = 3+2*global.diff;
 		for(i = 0; i < n; i++) {
-			create_enemy3c(b->pos, ENEMY_IMMUNE, KurumiSlave, kurumi_burstslave, cexp(I*2*M_PI/n*i+0.2*I*time/500), 0, add_ref(b));
+			create_enemy3c(b->pos, ENEMY_IMMUNE, KurumiSlave, kurumi_burstslave, sim_cexp(I*2*M_PI/n*i+0.2*I*time/500), 0, add_ref(b));
 		}
 	}
 }
@@ -355,7 +355,7 @@ int kurumi_spikeslave(Enemy *e, int t) {
 		return ACTION_DESTROY;
 
 	e->pos += e->args[1];
-	e->args[1] *= cexp(0.01*I*e->args[0]);
+	e->args[1] *= sim_cexp(0.01*I*e->args[0]);
 
 	FROM_TO(0, 600, 18-2*global.diff) {
 		float r = cimag(e->pos)/VIEWPORT_H;
@@ -393,7 +393,7 @@ void kurumi_redspike(Boss *b, int time) {
 					.color = RGBA(1.0, 0.0, 0.0, 0.0),
 					.rule = asymptotic,
 					.args = {
-						(1+0.1*(global.diff == D_Normal))*3*cexp(2.0*I*M_PI/n*i+I*carg(global.plr.pos-b->pos)),
+						(1+0.1*(global.diff == D_Normal))*3*sim_cexp(2.0*I*M_PI/n*i+I*sim_carg(global.plr.pos-b->pos)),
 						3
 					},
 				);
@@ -412,8 +412,8 @@ void kurumi_redspike(Boss *b, int time) {
 
 		FROM_TO_INT(80, 500, 40,200,2+2*(global.diff == D_Hard)) {
 			tsrand_fill(2);
-			complex offset = 100*afrand(0)*cexp(2.0*I*M_PI*afrand(1));
-			complex n = cexp(I*carg(global.plr.pos-b->pos-offset));
+			complex offset = 100*afrand(0)*sim_cexp(2.0*I*M_PI*afrand(1));
+			complex n = sim_cexp(I*sim_carg(global.plr.pos-b->pos-offset));
 			PROJECTILE("rice", b->pos+offset, RGBA(1, 0, 0, 0), accelerated,
 				.args = { -1*n, 0.05*n },
 			);
@@ -515,7 +515,7 @@ int stage4_supercard(Enemy *e, int t) {
 		play_sound_ex("shot1",5,false);
 
 		int i;
-		complex n = cexp(I*carg(global.plr.pos - e->pos) + 2*M_PI/20.*I*_i);
+		complex n = sim_cexp(I*sim_carg(global.plr.pos - e->pos) + 2*M_PI/20.*I*_i);
 		for(i = -1; i <= 1 && t; i++)
 			PROJECTILE("card", e->pos + 30*n, RGB(0,0.4,1-_i/40.0), splitcard,
 				{1*n, 0.1*_i, 100-time+70, 1.4*I*i*n}
@@ -559,20 +559,20 @@ void kurumi_breaker(Boss *b, int time) {
 	if(time < 0)
 		return;
 
-	GO_TO(b, VIEWPORT_W/2 + VIEWPORT_W/3*sin(time/220) + I*cimag(b->pos), 0.02);
+	GO_TO(b, VIEWPORT_W/2 + VIEWPORT_W/3*sim_sin(time/220) + I*cimag(b->pos), 0.02);
 
 	TIMER(&t);
 
 	FROM_TO_SND("shot1_loop", 50, 400, 50-7*global.diff) {
-		complex p = b->pos + 150*sin(_i) + 100.0*I*cos(_i);
+		complex p = b->pos + 150*sim_sin(_i) + 100.0*I*sim_cos(_i);
 
 		for(i = 0; i < c; i++) {
-			complex n = cexp(2.0*I*M_PI/c*i);
+			complex n = sim_cexp(2.0*I*M_PI/c*i);
 			PROJECTILE("rice", p, RGB(1,0,0.5), splitcard_elly, {
 				3*n,
 				0,
 				kt,
-				1.5*cexp(I*carg(global.plr.pos - p - 2*kt*n))-2.6*n
+				1.5*sim_cexp(I*sim_carg(global.plr.pos - p - 2*kt*n))-2.6*n
 			});
 
 		}
@@ -584,7 +584,7 @@ void kurumi_breaker(Boss *b, int time) {
 		aniplayer_queue(&b->ani,"main",0);
 		for(i = 0; i < 20; i++) {
 			PROJECTILE("bigball", b->pos, RGBA(0.5, 0.0, 0.5, 0.0), asymptotic,
-				.args = { cexp(2.0*I*M_PI/20.0*i), 3 },
+				.args = { sim_cexp(2.0*I*M_PI/20.0*i), 3 },
 			);
 		}
 	}
@@ -600,7 +600,7 @@ int aniwall_bullet(Projectile *p, int t) {
 		if(global.diff > D_Normal) {
 			tsrand_fill(2);
 			p->args[0] += 0.1*(0.1-0.2*afrand(0) + 0.1*I-0.2*I*afrand(1))*(global.diff-2);
-			p->args[0] += 0.002*cexp(I*carg(global.plr.pos - p->pos));
+			p->args[0] += 0.002*sim_cexp(I*sim_carg(global.plr.pos - p->pos));
 		}
 
 		p->pos += p->args[0];
@@ -628,7 +628,7 @@ int aniwall_slave(Enemy *e, int t) {
 	re = creal(e->pos);
 	im = cimag(e->pos);
 
-	if(cabs(e->args[1]) <= 0.1) {
+	if(sim_cabs(e->args[1]) <= 0.1) {
 		if(re == 0 || re == VIEWPORT_W) {
 
 			e->args[1] = 1;
@@ -648,7 +648,7 @@ int aniwall_slave(Enemy *e, int t) {
 		e->pos += e->args[2];
 
 		if(!(t % 7-global.diff-2*(global.diff > D_Normal))) {
-			complex v = e->args[2]/cabs(e->args[2])*I*sign(creal(e->args[0]));
+			complex v = e->args[2]/sim_cabs(e->args[2])*I*sign(creal(e->args[0]));
 			if(cimag(v) > -0.1 || global.diff >= D_Normal) {
 				play_sound("shot1");
 				PROJECTILE("ball", e->pos+I*v*20*nfrand(), RGB(1,0,0), aniwall_bullet, { 1*v, 40 });
@@ -682,7 +682,7 @@ void kurumi_aniwall(Boss *b, int time) {
 		enemy_kill_all(&global.enemies);
 	}
 
-	GO_TO(b, VIEWPORT_W/2 + VIEWPORT_W/3*sin(time/200) + I*cimag(b->pos),0.03)
+	GO_TO(b, VIEWPORT_W/2 + VIEWPORT_W/3*sim_sin(time/200) + I*cimag(b->pos),0.03)
 
 	if(time < 0)
 		return;
@@ -690,10 +690,10 @@ void kurumi_aniwall(Boss *b, int time) {
 	AT(0) {
 		aniplayer_queue(&b->ani, "muda", 0);
 		play_sound("laser1");
-		create_lasercurve2c(b->pos, 50, 80, RGBA(1.0, 0.8, 0.8, 0.0), las_accel, 0, 0.2*cexp(0.4*I));
-		create_enemy1c(b->pos, ENEMY_IMMUNE, KurumiAniWallSlave, aniwall_slave, 0.2*cexp(0.4*I));
-		create_lasercurve2c(b->pos, 50, 80, RGBA(1.0, 0.8, 0.8, 0.0), las_accel, 0, 0.2*cexp(I*M_PI - 0.4*I));
-		create_enemy1c(b->pos, ENEMY_IMMUNE, KurumiAniWallSlave, aniwall_slave, 0.2*cexp(I*M_PI - 0.4*I));
+		create_lasercurve2c(b->pos, 50, 80, RGBA(1.0, 0.8, 0.8, 0.0), las_accel, 0, 0.2*sim_cexp(0.4*I));
+		create_enemy1c(b->pos, ENEMY_IMMUNE, KurumiAniWallSlave, aniwall_slave, 0.2*sim_cexp(0.4*I));
+		create_lasercurve2c(b->pos, 50, 80, RGBA(1.0, 0.8, 0.8, 0.0), las_accel, 0, 0.2*sim_cexp(I*M_PI - 0.4*I));
+		create_enemy1c(b->pos, ENEMY_IMMUNE, KurumiAniWallSlave, aniwall_slave, 0.2*sim_cexp(I*M_PI - 0.4*I));
 	}
 }
 
@@ -710,14 +710,14 @@ void kurumi_sbreaker(Boss *b, int time) {
 	int kt = 40;
 
 	FROM_TO_SND("shot1_loop", 50, dur, 2+(global.diff < D_Hard)) {
-		complex p = b->pos + 150*sin(_i/8.0)+100.0*I*cos(_i/15.0);
+		complex p = b->pos + 150*sim_sin(_i/8.0)+100.0*I*sim_cos(_i/15.0);
 
-		complex n = cexp(2.0*I*M_PI/c*_i);
+		complex n = sim_cexp(2.0*I*M_PI/c*_i);
 		PROJECTILE("rice", p, RGB(1.0, 0.0, 0.5), splitcard_elly, {
 			2*n,
 			0,
 			kt,
-			1.5*cexp(I*carg(global.plr.pos - p - 2*kt*n))-1.7*n
+			1.5*sim_cexp(I*sim_carg(global.plr.pos - p - 2*kt*n))-1.7*n
 		});
 
 	}
@@ -729,7 +729,7 @@ void kurumi_sbreaker(Boss *b, int time) {
 
 		for(i = 0; i < 20; i++) {
 			PROJECTILE("bigball", b->pos, RGBA(0.5, 0.0, 0.5, 0.0), asymptotic,
-				.args = { cexp(2.0*I*M_PI/20.0*i), 3 },
+				.args = { sim_cexp(2.0*I*M_PI/20.0*i), 3 },
 			);
 		}
 	}
@@ -773,7 +773,7 @@ int blowwall_slave(Enemy *e, int t) {
 				type = "plainball";
 
 			PROJECTILE(type, e->pos, RGBA(1.0, 0.1, 0.1, 0.0), asymptotic,
-				.args = { (1+3*f)*cexp(2.0*I*M_PI*frand()), 4 },
+				.args = { (1+3*f)*sim_cexp(2.0*I*M_PI*frand()), 4 },
 			);
 		}
 
@@ -785,11 +785,11 @@ int blowwall_slave(Enemy *e, int t) {
 }
 
 static void bwlaser(Boss *b, float arg, int slave) {
-	create_lasercurve2c(b->pos, 50, 100, RGBA(1.0, 0.5+0.3*slave, 0.5+0.3*slave, 0.0), las_accel, 0, (0.1+0.1*slave)*cexp(I*arg));
+	create_lasercurve2c(b->pos, 50, 100, RGBA(1.0, 0.5+0.3*slave, 0.5+0.3*slave, 0.0), las_accel, 0, (0.1+0.1*slave)*sim_cexp(I*arg));
 
 	if(slave) {
 		play_sound("laser1");
-		create_enemy1c(b->pos, ENEMY_IMMUNE, NULL, blowwall_slave, 0.2*cexp(I*arg));
+		create_enemy1c(b->pos, ENEMY_IMMUNE, NULL, blowwall_slave, 0.2*sim_cexp(I*arg));
 	} else {
 		// FIXME: needs a better sound
 		play_sound("shot2");
@@ -868,12 +868,12 @@ static int kdanmaku_proj(Projectile *p, int t) {
 		play_sound("shot3");
 	}
 
-	if(t > time && cabs(p->args[1]) < 2) {
+	if(t > time && sim_cabs(p->args[1]) < 2) {
 		p->args[1] *= 1.02;
 	}
 
 	p->pos += p->args[1];
-	p->angle = carg(p->args[1]);
+	p->angle = sim_carg(p->args[1]);
 
 	return ACTION_NONE;
 }
@@ -908,9 +908,9 @@ int kdanmaku_slave(Enemy *e, int t) {
 
 		for(i = 0; i < n; i++) {
 			complex p = VIEWPORT_W/(float)n*(i+psin(t*t*i*i+t*t)) + I*cimag(e->pos);
-			if(cabs(p-global.plr.pos) > 60) {
+			if(sim_cabs(p-global.plr.pos) > 60) {
 				PROJECTILE("thickrice", p, RGBA(1.0, 0.5, 0.5, 0.0), kdanmaku_proj,
-					.args = { 160, speed*0.5*cexp(2.0*I*M_PI*sin(245*t+i*i*3501)) },
+					.args = { 160, speed*0.5*sim_cexp(2.0*I*M_PI*sim_sin(245*t+i*i*3501)) },
 				);
 
 				if(frand()<0.5) {
@@ -942,10 +942,10 @@ void kurumi_danmaku(Boss *b, int time) {
 
 	AT(50) {
 		play_sound("laser1");
-		create_lasercurve2c(b->pos, 50, 100, RGBA(1.0, 0.8, 0.8, 0.0), las_accel, 0, 0.2*cexp(I*carg(-b->pos)));
-		create_lasercurve2c(b->pos, 50, 100, RGBA(1.0, 0.8, 0.8, 0.0), las_accel, 0, 0.2*cexp(I*carg(VIEWPORT_W-b->pos)));
-		create_enemy3c(b->pos, ENEMY_IMMUNE, KurumiAniWallSlave, kdanmaku_slave, 0.2*cexp(I*carg(-b->pos)), 0, 1);
-		create_enemy3c(b->pos, ENEMY_IMMUNE, KurumiAniWallSlave, kdanmaku_slave, 0.2*cexp(I*carg(VIEWPORT_W-b->pos)), 0, 0);
+		create_lasercurve2c(b->pos, 50, 100, RGBA(1.0, 0.8, 0.8, 0.0), las_accel, 0, 0.2*sim_cexp(I*sim_carg(-b->pos)));
+		create_lasercurve2c(b->pos, 50, 100, RGBA(1.0, 0.8, 0.8, 0.0), las_accel, 0, 0.2*sim_cexp(I*sim_carg(VIEWPORT_W-b->pos)));
+		create_enemy3c(b->pos, ENEMY_IMMUNE, KurumiAniWallSlave, kdanmaku_slave, 0.2*sim_cexp(I*sim_carg(-b->pos)), 0, 1);
+		create_enemy3c(b->pos, ENEMY_IMMUNE, KurumiAniWallSlave, kdanmaku_slave, 0.2*sim_cexp(I*sim_carg(VIEWPORT_W-b->pos)), 0, 0);
 	}
 }
 
@@ -953,7 +953,7 @@ void kurumi_extra_shield_pos(Enemy *e, int time) {
 	double dst = 75 + 100 * max((60 - time) / 60.0, 0);
 	double spd = cimag(e->args[0]) * min(time / 120.0, 1);
 	e->args[0] += spd;
-	e->pos = global.boss->pos + dst * cexp(I*creal(e->args[0]));
+	e->pos = global.boss->pos + dst * sim_cexp(I*creal(e->args[0]));
 }
 
 bool kurumi_extra_shield_expire(Enemy *e, int time) {
@@ -984,9 +984,9 @@ int kurumi_extra_dead_shield(Enemy *e, int time) {
 	}
 
 	if(!(time % 6)) {
-		// complex dir = cexp(I*(M_PI * 0.5 * nfrand() + carg(global.plr.pos - e->pos)));
-		// complex dir = cexp(I*(carg(global.plr.pos - e->pos)));
-		complex dir = cexp(I*creal(e->args[0]));
+		// complex dir = sim_cexp(I*(M_PI * 0.5 * nfrand() + sim_carg(global.plr.pos - e->pos)));
+		// complex dir = sim_cexp(I*(sim_carg(global.plr.pos - e->pos)));
+		complex dir = sim_cexp(I*creal(e->args[0]));
 		PROJECTILE("rice", e->pos, 0, kurumi_extra_dead_shield_proj, { 2*dir, 10 });
 		play_sound("shot1");
 	}
@@ -998,7 +998,7 @@ int kurumi_extra_dead_shield(Enemy *e, int time) {
 	if(kurumi_extra_shield_expire(e, time)) {
 		int cnt = 10;
 		for(int i = 0; i < cnt; ++i) {
-			complex dir = cexp(I*M_PI*2*i/(double)cnt);
+			complex dir = sim_cexp(I*M_PI*2*i/(double)cnt);
 			tsrand_fill(2);
 			PROJECTILE("ball", e->pos, 0, kurumi_extra_dead_shield_proj,
 				.args = { 1.5 * (1 + afrand(0)) * dir, 4 + anfrand(1) },
@@ -1046,9 +1046,9 @@ int kurumi_extra_bigfairy1(Enemy *e, int time) {
 
 	FROM_TO(50,escapetime,60) {
 		int count = 5;
-		complex phase = cexp(I*2*M_PI*frand());
+		complex phase = sim_cexp(I*2*M_PI*frand());
 		for(int i = 0; i < count; i++) {
-			complex arg = cexp(I*2*M_PI*i/count);
+			complex arg = sim_cexp(I*2*M_PI*i/count);
 			if(global.diff == D_Lunatic)
 				arg *= phase;
 			create_lasercurve2c(e->pos, 20, 200, RGBA(1.0, 0.3, 0.7, 0.0), las_accel, arg, 0.1*arg);
@@ -1184,22 +1184,22 @@ int kurumi_extra_fairy(Enemy *e, int t) {
 	}
 
 	/*FROM_TO(100, 200, 22-global.diff*3) {
-		PROJECTILE("ball", e->pos, RGB(1, 0.3, 0.5), asymptotic, 2*cexp(I*M_PI*2*frand()), 3);
+		PROJECTILE("ball", e->pos, RGB(1, 0.3, 0.5), asymptotic, 2*sim_cexp(I*M_PI*2*frand()), 3);
 	}*/
 
 	int attacktime = creal(e->args[1]);
 	int flytime = cimag(e->args[1]);
 	FROM_TO_SND("shot1_loop", attacktime-20,attacktime+20,20) {
-		complex vel = cexp(I*frand()*2*M_PI)*(2+0.1*(global.diff-D_Easy));
+		complex vel = sim_cexp(I*frand()*2*M_PI)*(2+0.1*(global.diff-D_Easy));
 		if(e->args[2] == 0) { // attack type
 			int corners = 5;
 			double len = 50;
 			int count = 5;
 			for(int i = 0; i < corners; i++) {
 				for(int j = 0; j < count; j++) {
-					complex pos = len/2/tan(2*M_PI/corners)*I+(j/(double)count-0.5)*len;
-					pos *= cexp(I*2*M_PI/corners*i);
-					PROJECTILE("flea", e->pos+pos, RGB(1, 0.3, 0.5), linear, { vel+0.1*I*pos/cabs(pos) });
+					complex pos = len/2/sim_tan(2*M_PI/corners)*I+(j/(double)count-0.5)*len;
+					pos *= sim_cexp(I*2*M_PI/corners*i);
+					PROJECTILE("flea", e->pos+pos, RGB(1, 0.3, 0.5), linear, { vel+0.1*I*pos/sim_cabs(pos) });
 				}
 			}
 		} else {
@@ -1207,8 +1207,8 @@ int kurumi_extra_fairy(Enemy *e, int t) {
 			double rad = 20;
 			for(int j = 0; j < count; j++) {
 				double x = (j/(double)count-0.5)*2*M_PI;
-				complex pos = 0.5*cos(x)+sin(2*x) + (0.5*sin(x)+cos(2*x))*I;
-				pos*=vel/cabs(vel);
+				complex pos = 0.5*sim_cos(x)+sim_sin(2*x) + (0.5*sim_sin(x)+sim_cos(2*x))*I;
+				pos*=vel/sim_cabs(vel);
 				PROJECTILE("flea", e->pos+rad*pos, RGB(0.5, 0.3, 1), linear, { vel+0.1*pos });
 			}
 		}
@@ -1375,7 +1375,7 @@ static int scythe_post_mid(Enemy *e, int t) {
 	double targ = (t-300) * (0.5 + psin(t/300.0));
 	double w = min(0.15, 0.0001*targ);
 
-	complex pofs = 150*cos(w*targ+M_PI/2.0) + I*80*sin(2*w*targ);
+	complex pofs = 150*sim_cos(w*targ+M_PI/2.0) + I*80*sim_sin(2*w*targ);
 	pofs += ((VIEWPORT_W/2+VIEWPORT_H/2*I - opos) * (global.diff - D_Easy)) / (D_Lunatic - D_Easy);
 
 	e->pos = opos + pofs * (1.0 - clamp((t - (fleetime - 120)) / 60.0, 0.0, 1.0)) * smooth(smooth(scale));
@@ -1383,8 +1383,8 @@ static int scythe_post_mid(Enemy *e, int t) {
 	e->args[1] = creal(e->args[1]) + spin * I;
 
 	FROM_TO(90, fleetime - 120, 1) {
-		complex shotorg = e->pos+80*cexp(I*creal(e->args[1]));
-		complex shotdir = cexp(I*creal(e->args[1]));
+		complex shotorg = e->pos+80*sim_cexp(I*creal(e->args[1]));
+		complex shotdir = sim_cexp(I*creal(e->args[1]));
 
 		struct projentry { char *proj; char *snd; } projs[] = {
 			{ "ball",       "shot1"},
@@ -1396,12 +1396,12 @@ static int scythe_post_mid(Enemy *e, int t) {
 		struct projentry *pe = &projs[_i % (sizeof(projs)/sizeof(struct projentry))];
 
 		double ca = creal(e->args[1]) + _i/60.0;
-		Color *c = RGB(cos(ca), sin(ca), cos(ca+2.1));
+		Color *c = RGB(sim_cos(ca), sim_sin(ca), sim_cos(ca+2.1));
 
 		play_sound_ex(pe->snd, 3, true);
 		PROJECTILE(pe->proj, shotorg, c, asymptotic, {
 			(1.2-0.1*global.diff)*shotdir,
-			5 * sin(t/150.0)
+			5 * sim_sin(t/150.0)
 		});
 
 	}
@@ -1435,7 +1435,7 @@ void stage4_events(void) {
 
 	FROM_TO(500, 550, 10) {
 		int d = _i&1;
-		create_enemy1c(VIEWPORT_W*d, 1000, Fairy, stage4_partcircle, 2*cexp(I*M_PI/2.0*(0.2+0.6*frand()+d)));
+		create_enemy1c(VIEWPORT_W*d, 1000, Fairy, stage4_partcircle, 2*sim_cexp(I*M_PI/2.0*(0.2+0.6*frand()+d)));
 	}
 
 	FROM_TO(600, 1400, 100) {
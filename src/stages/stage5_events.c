@@ -56,7 +56,7 @@ int stage5_greeter(Enemy *e, int t) {
 	FROM_TO(80, 180, 20) {
 		for(int i = -(int)global.diff; i <= (int)global.diff; i++) {
 			PROJECTILE("bullet", e->pos, RGB(0.0,0.0,1.0), asymptotic, {
-				(3.5+(global.diff == D_Lunatic))*cexp(I*carg(global.plr.pos-e->pos) + 0.06*I*i),
+				(3.5+(global.diff == D_Lunatic))*sim_cexp(I*sim_carg(global.plr.pos-e->pos) + 0.06*I*i),
 				5
 			});
 		}
@@ -84,8 +84,8 @@ int stage5_lightburst(Enemy *e, int t) {
 	FROM_TO_SND("shot1_loop", 20, 300, 5) {
 		int c = 5+global.diff;
 		for(int i = 0; i < c; i++) {
-			complex n = cexp(I*carg(global.plr.pos) + 2.0*I*M_PI/c*i);
-			PROJECTILE("ball", e->pos + 50*n*cexp(-0.4*I*_i*global.diff), RGB(0.3, 0, 0.7), asymptotic, { 3*n, 3 });
+			complex n = sim_cexp(I*sim_carg(global.plr.pos) + 2.0*I*M_PI/c*i);
+			PROJECTILE("ball", e->pos + 50*n*sim_cexp(-0.4*I*_i*global.diff), RGB(0.3, 0, 0.7), asymptotic, { 3*n, 3 });
 		}
 
 		play_sound("shot2");
@@ -107,8 +107,8 @@ int stage5_swirl(Enemy *e, int t) {
 	e->pos += e->args[0];
 
 	FROM_TO(0, 400, 26-global.diff*4) {
-		PROJECTILE("bullet", e->pos, RGB(0.3, 0.4, 0.5), asymptotic, { 2*e->args[0]*I/cabs(e->args[0]), 3 });
-		PROJECTILE("bullet", e->pos, RGB(0.3, 0.4, 0.5), asymptotic, {-2*e->args[0]*I/cabs(e->args[0]), 3 });
+		PROJECTILE("bullet", e->pos, RGB(0.3, 0.4, 0.5), asymptotic, { 2*e->args[0]*I/sim_cabs(e->args[0]), 3 });
+		PROJECTILE("bullet", e->pos, RGB(0.3, 0.4, 0.5), asymptotic, {-2*e->args[0]*I/sim_cabs(e->args[0]), 3 });
 		play_sound("shot1");
 	}
 
@@ -125,8 +125,8 @@ int stage5_limiter(Enemy *e, int t) {
 	e->pos += e->args[0];
 
 	FROM_TO_SND("shot1_loop", 0, 1200, 3) {
-		PROJECTILE("rice", e->pos, RGB(0.5,0.1,0.2), asymptotic, { 10*cexp(I*carg(global.plr.pos-e->pos)+0.2*I-0.1*I*(global.diff/4)+3.0*I/(_i+1)), 2 });
-		PROJECTILE("rice", e->pos, RGB(0.5,0.1,0.2), asymptotic, { 10*cexp(I*carg(global.plr.pos-e->pos)-0.2*I+0.1*I*(global.diff/4)-3.0*I/(_i+1)), 2 });
+		PROJECTILE("rice", e->pos, RGB(0.5,0.1,0.2), asymptotic, { 10*sim_cexp(I*sim_carg(global.plr.pos-e->pos)+0.2*I-0.1*I*(global.diff/4)+3.0*I/(_i+1)), 2 });
+		PROJECTILE("rice", e->pos, RGB(0.5,0.1,0.2), asymptotic, { 10*sim_cexp(I*sim_carg(global.plr.pos-e->pos)-0.2*I+0.1*I*(global.diff/4)-3.0*I/(_i+1)), 2 });
 	}
 
 	return 1;
@@ -147,7 +147,7 @@ int stage5_laserfairy(Enemy *e, int t) {
 		e->pos -= e->args[0];
 
 	FROM_TO(100, 700, (7-global.diff)*(1+(int)creal(e->args[1]))) {
-		complex n = cexp(I*carg(global.plr.pos-e->pos)+(0.2-0.02*global.diff)*I*_i);
+		complex n = sim_cexp(I*sim_carg(global.plr.pos-e->pos)+(0.2-0.02*global.diff)*I*_i);
 		float fac = (0.5+0.2*global.diff);
 		create_lasercurve2c(e->pos, 100, 300, RGBA(0.7, 0.3, 1, 0), las_accel, fac*4*n, fac*0.05*n);
 		PROJECTILE("plainball", e->pos, RGBA(0.7, 0.3, 1, 0), accelerated, { fac*4*n, fac*0.05*n });
@@ -168,7 +168,7 @@ int stage5_miner(Enemy *e, int t) {
 
 	FROM_TO(0, 600, 5-global.diff/2) {
 		tsrand_fill(2);
-		PROJECTILE("rice", e->pos + 20*cexp(2.0*I*M_PI*afrand(0)), RGB(0,0,cabs(e->args[0])), linear, { cexp(2.0*I*M_PI*afrand(1)) });
+		PROJECTILE("rice", e->pos + 20*sim_cexp(2.0*I*M_PI*afrand(0)), RGB(0,0,sim_cabs(e->args[0])), linear, { sim_cexp(2.0*I*M_PI*afrand(1)) });
 		play_sound_ex("shot3", 0, false);
 	}
 
@@ -215,18 +215,18 @@ int stage5_magnetto(Enemy *e, int t) {
 	}
 
 	FROM_TO(140, 320, 1) {
-		e->pos += 3 * cexp(I*(carg(e->args[1] - e->pos) + M_PI/2));
-		GO_TO(e, e->args[1], pow((t - 140) / 300.0, 3));
+		e->pos += 3 * sim_cexp(I*(sim_carg(e->args[1] - e->pos) + M_PI/2));
+		GO_TO(e, e->args[1], sim_pow((t - 140) / 300.0, 3));
 	}
 
 	FROM_TO_SND("shot1_loop", 140, 280, 1 + 2 * (1 + D_Lunatic - global.diff)) {
-		// complex dir = cexp(I*carg(global.plr.pos - e->pos));
+		// complex dir = sim_cexp(I*sim_carg(global.plr.pos - e->pos));
 
 		for(int i = 0; i < 2 - (global.diff == D_Easy); ++i) {
-			complex dir = cexp(I*(M_PI*i + M_PI/8*sin(2*(t-140)/70.0 * M_PI) + carg(e->args[1] - e->pos)));
+			complex dir = sim_cexp(I*(M_PI*i + M_PI/8*sim_sin(2*(t-140)/70.0 * M_PI) + sim_carg(e->args[1] - e->pos)));
 
 			PROJECTILE("ball", e->pos,
-				.color = RGBA(0.1 + 0.5 * pow((t - 140) / 140.0, 2), 0.0, 0.8, 0.0),
+				.color = RGBA(0.1 + 0.5 * sim_pow((t - 140) / 140.0, 2), 0.0, 0.8, 0.0),
 				.rule = accelerated,
 				.args = {
 					(-2 + (global.diff == D_Hard)) * dir,
@@ -256,18 +256,18 @@ int stage5_explosion(Enemy *e, int t) {
 	}
 
 	FROM_TO(90, 300, 7-global.diff) {
-		PROJECTILE("soul", e->pos, RGBA(0, 0, 1, 0), asymptotic, { 4*cexp(0.5*I*_i), 3 });
+		PROJECTILE("soul", e->pos, RGBA(0, 0, 1, 0), asymptotic, { 4*sim_cexp(0.5*I*_i), 3 });
 		play_sound("shot_special1");
 	}
 
 	FROM_TO(200, 720, 6-global.diff) {
-		PROJECTILE("rice", e->pos, RGB(1,0,0), asymptotic, { 2*cexp(-0.3*I*_i+frand()*I), 3 });
-		PROJECTILE("rice", e->pos, RGB(1,0,0), asymptotic, {-2*cexp(-0.3*I*_i+frand()*I), 3 });
+		PROJECTILE("rice", e->pos, RGB(1,0,0), asymptotic, { 2*sim_cexp(-0.3*I*_i+frand()*I), 3 });
+		PROJECTILE("rice", e->pos, RGB(1,0,0), asymptotic, {-2*sim_cexp(-0.3*I*_i+frand()*I), 3 });
 		play_sound("shot3");
 	}
 
 	FROM_TO(500-30*(global.diff-D_Easy), 800, 100-10*global.diff) {
-		create_laserline(e->pos, 10*cexp(I*carg(global.plr.pos-e->pos)+0.04*I*(1-2*frand())), 60, 120, RGBA(1, 0.3, 1, 0));
+		create_laserline(e->pos, 10*sim_cexp(I*sim_carg(global.plr.pos-e->pos)+0.04*I*(1-2*frand())), 60, 120, RGBA(1, 0.3, 1, 0));
 		play_sound_delayed("laser1", 0, true, 45);
 	}
 
@@ -355,14 +355,14 @@ int stage5_lightburst2(Enemy *e, int t) {
 		int c = 4+global.diff-(global.diff==D_Easy);
 		for(i = 0; i < c; i++) {
 			tsrand_fill(2);
-			complex n = cexp(I*carg(global.plr.pos-e->pos) + 2.0*I*M_PI/c*i);
+			complex n = sim_cexp(I*sim_carg(global.plr.pos-e->pos) + 2.0*I*M_PI/c*i);
 			PROJECTILE(
 				.sprite = "bigball",
-				.pos = e->pos + 50*n*cexp(-1.0*I*_i*global.diff),
+				.pos = e->pos + 50*n*sim_cexp(-1.0*I*_i*global.diff),
 				.color = RGB(0.3, 0, 0.7+0.3*(_i&1)),
 				.rule = asymptotic,
 				.args = {
-					2.5*n+0.25*global.diff*afrand(0)*cexp(2.0*I*M_PI*afrand(1)),
+					2.5*n+0.25*global.diff*afrand(0)*sim_cexp(2.0*I*M_PI*afrand(1)),
 					3
 				}
 			);
@@ -386,7 +386,7 @@ int stage5_superbullet(Enemy *e, int t) {
 	}
 
 	FROM_TO(60, 200, 1) {
-		complex n = cexp(I*M_PI*sin(_i/(8.0+global.diff)+frand()*0.1)+I*carg(global.plr.pos-e->pos));
+		complex n = sim_cexp(I*M_PI*sim_sin(_i/(8.0+global.diff)+frand()*0.1)+I*sim_carg(global.plr.pos-e->pos));
 		PROJECTILE("bullet", e->pos + 50*n, RGB(0.6, 0, 0), asymptotic, { 2*n, 10 });
 		play_sound("shot1");
 	}
@@ -439,7 +439,7 @@ void iku_bolts(Boss *b, int time) {
 		for(i = 0; i < c; i++) {
 			PROJECTILE("ball", b->pos, RGBA(0.4, 1.0, 1.0, 0), asymptotic,
 				.args = {
-					(i+2)*0.4*cexp(I*carg(global.plr.pos-b->pos))+0.2*(global.diff-1)*frand(),
+					(i+2)*0.4*sim_cexp(I*sim_carg(global.plr.pos-b->pos))+0.2*(global.diff-1)*frand(),
 					3
 				},
 			);
@@ -472,12 +472,12 @@ void iku_atmospheric(Boss *b, int time) {
 	int t = time % 500;
 	TIMER(&t);
 
-	GO_TO(b,VIEWPORT_W/2+tanh(sin(time/100))*(200-100*(global.diff==D_Easy))+I*VIEWPORT_H/3+I*(cos(t/200)-1)*50,0.03);
+	GO_TO(b,VIEWPORT_W/2+sim_tanh(sim_sin(time/100))*(200-100*(global.diff==D_Easy))+I*VIEWPORT_H/3+I*(sim_cos(t/200)-1)*50,0.03);
 
 	FROM_TO(0, 500, 23-2*global.diff) {
 		tsrand_fill(4);
 		complex p1 = VIEWPORT_W*afrand(0) + VIEWPORT_H/2*I*afrand(1);
-		complex p2 = p1 + (120+20*global.diff)*cexp(0.5*I-afrand(2)*I)*(1-2*(afrand(3) > 0.5));
+		complex p2 = p1 + (120+20*global.diff)*sim_cexp(0.5*I-afrand(2)*I)*(1-2*(afrand(3) > 0.5));
 
 		int i;
 		int c = 6+global.diff;
@@ -489,7 +489,7 @@ void iku_atmospheric(Boss *b, int time) {
 				.color = RGBA(1-1/(1+fabs(0.1*i)), 0.5-0.1*abs(i), 1, 0),
 				.rule = accelerated,
 				.args = {
-					0, (0.004+0.001*global.diff)*cexp(I*carg(p2-p1)+I*M_PI/2+0.2*I*i)
+					0, (0.004+0.001*global.diff)*sim_cexp(I*sim_carg(p2-p1)+I*M_PI/2+0.2*I*i)
 				},
 			);
 		}
@@ -513,7 +513,7 @@ complex bolts2_laser(Laser *l, float t) {
 	}
 
 	double diff = creal(l->args[2]);
-	return creal(l->args[0])+I*cimag(l->pos) + sign(cimag(l->args[0]-l->pos))*0.06*I*t*t + (20+4*diff)*sin(t*0.025*diff+creal(l->args[0]))*l->args[1];
+	return creal(l->args[0])+I*cimag(l->pos) + sign(cimag(l->args[0]-l->pos))*0.06*I*t*t + (20+4*diff)*sim_sin(t*0.025*diff+creal(l->args[0]))*l->args[1];
 }
 
 void iku_bolts2(Boss *b, int time) {
@@ -541,7 +541,7 @@ void iku_bolts2(Boss *b, int time) {
 
 	FROM_TO_SND("shot1_loop", 0, 400, 5-global.diff)
 		if(frand() < 0.9)
-			PROJECTILE("plainball", b->pos, RGB(0.2,0,0.8), linear, { cexp(0.1*I*_i) });
+			PROJECTILE("plainball", b->pos, RGB(0.2,0,0.8), linear, { sim_cexp(0.1*I*_i) });
 
 	FROM_TO(0, 70, 1)
 		GO_TO(b, 100+200.0*I, 0.02);
@@ -562,15 +562,15 @@ int lightning_slave(Enemy *e, int t) {
 	e->pos += e->args[0];
 
 	FROM_TO(0,200,20)
-		e->args[0] *= cexp(I * (0.25 + 0.25 * frand() * M_PI));
+		e->args[0] *= sim_cexp(I * (0.25 + 0.25 * frand() * M_PI));
 
 	FROM_TO(0, 200, 3)
-		if(cabs(e->pos-global.plr.pos) > 60) {
+		if(sim_cabs(e->pos-global.plr.pos) > 60) {
 			Color *clr = RGBA(1-1/(1+0.01*_i), 0.5-0.01*_i, 1, 0);
 
 			Projectile *p = PROJECTILE("wave", e->pos, clr, asymptotic,
 				.args = {
-					0.75*e->args[0]/cabs(e->args[0])*I,
+					0.75*e->args[0]/sim_cabs(e->args[0])*I,
 					10
 				},
 			);
@@ -578,7 +578,7 @@ int lightning_slave(Enemy *e, int t) {
 			if(projectile_in_viewport(p)) {
 				for(int i = 0; i < 3; ++i) {
 					tsrand_fill(2);
-					lightning_particle(p->pos + 5 * afrand(0) * cexp(I*M_PI*2*afrand(1)), 0);
+					lightning_particle(p->pos + 5 * afrand(0) * sim_cexp(I*M_PI*2*afrand(1)), 0);
 				}
 
 				play_sound_ex("shot3", 0, false);
@@ -625,14 +625,14 @@ void iku_lightning(Boss *b, int time) {
 
 	TIMER(&t);
 
-	GO_TO(b,VIEWPORT_W/2+tanh(sin(time/100))*200+I*VIEWPORT_H/3+I*(cos(t/200)-1)*50,0.03);
+	GO_TO(b,VIEWPORT_W/2+sim_tanh(sim_sin(time/100))*200+I*VIEWPORT_H/3+I*(sim_cos(t/200)-1)*50,0.03);
 
 	AT(0) {
 		play_sound("charge_generic");
 	}
 
 	FROM_TO(0, 60, 1) {
-		complex n = cexp(2.0*I*M_PI*frand());
+		complex n = sim_cexp(2.0*I*M_PI*frand());
 		float l = 150*frand()+50;
 		float s = 4+_i*0.01;
 		float alpha = 0.5;
@@ -652,7 +652,7 @@ void iku_lightning(Boss *b, int time) {
 		int c = 7 + 2 * (global.diff == D_Lunatic);
 		for(int i = 0; i<c; i++) {
 			PROJECTILE("bigball", b->pos, RGBA(0.5, 0.1, 1.0, 0.0), zigzag_bullet,
-				.args = { cexp(2*M_PI*I/c*i+I*carg(global.plr.pos-b->pos)) },
+				.args = { sim_cexp(2*M_PI*I/c*i+I*sim_carg(global.plr.pos-b->pos)) },
 			);
 		}
 
@@ -668,7 +668,7 @@ void iku_lightning(Boss *b, int time) {
 		int s = 10;
 
 		for(int i=0; i < c; i++) {
-			complex n = cexp(2.0*I*M_PI*frand());
+			complex n = sim_cexp(2.0*I*M_PI*frand());
 			PARTICLE(
 				.sprite = "smoke",
 				.pos = b->pos,
@@ -681,7 +681,7 @@ void iku_lightning(Boss *b, int time) {
 		}
 
 		for(int i = 0; i < global.diff+1; i++){
-			create_enemy1c(b->pos, ENEMY_IMMUNE, NULL, lightning_slave, 10*cexp(I*carg(global.plr.pos - b->pos)+2.0*I*M_PI/(global.diff+1)*i));
+			create_enemy1c(b->pos, ENEMY_IMMUNE, NULL, lightning_slave, 10*sim_cexp(I*sim_carg(global.plr.pos - b->pos)+2.0*I*M_PI/(global.diff+1)*i));
 		}
 
 		play_sound("shot_special1");
@@ -700,7 +700,7 @@ void iku_bolts3(Boss *b, int time) {
 		aniplayer_queue(&b->ani, (_i&1) ? "dashdown_left" : "dashdown_right",1);
 		aniplayer_queue(&b->ani, "main", 0);
 		int i, c = 10+global.diff;
-		complex n = cexp(I*carg(global.plr.pos-b->pos)+0.1*I-0.2*I*frand());
+		complex n = sim_cexp(I*sim_carg(global.plr.pos-b->pos)+0.1*I-0.2*I*frand());
 		for(i = 0; i < c; i++) {
 			PROJECTILE("ball", b->pos, RGBA(0.4, 1.0, 1.0, 0.0), asymptotic,
 				.args = {
@@ -716,7 +716,7 @@ void iku_bolts3(Boss *b, int time) {
 
 	FROM_TO_SND("shot1_loop", 0, 400, 5-global.diff)
 		if(frand() < 0.9)
-			PROJECTILE("plainball", b->pos, RGB(0.2,0,0.8), linear, { cexp(0.1*I*_i) });
+			PROJECTILE("plainball", b->pos, RGB(0.2,0,0.8), linear, { sim_cexp(0.1*I*_i) });
 
 	FROM_TO(0, 70, 1)
 		GO_TO(b, 100+200.0*I, 0.02);
@@ -727,7 +727,7 @@ void iku_bolts3(Boss *b, int time) {
 }
 
 static complex induction_bullet_traj(Projectile *p, float t) {
-	return p->pos0 + p->args[0]*t*cexp(p->args[1]*t);
+	return p->pos0 + p->args[0]*t*sim_cexp(p->args[1]*t);
 }
 
 int induction_bullet(Projectile *p, int time) {
@@ -751,7 +751,7 @@ int induction_bullet(Projectile *p, int time) {
 		p->prevpos = p->pos;
 	}
 
-	p->angle = carg(p->args[0]*cexp(p->args[1]*t)*(1+p->args[1]*t));
+	p->angle = sim_carg(p->args[0]*sim_cexp(p->args[1]*t)*(1+p->args[1]*t));
 	return 1;
 }
 
@@ -763,7 +763,7 @@ complex cathode_laser(Laser *l, float t) {
 
 	l->args[1] = I*cimag(l->args[1]);
 
-	return l->pos + l->args[0]*t*cexp(l->args[1]*t);
+	return l->pos + l->args[0]*t*sim_cexp(l->args[1]*t);
 }
 
 void iku_cathode(Boss *b, int t) {
@@ -783,13 +783,13 @@ void iku_cathode(Boss *b, int t) {
 		for(i = 0; i < c; i++) {
 			PROJECTILE("bigball", b->pos, RGBA(0.2, 0.4, 1.0, 0.0), induction_bullet,
 				.args = {
-					speedmod*2*cexp(2.0*I*M_PI*frand()),
+					speedmod*2*sim_cexp(2.0*I*M_PI*frand()),
 					speedmod*0.01*I*(1-2*(_i&1)),
 					1
 				},
 			);
 			if(i < c*3/4)
-				create_lasercurve2c(b->pos, 60, 200, RGBA(0.4, 1, 1, 0), cathode_laser, 2*cexp(2.0*I*M_PI*M_PI*frand()), 0.015*I*(1-2*(_i&1)));
+				create_lasercurve2c(b->pos, 60, 200, RGBA(0.4, 1, 1, 0), cathode_laser, 2*sim_cexp(2.0*I*M_PI*M_PI*frand()), 0.015*I*(1-2*(_i&1)));
 		}
 
 		// XXX: better ideas?
@@ -830,7 +830,7 @@ void iku_induction(Boss *b, int t) {
 					a += 0.0005;
 				PROJECTILE("ball", b->pos, clr, induction_bullet,
 					.args = {
-						2*cexp(2.0*I*M_PI/c*i+I*M_PI/2+I*shift),
+						2*sim_cexp(2.0*I*M_PI/c*i+I*M_PI/2+I*shift),
 						(0.01+0.001*global.diff)*I*(1-2*j)+a
 					},
 					.max_viewport_dist = 400*(global.diff>=D_Hard),
@@ -847,14 +847,14 @@ Enemy* iku_extra_find_next_slave(complex from, double playerbias) {
 	Enemy *nearest = NULL, *e;
 	double dist, mindist = INFINITY;
 
-	complex org = from + playerbias * cexp(I*(carg(global.plr.pos - from)));
+	complex org = from + playerbias * sim_cexp(I*(sim_carg(global.plr.pos - from)));
 
 	for(e = global.enemies.first; e; e = e->next) {
 		if(e->args[2]) {
 			continue;
 		}
 
-		dist = cabs(e->pos - org);
+		dist = sim_cabs(e->pos - org);
 
 		if(dist < mindist) {
 			nearest = e;
@@ -907,7 +907,7 @@ int iku_extra_trigger_bullet(Projectile *p, int t) {
 
 	if(creal(p->args[2]) < 0) {
 		linear(p, t);
-		if(cabs(p->pos - target->pos) < 5) {
+		if(sim_cabs(p->pos - target->pos) < 5) {
 			p->pos = target->pos;
 			target->args[1] = 1;
 			p->args[2] = 55 - 5 * global.diff;
@@ -922,7 +922,7 @@ int iku_extra_trigger_bullet(Projectile *p, int t) {
 	if(creal(p->args[2]) == 0) {
 		int cnt = 6 + 2 * global.diff;
 		for(int i = 0; i < cnt; ++i) {
-			complex dir = cexp(I*(t + i*2*M_PI/cnt));
+			complex dir = sim_cexp(I*(t + i*2*M_PI/cnt));
 			PROJECTILE("bigball", p->pos, RGBA(1.0, 0.5, 0.0, 0.0), asymptotic, { 1.1*dir, 5  });
 			PROJECTILE("bigball", p->pos, RGBA(0.0, 0.5, 1.0, 0.0), asymptotic, {     dir, 10 });
 		}
@@ -960,7 +960,7 @@ void iku_extra_fire_trigger_bullet(void) {
 	Boss *b = global.boss;
 
 	PROJECTILE("soul", b->pos, RGB(0.2, 0.2, 1.0), iku_extra_trigger_bullet, {
-		3*cexp(I*carg(e->pos - b->pos)),
+		3*sim_cexp(I*sim_carg(e->pos - b->pos)),
 		add_ref(e),
 		-1
 	});
@@ -999,7 +999,7 @@ int iku_extra_slave(Enemy *e, int t) {
 
 					for(i = 0; i < cnt; ++i) {
 						PROJECTILE("rice", e->pos, RGBA(1, 1, 0, 0), asymptotic,
-							.args = { 2*cexp(I*(r+i*2*M_PI/cnt)), 2 },
+							.args = { 2*sim_cexp(I*(r+i*2*M_PI/cnt)), 2 },
 						);
 					}
 
@@ -1023,7 +1023,7 @@ int iku_extra_slave(Enemy *e, int t) {
 
 					for(i = 0; i < cnt; ++i) {
 						PROJECTILE("ball", o->pos, RGBA(0, 1, 1, 0), asymptotic,
-							.args = { 1.5*cexp(I*(t + i*2*M_PI/cnt)), 8},
+							.args = { 1.5*sim_cexp(I*(t + i*2*M_PI/cnt)), 8},
 						);
 					}
 
@@ -1129,12 +1129,12 @@ void stage5_events(void) {
 
 	FROM_TO(400, 600, 10) {
 		tsrand_fill(2);
-		create_enemy3c(200.0*I*afrand(0), 500, Swirl, stage5_swirl, 4+I, 70+20*afrand(1)+200.0*I, cexp(-0.05*I));
+		create_enemy3c(200.0*I*afrand(0), 500, Swirl, stage5_swirl, 4+I, 70+20*afrand(1)+200.0*I, sim_cexp(-0.05*I));
 	}
 
 	FROM_TO(700, 800, 10) {
 		tsrand_fill(3);
-		create_enemy3c(VIEWPORT_W+200.0*I*afrand(0), 500, Swirl, stage5_swirl, -4+afrand(1)*I, 70+20*afrand(2)+200.0*I, cexp(0.05*I));
+		create_enemy3c(VIEWPORT_W+200.0*I*afrand(0), 500, Swirl, stage5_swirl, -4+afrand(1)*I, 70+20*afrand(2)+200.0*I, sim_cexp(0.05*I));
 	}
 
 	FROM_TO(870+50*(global.diff==D_Easy), 1000, 50)
@@ -1189,13 +1189,13 @@ void stage5_events(void) {
 	FROM_TO(4200, 5000, 20-3*global.diff) {
 		float f = frand();
 		create_enemy3c(
-			VIEWPORT_W/2+300*sin(global.frames)*cos(2*global.frames),
+			VIEWPORT_W/2+300*sim_sin(global.frames)*sim_cos(2*global.frames),
 			400,
 			Swirl,
 			stage5_swirl,
-			2*cexp(I*M_PI*f)+I,
+			2*sim_cexp(I*M_PI*f)+I,
 			60 + 100.0*I,
-			cexp(0.01*I*(1-2*(f<0.5)))
+			sim_cexp(0.01*I*(1-2*(f<0.5)))
 		);
 	}
 
@@ -41,9 +41,9 @@ int stage6_hacker(Enemy *e, int t) {
 	FROM_TO_SND("shot1_loop",100, 180+40*global.diff, 3) {
 		int i;
 		for(i = 0; i < 6; i++) {
-			complex n = sin(_i*0.2)*cexp(I*0.3*(i/2-1))*(1-2*(i&1));
+			complex n = sim_sin(_i*0.2)*sim_cexp(I*0.3*(i/2-1))*(1-2*(i&1));
 			PROJECTILE("wave", e->pos + 120*n, RGB(1.0, 0.2-0.01*_i, 0.0), linear, {
-				(0.25-0.5*psin(global.frames+_i*46752+16463*i+467*sin(global.frames*_i*i)))*global.diff+creal(n)+2.0*I
+				(0.25-0.5*psin(global.frames+_i*46752+16463*i+467*sim_sin(global.frames*_i*i)))*global.diff+creal(n)+2.0*I
 			});
 		}
 	}
@@ -71,7 +71,7 @@ int stage6_side(Enemy *e, int t) {
 			PROJECTILE(
 				.sprite = (i%2 == 0) ? "rice" : "flea",
 				.pos = e->pos+5*(i/2)*e->args[1],
-				.color = RGB(0.1*cabs(e->args[2]), 0.5, 1),
+				.color = RGB(0.1*sim_cabs(e->args[2]), 0.5, 1),
 				.rule = accelerated,
 				.args = {
 					(1.0*I-2.0*I*(i&1))*(0.7+0.2*global.diff),
@@ -102,7 +102,7 @@ int wait_proj(Projectile *p, int t) {
 			);
 		}
 
-		p->angle = carg(p->args[0]);
+		p->angle = sim_carg(p->args[0]);
 		p->pos += p->args[0];
 	}
 
@@ -119,16 +119,16 @@ int stage6_flowermine(Enemy *e, int t) {
 	e->pos += e->args[0];
 
 	FROM_TO(70, 200, 1)
-		e->args[0] += 0.07*cexp(I*carg(e->args[1]-e->pos));
+		e->args[0] += 0.07*sim_cexp(I*sim_carg(e->args[1]-e->pos));
 
 	FROM_TO(0, 1000, 7-global.diff) {
 		PROJECTILE(
 			.sprite = "rice",
-			.pos = e->pos + 40*cexp(I*0.6*_i+I*carg(e->args[0])),
+			.pos = e->pos + 40*sim_cexp(I*0.6*_i+I*sim_carg(e->args[0])),
 			.color = RGB(1-psin(_i), 0.3, psin(_i)),
 			.rule = wait_proj,
 			.args = {
-				I*cexp(I*0.6*_i)*(0.7+0.3*global.diff),
+				I*sim_cexp(I*0.6*_i)*(0.7+0.3*global.diff),
 				200
 			},
 			.angle = 0.6*_i,
@@ -158,7 +158,7 @@ int scythe_mid(Enemy *e, int t) {
 
 	e->pos += (6-global.diff-0.005*I*t)*e->args[0];
 
-	n = cexp(cimag(e->args[1])*I*t);
+	n = sim_cexp(cimag(e->args[1])*I*t);
 	FROM_TO_SND("shot1_loop",0,300,1) {}
 	PROJECTILE(
 		.sprite = "bigball",
@@ -166,7 +166,7 @@ int scythe_mid(Enemy *e, int t) {
 		.color = RGBA(0.2, 0.5-0.5*cimag(n), 0.5+0.5*creal(n), 0.0),
 		.rule = wait_proj,
 		.args = {
-			global.diff*cexp(0.6*I)*n,
+			global.diff*sim_cexp(0.6*I)*n,
 			100
 		},
 	);
@@ -175,7 +175,7 @@ int scythe_mid(Enemy *e, int t) {
 		Projectile *p = PROJECTILE("ball", e->pos + 80*n, RGBA(0, 0.2, 0.5, 0.0), accelerated,
 			.args = {
 				n,
-				0.01*global.diff*cexp(I*carg(global.plr.pos - e->pos - 80*n))
+				0.01*global.diff*sim_cexp(I*sim_carg(global.plr.pos - e->pos - 80*n))
 			},
 		);
 
@@ -206,7 +206,7 @@ void Scythe(Enemy *e, int t, bool render) {
 
 	PARTICLE(
 		.sprite_ptr = get_sprite("stage6/scythe"),
-		.pos = e->pos+I*6*sin(global.frames/25.0),
+		.pos = e->pos+I*6*sim_sin(global.frames/25.0),
 		.draw_rule = ScytheTrail,
 		.timeout = 8,
 		.args = { 0, e->args[2] },
@@ -216,7 +216,7 @@ void Scythe(Enemy *e, int t, bool render) {
 
 	PARTICLE(
 		.sprite = "smoothdot",
-		.pos = e->pos+100*creal(e->args[2])*frand()*cexp(2.0*I*M_PI*frand()),
+		.pos = e->pos+100*creal(e->args[2])*frand()*sim_cexp(2.0*I*M_PI*frand()),
 		.color = RGBA(1.0, 0.1, 1.0, 0.0),
 		.draw_rule = GrowFade,
 		.rule = linear,
@@ -283,15 +283,15 @@ int scythe_infinity(Enemy *e, int t) {
 
 	FROM_TO_SND("shot1_loop",40, 3000, 1) {
 		float w = min(0.15, 0.0001*(t-40));
-		e->pos = VIEWPORT_W/2 + 200.0*I + 200*cos(w*(t-40)+M_PI/2.0) + I*80*sin(creal(e->args[0])*w*(t-40));
+		e->pos = VIEWPORT_W/2 + 200.0*I + 200*sim_cos(w*(t-40)+M_PI/2.0) + I*80*sim_sin(creal(e->args[0])*w*(t-40));
 
 		PROJECTILE(
 			.sprite = "ball",
-			.pos = e->pos+80*cexp(I*creal(e->args[1])),
-			.color = RGB(cos(creal(e->args[1])), sin(creal(e->args[1])), cos(creal(e->args[1])+2.1)),
+			.pos = e->pos+80*sim_cexp(I*creal(e->args[1])),
+			.color = RGB(sim_cos(creal(e->args[1])), sim_sin(creal(e->args[1])), sim_cos(creal(e->args[1])+2.1)),
 			.rule = asymptotic,
 			.args = {
-				(1+0.4*global.diff)*cexp(I*creal(e->args[1])),
+				(1+0.4*global.diff)*sim_cexp(I*creal(e->args[1])),
 				3 + 0.2 * global.diff
 			}
 		);
@@ -373,7 +373,7 @@ int scythe_newton(Enemy *e, int t) {
 	}
 
 	FROM_TO(100, 10000, 1) {
-		e->pos = VIEWPORT_W/2+I*VIEWPORT_H/2 + 400*cos(_i*0.04)*cexp(I*_i*0.01);
+		e->pos = VIEWPORT_W/2+I*VIEWPORT_H/2 + 400*sim_cos(_i*0.04)*sim_cexp(I*_i*0.01);
 	}
 
 
@@ -382,8 +382,8 @@ int scythe_newton(Enemy *e, int t) {
 		for(p = global.projs.first; p; p = p->next) {
 			if(
 				p->type == EnemyProj &&
-				cabs(p->pos-e->pos) < 50 &&
-				cabs(global.plr.pos-e->pos) > 50 &&
+				sim_cabs(p->pos-e->pos) < 50 &&
+				sim_cabs(global.plr.pos-e->pos) > 50 &&
 				p->args[2] == 0 &&
 				p->sprite != get_sprite("proj/apple")
 			) {
@@ -392,7 +392,7 @@ int scythe_newton(Enemy *e, int t) {
 				play_sound_ex("redirect",4,false);
 				p->birthtime=global.frames;
 				p->pos0=p->pos;
-				p->args[0] = (2+0.125*global.diff)*cexp(I*2*M_PI*frand());
+				p->args[0] = (2+0.125*global.diff)*sim_cexp(I*2*M_PI*frand());
 				p->color = *RGBA_MUL_ALPHA(frand(), 0, 1, 0.8);
 				p->args[2] = 1;
 			}
@@ -401,7 +401,7 @@ int scythe_newton(Enemy *e, int t) {
 
 	/*
 	FROM_TO(100, 10000, 5-global.diff/2) {
-		if(cabs(global.plr.pos-e->pos) > 50)
+		if(sim_cabs(global.plr.pos-e->pos) > 50)
 			PROJECTILE("rice", e->pos, RGB(0.3, 1, 0.8), linear, { I });
 	}
 	*/
@@ -414,7 +414,7 @@ static int newton_apple(Projectile *p, int t) {
 	int r = accelerated(p, t);
 
 	if(t >= 0) {
-		p->angle += M_PI/16 * sin(creal(p->args[2]) + t / 30.0);
+		p->angle += M_PI/16 * sim_sin(creal(p->args[2]) + t / 30.0);
 	}
 
 	return r;
@@ -463,14 +463,14 @@ void elly_newton(Boss *b, int t) {
 	}
 
 	FROM_TO(0, 100000, 20+10*(global.diff>D_Normal)) {
-		float a = 2.7*_i+carg(global.plr.pos-b->pos);
+		float a = 2.7*_i+sim_carg(global.plr.pos-b->pos);
 		int x, y;
 		float w = global.diff/2.0+1.5;
 
 		play_sound("shot_special1");
 		for(x = -w; x <= w; x++) {
 			for(y = -w; y <= w; y++) {
-				PROJECTILE("ball", b->pos+(x+I*y)*25*cexp(I*a), RGB(0, 0.5, 1), linear, { (2+(_i==0))*cexp(I*a) });
+				PROJECTILE("ball", b->pos+(x+I*y)*25*sim_cexp(I*a), RGB(0, 0.5, 1), linear, { (2+(_i==0))*sim_cexp(I*a) });
 			}
 		}
 	}
@@ -489,7 +489,7 @@ int scythe_kepler(Enemy *e, int t) {
 	}
 
 	FROM_TO(20, 10000, 1) {
-		GO_TO(e, global.boss->pos + 100*cexp(I*_i*0.01),0.03);
+		GO_TO(e, global.boss->pos + 100*sim_cexp(I*_i*0.01),0.03);
 	}
 
 	scythe_common(e, t);
@@ -522,7 +522,7 @@ int kepler_bullet(Projectile *p, int t) {
 	complex pos = p->pos0;
 
 	if(tier != 0) {
-		Projectile *parent = (Projectile *) REF(creal(p->args[2]));
+		Projectile *parent = REF_ENT(creal(p->args[2]), Projectile);
 
 		if(parent == 0) {
 			p->pos += p->args[3];
@@ -533,7 +533,7 @@ int kepler_bullet(Projectile *p, int t) {
 		pos += t*p->args[2];
 	}
 
-	complex newpos = pos + tanh(t/90.)*p->args[0]*cexp((1-2*(tier&1))*I*t*0.5/cabs(p->args[0]));
+	complex newpos = pos + sim_tanh(t/90.)*p->args[0]*sim_cexp((1-2*(tier&1))*I*t*0.5/sim_cabs(p->args[0]));
 	complex vel = newpos-p->pos;
 	p->pos = newpos;
 	p->args[3] = vel;
@@ -541,7 +541,7 @@ int kepler_bullet(Projectile *p, int t) {
 	if(t%(30-5*global.diff) == 0) {
 		p->args[1]+=1*I;
 		int tau = global.frames-global.boss->current->starttime;
-		complex phase = cexp(I*0.2*tau*tau);
+		complex phase = sim_cexp(I*0.2*tau*tau);
 		int n = global.diff/2+3+(frand()>0.3);
 		if(global.diff == D_Easy)
 			n=7;
@@ -554,7 +554,7 @@ int kepler_bullet(Projectile *p, int t) {
 				.color = RGB(0.3 + 0.3 * tier, 0.6 - 0.3 * tier, 1.0),
 				.rule = kepler_bullet,
 				.args = {
-					cabs(p->args[0])*phase,
+					sim_cabs(p->args[0])*phase,
 					tier+1,
 					add_ref(p)
 				}
@@ -587,7 +587,7 @@ void elly_kepler(Boss *b, int t) {
 		int c = 2;
 		play_sound("shot_special1");
 		for(int i = 0; i < c; i++) {
-			complex n = cexp(I*2*M_PI/c*i+I*0.6*_i);
+			complex n = sim_cexp(I*2*M_PI/c*i+I*0.6*_i);
 
 			PROJECTILE(
 				.proto = kepler_pick_bullet(0),
@@ -619,8 +619,8 @@ void elly_frequency2(Boss *b, int t) {
 	}
 
 	FROM_TO_SND("shot1_loop",0, 2000, 3-global.diff/2) {
-		complex n = sin(t*0.12*global.diff)*cexp(t*0.02*I*global.diff);
-		PROJECTILE("plainball", b->pos+80*n, RGB(0,0,0.7), asymptotic, { 2*n/cabs(n), 3 });
+		complex n = sim_sin(t*0.12*global.diff)*sim_cexp(t*0.02*I*global.diff);
+		PROJECTILE("plainball", b->pos+80*n, RGB(0,0,0.7), asymptotic, { 2*n/sim_cabs(n), 3 });
 	}
 }
 
@@ -631,7 +631,7 @@ complex maxwell_laser(Laser *l, float t) {
 		return 0;
 	}
 
-	return l->pos + l->args[0]*(t+I*creal(l->args[2])*t*0.02*sin(0.1*t+cimag(l->args[2])));
+	return l->pos + l->args[0]*(t+I*creal(l->args[2])*t*0.02*sim_sin(0.1*t+cimag(l->args[2])));
 }
 
 void maxwell_laser_logic(Laser *l, int t) {
@@ -659,7 +659,7 @@ void elly_maxwell(Boss *b, int t) {
 
 	}
 	FROM_TO(40, 159, 5) {
-		create_laser(b->pos, 200, 10000, RGBA(0, 0.2, 1, 0.0), maxwell_laser, maxwell_laser_logic, cexp(2.0*I*M_PI/24*_i)*VIEWPORT_H*0.005, 200+15.0*I, 0, 0);
+		create_laser(b->pos, 200, 10000, RGBA(0, 0.2, 1, 0.0), maxwell_laser, maxwell_laser_logic, sim_cexp(2.0*I*M_PI/24*_i)*VIEWPORT_H*0.005, 200+15.0*I, 0, 0);
 	}
 
 }
@@ -678,10 +678,10 @@ void Baryon(Enemy *e, int t, bool render) {
 	Enemy *n;
 
 	if(!render) {
-		if(!(t % 10) && global.boss && cabs(e->pos - global.boss->pos) > 2) {
+		if(!(t % 10) && global.boss && sim_cabs(e->pos - global.boss->pos) > 2) {
 			PARTICLE(
 				.sprite = "stain",
-				.pos = e->pos+10*frand()*cexp(2.0*I*M_PI*frand()),
+				.pos = e->pos+10*frand()*sim_cexp(2.0*I*M_PI*frand()),
 				.color = RGBA(0, 1, 0.7, 0.0),
 				.draw_rule = Fade,
 				.timeout = 50,
@@ -708,7 +708,7 @@ void BaryonCenter(Enemy *e, int t, bool render) {
 	int i;
 
 	if(!render) {
-		complex p = e->pos+40*frand()*cexp(2.0*I*M_PI*frand());
+		complex p = e->pos+40*frand()*sim_cexp(2.0*I*M_PI*frand());
 
 		PARTICLE("flare", p, RGBA(0.0, 1.0, 1.0, 0.0),
 			.draw_rule = GrowFade,
@@ -766,9 +766,9 @@ int baryon_unfold(Enemy *baryon, int t) {
 			if(e->visual_rule == BaryonCenter) {
 				float f = t / (float)timeout;
 				float x = f;
-				float g = sin(2 * M_PI * log(log(x + 1) + 1));
-				float a = g * pow(1 - x, 2 * x);
-				f = 1 - pow(1 - f, 3) + a;
+				float g = sim_sin(2 * M_PI * sim_log(sim_log(x + 1) + 1));
+				float a = g * sim_pow(1 - x, 2 * x);
+				f = 1 - sim_pow(1 - f, 3) + a;
 
 				baryon->pos = baryon->pos0 = e->pos + baryon->args[0] * f * extent;
 				return 1;
@@ -824,7 +824,7 @@ void elly_spawn_baryons(complex pos) {
 	Enemy *e, *last = NULL, *first = NULL, *middle = NULL;
 
 	for(i = 0; i < 6; i++) {
-		e = create_enemy3c(pos, ENEMY_IMMUNE, Baryon, baryon_unfold, 1.5*cexp(2.0*I*M_PI/6*i), i != 0 ? add_ref(last) : 0, i);
+		e = create_enemy3c(pos, ENEMY_IMMUNE, Baryon, baryon_unfold, 1.5*sim_cexp(2.0*I*M_PI/6*i), i != 0 ? add_ref(last) : 0, i);
 		e->ent.draw_layer = LAYER_BACKGROUND;
 
 		if(i == 0) {
@@ -902,7 +902,7 @@ int baryon_eigenstate(Enemy *e, int t) {
 	if(t < 0)
 		return 1;
 
-	e->pos = e->pos0 + 40*sin(0.03*t+M_PI*(creal(e->args[0]) > 0)) + 30*cimag(e->args[0])*I*sin(0.06*t);
+	e->pos = e->pos0 + 40*sim_sin(0.03*t+M_PI*(creal(e->args[0]) > 0)) + 30*cimag(e->args[0])*I*sim_sin(0.06*t);
 
 	TIMER(&t);
 
@@ -913,17 +913,17 @@ int baryon_eigenstate(Enemy *e, int t) {
 		play_sound("shot_special1");
 		play_sound_delayed("redirect",4,true,60);
 		for(i = 0; i < c; i++) {
-			complex n = cexp(2.0*I*_i+I*M_PI/2+I*creal(e->args[2]));
+			complex n = sim_cexp(2.0*I*_i+I*M_PI/2+I*creal(e->args[2]));
 			for(j = 0; j < 3; j++) {
 				PROJECTILE(.sprite = "plainball",
-					.pos = e->pos + 60*cexp(2.0*I*M_PI/c*i),
+					.pos = e->pos + 60*sim_cexp(2.0*I*M_PI/c*i),
 					.color = RGBA(j == 0, j == 1, j == 2, 0.0),
 					.rule = eigenstate_proj,
 					.args = {
 						1*n,
 						1,
 						60,
-						0.6*I*n*(j-1)*cexp(0.4*I-0.1*I*global.diff)
+						0.6*I*n*(j-1)*sim_cexp(0.4*I-0.1*I*global.diff)
 					},
 				);
 			}
@@ -984,14 +984,14 @@ int broglie_particle(Projectile *p, int t) {
 	int scattertime = creal(p->args[1]);
 
 	if(t < scattertime) {
-		Laser *laser = (Laser*)REF(p->args[0]);
+		Laser *laser = REF_ENT(p->args[0], Laser);
 
 		if(laser) {
 			complex oldpos = p->pos;
 			p->pos = laser->prule(laser, min(t, cimag(p->args[1])));
 
 			if(oldpos != p->pos) {
-				p->angle = carg(p->pos - oldpos);
+				p->angle = sim_carg(p->pos - oldpos);
 			}
 		}
 	} else {
@@ -1003,13 +1003,13 @@ int broglie_particle(Projectile *p, int t) {
 			double angle_ampl = creal(p->args[3]);
 			double angle_freq = cimag(p->args[3]);
 
-			p->angle += angle_ampl * sin(t * angle_freq) * cos(2 * t * angle_freq);
-			p->args[2] = -cabs(p->args[2]) * cexp(I*p->angle);
+			p->angle += angle_ampl * sim_sin(t * angle_freq) * sim_cos(2 * t * angle_freq);
+			p->args[2] = -sim_cabs(p->args[2]) * sim_cexp(I*p->angle);
 
 			play_sound("redirect");
 		}
 
-		p->angle = carg(p->args[2]);
+		p->angle = sim_carg(p->args[2]);
 		p->pos = p->pos + p->args[2];
 	}
 
@@ -1030,7 +1030,7 @@ void broglie_laser_logic(Laser *l, int t) {
 	}
 
 	int dt = l->timespan * l->speed;
-	float charge = min(1, pow((double)t / dt, 4));
+	float charge = min(1, sim_pow((double)t / dt, 4));
 	l->color = *HSLA(hue, 1.0, 0.5 + 0.2 * charge, 0.0);
 	l->width_exponent = 1.0 - 0.5 * charge;
 }
@@ -1069,7 +1069,7 @@ int broglie_charge(Projectile *p, int t) {
 		double hue = creal(p->args[3]);
 
 		p->pos -= p->args[0] * 15;
-		complex aim = cexp(I*p->angle);
+		complex aim = sim_cexp(I*p->angle);
 
 		double s_ampl = 30 + 2 * attack_num;
 		double s_freq = 0.10 + 0.01 * attack_num;
@@ -1083,7 +1083,7 @@ int broglie_charge(Projectile *p, int t) {
 			l->lrule = broglie_laser_logic;
 
 			int pnum = 0;
-			double inc = pow(1.10 - 0.10 * (global.diff - D_Easy), 2);
+			double inc = sim_pow(1.10 - 0.10 * (global.diff - D_Easy), 2);
 
 			for(double ofs = 0; ofs < l->deathtime; ofs += inc, ++pnum) {
 				bool fast = global.diff == D_Easy || pnum & 1;
@@ -1108,15 +1108,15 @@ int broglie_charge(Projectile *p, int t) {
 
 		return ACTION_DESTROY;
 	} else {
-		float f = pow(clamp((140 - (firetime - t)) / 90.0, 0, 1), 8);
+		float f = sim_pow(clamp((140 - (firetime - t)) / 90.0, 0, 1), 8);
 		complex o = p->pos - p->args[0] * 15;
-		p->args[0] *= cexp(I*M_PI*0.2*f);
+		p->args[0] *= sim_cexp(I*M_PI*0.2*f);
 		p->pos = o + p->args[0] * 15;
 
 		if(f > 0.1) {
 			play_loop("charge_generic");
 
-			complex n = cexp(2.0*I*M_PI*frand());
+			complex n = sim_cexp(2.0*I*M_PI*frand());
 			float l = 50*frand()+25;
 			float s = 4+f;
 
@@ -1183,12 +1183,12 @@ int baryon_broglie(Enemy *e, int t) {
 
 	AT(delay) {
 		elly_clap(global.boss,fire_delay);
-		aim_angle = carg(e->pos - global.boss->pos);
+		aim_angle = sim_carg(e->pos - global.boss->pos);
 	}
 
 	FROM_TO(delay, delay + step * cnt - 1, step) {
 		double a = 2*M_PI * (0.25 + 1.0/cnt*_i);
-		complex n = cexp(I*a);
+		complex n = sim_cexp(I*a);
 		double hue = (attack_num * M_PI + a + M_PI/6) / (M_PI*2);
 
 		PROJECTILE(
@@ -1208,7 +1208,7 @@ int baryon_broglie(Enemy *e, int t) {
 	}
 
 	if(t < delay /*|| t > delay + fire_delay*/) {
-		complex target_pos = global.boss->pos + 100 * cexp(I*carg(global.plr.pos - global.boss->pos));
+		complex target_pos = global.boss->pos + 100 * sim_cexp(I*sim_carg(global.plr.pos - global.boss->pos));
 		GO_TO(e, target_pos, 0.03);
 	}
 
@@ -1253,18 +1253,18 @@ int baryon_nattack(Enemy *e, int t) {
 
 	TIMER(&t);
 
-	e->pos = global.boss->pos + (e->pos-global.boss->pos)*cexp(0.006*I);
+	e->pos = global.boss->pos + (e->pos-global.boss->pos)*sim_cexp(0.006*I);
 
 	FROM_TO_SND("shot1_loop",30, 10000, (7 - global.diff)) {
 		float a = 0.2*_i + creal(e->args[2]) + 0.006*t;
 		float ca = a + t/60.0f;
 		PROJECTILE(
 			.sprite = "ball",
-			.pos = e->pos+40*cexp(I*a),
-			.color = RGB(cos(ca), sin(ca), cos(ca+2.1)),
+			.pos = e->pos+40*sim_cexp(I*a),
+			.color = RGB(sim_cos(ca), sim_sin(ca), sim_cos(ca+2.1)),
 			.rule = asymptotic,
 			.args = {
-				(1+0.2*global.diff)*cexp(I*a),
+				(1+0.2*global.diff)*sim_cexp(I*a),
 				3
 			}
 		);
@@ -1284,7 +1284,7 @@ int baryon_nattack(Enemy *e, int t) {
 #define SAFE_RADIUS_PHASE_FUNC(o) ((int)(creal(e->args[2])+0.5) * M_PI/3 + SAFE_RADIUS_PHASE + max(0, time - SAFE_RADIUS_DELAY) * SAFE_RADIUS_SPEED)
 #define SAFE_RADIUS_PHASE_NORMALIZED(o) (fmod(SAFE_RADIUS_PHASE_FUNC(o) - SAFE_RADIUS_PHASE, 2*M_PI) / (2*M_PI))
 #define SAFE_RADIUS_PHASE_NUM(o) ((int)((SAFE_RADIUS_PHASE_FUNC(o) - SAFE_RADIUS_PHASE) / (2*M_PI)))
-#define SAFE_RADIUS(o) smoothreclamp(SAFE_RADIUS_BASE + SAFE_RADIUS_STRETCH * sin(SAFE_RADIUS_PHASE_FUNC(o)), SAFE_RADIUS_BASE - SAFE_RADIUS_STRETCH, SAFE_RADIUS_BASE + SAFE_RADIUS_STRETCH, SAFE_RADIUS_MIN, SAFE_RADIUS_MAX)
+#define SAFE_RADIUS(o) smoothreclamp(SAFE_RADIUS_BASE + SAFE_RADIUS_STRETCH * sim_sin(SAFE_RADIUS_PHASE_FUNC(o)), SAFE_RADIUS_BASE - SAFE_RADIUS_STRETCH, SAFE_RADIUS_BASE + SAFE_RADIUS_STRETCH, SAFE_RADIUS_MIN, SAFE_RADIUS_MAX)
 
 static void ricci_laser_logic(Laser *l, int t) {
 	if(t == EVENT_BIRTH) {
@@ -1298,7 +1298,7 @@ static void ricci_laser_logic(Laser *l, int t) {
 		return;
 	}
 
-	Enemy *e = (Enemy*)REF(l->args[2]);
+	Enemy *e = REF_ENT(l->args[2], Enemy);
 
 	if(e) {
 		// attach to baryon
@@ -1307,7 +1307,7 @@ static void ricci_laser_logic(Laser *l, int t) {
 
 	if(t > 0) {
 		// expand then shrink radius
-		l->args[1] = cimag(l->args[1]) * (I + sin(M_PI * t / (l->deathtime + l->timespan)));
+		l->args[1] = cimag(l->args[1]) * (I + sim_sin(M_PI * t / (l->deathtime + l->timespan)));
 	}
 
 	return;
@@ -1321,7 +1321,7 @@ static int ricci_proj2(Projectile *p, int t) {
 	}
 
 	AT(EVENT_DEATH) {
-		Enemy *e = (Enemy*)REF(p->args[1]);
+		Enemy *e = REF_ENT(p->args[1], Enemy);
 
 		if(!e) {
 			return ACTION_ACK;
@@ -1346,7 +1346,7 @@ static int ricci_proj2(Projectile *p, int t) {
 		return ACTION_ACK;
 	}
 
-	Enemy *e = (Enemy*)REF(p->args[1]);
+	Enemy *e = REF_ENT(p->args[1], Enemy);
 
 	if(!e) {
 		return ACTION_DESTROY;
@@ -1374,13 +1374,13 @@ int baryon_ricci(Enemy *e, int t) {
 			GO_TO(e, global.plr.pos, 0.1);
 		} else {
 			float s = 1.00 + 0.25 * (global.diff - D_Easy);
-			complex d = e->pos - VIEWPORT_W/2-VIEWPORT_H*I*2/3 + 100*sin(s*t/200.)+25*I*cos(s*t*3./500.);
-			e->pos += -0.5*d/cabs(d);
+			complex d = e->pos - VIEWPORT_W/2-VIEWPORT_H*I*2/3 + 100*sim_sin(s*t/200.)+25*I*sim_cos(s*t*3./500.);
+			e->pos += -0.5*d/sim_cabs(d);
 		}
 	} else {
 		for(Enemy *reference = global.enemies.first; reference; reference = reference->next) {
 			if(reference->logic_rule == baryon_ricci && (int)(creal(reference->args[2])+0.5) == 0) {
-				e->pos = global.boss->pos+(reference->pos-global.boss->pos)*cexp(I*2*M_PI*(1./6*creal(e->args[2])));
+				e->pos = global.boss->pos+(reference->pos-global.boss->pos)*sim_cexp(I*2*M_PI*(1./6*creal(e->args[2])));
 			}
 		}
 	}
@@ -1394,7 +1394,7 @@ int baryon_ricci(Enemy *e, int t) {
 		if(phase < 0.55 && phase > 0.15) {
 			FROM_TO(150,100000,10) {
 				int c = 3;
-				complex n = cexp(2*M_PI*I * (0.25 + 1.0/c*_i));
+				complex n = sim_cexp(2*M_PI*I * (0.25 + 1.0/c*_i));
 				PROJECTILE(
 					.sprite = "ball",
 					.pos = 15*n,
@@ -1427,7 +1427,7 @@ static int ricci_proj(Projectile *p, int t) {
 		p->prevpos = p->pos0 = p->pos;
 		p->birthtime = global.frames;
 		p->rule = asymptotic;
-		p->args[0] = cexp(I*M_PI*2*frand());
+		p->args[0] = sim_cexp(I*M_PI*2*frand());
 		p->args[1] = 9;
 		return ACTION_NONE;
 	}
@@ -1451,29 +1451,29 @@ static int ricci_proj(Projectile *p, int t) {
 			complex d = e->pos-p->pos;
 			float s = 1.00 + 0.25 * (global.diff - D_Easy);
 			int gaps = SAFE_RADIUS_PHASE_NUM(e) + 5;
-			double r = cabs(d)/(1.0-0.15*sin(gaps*carg(d)+0.01*s*time));
-			double range = 1/(exp((r-radius)/50)+1);
+			double r = sim_cabs(d)/(1.0-0.15*sim_sin(gaps*sim_carg(d)+0.01*s*time));
+			double range = 1/(sim_exp((r-radius)/50)+1);
 			shift += -1.1*(radius-r)/r*d*range;
 			influence += range;
 		}
 	}
 
 	p->pos = p->pos0 + p->args[0]*t+shift;
-	p->angle = carg(p->args[0]);
+	p->angle = sim_carg(p->args[0]);
 	p->prevpos = p->pos;
 
-	float a = 0.5 + 0.5 * max(0,tanh((time-80)/100.))*clamp(influence,0.2,1);
+	float a = 0.5 + 0.5 * max(0,sim_tanh((time-80)/100.))*clamp(influence,0.2,1);
 	a *= min(1, t / 20.0f);
 
 	/*
 	p->color = derive_color(p->color, CLRMASK_B|CLRMASK_A,
-		rgba(0, 0, cabs(shift)/20.0, a)
+		rgba(0, 0, sim_cabs(shift)/20.0, a)
 	);
 	*/
 
 	p->color.r = 0.5;
 	p->color.g = 0;
-	p->color.b = cabs(shift)/20.0;
+	p->color.b = sim_cabs(shift)/20.0;
 	p->color.a = 0;
 	// HACK: default bullet shader multiplies final color by (1 - param[0]).
 	// This is currently the only way to influence the white part, sadly.
@@ -1547,7 +1547,7 @@ void elly_baryonattack2(Boss *b, int t) {
 			for(int i = 0; i < cnt; ++i) {
 				float a = M_PI/4;
 				a = a * (i/(float)cnt) - a/2;
-				complex n = cexp(I*(a+carg(global.plr.pos-b->pos)));
+				complex n = sim_cexp(I*(a+sim_carg(global.plr.pos-b->pos)));
 
 				for(int j = 0; j < 3; ++j) {
 					PROJECTILE("bigball", b->pos, RGB(0,0.2,0.9), asymptotic, { n, 2 * j });
@@ -1556,7 +1556,7 @@ void elly_baryonattack2(Boss *b, int t) {
 		} else {
 			int x, y;
 			int w = 1+(global.diff > D_Normal);
-			complex n = cexp(I*carg(global.plr.pos-b->pos));
+			complex n = sim_cexp(I*sim_carg(global.plr.pos-b->pos));
 
 			for(x = -w; x <= w; x++)
 				for(y = -w; y <= w; y++)
@@ -1628,15 +1628,15 @@ void elly_lhc(Boss *b, int t) {
 		play_sound("boom");
 
 		for(i = 0; i < c; i++) {
-			complex v = 3*cexp(2.0*I*M_PI*frand());
+			complex v = 3*sim_cexp(2.0*I*M_PI*frand());
 			tsrand_fill(4);
 			create_lasercurve2c(pos, 70+20*global.diff, 300, RGBA(1, 1, 1, 0), las_accel, v, 0.02*frand()*copysign(1,creal(v)))->width=15;
 
 			PROJECTILE("soul",    pos, RGBA(0.4, 0.0, 1.0, 0.0), linear,
-				.args = { (1+2.5*afrand(0))*cexp(2.0*I*M_PI*afrand(1)) },
+				.args = { (1+2.5*afrand(0))*sim_cexp(2.0*I*M_PI*afrand(1)) },
 			);
 			PROJECTILE("bigball", pos, RGBA(1.0, 0.0, 0.4, 0.0), linear,
-				.args = { (1+2.5*afrand(2))*cexp(2.0*I*M_PI*afrand(3)) },
+				.args = { (1+2.5*afrand(2))*sim_cexp(2.0*I*M_PI*afrand(3)) },
 			);
 		}
 	}
@@ -1644,7 +1644,7 @@ void elly_lhc(Boss *b, int t) {
 	FROM_TO(0, 100000,7-global.diff) {
 		play_sound_ex("shot2",10,false);
 		PROJECTILE("ball", b->pos, RGBA(0.0, 0.4, 1.0, 0.0), asymptotic,
-			.args = { cexp(2.0*I*_i), 3 },
+			.args = { sim_cexp(2.0*I*_i), 3 },
 		);
 	}
 
@@ -1663,7 +1663,7 @@ int baryon_explode(Enemy *e, int t) {
 		return 1;
 	}
 
-	GO_TO(e, global.boss->pos + (e->pos0-global.boss->pos)*(1.5+0.2*sin(t*0.1)), 0.04);
+	GO_TO(e, global.boss->pos + (e->pos0-global.boss->pos)*(1.5+0.2*sim_sin(t*0.1)), 0.04);
 
 	if(frand() < t / 1000.0) {
 		e->hp = 0;
@@ -1677,16 +1677,16 @@ int baryon_curvature(Enemy *e, int t) {
 	int num = creal(e->args[2])+0.5;
 	int odd = num&1;
 	complex bpos = global.boss->pos;
-	complex target = (1-2*odd)*(300+100*sin(t*0.01))*cexp(I*(2*M_PI*(num+0.5*odd)/6+0.6*sqrt(1+t*t/600.)));
+	complex target = (1-2*odd)*(300+100*sim_sin(t*0.01))*sim_cexp(I*(2*M_PI*(num+0.5*odd)/6+0.6*sqrt(1+t*t/600.)));
 	GO_TO(e,bpos+target, 0.1);
 
 	if(global.diff > D_Easy && t % (80-4*global.diff) == 0) {
 		tsrand_fill(2);
 		complex pos = e->pos+60*anfrand(0)+I*60*anfrand(1);
 
-		if(cabs(pos - global.plr.pos) > 100) {
+		if(sim_cabs(pos - global.plr.pos) > 100) {
 			PROJECTILE("ball", pos, RGBA(1.0, 0.4, 1.0, 0.0), linear,
-				.args = { cexp(I*carg(global.plr.pos-pos)) },
+				.args = { sim_cexp(I*sim_carg(global.plr.pos-pos)) },
 			  );
 		}
 	}
@@ -1699,11 +1699,14 @@ int curvature_bullet(Projectile *p, int t) {
 		return ACTION_ACK;
 	}
 
-	if(REF(p->args[1]) == 0) {
+	Enemy *e = REF_ENT(p->args[1], Enemy);
+
+	if(!e) {
 		return 0;
 	}
+
 	float vx, vy, x, y;
-	complex v = ((Enemy *)REF(p->args[1]))->args[0]*0.00005;
+	complex v = e->args[0]*0.00005;
 	vx = creal(v);
 	vy = cimag(v);
 	x = creal(p->pos-global.plr.pos);
@@ -1726,10 +1729,12 @@ int curvature_orbiter(Projectile *p, int t) {
 	}
 
 	const double w = 0.03;
-	if(REF(p->args[1]) != 0 && p->args[3] == 0) {
-		p->pos = ((Projectile *)REF(p->args[1]))->pos+p->args[0]*cexp(I*t*w);
+	Projectile *center = REF_ENT(p->args[1], Projectile);
+
+	if(center && p->args[3] == 0) {
+		p->pos = center->pos+p->args[0]*sim_cexp(I*t*w);
 
-		p->args[2] = p->args[0]*I*w*cexp(I*t*w);
+		p->args[2] = p->args[0]*I*w*sim_cexp(I*t*w);
 	} else {
 		p->pos += p->args[2];
 	}
@@ -1741,7 +1746,7 @@ int curvature_orbiter(Projectile *p, int t) {
 }
 
 static double saw(double t) {
-	return cos(t)+cos(3*t)/9+cos(5*t)/25;
+	return sim_cos(t)+sim_cos(3*t)/9+sim_cos(5*t)/25;
 }
 
 int curvature_slave(Enemy *e, int t) {
@@ -1752,7 +1757,7 @@ int curvature_slave(Enemy *e, int t) {
 	if(t % (2+(global.diff < D_Hard)) == 0) {
 		tsrand_fill(2);
 		complex pos = VIEWPORT_W*afrand(0)+I*VIEWPORT_H*afrand(1);
-		if(cabs(pos - global.plr.pos) > 50) {
+		if(sim_cabs(pos - global.plr.pos) > 50) {
 			tsrand_fill(2);
 			float speed = 0.5/(1+(global.diff < D_Hard));
 
@@ -1762,7 +1767,7 @@ int curvature_slave(Enemy *e, int t) {
 				.color = RGB(0.1*afrand(0), 0.6,1),
 				.rule = curvature_bullet,
 				.args = {
-					speed*cexp(2*M_PI*I*afrand(1)),
+					speed*sim_cexp(2*M_PI*I*afrand(1)),
 					add_ref(e)
 				}
 			);
@@ -1776,7 +1781,7 @@ int curvature_slave(Enemy *e, int t) {
 			.pos = global.boss->pos,
 			.color = RGBA(0.5, 0.4, 1.0, 0.0),
 			.rule = linear,
-			.args = { 4*I*cexp(I*M_PI*2/5*saw(t/100.)) },
+			.args = { 4*I*sim_cexp(I*M_PI*2/5*saw(t/100.)) },
 		);
 
 		if(global.diff == D_Lunatic) {
@@ -1786,7 +1791,7 @@ int curvature_slave(Enemy *e, int t) {
 				.color = RGBA(0.2, 0.4, 1.0, 0.0),
 				.rule = curvature_orbiter,
 				.args = {
-					40*cexp(I*t/400),
+					40*sim_cexp(I*t/400),
 					add_ref(p)
 				},
 			);
@@ -1820,7 +1825,7 @@ void elly_curvature(Boss *b, int t) {
 		create_enemy2c(b->pos, ENEMY_IMMUNE, 0, curvature_slave, 0, global.plr.pos);
 	}
 
-	GO_TO(b, VIEWPORT_W/2+100*I+VIEWPORT_W/3*round(sin(t/200)), 0.04);
+	GO_TO(b, VIEWPORT_W/2+100*I+VIEWPORT_W/3*round(sim_sin(t/200)), 0.04);
 
 }
 void elly_baryon_explode(Boss *b, int t) {
@@ -1840,7 +1845,7 @@ void elly_baryon_explode(Boss *b, int t) {
 
 	FROM_TO(0, 200, 1) {
 		tsrand_fill(2);
-		petal_explosion(1, b->pos + 100*afrand(0)*cexp(2.0*I*M_PI*afrand(1)));
+		petal_explosion(1, b->pos + 100*afrand(0)*sim_cexp(2.0*I*M_PI*afrand(1)));
 		global.shake_view = max(global.shake_view, 5 * _i / 200.0);
 
 		if(_i > 30) {
@@ -1853,7 +1858,7 @@ void elly_baryon_explode(Boss *b, int t) {
 		global.shake_view += 30;
 		global.shake_view_fade = 0.05;
 		play_sound("boom");
-		petal_explosion(100, b->pos + 100*afrand(0)*cexp(2.0*I*M_PI*afrand(1)));
+		petal_explosion(100, b->pos + 100*afrand(0)*sim_cexp(2.0*I*M_PI*afrand(1)));
 		enemy_kill_all(&global.enemies);
 	}
 }
@@ -1908,7 +1913,7 @@ static int elly_toe_boson(Projectile *p, int t) {
 		return ACTION_ACK;
 	}
 
-	p->angle = carg(p->args[0]);
+	p->angle = sim_carg(p->args[0]);
 
 	int activate_time = creal(p->args[2]);
 	int num_in_trail = cimag(p->args[2]);
@@ -1922,8 +1927,8 @@ static int elly_toe_boson(Projectile *p, int t) {
 
 		float a = 0.1;
 		float x = fract;
-		float modulate = sin(x * M_PI) * (0.5 + cos(x * M_PI));
-		fract = (pow(a, x) - 1) / (a - 1);
+		float modulate = sim_sin(x * M_PI) * (0.5 + sim_cos(x * M_PI));
+		fract = (sim_pow(a, x) - 1) / (a - 1);
 		fract *= (1 + (1 - x) * modulate);
 
 		p->pos = p->args[3] * fract + p->pos0 * (1 - fract);
@@ -2061,8 +2066,8 @@ static bool elly_toe_its_yukawatime(complex pos) {
 	int sectors = 4;
 
 	pos -= global.boss->pos;
-	if(((int)(carg(pos)/2/M_PI*sectors+sectors+0.005*t))%2)
-		return t > YUKAWATIME+0.2*cabs(pos);
+	if(((int)(sim_carg(pos)/2/M_PI*sectors+sectors+0.005*t))%2)
+		return t > YUKAWATIME+0.2*sim_cabs(pos);
 
 	return false;
 }
@@ -2096,10 +2101,10 @@ static int elly_toe_fermion(Projectile *p, int t) {
 
 	int speeduptime = creal(p->args[2]);
 	if(t > speeduptime)
-		p->pos0 += p->pos0/cabs(p->pos0)*(t-speeduptime)*0.01;
+		p->pos0 += p->pos0/sim_cabs(p->pos0)*(t-speeduptime)*0.01;
 	else
 		p->pos0 += (p->args[0]-p->pos0)*0.01;
-	p->pos = global.boss->pos+p->pos0*cexp(I*0.01*t)+5*cexp(I*t*0.05+I*p->args[1]);
+	p->pos = global.boss->pos+p->pos0*sim_cexp(I*0.01*t)+5*sim_cexp(I*t*0.05+I*p->args[1]);
 
 	Color thiscolor_additive = p->color;
 	thiscolor_additive.a = 0;
@@ -2172,9 +2177,9 @@ static int elly_toe_higgs(Projectile *p, int t) {
 		global_time = max_time;
 	}
 
-	complex vel = p->args[0] * cexp(I*rotation*global_time/(float)max_time);
+	complex vel = p->args[0] * sim_cexp(I*rotation*global_time/(float)max_time);
 	p->pos = p->pos0 + t * vel;
-	p->angle = carg(vel);
+	p->angle = sim_carg(vel);
 
 	return ACTION_NONE;
 }
@@ -2211,9 +2216,9 @@ static complex elly_toe_laser_pos(Laser *l, float t) { // a[0]: direction, a[1]:
 	case 0:
 		return l->pos+l->args[0]*t;
 	case 1:
-		return l->pos+l->args[0]*(t+width*I*sin(t/width));
+		return l->pos+l->args[0]*(t+width*I*sim_sin(t/width));
 	case 2:
-		return l->pos+l->args[0]*(t+width*(0.6*(cos(3*t/width)-1)+I*sin(3*t/width)));
+		return l->pos+l->args[0]*(t+width*(0.6*(sim_cos(3*t/width)-1)+I*sim_sin(3*t/width)));
 	case 3:
 		return l->pos+l->args[0]*(t+floor(t/width)*width);
 	}
@@ -2296,7 +2301,7 @@ static void elly_toe_laser_logic(Laser *l, int t) {
 		} while(newtype2 == -1 || newtype2 == 3 || newtype == 3);
 
 		complex origin = l->prule(l,t);
-		complex newdir = cexp(0.3*I);
+		complex newdir = sim_cexp(0.3*I);
 
 		Laser *l1 = create_laser(origin,LASER_LENGTH,LASER_LENGTH,RGBA(1, 1, 1, 0),
 			elly_toe_laser_pos,elly_toe_laser_logic,
@@ -2385,7 +2390,7 @@ void elly_theory(Boss *b, int time) {
 	TIMER(&time);
 
 	AT(0) {
-		assert(cabs(b->pos - ELLY_TOE_TARGET_POS) < 1);
+		assert(sim_cabs(b->pos - ELLY_TOE_TARGET_POS) < 1);
 		b->pos = ELLY_TOE_TARGET_POS;
 		global.shake_view = 0;
 		elly_clap(b,50000);
@@ -2428,8 +2433,8 @@ void elly_theory(Boss *b, int time) {
 			for(int i = 0; i < 4; i++) {
 				pnum = (count - pnum - 1);
 
-				complex dir = I*cexp(I*(2*M_PI/count*(pnum+0.5)));
-				dir *= cexp(I*0.15*sign(creal(dir))*sin(_i));
+				complex dir = I*sim_cexp(I*(2*M_PI/count*(pnum+0.5)));
+				dir *= sim_cexp(I*0.15*sign(creal(dir))*sim_sin(_i));
 
 				complex bpos = b->pos + 18 * dir * i;
 
@@ -2453,7 +2458,7 @@ void elly_theory(Boss *b, int time) {
 		// play_loop("noise1");
 		play_sound_ex("shot1", 5, false);
 
-		complex dest = 100*cexp(I*1*_i);
+		complex dest = 100*sim_cexp(I*1*_i);
 		for(int clr = 0; clr < 3; clr++) {
 			PROJECTILE("ball", b->pos, RGBA(clr==0, clr==1, clr==2, 0),
 				.rule = elly_toe_fermion,
@@ -2531,12 +2536,12 @@ void elly_theory(Boss *b, int time) {
 
 		for(int dir = 0; dir < 2; dir++) {
 			for(int arm = 0; arm < arms; arm++) {
-				complex v = -2*I*cexp(I*M_PI/(arms+1)*(arm+1)+0.1*I*sin(time*0.1+arm));
+				complex v = -2*I*sim_cexp(I*M_PI/(arms+1)*(arm+1)+0.1*I*sim_sin(time*0.1+arm));
 				if(dir)
 					v = -conj(v);
 				if(time>symmetrytime) {
 					int t = time-symmetrytime;
-					v*=cexp(-I*0.001*t*t+0.01*frand()*dir);
+					v*=sim_cexp(-I*0.001*t*t+0.01*frand()*dir);
 				}
 				PROJECTILE("flea", b->pos, RGB(dir*(time>symmetrytime),0,1),
 					.rule = elly_toe_higgs,
@@ -2549,12 +2554,12 @@ void elly_theory(Boss *b, int time) {
 	FROM_TO(breaktime,breaktime+10000,100) {
 		play_sound_ex("laser1", 0, true);
 
-		complex phase = cexp(2*I*M_PI*frand());
+		complex phase = sim_cexp(2*I*M_PI*frand());
 		int count = 8;
 		for(int i = 0; i < count; i++) {
 			create_laser(b->pos,LASER_LENGTH,LASER_LENGTH/2,RGBA(1, 1, 1, 0),
 				elly_toe_laser_pos,elly_toe_laser_logic,
-				2*cexp(2*I*M_PI/count*i)*phase,
+				2*sim_cexp(2*I*M_PI/count*i)*phase,
 				0,
 				LASER_EXTENT,
 				0
@@ -2570,7 +2575,7 @@ void elly_theory(Boss *b, int time) {
 			PROJECTILE("soul", b->pos, RGBA(clr==0, clr==1, clr==2, 0),
 				.rule = elly_toe_fermion,
 				.args = {
-					50*cexp(1.3*I*_i),
+					50*sim_cexp(1.3*I*_i),
 					clr*2*M_PI/3,
 					40,
 					-1,
@@ -2619,7 +2624,7 @@ void elly_spellbg_toe(Boss *b, int t) {
 		char *texname = strfmt("stage6/toelagrangian/%d",i);
 		float wobble = max(0,t-BREAKTIME)*0.03;
 		r_mat_push();
-		r_mat_translate(VIEWPORT_W/2+positions[i][0]+cos(wobble+i)*wobble,VIEWPORT_H/2-150+positions[i][1]+sin(i+wobble)*wobble,0);
+		r_mat_translate(VIEWPORT_W/2+positions[i][0]+sim_cos(wobble+i)*wobble,VIEWPORT_H/2-150+positions[i][1]+sim_sin(i+wobble)*wobble,0);
 		draw_sprite_batched(0,0,texname);
 		free(texname);
 		r_mat_pop();
@@ -2731,14 +2736,14 @@ void stage6_events(void) {
 
 	FROM_TO(720, 940, 10) {
 		complex p = VIEWPORT_W/2+(1-2*(_i&1))*20*(_i%10);
-		create_enemy3c(p, 2000, Fairy, stage6_side, 2.0*I+1*(1-2*(_i&1)),I*cexp(I*carg(global.plr.pos-p))*(1-2*(_i&1)),_i*psin(_i));
+		create_enemy3c(p, 2000, Fairy, stage6_side, 2.0*I+1*(1-2*(_i&1)),I*sim_cexp(I*sim_carg(global.plr.pos-p))*(1-2*(_i&1)),_i*psin(_i));
 	}
 
 	FROM_TO(1380, 1660, 20)
-		create_enemy2c(200.0*I, 600, Fairy, stage6_flowermine, 2*cexp(0.5*I*M_PI/9*_i)+1, 0);
+		create_enemy2c(200.0*I, 600, Fairy, stage6_flowermine, 2*sim_cexp(0.5*I*M_PI/9*_i)+1, 0);
 
 	FROM_TO(1600, 2000, 20)
-		create_enemy3c(VIEWPORT_W/2, 600, Fairy, stage6_flowermine, 2*cexp(0.5*I*M_PI/9*_i+I*M_PI/2)+1.0*I, VIEWPORT_H/2*I+VIEWPORT_W, 1);
+		create_enemy3c(VIEWPORT_W/2, 600, Fairy, stage6_flowermine, 2*sim_cexp(0.5*I*M_PI/9*_i+I*M_PI/2)+1.0*I, VIEWPORT_H/2*I+VIEWPORT_W, 1);
 
 	AT(2300)
 		create_enemy3c(200.0*I-200, ENEMY_IMMUNE, Scythe, scythe_mid, 1, 0.2*I, 1);
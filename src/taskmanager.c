@@ -9,151 +9,322 @@
 #include "taisei.h"
 
 #include "taskmanager.h"
-#include "list.h"
 #include "util.h"
 
+#define TASK_DEQUE_INITIAL_CAPACITY 64
+
+// Ring buffer of tasks. The owning worker pushes and pops at the bottom; other workers steal
+// from the top. Every operation only takes a spinlock for a few instructions, so submissions
+// and steals hardly ever contend with each other.
+typedef struct TaskDeque {
+	SDL_SpinLock lock;
+	Task **tasks;
+	uint capacity;
+	uint top;
+	uint size;
+} TaskDeque;
+
+typedef struct TaskWorker {
+	TaskManager *mgr;
+	SDL_Thread *thread;
+	TaskDeque deque;
+	uint index;
+} TaskWorker;
+
 struct TaskManager {
-	LIST_ANCHOR(Task) queue;
+	// Used only to put idle workers to sleep and wake them up.
 	SDL_mutex *mutex;
 	SDL_cond *cond;
-	uint numthreads;
-	uint running : 1;
-	uint aborted : 1;
-	SDL_atomic_t numtasks;
+
+	// Used only by threads waiting for tasks to complete.
+	SDL_mutex *done_mutex;
+	SDL_cond *done_cond;
+
+	SDL_atomic_t numtasks;       // pending or running
+	SDL_atomic_t numqueued;      // sitting in one of the deques
+	SDL_atomic_t numsleeping;
+	SDL_atomic_t numwaiting;
+	SDL_atomic_t next_worker;
+	SDL_atomic_t running;
+	SDL_atomic_t aborted;
+
 	SDL_ThreadPriority thread_prio;
-	SDL_Thread *threads[];
+	uint numthreads;
+	TaskWorker workers[];
 };
 
 struct Task {
-	LIST_INTERFACE(Task);
+	TaskManager *mgr;
+	TaskGroup *group;
 	task_func_t callback;
 	task_free_func_t userdata_free_callback;
 	void *userdata;
-	int prio;
-	SDL_mutex *mutex;
-	SDL_cond *cond;
-	TaskStatus status;
 	void *result;
-	uint disowned : 1;
-	uint in_queue : 1;
+	SDL_atomic_t status;
+	SDL_atomic_t refs;  // one for the queue, one for the owner of the handle
 };
 
 static TaskManager *g_taskmgr;
+static SDL_TLSID g_worker_tls;
 
-static void taskmgr_free(TaskManager *mgr) {
-	if(mgr->mutex != NULL) {
-		SDL_DestroyMutex(mgr->mutex);
+static void task_free(Task *task) {
+	if(task->userdata_free_callback != NULL) {
+		task->userdata_free_callback(task->userdata);
 	}
 
-	if(mgr->cond != NULL) {
-		SDL_DestroyCond(mgr->cond);
+	free(task);
+}
+
+static void task_unref(Task *task) {
+	if(SDL_AtomicDecRef(&task->refs)) {
+		task_free(task);
 	}
+}
 
-	free(mgr);
+static void deque_grow(TaskDeque *dq) {
+	uint capacity = dq->capacity ? dq->capacity * 2 : TASK_DEQUE_INITIAL_CAPACITY;
+	Task **tasks = calloc(capacity, sizeof(*tasks));
+
+	for(uint i = 0; i < dq->size; ++i) {
+		tasks[i] = dq->tasks[(dq->top + i) & (dq->capacity - 1)];
+	}
+
+	free(dq->tasks);
+	dq->tasks = tasks;
+	dq->capacity = capacity;
+	dq->top = 0;
 }
 
-static void task_free(Task *task) {
-	assert(!task->in_queue);
-	assert(task->disowned);
+static void deque_push(TaskDeque *dq, Task *task, bool bottom) {
+	SDL_AtomicLock(&dq->lock);
 
-	if(task->userdata_free_callback != NULL) {
-		task->userdata_free_callback(task->userdata);
+	if(dq->size == dq->capacity) {
+		deque_grow(dq);
 	}
 
-	if(task->mutex != NULL) {
-		SDL_DestroyMutex(task->mutex);
+	uint mask = dq->capacity - 1;
+
+	if(bottom) {
+		dq->tasks[(dq->top + dq->size) & mask] = task;
+	} else {
+		dq->top = (dq->top - 1) & mask;
+		dq->tasks[dq->top] = task;
 	}
 
-	if(task->cond != NULL) {
-		SDL_DestroyCond(task->cond);
+	++dq->size;
+	SDL_AtomicUnlock(&dq->lock);
+}
+
+static Task* deque_pop(TaskDeque *dq, bool bottom) {
+	Task *task = NULL;
+	SDL_AtomicLock(&dq->lock);
+
+	if(dq->size) {
+		uint mask = dq->capacity - 1;
+		--dq->size;
+
+		if(bottom) {
+			task = dq->tasks[(dq->top + dq->size) & mask];
+		} else {
+			task = dq->tasks[dq->top];
+			dq->top = (dq->top + 1) & mask;
+		}
 	}
 
-	free(task);
+	SDL_AtomicUnlock(&dq->lock);
+	return task;
 }
 
-static int taskmgr_thread(void *arg) {
-	TaskManager *mgr = arg;
-	attr_unused SDL_threadID tid = SDL_ThreadID();
+static TaskWorker* taskmgr_current_worker(TaskManager *mgr) {
+	TaskWorker *worker = SDL_TLSGet(g_worker_tls);
+	return (worker && worker->mgr == mgr) ? worker : NULL;
+}
 
-	if(SDL_SetThreadPriority(mgr->thread_prio) < 0) {
-		log_sdl_error("SDL_SetThreadPriority");
+static void taskmgr_enqueue(TaskManager *mgr, Task *task, bool topmost) {
+	TaskWorker *worker = taskmgr_current_worker(mgr);
+	bool bottom = true;
+
+	if(worker == NULL) {
+		// Outside submissions go to the top, so that each worker runs them in submission order.
+		worker = mgr->workers + (uint)SDL_AtomicAdd(&mgr->next_worker, 1) % mgr->numthreads;
+		bottom = topmost;
 	}
 
-	bool running;
-	bool aborted;
+	SDL_AtomicIncRef(&mgr->numtasks);
+	deque_push(&worker->deque, task, bottom);
+	SDL_AtomicIncRef(&mgr->numqueued);
 
-	do {
+	if(SDL_AtomicGet(&mgr->numsleeping)) {
 		SDL_LockMutex(mgr->mutex);
+		SDL_CondSignal(mgr->cond);
+		SDL_UnlockMutex(mgr->mutex);
+	}
+}
 
-		running = mgr->running;
-		aborted = mgr->aborted;
+static Task* taskmgr_dequeue(TaskManager *mgr, TaskWorker *self) {
+	Task *task;
 
-		if(!running && !aborted) {
-			SDL_CondWait(mgr->cond, mgr->mutex);
+	if(self && (task = deque_pop(&self->deque, true))) {
+		goto found;
+	}
+
+	uint start = self ? self->index + 1 : 0;
+
+	for(uint i = 0; i < mgr->numthreads && SDL_AtomicGet(&mgr->numqueued); ++i) {
+		TaskWorker *victim = mgr->workers + (start + i) % mgr->numthreads;
+
+		if(victim != self && (task = deque_pop(&victim->deque, false))) {
+			goto found;
 		}
+	}
 
-		SDL_UnlockMutex(mgr->mutex);
-	} while(!running && !aborted);
+	return NULL;
 
-	while(running && !aborted) {
-		SDL_LockMutex(mgr->mutex);
-		Task *task = alist_pop(&mgr->queue);
+found:
+	(void)SDL_AtomicDecRef(&mgr->numqueued);
+	return task;
+}
 
-		running = mgr->running;
-		aborted = mgr->aborted;
+static void taskmgr_notify_done(TaskManager *mgr) {
+	if(SDL_AtomicGet(&mgr->numwaiting)) {
+		SDL_LockMutex(mgr->done_mutex);
+		SDL_CondBroadcast(mgr->done_cond);
+		SDL_UnlockMutex(mgr->done_mutex);
+	}
+}
 
-		if(running && task == NULL && !aborted) {
-			SDL_CondWait(mgr->cond, mgr->mutex);
-		}
+static void taskmgr_run_task(TaskManager *mgr, Task *task) {
+	if(SDL_AtomicGet(&mgr->aborted)) {
+		SDL_AtomicCAS(&task->status, TASK_PENDING, TASK_CANCELLED);
+	}
 
-		SDL_UnlockMutex(mgr->mutex);
+	if(SDL_AtomicCAS(&task->status, TASK_PENDING, TASK_RUNNING)) {
+		task->result = task->callback(task->userdata);
+		SDL_MemoryBarrierRelease();
+		SDL_AtomicSet(&task->status, TASK_FINISHED);
+	}
 
-		if(task != NULL) {
-			SDL_LockMutex(task->mutex);
+	TaskGroup *group = task->group;
+	task_unref(task);
 
-			bool task_disowned = task->disowned;
+	if(group) {
+		// The group may go out of scope as soon as this hits zero.
+		SDL_AtomicAdd(&group->remaining, -1);
+	}
+
+	(void)SDL_AtomicDecRef(&mgr->numtasks);
+	taskmgr_notify_done(mgr);
+}
 
-			if(aborted && task->status == TASK_PENDING) {
-				task->status = TASK_CANCELLED;
+static void taskmgr_wait_until(TaskManager *mgr, bool (*done)(void *arg), void *arg, bool help) {
+	TaskWorker *self = taskmgr_current_worker(mgr);
+
+	// Workers must always help, otherwise they could all end up waiting for tasks none of them runs.
+	help = help || self;
+
+	while(!done(arg)) {
+		if(help) {
+			Task *task = taskmgr_dequeue(mgr, self);
+
+			if(task) {
+				taskmgr_run_task(mgr, task);
+				continue;
 			}
+		}
 
-			if(task->status == TASK_PENDING) {
-				task->status = TASK_RUNNING;
-
-				SDL_UnlockMutex(task->mutex);
-				task->result = task->callback(task->userdata);
-				SDL_LockMutex(task->mutex);
-
-				assert(task->in_queue);
-				task->in_queue = false;
-				(void)SDL_AtomicDecRef(&mgr->numtasks);
-
-				if((task_disowned = task->disowned)) {
-					SDL_UnlockMutex(task->mutex);
-					task_free(task);
-				} else {
-					task->status = TASK_FINISHED;
-					SDL_CondBroadcast(task->cond);
-					SDL_UnlockMutex(task->mutex);
-				}
-			} else if(task->status == TASK_CANCELLED) {
-				assert(task->in_queue);
-				task->in_queue = false;
-				(void)SDL_AtomicDecRef(&mgr->numtasks);
-				SDL_UnlockMutex(task->mutex);
-
-				if(task_disowned) {
-					task_free(task);
-				}
+		SDL_AtomicIncRef(&mgr->numwaiting);
+		SDL_LockMutex(mgr->done_mutex);
+
+		if(!done(arg)) {
+			if(help) {
+				// Wake up periodically to look for more work.
+				SDL_CondWaitTimeout(mgr->done_cond, mgr->done_mutex, 1);
 			} else {
-				UNREACHABLE;
+				SDL_CondWait(mgr->done_cond, mgr->done_mutex);
 			}
 		}
+
+		SDL_UnlockMutex(mgr->done_mutex);
+		(void)SDL_AtomicDecRef(&mgr->numwaiting);
+	}
+
+	SDL_MemoryBarrierAcquire();
+}
+
+static int taskmgr_thread(void *arg) {
+	TaskWorker *self = arg;
+	TaskManager *mgr = self->mgr;
+
+	if(SDL_SetThreadPriority(mgr->thread_prio) < 0) {
+		log_sdl_error("SDL_SetThreadPriority");
+	}
+
+	SDL_TLSSet(g_worker_tls, self, NULL);
+
+	for(;;) {
+		Task *task = taskmgr_dequeue(mgr, self);
+
+		if(task != NULL) {
+			taskmgr_run_task(mgr, task);
+			continue;
+		}
+
+		SDL_LockMutex(mgr->mutex);
+		SDL_AtomicIncRef(&mgr->numsleeping);
+
+		while(!SDL_AtomicGet(&mgr->numqueued) && SDL_AtomicGet(&mgr->running)) {
+			SDL_CondWait(mgr->cond, mgr->mutex);
+		}
+
+		(void)SDL_AtomicDecRef(&mgr->numsleeping);
+		bool quit = !SDL_AtomicGet(&mgr->numqueued) && !SDL_AtomicGet(&mgr->running);
+		SDL_UnlockMutex(mgr->mutex);
+
+		if(quit) {
+			break;
+		}
 	}
 
 	return 0;
 }
 
+static void taskmgr_free(TaskManager *mgr) {
+	if(mgr->mutex != NULL) {
+		SDL_DestroyMutex(mgr->mutex);
+	}
+
+	if(mgr->cond != NULL) {
+		SDL_DestroyCond(mgr->cond);
+	}
+
+	if(mgr->done_mutex != NULL) {
+		SDL_DestroyMutex(mgr->done_mutex);
+	}
+
+	if(mgr->done_cond != NULL) {
+		SDL_DestroyCond(mgr->done_cond);
+	}
+
+	for(uint i = 0; i < mgr->numthreads; ++i) {
+		assert(mgr->workers[i].deque.size == 0);
+		free(mgr->workers[i].deque.tasks);
+	}
+
+	free(mgr);
+}
+
+static void taskmgr_stop_workers(TaskManager *mgr, uint numthreads) {
+	SDL_LockMutex(mgr->mutex);
+	SDL_AtomicSet(&mgr->running, false);
+	SDL_CondBroadcast(mgr->cond);
+	SDL_UnlockMutex(mgr->mutex);
+
+	for(uint i = 0; i < numthreads; ++i) {
+		SDL_WaitThread(mgr->workers[i].thread, NULL);
+		mgr->workers[i].thread = NULL;
+	}
+}
+
 TaskManager* taskmgr_create(uint numthreads, SDL_ThreadPriority prio, const char *name) {
 	int numcores = SDL_GetCPUCount();
 	uint maxthreads = numcores * 8;
@@ -170,7 +341,13 @@ TaskManager* taskmgr_create(uint numthreads, SDL_ThreadPriority prio, const char
 		numthreads = maxthreads;
 	}
 
-	TaskManager *mgr = calloc(1, sizeof(TaskManager) + numthreads * sizeof(SDL_Thread*));
+	if(!g_worker_tls && !(g_worker_tls = SDL_TLSCreate())) {
+		log_sdl_error("SDL_TLSCreate");
+		return NULL;
+	}
+
+	TaskManager *mgr = calloc(1, sizeof(TaskManager) + numthreads * sizeof(TaskWorker));
+	mgr->numthreads = numthreads;
 
 	if(!(mgr->mutex = SDL_CreateMutex())) {
 		log_sdl_error("SDL_CreateMutex");
@@ -182,36 +359,36 @@ TaskManager* taskmgr_create(uint numthreads, SDL_ThreadPriority prio, const char
 		goto fail;
 	}
 
-	mgr->numthreads = numthreads;
+	if(!(mgr->done_mutex = SDL_CreateMutex())) {
+		log_sdl_error("SDL_CreateMutex");
+		goto fail;
+	}
+
+	if(!(mgr->done_cond = SDL_CreateCond())) {
+		log_sdl_error("SDL_CreateCond");
+		goto fail;
+	}
+
 	mgr->thread_prio = prio;
+	SDL_AtomicSet(&mgr->running, true);
 
 	for(uint i = 0; i < numthreads; ++i) {
+		TaskWorker *worker = mgr->workers + i;
+		worker->mgr = mgr;
+		worker->index = i;
+
 		int digits = i ? log10(i) + 1 : 0;
 		static const char *const prefix = "taskmgr";
 		char threadname[sizeof(prefix) + strlen(name) + digits + 2];
 		snprintf(threadname, sizeof(threadname), "%s:%s/%i", prefix, name, i);
 
-		if(!(mgr->threads[i] = SDL_CreateThread(taskmgr_thread, threadname, mgr))) {
+		if(!(worker->thread = SDL_CreateThread(taskmgr_thread, threadname, worker))) {
 			log_sdl_error("SDL_CreateThread");
-
-			for(uint j = 0; j < i; ++j) {
-				SDL_DetachThread(mgr->threads[j]);
-				mgr->threads[j] = NULL;
-			}
-
-			SDL_LockMutex(mgr->mutex);
-			mgr->aborted = true;
-			SDL_CondBroadcast(mgr->cond);
-			SDL_UnlockMutex(mgr->mutex);
+			taskmgr_stop_workers(mgr, i);
 			goto fail;
 		}
 	}
 
-	SDL_LockMutex(mgr->mutex);
-	mgr->running = true;
-	SDL_CondBroadcast(mgr->cond);
-	SDL_UnlockMutex(mgr->mutex);
-
 	log_debug(
 		"Created task manager %s (%p) with %u threads at priority %i",
 		name,
@@ -227,48 +404,20 @@ fail:
 	return NULL;
 }
 
-static int task_prio_func(List *ltask) {
-	return ((Task*)ltask)->prio;
-}
-
 Task* taskmgr_submit(TaskManager *mgr, TaskParams params) {
 	assert(params.callback != NULL);
+	assert(SDL_AtomicGet(&mgr->running));
 
 	Task *task = calloc(1, sizeof(Task));
+	task->mgr = mgr;
 	task->callback = params.callback;
 	task->userdata_free_callback = params.userdata_free_callback;
 	task->userdata = params.userdata;
-	task->prio = params.prio;
-	task->status = TASK_PENDING;
-
-	if(!(task->mutex = SDL_CreateMutex())) {
-		log_sdl_error("SDL_CreateMutex");
-		goto fail;
-	}
-
-	if(!(task->cond = SDL_CreateCond())) {
-		log_sdl_error("SDL_CreateCond");
-		goto fail;
-	}
-
-	SDL_LockMutex(mgr->mutex);
-
-	if(params.topmost) {
-		alist_insert_at_priority_head(&mgr->queue, task, task->prio, task_prio_func);
-	} else {
-		alist_insert_at_priority_tail(&mgr->queue, task, task->prio, task_prio_func);
-	}
-
-	task->in_queue = true;
-	SDL_AtomicIncRef(&mgr->numtasks);
-	SDL_CondSignal(mgr->cond);
-	SDL_UnlockMutex(mgr->mutex);
+	SDL_AtomicSet(&task->status, TASK_PENDING);
+	SDL_AtomicSet(&task->refs, 2);
 
+	taskmgr_enqueue(mgr, task, params.topmost);
 	return task;
-
-fail:
-	task_free(task);
-	return NULL;
 }
 
 uint taskmgr_remaining(TaskManager *mgr) {
@@ -284,19 +433,11 @@ static void taskmgr_finalize_and_wait(TaskManager *mgr, bool abort) {
 		abort
 	);
 
-	assert(mgr->running);
-	assert(!mgr->aborted);
-
-	SDL_LockMutex(mgr->mutex);
-	mgr->running = false;
-	mgr->aborted = abort;
-	SDL_CondBroadcast(mgr->cond);
-	SDL_UnlockMutex(mgr->mutex);
-
-	for(uint i = 0; i < mgr->numthreads; ++i) {
-		SDL_WaitThread(mgr->threads[i], NULL);
-	}
+	assert(SDL_AtomicGet(&mgr->running));
+	assert(!SDL_AtomicGet(&mgr->aborted));
 
+	SDL_AtomicSet(&mgr->aborted, abort);
+	taskmgr_stop_workers(mgr, mgr->numthreads);
 	taskmgr_free(mgr);
 }
 
@@ -308,88 +449,141 @@ void taskmgr_abort(TaskManager *mgr) {
 	taskmgr_finalize_and_wait(mgr, true);
 }
 
-TaskStatus task_status(Task *task) {
-	TaskStatus result = TASK_INVALID;
+void taskgroup_init(TaskGroup *grp, TaskManager *mgr) {
+	grp->mgr = mgr;
+	SDL_AtomicSet(&grp->remaining, 0);
+}
 
-	if(task != NULL) {
-		SDL_LockMutex(task->mutex);
-		result = task->status;
-		SDL_UnlockMutex(task->mutex);
+void taskgroup_submit(TaskGroup *grp, task_func_t callback, void *userdata) {
+	if(grp->mgr == NULL) {
+		callback(userdata);
+		return;
 	}
 
-	return result;
+	Task *task = calloc(1, sizeof(Task));
+	task->mgr = grp->mgr;
+	task->group = grp;
+	task->callback = callback;
+	task->userdata = userdata;
+	SDL_AtomicSet(&task->status, TASK_PENDING);
+	SDL_AtomicSet(&task->refs, 1);
+
+	SDL_AtomicIncRef(&grp->remaining);
+	taskmgr_enqueue(grp->mgr, task, false);
 }
 
-bool task_wait(Task *task, void **result) {
-	bool success = false;
+static bool taskgroup_done(void *arg) {
+	TaskGroup *grp = arg;
+	return SDL_AtomicGet(&grp->remaining) == 0;
+}
 
-	if(task == NULL) {
-		return success;
+void taskgroup_wait(TaskGroup *grp) {
+	if(grp->mgr != NULL) {
+		taskmgr_wait_until(grp->mgr, taskgroup_done, grp, true);
 	}
+}
 
-	void *_result = NULL;
+typedef struct ParallelForChunk {
+	task_range_func_t func;
+	void *userdata;
+	uint begin;
+	uint end;
+} ParallelForChunk;
 
-	SDL_LockMutex(task->mutex);
+static void* parallel_for_chunk(void *arg) {
+	ParallelForChunk *chunk = arg;
+	chunk->func(chunk->begin, chunk->end, chunk->userdata);
+	return NULL;
+}
 
-	if(task->status == TASK_CANCELLED) {
-		success = false;
-	} else if(task->status == TASK_FINISHED) {
-		success = true;
-		_result = task->result;
-	} else {
-		SDL_CondWait(task->cond, task->mutex);
-		_result = task->result;
-		success = (task->status == TASK_FINISHED);
+void taskmgr_parallel_for(TaskManager *mgr, uint begin, uint end, uint grain, task_range_func_t func, void *userdata) {
+	if(end <= begin) {
+		return;
 	}
 
-	SDL_UnlockMutex(task->mutex);
+	uint count = end - begin;
 
-	if(success && result != NULL) {
-		*result = _result;
+	if(grain == 0) {
+		// A few chunks per thread, so that stealing can even out the load.
+		uint numchunks = mgr ? (mgr->numthreads + 1) * 4 : 1;
+		grain = (count + numchunks - 1) / numchunks;
 	}
 
-	return success;
+	uint numchunks = (count + grain - 1) / grain;
+
+	if(mgr == NULL || numchunks == 1) {
+		func(begin, end, userdata);
+		return;
+	}
+
+	ParallelForChunk *chunks = calloc(numchunks, sizeof(*chunks));
+	TaskGroup grp;
+	taskgroup_init(&grp, mgr);
+
+	for(uint i = 0; i < numchunks; ++i) {
+		chunks[i].func = func;
+		chunks[i].userdata = userdata;
+		chunks[i].begin = begin + i * grain;
+		chunks[i].end = (i == numchunks - 1) ? end : chunks[i].begin + grain;
+
+		if(i > 0) {
+			taskgroup_submit(&grp, parallel_for_chunk, chunks + i);
+		}
+	}
+
+	parallel_for_chunk(chunks);
+	taskgroup_wait(&grp);
+	free(chunks);
 }
 
-bool task_cancel(Task *task) {
-	bool success = false;
+TaskStatus task_status(Task *task) {
+	if(task == NULL) {
+		return TASK_INVALID;
+	}
+
+	return SDL_AtomicGet(&task->status);
+}
 
+static bool task_done(void *arg) {
+	TaskStatus status = task_status(arg);
+	return status == TASK_FINISHED || status == TASK_CANCELLED;
+}
+
+bool task_wait(Task *task, void **result) {
 	if(task == NULL) {
-		return success;
+		return false;
 	}
 
-	SDL_LockMutex(task->mutex);
+	if(task->mgr != NULL) {
+		taskmgr_wait_until(task->mgr, task_done, task, false);
+	}
 
-	if(task->status == TASK_PENDING) {
-		task->status = TASK_CANCELLED;
-		success = true;
+	if(task_status(task) != TASK_FINISHED) {
+		return false;
 	}
 
-	SDL_UnlockMutex(task->mutex);
+	if(result != NULL) {
+		*result = task->result;
+	}
 
-	return success;
+	return true;
 }
 
-bool task_detach(Task *task) {
-	bool success = false;
-	bool task_in_queue;
-
+bool task_cancel(Task *task) {
 	if(task == NULL) {
-		return success;
+		return false;
 	}
 
-	SDL_LockMutex(task->mutex);
-	assert(!task->disowned);
-	task->disowned = true;
-	task_in_queue = task->in_queue;
-	success = true;
-	SDL_UnlockMutex(task->mutex);
+	return SDL_AtomicCAS(&task->status, TASK_PENDING, TASK_CANCELLED);
+}
 
-	if(!task_in_queue) {
-		task_free(task);
+bool task_detach(Task *task) {
+	if(task == NULL) {
+		return false;
 	}
 
-	return success;
+	task_unref(task);
+	return true;
 }
 
 bool task_finish(Task *task, void **result) {
@@ -416,6 +610,10 @@ void taskmgr_global_shutdown(void) {
 	}
 }
 
+TaskManager* taskmgr_global(void) {
+	return g_taskmgr;
+}
+
 Task* taskmgr_global_submit(TaskParams params) {
 	if(g_taskmgr == NULL) {
 		Task *t = calloc(1, sizeof(Task));
@@ -423,6 +621,8 @@ Task* taskmgr_global_submit(TaskParams params) {
 		t->userdata = params.userdata;
 		t->userdata_free_callback = params.userdata_free_callback;
 		t->result = params.callback(params.userdata);
+		SDL_AtomicSet(&t->status, TASK_FINISHED);
+		SDL_AtomicSet(&t->refs, 1);
 		return t;
 	}
 
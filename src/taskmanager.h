@@ -50,20 +50,32 @@ typedef struct TaskParams {
 	task_free_func_t userdata_free_callback;
 
 	/**
-	 * Priority of the task. Lower values mean higher priority. Higher priority tasks are added
-	 * to the queue ahead of the lower priority ones, and thus will start execute sooner. Note
-	 * that this affects only the pending tasks. A task that already began executing cannot be
-	 * interrupted, regardless of its priority.
+	 * Priority of the task. Kept for compatibility only: tasks are spread across the per-worker
+	 * queues of the task manager, so there is no global order for this to affect anymore.
 	 */
 	int prio;
 
 	/**
-	 * If true, this task will be inserted ahead of the others with the same priority, if any.
-	 * Otherwise, it'll be put behind them instead.
+	 * If true, this task will be placed where its worker thread picks it up next, ahead of the
+	 * tasks already queued there. Otherwise, it'll be put behind them instead.
 	 */
 	bool topmost;
 } TaskParams;
 
+/**
+ * Counts the outstanding tasks submitted with `taskgroup_submit`, so that they can be waited
+ * for together. Initialize with `taskgroup_init`; it can live on the stack of whoever waits.
+ */
+typedef struct TaskGroup {
+	TaskManager *mgr;
+	SDL_atomic_t remaining;
+} TaskGroup;
+
+/**
+ * Body of a `taskmgr_parallel_for` loop, processing indices in the range [begin, end).
+ */
+typedef void (*task_range_func_t)(uint begin, uint end, void *userdata);
+
 /**
  * Create a new TaskManager with [numthreads] worker threads, and set their priority to [prio].
  * If [numthreads] is 0, a default based on the amount of system's CPU cores will be used.
@@ -78,8 +90,11 @@ TaskManager* taskmgr_create(uint numthreads, SDL_ThreadPriority prio, const char
 	attr_nodiscard attr_nonnull(3);
 
 /**
- * Submit a new task to [mgr] described by [params]. It is generally placed at the end of the
- * task manager's queue, but that can be influenced with [params.prio] and [params.topmost].
+ * Submit a new task to [mgr] described by [params].
+ *
+ * Every worker thread has its own queue. Tasks submitted from a worker thread of [mgr] go into
+ * that worker's queue; other submissions are distributed between the workers in turn. Idle
+ * workers steal tasks from the queues of busy ones.
  *
  * See documentation for TaskParams above.
  *
@@ -115,6 +130,35 @@ void taskmgr_finish(TaskManager *mgr)
 void taskmgr_abort(TaskManager *mgr)
 	attr_nonnull(1);
 
+/**
+ * Prepare [grp] to collect tasks for [mgr]. If [mgr] is NULL, tasks submitted to the group are
+ * executed immediately in the calling thread.
+ */
+void taskgroup_init(TaskGroup *grp, TaskManager *mgr)
+	attr_nonnull(1);
+
+/**
+ * Submit a task to the task manager of [grp]. Its return value is discarded; the task can not be
+ * cancelled or waited for individually.
+ */
+void taskgroup_submit(TaskGroup *grp, task_func_t callback, void *userdata)
+	attr_nonnull(1, 2);
+
+/**
+ * Wait for all tasks submitted to [grp] to complete. The calling thread executes pending tasks
+ * of the task manager in the meantime, instead of just sleeping.
+ */
+void taskgroup_wait(TaskGroup *grp)
+	attr_nonnull(1);
+
+/**
+ * Call [func] for sub-ranges of [begin, end) in parallel, then wait for all of them to complete.
+ * The range is split into chunks of at most [grain] indices; if [grain] is 0, a default based on
+ * the number of worker threads is used. One of the chunks is always run in the calling thread.
+ */
+void taskmgr_parallel_for(TaskManager *mgr, uint begin, uint end, uint grain, task_range_func_t func, void *userdata)
+	attr_nonnull(5);
+
 /**
  * Returns the current status of [task]. See TaskStatus documentation above.
  * Returns TASK_INVALID on failure.
@@ -126,6 +170,9 @@ TaskStatus task_status(Task *task);
  *
  * On success, returns true and stores the task's return value in [result] (unless [result] is NULL).
  * On failure, returns false; [result] is left untouched.
+ *
+ * When called from one of the task manager's own worker threads, that thread keeps executing
+ * other pending tasks while it waits.
  */
 bool task_wait(Task *task, void **result);
 
@@ -171,6 +218,11 @@ void taskmgr_global_init(void);
  */
 void taskmgr_global_shutdown(void);
 
+/**
+ * Returns the global task manager, or NULL if it's not initialized.
+ */
+TaskManager* taskmgr_global(void);
+
 /**
  * Submit a task to the global task manager. See `taskmgr_submit`.
  */
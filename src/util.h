@@ -12,6 +12,7 @@
 #include "util/assert.h"
 #include "util/crap.h"
 #include "util/debug.h"
+#include "util/dmath.h"
 #include "util/env.h"
 #include "util/geometry.h"
 // #include "util/glm.h"
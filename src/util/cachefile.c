@@ -0,0 +1,98 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include "cachefile.h"
+#include "assert.h"
+#include "log.h"
+#include "vfs/public.h"
+#include "stringops.h"
+
+#define CACHE_DIR "storage/cache"
+
+static_assert(sizeof(CacheFileHeader) % 8 == 0, "Cache file header breaks data alignment");
+
+static char* cachefile_path(const CacheFileFormat *fmt, uint64_t id) {
+	return strfmt(CACHE_DIR "/%s/%016"PRIx64"%s", fmt->subdir, id, fmt->extension);
+}
+
+static void cachefile_fill_header(CacheFileHeader *hdr, const CacheFileFormat *fmt, uint64_t key) {
+	assert(strlen(fmt->magic) < sizeof(hdr->magic));
+
+	memset(hdr, 0, sizeof(*hdr));
+	strcpy(hdr->magic, fmt->magic);
+	hdr->version = fmt->version;
+	hdr->key = key;
+}
+
+bool cachefile_open_read(CacheFile *cf, const CacheFileFormat *fmt, uint64_t id, uint64_t key) {
+	memset(cf, 0, sizeof(*cf));
+	cf->path = cachefile_path(fmt, id);
+	cf->rw = vfs_open(cf->path, VFS_MODE_READ);
+
+	if(!cf->rw) {
+		cachefile_close(cf);
+		return false;
+	}
+
+	CacheFileHeader hdr, expected;
+	cachefile_fill_header(&expected, fmt, key);
+
+	if(!cachefile_read(cf, &hdr, sizeof(hdr)) || memcmp(&hdr, &expected, sizeof(hdr))) {
+		cachefile_close(cf);
+		return false;
+	}
+
+	return true;
+}
+
+bool cachefile_open_write(CacheFile *cf, const CacheFileFormat *fmt, uint64_t id, uint64_t key, const char *what) {
+	memset(cf, 0, sizeof(*cf));
+	cf->what = what;
+	cf->path = cachefile_path(fmt, id);
+
+	char *dir = strfmt(CACHE_DIR "/%s", fmt->subdir);
+	vfs_mkdir(CACHE_DIR);
+	vfs_mkdir(dir);
+	free(dir);
+
+	cf->rw = vfs_open(cf->path, VFS_MODE_WRITE);
+
+	if(!cf->rw) {
+		log_warn("Couldn't cache %s in %s: %s", what, cf->path, vfs_get_error());
+		cachefile_close(cf);
+		return false;
+	}
+
+	CacheFileHeader hdr;
+	cachefile_fill_header(&hdr, fmt, key);
+	cachefile_write(cf, &hdr, sizeof(hdr));
+	return true;
+}
+
+bool cachefile_read(CacheFile *cf, void *data, size_t size) {
+	// a short read most likely means a partially written file
+	return size == 0 || SDL_RWread(cf->rw, data, size, 1) == 1;
+}
+
+void cachefile_write(CacheFile *cf, const void *data, size_t size) {
+	if(!cf->failed && size > 0 && SDL_RWwrite(cf->rw, data, size, 1) != 1) {
+		log_warn("Couldn't cache %s in %s: %s", cf->what, cf->path, SDL_GetError());
+		cf->failed = true;
+	}
+}
+
+void cachefile_close(CacheFile *cf) {
+	if(cf->rw) {
+		SDL_RWclose(cf->rw);
+	}
+
+	free(cf->path);
+	memset(cf, 0, sizeof(*cf));
+}
@@ -0,0 +1,58 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include <SDL.h>
+
+/*
+ * Files in storage/cache, for data that is expensive to derive and can always be derived again.
+ *
+ * Every file starts with a CacheFileHeader: the format's magic and version, and a 64-bit key
+ * computed by the caller from everything the data depends on. A file with a different header,
+ * or one that ends early (e.g. the game was killed while writing it), is simply a cache miss.
+ * Format-specific data follows the header; sizeof(CacheFileHeader) is a multiple of 8.
+ */
+
+typedef struct CacheFileFormat {
+	const char *subdir;     // directory under storage/cache
+	const char *extension;  // including the dot
+	const char *magic;      // up to 7 characters
+	uint32_t version;
+} CacheFileFormat;
+
+typedef struct CacheFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t key;
+} CacheFileHeader;
+
+typedef struct CacheFile {
+	SDL_RWops *rw;
+	char *path;
+	const char *what;
+	bool failed;
+} CacheFile;
+
+// Files are named after id. Returns false if there's no file, or if its header doesn't match.
+bool cachefile_open_read(CacheFile *cf, const CacheFileFormat *fmt, uint64_t id, uint64_t key)
+	attr_nonnull(1, 2) attr_nodiscard;
+
+// Creates the file and writes the header. what describes the data in warnings.
+bool cachefile_open_write(CacheFile *cf, const CacheFileFormat *fmt, uint64_t id, uint64_t key, const char *what)
+	attr_nonnull(1, 2, 5) attr_nodiscard;
+
+// Returns false if the file ends before size bytes could be read.
+bool cachefile_read(CacheFile *cf, void *data, size_t size) attr_nonnull(1, 2);
+
+// Only the first error is reported; the rest of the file is skipped after that.
+void cachefile_write(CacheFile *cf, const void *data, size_t size) attr_nonnull(1, 2);
+
+void cachefile_close(CacheFile *cf) attr_nonnull(1);
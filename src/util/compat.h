@@ -66,10 +66,12 @@
 	#define __extension__
 	#define PRAGMA(p)
 	#define UNREACHABLE
+	#define PREFETCH(addr) ((void)(addr))
 #else
 	#define PRAGMA(p) _Pragma(#p)
 	#define USE_GNU_EXTENSIONS
 	#define UNREACHABLE __builtin_unreachable()
+	#define PREFETCH(addr) __builtin_prefetch(addr)
 #endif
 
 #ifndef __has_attribute
@@ -18,3 +18,21 @@ void* memdup(const void *src, size_t size) {
 	memcpy(data, src, size);
 	return data;
 }
+
+uint64_t memhash64(const void *data, size_t size) {
+	const uint8_t *p = data;
+	uint64_t h = 0xcbf29ce484222325ull ^ size;
+	uint64_t word;
+
+	for(; size >= sizeof(word); size -= sizeof(word), p += sizeof(word)) {
+		memcpy(&word, p, sizeof(word));
+		h = (h ^ word) * 0x9e3779b97f4a7c15ull;
+		h ^= h >> 29;
+	}
+
+	for(; size; --size, ++p) {
+		h = (h ^ *p) * 0x100000001b3ull;
+	}
+
+	return h;
+}
@@ -10,3 +10,6 @@
 #include "taisei.h"
 
 void* memdup(const void *src, size_t size);
+
+// Fast non-cryptographic hash, good enough for keying on-disk caches.
+uint64_t memhash64(const void *data, size_t size);
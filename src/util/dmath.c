@@ -0,0 +1,378 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#include "taisei.h"
+
+#include "dmath.h"
+
+// The polynomial coefficients and range reduction constants are those of fdlibm
+// (Copyright (C) 1993 by Sun Microsystems, Inc.), which is freely redistributable.
+// Only the evaluation order differs, and it is spelled out explicitly here.
+
+#if defined(__GNUC__) && defined(__i386__) && !defined(__SSE2_MATH__)
+	#warning "Double arithmetic is done in x87 registers, dmath results will differ from other platforms"
+#endif
+
+bool _dmath_deterministic;
+
+void dmath_set_deterministic(bool deterministic) {
+	_dmath_deterministic = deterministic;
+}
+
+// π/2 split into three parts with 33 significant bits each, so that n * PIO2_n
+// is exact for any |n| < 2^20.
+static const double INVPIO2 = 6.36619772367581382433e-01;
+static const double PIO2_1  = 1.57079632673412561417e+00;
+static const double PIO2_2  = 6.07710050630396597660e-11;
+static const double PIO2_3  = 2.02226624871116645580e-21;
+
+static const double S1 = -1.66666666666666324348e-01;
+static const double S2 =  8.33333333332248946124e-03;
+static const double S3 = -1.98412698298579493134e-04;
+static const double S4 =  2.75573137070700676789e-06;
+static const double S5 = -2.50507602534068634195e-08;
+static const double S6 =  1.58969099521155010221e-10;
+
+static const double C1 =  4.16666666666666019037e-02;
+static const double C2 = -1.38888888888741095749e-03;
+static const double C3 =  2.48015872894767294178e-05;
+static const double C4 = -2.75573143513906633035e-07;
+static const double C5 =  2.08757232129817482790e-09;
+static const double C6 = -1.13596475577881948265e-11;
+
+// sin(x) for |x| <= π/4
+static inline double kernel_sin(double x) {
+	double z = x * x;
+	double r = S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)));
+	return x + (x * z) * (S1 + z * r);
+}
+
+// cos(x) for |x| <= π/4
+static inline double kernel_cos(double x) {
+	double z = x * x;
+	double r = z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+	return 1.0 - (0.5 * z - z * r);
+}
+
+// Returns x - n*π/2 with n rounded to nearest, and n modulo 4 in *quadrant.
+// Arguments past ~10^6 lose precision, but are still reduced deterministically.
+static double reduce_pio2(double x, int *quadrant) {
+	double n = floor(x * INVPIO2 + 0.5);
+	*quadrant = (int)(int64_t)fmod(n, 4.0);
+
+	if(*quadrant < 0) {
+		*quadrant += 4;
+	}
+
+	return ((x - n * PIO2_1) - n * PIO2_2) - n * PIO2_3;
+}
+
+void dmath_sincos(double x, double *out_sin, double *out_cos) {
+	if(!isfinite(x)) {
+		*out_sin = *out_cos = x - x;
+		return;
+	}
+
+	int q;
+	double r = reduce_pio2(x, &q);
+	double s = kernel_sin(r);
+	double c = kernel_cos(r);
+
+	switch(q) {
+		case 0: *out_sin =  s; *out_cos =  c; break;
+		case 1: *out_sin =  c; *out_cos = -s; break;
+		case 2: *out_sin = -s; *out_cos = -c; break;
+		case 3: *out_sin = -c; *out_cos =  s; break;
+		default: UNREACHABLE;
+	}
+}
+
+double dmath_sin(double x) {
+	double s, c;
+	dmath_sincos(x, &s, &c);
+	return s;
+}
+
+double dmath_cos(double x) {
+	double s, c;
+	dmath_sincos(x, &s, &c);
+	return c;
+}
+
+double dmath_tan(double x) {
+	double s, c;
+	dmath_sincos(x, &s, &c);
+	return s / c;
+}
+
+static const double ATANHI[] = {
+	4.63647609000806093515e-01, // atan(0.5)
+	7.85398163397448278999e-01, // atan(1.0)
+	9.82793723247329054082e-01, // atan(1.5)
+	1.57079632679489655800e+00, // atan(inf)
+};
+
+static const double ATANLO[] = {
+	2.26987774529616870924e-17,
+	3.06161699786838301793e-17,
+	1.39033110312309984516e-17,
+	6.12323399573676603587e-17,
+};
+
+static const double AT[] = {
+	 3.33333333333329318027e-01,
+	-1.99999999998764832476e-01,
+	 1.42857142725034663711e-01,
+	-1.11111104054623557880e-01,
+	 9.09088713343650656196e-02,
+	-7.69187620504482999495e-02,
+	 6.66107313738753120669e-02,
+	-5.83357013379057348645e-02,
+	 4.97687799461593236017e-02,
+	-3.65315727442169155270e-02,
+	 1.62858201153657823623e-02,
+};
+
+// atan(x) for x >= 0
+static double atan_positive(double x) {
+	int id;
+
+	if(x < 0.4375) {
+		id = -1;
+	} else if(x < 0.6875) {
+		id = 0;
+		x = (2.0 * x - 1.0) / (2.0 + x);
+	} else if(x < 1.1875) {
+		id = 1;
+		x = (x - 1.0) / (x + 1.0);
+	} else if(x < 2.4375) {
+		id = 2;
+		x = (x - 1.5) / (1.0 + 1.5 * x);
+	} else {
+		id = 3;
+		x = -1.0 / x;
+	}
+
+	double z = x * x;
+	double w = z * z;
+	double s1 = z * (AT[0] + w * (AT[2] + w * (AT[4] + w * (AT[6] + w * (AT[8] + w * AT[10])))));
+	double s2 = w * (AT[1] + w * (AT[3] + w * (AT[5] + w * (AT[7] + w * AT[9]))));
+
+	if(id < 0) {
+		return x - x * (s1 + s2);
+	}
+
+	return ATANHI[id] - ((x * (s1 + s2) - ATANLO[id]) - x);
+}
+
+static const double PI_HI = 3.1415926535897931160e+00;
+static const double PI_LO = 1.2246467991473531772e-16;
+
+double dmath_atan2(double y, double x) {
+	if(isnan(x) || isnan(y)) {
+		return x + y;
+	}
+
+	if(y == 0) {
+		return signbit(x) ? copysign(PI_HI, y) : y;
+	}
+
+	if(x == 0) {
+		return copysign(ATANHI[3], y);
+	}
+
+	double z = atan_positive(fabs(y / x));
+
+	if(x > 0) {
+		return copysign(z, y);
+	}
+
+	return copysign(PI_HI - (z - PI_LO), y);
+}
+
+double dmath_acos(double x) {
+	// (1 - x)(1 + x) rather than 1 - x², to keep precision near ±1; NaN for |x| > 1
+	return dmath_atan2(sqrt((1.0 - x) * (1.0 + x)), x);
+}
+
+static const double LN2_HI  = 6.93147180369123816490e-01;
+static const double LN2_LO  = 1.90821492927058770002e-10;
+static const double INVLN2  = 1.44269504088896338700e+00;
+static const double EXP_MAX = 7.09782712893383973096e+02;
+static const double EXP_MIN = -7.45133219101941108420e+02;
+
+static const double P1 =  1.66666666666666019037e-01;
+static const double P2 = -2.77777777770155933842e-03;
+static const double P3 =  6.61375632143793436117e-05;
+static const double P4 = -1.65339022054652515390e-06;
+static const double P5 =  4.13813679705723846039e-08;
+
+double dmath_exp(double x) {
+	if(isnan(x)) {
+		return x;
+	}
+
+	if(x > EXP_MAX) {
+		return INFINITY;
+	}
+
+	if(x < EXP_MIN) {
+		return 0;
+	}
+
+	double k = floor(x * INVLN2 + 0.5);
+	double hi = x - k * LN2_HI;
+	double lo = k * LN2_LO;
+	double r = hi - lo;
+	double t = r * r;
+	double c = r - t * (P1 + t * (P2 + t * (P3 + t * (P4 + t * P5))));
+	double y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+
+	// scaling by a power of two is exact
+	return ldexp(y, (int)k);
+}
+
+complex dmath_cexp(complex z) {
+	double re = creal(z);
+	double s, c;
+	dmath_sincos(cimag(z), &s, &c);
+
+	if(re == 0) {
+		return CMPLX(c, s);
+	}
+
+	double m = dmath_exp(re);
+	return CMPLX(m * c, m * s);
+}
+
+complex dmath_cdir(double angle) {
+	double s, c;
+	dmath_sincos(angle, &s, &c);
+	return CMPLX(c, s);
+}
+
+double dmath_cabs(complex z) {
+	double re = creal(z);
+	double im = cimag(z);
+	return sqrt(re * re + im * im);
+}
+
+double dmath_carg(complex z) {
+	return dmath_atan2(cimag(z), creal(z));
+}
+
+static const double LG1 = 6.666666666666735130e-01;
+static const double LG2 = 3.999999999940941908e-01;
+static const double LG3 = 2.857142874366239149e-01;
+static const double LG4 = 2.222219843214978396e-01;
+static const double LG5 = 1.818357216161805012e-01;
+static const double LG6 = 1.531383769920937332e-01;
+static const double LG7 = 1.479819860511658591e-01;
+
+double dmath_log(double x) {
+	if(isnan(x) || x < 0) {
+		return NAN;
+	}
+
+	if(x == 0) {
+		return -INFINITY;
+	}
+
+	if(isinf(x)) {
+		return x;
+	}
+
+	// x = 2^k * (1 + f) with √2/2 < 1 + f < √2; frexp and the scaling are exact
+	int k;
+	double m = frexp(x, &k);
+
+	if(m < M_SQRT1_2) {
+		m *= 2.0;
+		--k;
+	}
+
+	double f = m - 1.0;
+	double s = f / (2.0 + f);
+	double z = s * s;
+	double w = z * z;
+	double t1 = w * (LG2 + w * (LG4 + w * LG6));
+	double t2 = z * (LG1 + w * (LG3 + w * (LG5 + w * LG7)));
+	double hfsq = 0.5 * f * f;
+
+	return k * LN2_HI - ((hfsq - (s * (hfsq + (t1 + t2)) + k * LN2_LO)) - f);
+}
+
+double dmath_pow(double x, double y) {
+	if(y == 0) {
+		return 1;
+	}
+
+	if(isnan(x) || isnan(y)) {
+		return x + y;
+	}
+
+	if(y == floor(y) && fabs(y) <= 1024) {
+		// small integer powers by repeated squaring; pow(x, 2) comes out exactly as x * x
+		uint n = (uint)fabs(y);
+		double r = 1.0;
+		double b = x;
+
+		for(;;) {
+			if(n & 1) {
+				r *= b;
+			}
+
+			if(!(n >>= 1)) {
+				break;
+			}
+
+			b *= b;
+		}
+
+		return y < 0 ? 1.0 / r : r;
+	}
+
+	if(x < 0) {
+		return NAN;
+	}
+
+	if(x == 0) {
+		return y < 0 ? INFINITY : 0;
+	}
+
+	return dmath_exp(y * dmath_log(x));
+}
+
+double dmath_cosh(double x) {
+	double e = dmath_exp(fabs(x));
+	return 0.5 * e + 0.5 / e;
+}
+
+double dmath_tanh(double x) {
+	double a = fabs(x);
+
+	if(isnan(x)) {
+		return x;
+	}
+
+	if(a < 0x1p-28) {
+		return x;
+	}
+
+	if(a >= 22) {
+		return copysign(1.0, x);
+	}
+
+	double t = dmath_exp(-2.0 * a);
+	return copysign((1.0 - t) / (1.0 + t), x);
+}
+
+double dmath_atanh(double x) {
+	double a = fabs(x);
+	return copysign(0.5 * dmath_log((1.0 + a) / (1.0 - a)), x);
+}
@@ -0,0 +1,117 @@
+/*
+ * This software is licensed under the terms of the MIT-License
+ * See COPYING for further information.
+ * ---
+ * Copyright (c) 2011-2018, Lukas Weber <laochailan@web.de>.
+ * Copyright (c) 2012-2018, Andrei Alexeyev <akari@alienslab.net>.
+ */
+
+#pragma once
+#include "taisei.h"
+
+#include <complex.h>
+#include <math.h>
+
+/*
+ * Deterministic math.
+ *
+ * The dmath_* functions are built from IEEE 754 basic arithmetic and sqrt only, which are
+ * exactly specified, so they return bit-identical results on every compiler, libm and CPU.
+ * This relies on the build not contracting expressions into FMAs (-ffp-contract=off), and
+ * on 32-bit x86, on doing double arithmetic in SSE2 rather than x87 registers.
+ *
+ * Game logic that affects replays should use the sim_* wrappers instead. They call the
+ * deterministic kernels when deterministic mode is on, and plain libm otherwise, so that
+ * replays recorded before this mode existed still play back the same way.
+ */
+
+double dmath_sin(double x) attr_const;
+double dmath_cos(double x) attr_const;
+void dmath_sincos(double x, double *out_sin, double *out_cos) attr_nonnull(2, 3);
+double dmath_tan(double x) attr_const;
+double dmath_acos(double x) attr_const;
+double dmath_atan2(double y, double x) attr_const;
+double dmath_exp(double x) attr_const;
+double dmath_log(double x) attr_const;
+double dmath_pow(double x, double y) attr_const;
+double dmath_cosh(double x) attr_const;
+double dmath_tanh(double x) attr_const;
+double dmath_atanh(double x) attr_const;
+
+complex dmath_cexp(complex z) attr_const;
+complex dmath_cdir(double angle) attr_const;
+double dmath_cabs(complex z) attr_const;
+double dmath_carg(complex z) attr_const;
+
+extern bool _dmath_deterministic;
+
+void dmath_set_deterministic(bool deterministic);
+
+static inline attr_must_inline bool dmath_is_deterministic(void) {
+	return _dmath_deterministic;
+}
+
+static inline attr_must_inline double sim_sin(double x) {
+	return _dmath_deterministic ? dmath_sin(x) : sin(x);
+}
+
+static inline attr_must_inline double sim_cos(double x) {
+	return _dmath_deterministic ? dmath_cos(x) : cos(x);
+}
+
+static inline attr_must_inline double sim_tan(double x) {
+	return _dmath_deterministic ? dmath_tan(x) : tan(x);
+}
+
+static inline attr_must_inline double sim_acos(double x) {
+	return _dmath_deterministic ? dmath_acos(x) : acos(x);
+}
+
+static inline attr_must_inline double sim_atan2(double y, double x) {
+	return _dmath_deterministic ? dmath_atan2(y, x) : atan2(y, x);
+}
+
+static inline attr_must_inline double sim_exp(double x) {
+	return _dmath_deterministic ? dmath_exp(x) : exp(x);
+}
+
+static inline attr_must_inline double sim_log(double x) {
+	return _dmath_deterministic ? dmath_log(x) : log(x);
+}
+
+static inline attr_must_inline double sim_pow(double x, double y) {
+	return _dmath_deterministic ? dmath_pow(x, y) : pow(x, y);
+}
+
+static inline attr_must_inline double sim_cosh(double x) {
+	return _dmath_deterministic ? dmath_cosh(x) : cosh(x);
+}
+
+static inline attr_must_inline double sim_tanh(double x) {
+	return _dmath_deterministic ? dmath_tanh(x) : tanh(x);
+}
+
+static inline attr_must_inline double sim_atanh(double x) {
+	return _dmath_deterministic ? dmath_atanh(x) : atanh(x);
+}
+
+static inline attr_must_inline double sim_sqr(double x) {
+	return _dmath_deterministic ? x * x : pow(x, 2);
+}
+
+static inline attr_must_inline complex sim_cexp(complex z) {
+	return _dmath_deterministic ? dmath_cexp(z) : cexp(z);
+}
+
+// Same as sim_cexp(I * angle)
+static inline attr_must_inline complex sim_cdir(double angle) {
+	return _dmath_deterministic ? dmath_cdir(angle) : cexp(I * angle);
+}
+
+static inline attr_must_inline double sim_cabs(complex z) {
+	return _dmath_deterministic ? dmath_cabs(z) : cabs(z);
+}
+
+static inline attr_must_inline double sim_carg(complex z) {
+	return _dmath_deterministic ? dmath_carg(z) : carg(z);
+}
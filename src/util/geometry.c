@@ -9,6 +9,7 @@
 #include "taisei.h"
 
 #include "geometry.h"
+#include "dmath.h"
 
 #include <string.h>
 
@@ -20,8 +21,8 @@ bool point_in_ellipse(complex p, Ellipse e) {
 	double a = e.angle;
 
 	return (
-		pow(cos(a) * (Xp - Xe) + sin(a) * (Yp - Ye), 2) / pow(creal(e.axes)/2, 2) +
-		pow(sin(a) * (Xp - Xe) - cos(a) * (Yp - Ye), 2) / pow(cimag(e.axes)/2, 2)
+		sim_sqr(sim_cos(a) * (Xp - Xe) + sim_sin(a) * (Yp - Ye)) / sim_sqr(creal(e.axes)/2) +
+		sim_sqr(sim_sin(a) * (Xp - Xe) - sim_cos(a) * (Yp - Ye)) / sim_sqr(cimag(e.axes)/2)
 	) <= 1;
 }
 
@@ -36,8 +37,8 @@ double lineseg_circle_intersect(LineSegment seg, Circle c) {
 	m = seg.b - seg.a; // vector pointing along the line
 	v = seg.a - c.origin; // vector from circle to point A
 
-	lv = cabs(v);
-	lm = cabs(m);
+	lv = sim_cabs(v);
+	lm = sim_cabs(m);
 
 	if(lv < c.radius) {
 		return 0;
@@ -50,7 +51,7 @@ double lineseg_circle_intersect(LineSegment seg, Circle c) {
 	projection = -creal(v*conj(m)) / lm; // project v onto the line
 
 	// now the distance can be calculated by Pythagoras
-	distance = sqrt(pow(lv, 2) - pow(projection, 2));
+	distance = sqrt(sim_sqr(lv) - sim_sqr(projection));
 
 	if(distance <= c.radius) {
 		double f = projection/lm;
@@ -69,7 +70,7 @@ bool lineseg_ellipse_intersect(LineSegment seg, Ellipse e) {
 	// calculate the segment-circle intersection.
 
 	double ratio = creal(e.axes) / cimag(e.axes);
-	complex rotation = cexp(I * -e.angle);
+	complex rotation = sim_cexp(I * -e.angle);
 	seg.a *= rotation;
 	seg.b *= rotation;
 	seg.a = creal(seg.a) + I * ratio * cimag(seg.a);
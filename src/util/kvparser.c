@@ -147,6 +147,22 @@ bool parse_keyvalue_file_with_spec(const char *filename, KVSpec *spec) {
 	return parse_keyvalue_file_cb(filename, kvcallback_spec, spec);
 }
 
+bool parse_keyvalue_pairs_cb(uint num_pairs, const char *const pairs[], KVCallback callback, void *data) {
+	int errors = 0;
+
+	for(uint i = 0; i < num_pairs; ++i) {
+		if(!callback(pairs[i * 2], pairs[i * 2 + 1], data)) {
+			++errors;
+		}
+	}
+
+	return !errors;
+}
+
+bool parse_keyvalue_pairs_with_spec(uint num_pairs, const char *const pairs[], KVSpec *spec) {
+	return parse_keyvalue_pairs_cb(num_pairs, pairs, kvcallback_spec, spec);
+}
+
 bool parse_bool(const char *str, bool fallback) {
 	while(isspace(*str)) {
 		++str;
@@ -38,6 +38,10 @@ bool parse_keyvalue_file(const char *filename, ht_str2ptr_t *hashtable);
 bool parse_keyvalue_stream_with_spec(SDL_RWops *strm, KVSpec *spec);
 bool parse_keyvalue_file_with_spec(const char *filename, KVSpec *spec);
 
+// For already split up data; pairs holds num_pairs keys and values, interleaved.
+bool parse_keyvalue_pairs_cb(uint num_pairs, const char *const pairs[], KVCallback callback, void *data);
+bool parse_keyvalue_pairs_with_spec(uint num_pairs, const char *const pairs[], KVSpec *spec);
+
 bool parse_bool(const char *str, bool fallback) attr_nonnull(1);
 
 bool kvparser_deprecation(const char *key, const char *val, void *data);
@@ -10,6 +10,7 @@
 
 #include "miscmath.h"
 #include "assert.h"
+#include "dmath.h"
 
 double approach(double v, double t, double d) {
 	if(v < t) {
@@ -26,7 +27,7 @@ double approach(double v, double t, double d) {
 }
 
 double psin(double x) {
-	return 0.5 + 0.5 * sin(x);
+	return 0.5 + 0.5 * sim_sin(x);
 }
 
 double min(double a, double b) {
@@ -117,7 +118,7 @@ float ftopow2(float x) {
 }
 
 float smooth(float x) {
-	return 1.0 - (0.5 * cos(M_PI * x) + 0.5);
+	return 1.0 - (0.5 * sim_cos(M_PI * x) + 0.5);
 }
 
 float smoothreclamp(float x, float old_min, float old_max, float new_min, float new_max) {
@@ -130,7 +131,7 @@ float sanitize_scale(float scale) {
 }
 
 float normpdf(float x, float sigma) {
-    return 0.39894 * exp(-0.5 * pow(x, 2) / pow(sigma, 2)) / sigma;
+    return 0.39894 * sim_exp(-0.5 * sim_pow(x, 2) / sim_pow(sigma, 2)) / sigma;
 }
 
 void gaussian_kernel_1d(size_t size, float sigma, float kernel[size]) {
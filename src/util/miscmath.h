@@ -19,16 +19,16 @@ double min(double, double) attr_const;
 double max(double, double) attr_const;
 double clamp(double, double, double) attr_const;
 double approach(double v, double t, double d) attr_const;
-double psin(double) attr_const;
+double psin(double) attr_pure;
 int sign(double) attr_const;
 double swing(double x, double s) attr_const;
 uint32_t topow2_u32(uint32_t  x) attr_const;
 uint64_t topow2_u64(uint64_t x) attr_const;
 float ftopow2(float x) attr_const;
-float smooth(float x) attr_const;
-float smoothreclamp(float x, float old_min, float old_max, float new_min, float new_max) attr_const;
+float smooth(float x) attr_pure;
+float smoothreclamp(float x, float old_min, float old_max, float new_min, float new_max) attr_pure;
 float sanitize_scale(float scale) attr_const;
-float normpdf(float x, float sigma) attr_const;
+float normpdf(float x, float sigma) attr_pure;
 void gaussian_kernel_1d(size_t size, float sigma, float kernel[size]) attr_nonnull(3);
 
 #define topow2(x) (_Generic((x), \
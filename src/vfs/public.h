@@ -27,6 +27,8 @@ typedef enum VFSOpenMode {
 	VFS_MODE_READ = 1,
 	VFS_MODE_WRITE = 2,
 	VFS_MODE_SEEKABLE  = 4,
+	// the stream may be read on other threads, or after the opening thread has exited
+	VFS_MODE_ANY_THREAD = 8,
 } VFSOpenMode;
 
 #define VFS_MODE_RWMASK (VFS_MODE_READ | VFS_MODE_WRITE)
@@ -248,6 +248,10 @@ static VFSNodeFuncs vfs_funcs_union = {
 	.open = vfs_union_open,
 };
 
+bool vfs_node_is_union(VFSNode *node) {
+	return node->funcs == &vfs_funcs_union;
+}
+
 void vfs_union_init(VFSNode *node) {
 	node->funcs = &vfs_funcs_union;
 	node->data1 = node->data2 = NULL;
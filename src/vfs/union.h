@@ -13,3 +13,4 @@
 #include "union_public.h"
 
 void vfs_union_init(VFSNode *node);
+bool vfs_node_is_union(VFSNode *node) attr_nonnull(1);
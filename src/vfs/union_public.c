@@ -15,3 +15,18 @@ bool vfs_create_union_mountpoint(const char *mountpoint) {
 	vfs_union_init(unode);
 	return vfs_mount_or_decref(vfs_root, mountpoint, unode);
 }
+
+bool vfs_dir_is_merged(const char *path) {
+	char buf[strlen(path)+1];
+	path = vfs_path_normalize(path, buf);
+	VFSNode *node = vfs_locate(vfs_root, path);
+
+	if(!node) {
+		return false;
+	}
+
+	// locating through a union only yields another union if several members have this directory
+	bool merged = vfs_node_is_union(node);
+	vfs_decref(node);
+	return merged;
+}
@@ -11,3 +11,7 @@
 
 bool vfs_create_union_mountpoint(const char *mountpoint)
 	attr_nonnull(1);
+
+// True if path is a directory that more than one mounted source contributes files to.
+bool vfs_dir_is_merged(const char *path)
+	attr_nonnull(1);
@@ -11,21 +11,14 @@
 #include "zipfile.h"
 #include "zipfile_impl.h"
 
-static VFSZipFileTLS* vfs_zipfile_get_tls(VFSNode *node, bool create);
-
 #define LOG_SDL_ERROR log_debug("SDL error: %s", SDL_GetError())
 
 static zip_int64_t vfs_zipfile_srcfunc(void *userdata, void *data, zip_uint64_t len, zip_source_cmd_t cmd) {
-	VFSNode *zipnode = userdata;
-	VFSZipFileData *zdata = zipnode->data1;
-	VFSZipFileTLS *tls = vfs_zipfile_get_tls(zipnode, false);
+	VFSZipFileTLS *tls = userdata;
+	VFSZipFileData *zdata = tls->zipnode->data1;
 	VFSNode *source = zdata->source;
 	zip_int64_t ret = -1;
 
-	if(!tls) {
-		return -1;
-	}
-
 	switch(cmd) {
 		case ZIP_SOURCE_OPEN: {
 			if(!source->funcs->open) {
@@ -113,6 +106,10 @@ static zip_int64_t vfs_zipfile_srcfunc(void *userdata, void *data, zip_uint64_t
 		}
 
 		case ZIP_SOURCE_FREE: {
+			if(tls->private) {
+				free(tls);
+			}
+
 			return 0;
 		}
 
@@ -124,6 +121,12 @@ static zip_int64_t vfs_zipfile_srcfunc(void *userdata, void *data, zip_uint64_t
 }
 
 void vfs_zipfile_free_tls(VFSZipFileTLS *tls) {
+	if(tls->private) {
+		// the source callback frees the handle
+		zip_discard(tls->zip);
+		return;
+	}
+
 	if(tls->zip) {
 		zip_discard(tls->zip);
 	}
@@ -317,18 +320,12 @@ static void vfs_zipfile_init_pathmap(VFSNode *node) {
 	}
 }
 
-static VFSZipFileTLS* vfs_zipfile_get_tls(VFSNode *node, bool create) {
+static VFSZipFileTLS* vfs_zipfile_open_archive(VFSNode *node, bool private) {
 	VFSZipFileData *zdata = node->data1;
-	VFSZipFileTLS *tls = SDL_TLSGet(zdata->tls_id);
+	VFSZipFileTLS *tls = calloc(1, sizeof(VFSZipFileTLS));
+	tls->zipnode = node;
 
-	if(tls || !create) {
-		return tls;
-	}
-
-	tls = calloc(1, sizeof(VFSZipFileTLS));
-	SDL_TLSSet(zdata->tls_id, tls, (void(*)(void*))vfs_zipfile_free_tls);
-
-	zip_source_t *src = zip_source_function_create(vfs_zipfile_srcfunc, node, &tls->error);
+	zip_source_t *src = zip_source_function_create(vfs_zipfile_srcfunc, tls, &tls->error);
 	zip_t *zip = tls->zip = zip_open_from_source(src, ZIP_RDONLY, &tls->error);
 
 	// FIXME: Taisei currently doesn't handle zip files without explicit directory entries correctly (file listing will not work)
@@ -337,15 +334,35 @@ static VFSZipFileTLS* vfs_zipfile_get_tls(VFSNode *node, bool create) {
 		char *r = vfs_repr_node(zdata->source, true);
 		vfs_set_error("Failed to open zip archive '%s': %s", r, zip_error_strerror(&tls->error));
 		free(r);
-		vfs_zipfile_free_tls(tls);
-		SDL_TLSSet(zdata->tls_id, 0, NULL);
 		zip_source_free(src);
+		vfs_zipfile_free_tls(tls);
 		return NULL;
 	}
 
+	// from here on, the source owns it
+	tls->private = private;
 	return tls;
 }
 
+VFSZipFileTLS* vfs_zipfile_get_tls(VFSNode *node, bool create) {
+	VFSZipFileData *zdata = node->data1;
+	VFSZipFileTLS *tls = SDL_TLSGet(zdata->tls_id);
+
+	if(tls || !create) {
+		return tls;
+	}
+
+	if((tls = vfs_zipfile_open_archive(node, false))) {
+		SDL_TLSSet(zdata->tls_id, tls, (void(*)(void*))vfs_zipfile_free_tls);
+	}
+
+	return tls;
+}
+
+VFSZipFileTLS* vfs_zipfile_open_private(VFSNode *zipnode) {
+	return vfs_zipfile_open_archive(zipnode, true);
+}
+
 bool vfs_zipfile_init(VFSNode *node, VFSNode *source) {
 	VFSNode backup;
 	memcpy(&backup, node, sizeof(VFSNode));
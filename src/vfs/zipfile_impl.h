@@ -15,10 +15,18 @@
 
 /* zipfile */
 
+/*
+ * An open handle to the archive: a zip_t and the stream it reads the package through.
+ * Neither is thread-safe, so every thread gets its own (kept in TLS). Streams are read
+ * through the handle of the thread that opened them, unless they're opened with
+ * VFS_MODE_ANY_THREAD; those get a private handle.
+ */
 typedef struct VFSZipFileTLS {
 	zip_t *zip;
 	SDL_RWops *stream;
+	VFSNode *zipnode;
 	zip_error_t error;
+	bool private; // freed along with the zip_t
 } VFSZipFileTLS;
 
 typedef struct VFSZipFileData {
@@ -37,6 +45,9 @@ typedef struct VFSZipFileIterData {
 
 const char* vfs_zipfile_iter_shared(VFSNode *node, VFSZipFileData *zdata, VFSZipFileIterData *idata, VFSZipFileTLS *tls);
 void vfs_zipfile_iter_stop(VFSNode *node, void **opaque);
+VFSZipFileTLS* vfs_zipfile_get_tls(VFSNode *zipnode, bool create);
+VFSZipFileTLS* vfs_zipfile_open_private(VFSNode *zipnode);
+void vfs_zipfile_free_tls(VFSZipFileTLS *tls);
 
 /* zippath */
 
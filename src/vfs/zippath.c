@@ -84,23 +84,47 @@ static SDL_RWops* vfs_zippath_open(VFSNode *node, VFSOpenMode mode) {
 	}
 
 	VFSZipPathData *zdata = node->data1;
-	zip_file_t *zipfile = zip_fopen_index(zdata->tls->zip, zdata->index, 0);
+	VFSZipFileTLS *archive;
+	bool private = mode & VFS_MODE_ANY_THREAD;
+
+	if(private) {
+		// can't share the zip_t of the thread that opened it; this re-reads the central directory
+		archive = vfs_zipfile_open_private(zdata->zipnode);
+	} else {
+		archive = vfs_zipfile_get_tls(zdata->zipnode, true);
+	}
+
+	if(!archive) {
+		return NULL;
+	}
+
+	zip_file_t *zipfile = zip_fopen_index(archive->zip, zdata->index, 0);
 
 	if(!zipfile) {
-		vfs_set_error("ZIP error: %s", zip_error_strerror(&zdata->tls->error));
+		vfs_set_error("ZIP error: %s", zip_strerror(archive->zip));
+
+		if(private) {
+			vfs_zipfile_free_tls(archive);
+		}
+
 		return NULL;
 	}
 
-	SDL_RWops *ziprw = SDL_RWFromZipFile(zipfile, true);
-	assert(ziprw != NULL);
+	// seekable either way: stored entries natively, compressed ones by re-inflating
+	SDL_RWops *ziprw = SDL_RWFromZipFile(archive->zip, zdata->index, zipfile, true, private);
+
+	if(!ziprw) {
+		vfs_set_error("%s", SDL_GetError());
+		zip_fclose(zipfile);
 
-	if(!(mode & VFS_MODE_SEEKABLE)) {
-		return ziprw;
+		if(private) {
+			vfs_zipfile_free_tls(archive);
+		}
+
+		return NULL;
 	}
 
-	SDL_RWops *bufrw = SDL_RWCopyToBuffer(ziprw);
-	SDL_RWclose(ziprw);
-	return bufrw;
+	return ziprw;
 }
 
 static VFSNodeFuncs vfs_funcs_zippath = {
@@ -133,7 +133,7 @@ static const char* modeflagsstr(uint32_t flags) {
 
 static void video_new_window_internal(int w, int h, uint32_t flags, bool fallback) {
 	if(video.window) {
-		SDL_DestroyWindow(video.window);
+		r_destroy_window(video.window);
 		video.window = NULL;
 	}
 
@@ -517,7 +517,7 @@ void video_init(void) {
 void video_shutdown(void) {
 	events_unregister_handler(video_handle_window_event);
 	events_unregister_handler(video_handle_config_event);
-	SDL_DestroyWindow(video.window);
+	r_destroy_window(video.window);
 	r_shutdown();
 	free(video.modes);
 	SDL_VideoQuit();